@@ -2,9 +2,15 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <iterator>
+
 #include <mbedtls/aes.h>
 
+#include "Common/Assert.h"
+#include "Common/CPUDetect.h"
 #include "Common/Crypto/AES.h"
+#include "Common/Intrinsics.h"
 
 namespace Common::AES
 {
@@ -33,4 +39,161 @@ std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size)
 {
   return DecryptEncrypt(key, iv, src, size, Mode::Encrypt);
 }
+
+namespace
+{
+class ContextGeneric final : public Context
+{
+public:
+  ContextGeneric(const u8* key, Mode mode) : m_mode(mode)
+  {
+    if (mode == Mode::Encrypt)
+      mbedtls_aes_setkey_enc(&m_context, key, 128);
+    else
+      mbedtls_aes_setkey_dec(&m_context, key, 128);
+  }
+
+  void Crypt(u8* iv, const u8* src, u8* dst, size_t size) const override
+  {
+    ASSERT(size % 16 == 0);
+    // mbedtls doesn't write to the context, it just isn't const-correct.
+    mbedtls_aes_crypt_cbc(const_cast<mbedtls_aes_context*>(&m_context),
+                          m_mode == Mode::Encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT,
+                          size, iv, src, dst);
+  }
+
+private:
+  mbedtls_aes_context m_context;
+  Mode m_mode;
+};
+
+#ifdef _M_X86
+constexpr size_t NUM_ROUND_KEYS = 11;
+
+FUNCTION_TARGET_AES static __m128i ExpandKeyStep(__m128i key, __m128i assist)
+{
+  assist = _mm_shuffle_epi32(assist, _MM_SHUFFLE(3, 3, 3, 3));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+
+class ContextAESNI final : public Context
+{
+public:
+  FUNCTION_TARGET_AES ContextAESNI(const u8* key, Mode mode) : m_mode(mode)
+  {
+    // The round constants have to be immediates.
+    __m128i* rk = m_round_keys;
+    rk[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+    rk[1] = ExpandKeyStep(rk[0], _mm_aeskeygenassist_si128(rk[0], 0x01));
+    rk[2] = ExpandKeyStep(rk[1], _mm_aeskeygenassist_si128(rk[1], 0x02));
+    rk[3] = ExpandKeyStep(rk[2], _mm_aeskeygenassist_si128(rk[2], 0x04));
+    rk[4] = ExpandKeyStep(rk[3], _mm_aeskeygenassist_si128(rk[3], 0x08));
+    rk[5] = ExpandKeyStep(rk[4], _mm_aeskeygenassist_si128(rk[4], 0x10));
+    rk[6] = ExpandKeyStep(rk[5], _mm_aeskeygenassist_si128(rk[5], 0x20));
+    rk[7] = ExpandKeyStep(rk[6], _mm_aeskeygenassist_si128(rk[6], 0x40));
+    rk[8] = ExpandKeyStep(rk[7], _mm_aeskeygenassist_si128(rk[7], 0x80));
+    rk[9] = ExpandKeyStep(rk[8], _mm_aeskeygenassist_si128(rk[8], 0x1B));
+    rk[10] = ExpandKeyStep(rk[9], _mm_aeskeygenassist_si128(rk[9], 0x36));
+
+    if (mode == Mode::Decrypt)
+    {
+      // The equivalent inverse cipher uses the round keys in reverse order, with InvMixColumns
+      // applied to all but the first and last ones.
+      __m128i enc_keys[NUM_ROUND_KEYS];
+      std::copy(std::begin(m_round_keys), std::end(m_round_keys), enc_keys);
+      rk[0] = enc_keys[10];
+      for (size_t i = 1; i < NUM_ROUND_KEYS - 1; i++)
+        rk[i] = _mm_aesimc_si128(enc_keys[NUM_ROUND_KEYS - 1 - i]);
+      rk[10] = enc_keys[0];
+    }
+  }
+
+  void Crypt(u8* iv, const u8* src, u8* dst, size_t size) const override
+  {
+    ASSERT(size % 16 == 0);
+    if (m_mode == Mode::Encrypt)
+      Encrypt(iv, src, dst, size / 16);
+    else
+      Decrypt(iv, src, dst, size / 16);
+  }
+
+private:
+  // Each block depends on the previous one, so encryption can't be pipelined.
+  FUNCTION_TARGET_AES void Encrypt(u8* iv, const u8* src, u8* dst, size_t num_blocks) const
+  {
+    const __m128i* rk = m_round_keys;
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    for (size_t i = 0; i < num_blocks; i++)
+    {
+      block = _mm_xor_si128(block, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + i));
+      block = _mm_xor_si128(block, rk[0]);
+      for (size_t j = 1; j < NUM_ROUND_KEYS - 1; j++)
+        block = _mm_aesenc_si128(block, rk[j]);
+      block = _mm_aesenclast_si128(block, rk[10]);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst) + i, block);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), block);
+  }
+
+  // Decrypting a block only needs the ciphertext of the previous block, so several blocks can be
+  // in flight at once, which hides the latency of the AES instructions.
+  FUNCTION_TARGET_AES void Decrypt(u8* iv, const u8* src, u8* dst, size_t num_blocks) const
+  {
+    constexpr size_t PARALLEL_BLOCKS = 8;
+
+    const __m128i* rk = m_round_keys;
+    __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+    size_t i = 0;
+    for (; i + PARALLEL_BLOCKS <= num_blocks; i += PARALLEL_BLOCKS)
+    {
+      __m128i in[PARALLEL_BLOCKS];
+      __m128i block[PARALLEL_BLOCKS];
+      for (size_t k = 0; k < PARALLEL_BLOCKS; k++)
+      {
+        in[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + i + k);
+        block[k] = _mm_xor_si128(in[k], rk[0]);
+      }
+      for (size_t j = 1; j < NUM_ROUND_KEYS - 1; j++)
+      {
+        for (size_t k = 0; k < PARALLEL_BLOCKS; k++)
+          block[k] = _mm_aesdec_si128(block[k], rk[j]);
+      }
+      for (size_t k = 0; k < PARALLEL_BLOCKS; k++)
+      {
+        block[k] = _mm_aesdeclast_si128(block[k], rk[10]);
+        block[k] = _mm_xor_si128(block[k], k == 0 ? prev : in[k - 1]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst) + i + k, block[k]);
+      }
+      prev = in[PARALLEL_BLOCKS - 1];
+    }
+    for (; i < num_blocks; i++)
+    {
+      const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + i);
+      __m128i block = _mm_xor_si128(in, rk[0]);
+      for (size_t j = 1; j < NUM_ROUND_KEYS - 1; j++)
+        block = _mm_aesdec_si128(block, rk[j]);
+      block = _mm_aesdeclast_si128(block, rk[10]);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst) + i, _mm_xor_si128(block, prev));
+      prev = in;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), prev);
+  }
+
+  __m128i m_round_keys[NUM_ROUND_KEYS];
+  Mode m_mode;
+};
+#endif
+}  // namespace
+
+std::unique_ptr<Context> CreateContext(const u8* key, Mode mode)
+{
+#ifdef _M_X86
+  if (cpu_info.bAES)
+    return std::make_unique<ContextAESNI>(key, mode);
+#endif
+  return std::make_unique<ContextGeneric>(key, mode);
+}
 }  // namespace Common::AES
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -21,4 +22,18 @@ std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size
 // Convenience functions
 std::vector<u8> Decrypt(const u8* key, u8* iv, const u8* src, size_t size);
 std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size);
+
+// An expanded AES-128 key for repeated CBC operations. The AES instructions of the CPU are used
+// when they are available. A context can be used from several threads at once.
+class Context
+{
+public:
+  virtual ~Context() = default;
+
+  // Runs CBC over size bytes, which must be a multiple of 16. iv is updated so that another call
+  // continues the chain. src and dst may point to the same buffer.
+  virtual void Crypt(u8* iv, const u8* src, u8* dst, size_t size) const = 0;
+};
+
+std::unique_ptr<Context> CreateContext(const u8* key, Mode mode);
 }  // namespace Common::AES
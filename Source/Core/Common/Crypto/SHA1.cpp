@@ -0,0 +1,200 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/Crypto/SHA1.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "Common/CPUDetect.h"
+#include "Common/Intrinsics.h"
+#include "Common/Swap.h"
+
+namespace Common::SHA1
+{
+namespace
+{
+#ifdef _M_X86
+// Four of the 80 rounds, along with the part of the message schedule that can be interleaved
+// with them. The message words of four consecutive groups are rotated through msg.
+template <int group>
+FUNCTION_TARGET_SHA inline void RoundGroup(__m128i* abcd, __m128i* e0, __m128i* e1,
+                                           __m128i msg[4])
+{
+  __m128i& e = group % 2 == 0 ? *e0 : *e1;
+  __m128i& next_e = group % 2 == 0 ? *e1 : *e0;
+  const __m128i& w = msg[group % 4];
+
+  if constexpr (group == 0)
+    e = _mm_add_epi32(e, w);
+  else
+    e = _mm_sha1nexte_epu32(e, w);
+  next_e = *abcd;
+
+  if constexpr (group >= 3 && group <= 18)
+    msg[(group + 1) % 4] = _mm_sha1msg2_epu32(msg[(group + 1) % 4], w);
+  *abcd = _mm_sha1rnds4_epu32(*abcd, e, group / 5);
+  if constexpr (group >= 1 && group <= 16)
+    msg[(group + 3) % 4] = _mm_sha1msg1_epu32(msg[(group + 3) % 4], w);
+  if constexpr (group >= 2 && group <= 17)
+    msg[(group + 2) % 4] = _mm_xor_si128(msg[(group + 2) % 4], w);
+}
+
+template <int... groups>
+FUNCTION_TARGET_SHA inline void Rounds(__m128i* abcd, __m128i* e0, __m128i* e1, __m128i msg[4],
+                                       std::integer_sequence<int, groups...>)
+{
+  (RoundGroup<groups>(abcd, e0, e1, msg), ...);
+}
+
+FUNCTION_TARGET_SHA void ProcessBlocksSHA(u32 state[5], const u8* data, size_t num_blocks)
+{
+  // Loads the big-endian message words in the reverse order, like the state.
+  const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607, 0x08090a0b0c0d0e0f);
+
+  __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)),
+                                   _MM_SHUFFLE(0, 1, 2, 3));
+  __m128i e0 = _mm_set_epi32(state[4], 0, 0, 0);
+
+  for (size_t i = 0; i < num_blocks; i++, data += 64)
+  {
+    const __m128i abcd_saved = abcd;
+    const __m128i e0_saved = e0;
+    __m128i e1;
+
+    __m128i msg[4];
+    for (size_t j = 0; j < 4; j++)
+    {
+      msg[j] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + j),
+                                byte_swap);
+    }
+
+    Rounds(&abcd, &e0, &e1, msg, std::make_integer_sequence<int, 20>());
+
+    e0 = _mm_sha1nexte_epu32(e0, e0_saved);
+    abcd = _mm_add_epi32(abcd, abcd_saved);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_shuffle_epi32(abcd, _MM_SHUFFLE(0, 1, 2, 3)));
+  alignas(16) u32 e_words[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(e_words), e0);
+  state[4] = e_words[3];
+}
+#endif
+
+bool UseSHAInstructions()
+{
+#ifdef _M_X86
+  return cpu_info.bSHA1 && cpu_info.bSSSE3;
+#else
+  return false;
+#endif
+}
+
+// Only called when UseSHAInstructions returns true
+void ProcessBlocks(u32 state[5], const u8* data, size_t num_blocks)
+{
+#ifdef _M_X86
+  ProcessBlocksSHA(state, data, num_blocks);
+#endif
+}
+}  // namespace
+
+Context::Context() : m_use_sha_instructions(UseSHAInstructions())
+{
+  if (!m_use_sha_instructions)
+  {
+    mbedtls_sha1_init(&m_mbedtls_context);
+    mbedtls_sha1_starts_ret(&m_mbedtls_context);
+  }
+}
+
+Context::~Context()
+{
+  if (!m_use_sha_instructions)
+    mbedtls_sha1_free(&m_mbedtls_context);
+}
+
+void Context::Update(const u8* data, size_t size)
+{
+  if (!m_use_sha_instructions)
+  {
+    mbedtls_sha1_update_ret(&m_mbedtls_context, data, size);
+    return;
+  }
+
+  m_size += size;
+
+  if (m_buffer_size != 0)
+  {
+    const size_t bytes_to_copy = std::min(size, BLOCK_SIZE - m_buffer_size);
+    std::memcpy(m_buffer + m_buffer_size, data, bytes_to_copy);
+    m_buffer_size += bytes_to_copy;
+    data += bytes_to_copy;
+    size -= bytes_to_copy;
+
+    if (m_buffer_size != BLOCK_SIZE)
+      return;
+    ProcessBlocks(m_state, m_buffer, 1);
+    m_buffer_size = 0;
+  }
+
+  const size_t full_blocks = size / BLOCK_SIZE;
+  ProcessBlocks(m_state, data, full_blocks);
+
+  m_buffer_size = size % BLOCK_SIZE;
+  if (m_buffer_size != 0)
+    std::memcpy(m_buffer, data + full_blocks * BLOCK_SIZE, m_buffer_size);
+}
+
+Digest Context::Finish()
+{
+  Digest digest;
+
+  if (!m_use_sha_instructions)
+  {
+    mbedtls_sha1_finish_ret(&m_mbedtls_context, digest.data());
+    return digest;
+  }
+
+  // The padding is a 1 bit, zeroes, and the message length in bits, which takes one or two blocks
+  u8 tail[BLOCK_SIZE * 2] = {};
+  std::memcpy(tail, m_buffer, m_buffer_size);
+  tail[m_buffer_size] = 0x80;
+  const size_t tail_blocks = m_buffer_size + 1 + sizeof(u64) <= BLOCK_SIZE ? 1 : 2;
+  const u64 size_in_bits = Common::swap64(m_size * 8);
+  std::memcpy(tail + tail_blocks * BLOCK_SIZE - sizeof(u64), &size_in_bits, sizeof(u64));
+  ProcessBlocks(m_state, tail, tail_blocks);
+
+  for (size_t i = 0; i < 5; i++)
+  {
+    const u32 word = Common::swap32(m_state[i]);
+    std::memcpy(digest.data() + i * sizeof(u32), &word, sizeof(u32));
+  }
+  return digest;
+}
+
+void CalculateDigest(const u8* data, size_t size, u8* out)
+{
+  if (!UseSHAInstructions())
+  {
+    mbedtls_sha1_ret(data, size, out);
+    return;
+  }
+
+  Context context;
+  context.Update(data, size);
+  const Digest digest = context.Finish();
+  std::memcpy(out, digest.data(), digest.size());
+}
+
+Digest CalculateDigest(const u8* data, size_t size)
+{
+  Digest digest;
+  CalculateDigest(data, size, digest.data());
+  return digest;
+}
+}  // namespace Common::SHA1
@@ -0,0 +1,48 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <mbedtls/sha1.h>
+
+#include "Common/CommonTypes.h"
+
+namespace Common::SHA1
+{
+constexpr size_t DIGEST_SIZE = 20;
+using Digest = std::array<u8, DIGEST_SIZE>;
+
+// These use the SHA instructions of the CPU when they are available.
+void CalculateDigest(const u8* data, size_t size, u8* out);
+Digest CalculateDigest(const u8* data, size_t size);
+
+// For data that doesn't arrive all at once.
+class Context final
+{
+public:
+  Context();
+  ~Context();
+
+  Context(const Context&) = delete;
+  Context& operator=(const Context&) = delete;
+
+  void Update(const u8* data, size_t size);
+  Digest Finish();
+
+private:
+  static constexpr size_t BLOCK_SIZE = 64;
+
+  bool m_use_sha_instructions;
+  mbedtls_sha1_context m_mbedtls_context;
+
+  // Only used with the SHA instructions
+  u32 m_state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  u8 m_buffer[BLOCK_SIZE];
+  size_t m_buffer_size = 0;
+  u64 m_size = 0;
+};
+}  // namespace Common::SHA1
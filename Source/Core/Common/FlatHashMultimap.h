@@ -0,0 +1,166 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// A hash table with open addressing and linear probing, which can hold several values per key.
+// Unlike std::multimap and std::unordered_multimap, the keys and values are stored inline in a
+// single array, so looking up a key usually touches a single cache line. The keys are expected to
+// be hashes already and are only spread over the table by a multiplication.
+//
+// Inserting and erasing move other elements around, so pointers to values are only valid until
+// the table is modified.
+template <typename Value>
+class FlatHashMultimap
+{
+public:
+  size_t Size() const { return m_size; }
+  bool Empty() const { return m_size == 0; }
+
+  void Clear()
+  {
+    m_slots.clear();
+    m_size = 0;
+    m_mask = 0;
+    m_shift = 64;
+  }
+
+  void Insert(u64 key, Value value)
+  {
+    // Keep the load factor at or below 3/4, so that the probe sequences stay short.
+    if ((m_size + 1) * 4 > m_slots.size() * 3)
+      Grow();
+
+    size_t i = GetHome(key);
+    while (m_slots[i].occupied)
+      i = (i + 1) & m_mask;
+
+    m_slots[i] = {key, std::move(value), true};
+    m_size++;
+  }
+
+  // Removes one element with the given key and value. Returns false if there is none.
+  bool Erase(u64 key, const Value& value)
+  {
+    if (m_size == 0)
+      return false;
+
+    for (size_t i = GetHome(key); m_slots[i].occupied; i = (i + 1) & m_mask)
+    {
+      if (m_slots[i].key == key && m_slots[i].value == value)
+      {
+        EraseSlot(i);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Returns the first value with the given key which pred returns true for, or nullptr.
+  template <typename Predicate>
+  const Value* FindIf(u64 key, Predicate pred) const
+  {
+    if (m_size == 0)
+      return nullptr;
+
+    for (size_t i = GetHome(key); m_slots[i].occupied; i = (i + 1) & m_mask)
+    {
+      if (m_slots[i].key == key && pred(m_slots[i].value))
+        return &m_slots[i].value;
+    }
+
+    return nullptr;
+  }
+
+  size_t Count(u64 key) const
+  {
+    size_t count = 0;
+    FindIf(key, [&count](const Value&) {
+      count++;
+      return false;
+    });
+    return count;
+  }
+
+  // Calls func(key, value) for every element, in no particular order.
+  template <typename Func>
+  void ForEach(Func func) const
+  {
+    for (const Slot& slot : m_slots)
+    {
+      if (slot.occupied)
+        func(slot.key, slot.value);
+    }
+  }
+
+private:
+  struct Slot
+  {
+    u64 key;
+    Value value;
+    bool occupied;
+  };
+
+  size_t GetHome(u64 key) const
+  {
+    // Fibonacci hashing, the upper bits of the product depend on all bits of the key.
+    return m_shift >= 64 ? 0 : static_cast<size_t>((key * 0x9E3779B97F4A7C15) >> m_shift);
+  }
+
+  void Grow()
+  {
+    std::vector<Slot> old_slots(m_slots.size() ? m_slots.size() * 2 : 16);
+    std::swap(old_slots, m_slots);
+    m_mask = m_slots.size() - 1;
+    m_shift = 64;
+    for (size_t size = m_slots.size(); size > 1; size >>= 1)
+      m_shift--;
+
+    for (Slot& slot : old_slots)
+    {
+      if (!slot.occupied)
+        continue;
+
+      size_t i = GetHome(slot.key);
+      while (m_slots[i].occupied)
+        i = (i + 1) & m_mask;
+      m_slots[i] = std::move(slot);
+    }
+  }
+
+  // Backward shift deletion: elements after the hole which could live in it are moved back, so
+  // that lookups never need to skip over tombstones.
+  void EraseSlot(size_t hole)
+  {
+    for (size_t i = (hole + 1) & m_mask; m_slots[i].occupied; i = (i + 1) & m_mask)
+    {
+      const size_t home = GetHome(m_slots[i].key);
+      // Can the element at i be moved to the hole, i.e. is the hole between home and i?
+      if (((i - home) & m_mask) >= ((i - hole) & m_mask))
+      {
+        m_slots[hole] = std::move(m_slots[i]);
+        hole = i;
+      }
+    }
+
+    m_slots[hole].occupied = false;
+    m_slots[hole].value = Value{};
+    m_size--;
+  }
+
+  std::vector<Slot> m_slots;
+  size_t m_size = 0;
+  size_t m_mask = 0;
+  u32 m_shift = 64;
+};
+}  // namespace Common
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstring>
+
 #include "Common/BitUtils.h"
 #include "Common/CPUDetect.h"
 #include "Common/CommonFuncs.h"
@@ -16,6 +17,7 @@
 #include <intrin.h>
 #else
 #include <arm_acle.h>
+#include <arm_neon.h>
 #endif
 #endif
 
@@ -505,6 +507,239 @@ static u64 GetMurmurHash3(const u8* src, u32 len, u32 samples)
 }
 #endif
 
+// Wide hash
+//
+// The data is processed in stripes of 64 bytes, which are accumulated into eight 64-bit lanes
+// using 32x32->64-bit multiplies (like XXH3). The SIMD versions produce the same results as the
+// generic one.
+
+constexpr u32 WIDE_HASH_STRIPE_SIZE = 64;
+constexpr u32 WIDE_HASH_LANES = WIDE_HASH_STRIPE_SIZE / sizeof(u64);
+constexpr u32 WIDE_HASH_STRIPES_PER_BLOCK = 16;
+
+constexpr u64 WIDE_HASH_PRIME32_1 = 0x9E3779B1;
+constexpr u64 WIDE_HASH_PRIME64_1 = 0x9E3779B185EBCA87;
+constexpr u64 WIDE_HASH_PRIME64_2 = 0xC2B2AE3D27D4EB4F;
+
+// Stripe i of a block uses the keys i to i + 7, the scrambling at the end of a block uses the
+// keys 16 to 23.
+alignas(32) constexpr u64 s_wide_hash_keys[24] = {
+    0x7f5e941a98a40f5f, 0x9a1d2d452c373448, 0xc7cec24c20ff8045, 0x83783a84ebb3f723,
+    0x36121e759b6d4a6b, 0xa1ebe5c41ef39799, 0xefe9480802f36721, 0x3f9e2ae25328e921,
+    0xe8d3caa7d00ac125, 0x41d99bd53894ad3f, 0x4edb1ea519c5bc43, 0xc4782a91a09e012d,
+    0x640d08c7a934c14b, 0x06c28182cfd023a5, 0x5e8fda9fc6636a7f, 0x971788f0826fe1ef,
+    0xcd93dcbb7cd1d9f2, 0xc140b357a26cca41, 0x2de8339be5fee3f4, 0xc5e1f8b061f54494,
+    0x2d0055b9901322dd, 0xa105899fadd7f576, 0xb9380f6f08b08e18, 0x2ad277ac9a5f35c3,
+};
+
+// Accumulates num_stripes stripes which are stride bytes apart, using the keys of the first
+// stripe of the block.
+using WideHashAccumulateFunction = void (*)(u64* acc, const u8* src, u32 num_stripes,
+                                            size_t stride, const u64* keys);
+
+#if defined(_M_X86)
+
+static void AccumulateStripes_SSE2(u64* acc, const u8* src, u32 num_stripes, size_t stride,
+                                   const u64* keys)
+{
+  __m128i sums[WIDE_HASH_LANES / 2];
+  for (u32 j = 0; j < WIDE_HASH_LANES / 2; j++)
+    sums[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc) + j);
+
+  for (u32 i = 0; i < num_stripes; i++, src += stride)
+  {
+    for (u32 j = 0; j < WIDE_HASH_LANES / 2; j++)
+    {
+      const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + j);
+      const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i) + j);
+      const __m128i keyed = _mm_xor_si128(value, key);
+      const __m128i product =
+          _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+      sums[j] = _mm_add_epi64(sums[j], _mm_add_epi64(product, swapped));
+    }
+  }
+
+  for (u32 j = 0; j < WIDE_HASH_LANES / 2; j++)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc) + j, sums[j]);
+}
+
+FUNCTION_TARGET_AVX2
+static void AccumulateStripes_AVX2(u64* acc, const u8* src, u32 num_stripes, size_t stride,
+                                   const u64* keys)
+{
+  __m256i sums[WIDE_HASH_LANES / 4];
+  for (u32 j = 0; j < WIDE_HASH_LANES / 4; j++)
+    sums[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc) + j);
+
+  for (u32 i = 0; i < num_stripes; i++, src += stride)
+  {
+    for (u32 j = 0; j < WIDE_HASH_LANES / 4; j++)
+    {
+      const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src) + j);
+      const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i) + j);
+      const __m256i keyed = _mm256_xor_si256(value, key);
+      const __m256i product =
+          _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+      sums[j] = _mm256_add_epi64(sums[j], _mm256_add_epi64(product, swapped));
+    }
+  }
+
+  for (u32 j = 0; j < WIDE_HASH_LANES / 4; j++)
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc) + j, sums[j]);
+}
+
+static WideHashAccumulateFunction s_wide_hash_accumulate = &AccumulateStripes_SSE2;
+
+#elif defined(_M_ARM_64)
+
+static void AccumulateStripes_NEON(u64* acc, const u8* src, u32 num_stripes, size_t stride,
+                                   const u64* keys)
+{
+  uint64x2_t sums[WIDE_HASH_LANES / 2];
+  for (u32 j = 0; j < WIDE_HASH_LANES / 2; j++)
+    sums[j] = vld1q_u64(acc + j * 2);
+
+  for (u32 i = 0; i < num_stripes; i++, src += stride)
+  {
+    for (u32 j = 0; j < WIDE_HASH_LANES / 2; j++)
+    {
+      const uint64x2_t value = vreinterpretq_u64_u8(vld1q_u8(src + j * 16));
+      const uint64x2_t keyed = veorq_u64(value, vld1q_u64(keys + i + j * 2));
+      sums[j] = vaddq_u64(sums[j], vextq_u64(value, value, 1));
+      sums[j] = vmlal_u32(sums[j], vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+    }
+  }
+
+  for (u32 j = 0; j < WIDE_HASH_LANES / 2; j++)
+    vst1q_u64(acc + j * 2, sums[j]);
+}
+
+static WideHashAccumulateFunction s_wide_hash_accumulate = &AccumulateStripes_NEON;
+
+#else
+
+static void AccumulateStripes_Generic(u64* acc, const u8* src, u32 num_stripes, size_t stride,
+                                      const u64* keys)
+{
+  for (u32 i = 0; i < num_stripes; i++, src += stride)
+  {
+    for (u32 lane = 0; lane < WIDE_HASH_LANES; lane++)
+    {
+      u64 value;
+      std::memcpy(&value, src + lane * sizeof(u64), sizeof(u64));
+      const u64 keyed = value ^ keys[i + lane];
+      acc[lane ^ 1] += value;
+      acc[lane] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+  }
+}
+
+static WideHashAccumulateFunction s_wide_hash_accumulate = &AccumulateStripes_Generic;
+
+#endif
+
+static void ScrambleAccumulators(u64* acc)
+{
+  const u64* keys = s_wide_hash_keys + WIDE_HASH_STRIPES_PER_BLOCK;
+  for (u32 lane = 0; lane < WIDE_HASH_LANES; lane++)
+    acc[lane] = ((acc[lane] ^ (acc[lane] >> 47)) ^ keys[lane]) * WIDE_HASH_PRIME32_1;
+}
+
+static u64 MultiplyFold64(u64 a, u64 b)
+{
+#if defined(_MSC_VER) && defined(_M_X86_64)
+  u64 high;
+  const u64 low = _umul128(a, b, &high);
+  return low ^ high;
+#elif defined(_MSC_VER) && defined(_M_ARM_64)
+  return (a * b) ^ __umulh(a, b);
+#elif defined(__SIZEOF_INT128__)
+  const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  return static_cast<u64>(product) ^ static_cast<u64>(product >> 64);
+#else
+  const u64 lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+  const u64 hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+  const u64 lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+  const u64 hi_hi = (a >> 32) * (b >> 32);
+  const u64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  const u64 high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+  const u64 low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+  return low ^ high;
+#endif
+}
+
+static u64 MergeAccumulators(const u64* acc, const u64* keys, u64 start)
+{
+  u64 result = start;
+  for (u32 lane = 0; lane < WIDE_HASH_LANES; lane += 2)
+    result += MultiplyFold64(acc[lane] ^ keys[lane], acc[lane + 1] ^ keys[lane + 1]);
+
+  result ^= result >> 37;
+  result *= 0x165667919E3779F9;
+  result ^= result >> 32;
+  return result;
+}
+
+static void AccumulateWideHash(const u8* src, u32 len, u32 samples, u64* acc)
+{
+  acc[0] = 0xC2B2AE3D;
+  acc[1] = 0x9E3779B185EBCA87;
+  acc[2] = 0xC2B2AE3D27D4EB4F;
+  acc[3] = 0x165667B19E3779F9;
+  acc[4] = 0x85EBCA77C2B2AE63;
+  acc[5] = 0x85EBCA77;
+  acc[6] = 0x27D4EB2F165667C5;
+  acc[7] = 0x9E3779B1;
+
+  const u32 total_stripes = len / WIDE_HASH_STRIPE_SIZE;
+  u32 step = 1;
+  if (samples != 0)
+  {
+    const u32 sampled_stripes = std::max<u32>(samples / WIDE_HASH_LANES, 1);
+    step = std::max<u32>(total_stripes / sampled_stripes, 1);
+  }
+  const size_t stride = size_t{step} * WIDE_HASH_STRIPE_SIZE;
+
+  u32 remaining = (total_stripes + step - 1) / step;
+  const u8* data = src;
+  while (remaining != 0)
+  {
+    const u32 num_stripes = std::min(remaining, WIDE_HASH_STRIPES_PER_BLOCK);
+    s_wide_hash_accumulate(acc, data, num_stripes, stride, s_wide_hash_keys);
+    data += stride * num_stripes;
+    remaining -= num_stripes;
+    if (num_stripes == WIDE_HASH_STRIPES_PER_BLOCK)
+      ScrambleAccumulators(acc);
+  }
+
+  // The remaining bytes are hashed as one more stripe padded with zeroes. The length is mixed in
+  // when merging, so the padding can't be confused with actual zeroes.
+  const u32 tail_size = len % WIDE_HASH_STRIPE_SIZE;
+  if (tail_size != 0)
+  {
+    u8 tail[WIDE_HASH_STRIPE_SIZE] = {};
+    std::memcpy(tail, src + len - tail_size, tail_size);
+    s_wide_hash_accumulate(acc, tail, 1, WIDE_HASH_STRIPE_SIZE, s_wide_hash_keys + 7);
+  }
+}
+
+u64 GetWideHash64(const u8* src, u32 len, u32 samples)
+{
+  u64 acc[WIDE_HASH_LANES];
+  AccumulateWideHash(src, len, samples, acc);
+  return MergeAccumulators(acc, s_wide_hash_keys + 11, len * WIDE_HASH_PRIME64_1);
+}
+
+Hash128 GetWideHash128(const u8* src, u32 len, u32 samples)
+{
+  u64 acc[WIDE_HASH_LANES];
+  AccumulateWideHash(src, len, samples, acc);
+  return {MergeAccumulators(acc, s_wide_hash_keys + 11, len * WIDE_HASH_PRIME64_1),
+          MergeAccumulators(acc, s_wide_hash_keys + 3, ~(len * WIDE_HASH_PRIME64_2))};
+}
+
 u64 GetHash64(const u8* src, u32 len, u32 samples)
 {
   return ptrHashFunction(src, len, samples);
@@ -529,5 +764,10 @@ void SetHash64Function()
   {
     ptrHashFunction = &GetMurmurHash3;
   }
+
+#if defined(_M_X86)
+  if (cpu_info.bAVX2)
+    s_wide_hash_accumulate = &AccumulateStripes_AVX2;
+#endif
 }
 }  // namespace Common
@@ -28,6 +28,9 @@
  */
 
 #include <x86intrin.h>
+#ifndef __AVX2__
+#define FUNCTION_TARGET_AVX2 [[gnu::target("avx2")]]
+#endif
 #ifndef __SSE4_2__
 #define FUNCTION_TARGET_SSE42 [[gnu::target("sse4.2")]]
 #endif
@@ -40,6 +43,12 @@
 #ifndef __SSE3__
 #define FUNCTION_TARGET_SSE3 [[gnu::target("sse3")]]
 #endif
+#ifndef __AES__
+#define FUNCTION_TARGET_AES [[gnu::target("aes")]]
+#endif
+#ifndef __SHA__
+#define FUNCTION_TARGET_SHA [[gnu::target("sha,ssse3")]]
+#endif
 
 #elif defined(_MSC_VER) || defined(__INTEL_COMPILER)
 
@@ -58,6 +67,9 @@
  * version without the macro around a #ifdef guard. Be careful when using intrinsics, as all use
  * should still be placed around a #ifdef _M_X86 if the file is compiled on all architectures.
  */
+#ifndef FUNCTION_TARGET_AVX2
+#define FUNCTION_TARGET_AVX2
+#endif
 #ifndef FUNCTION_TARGET_SSE42
 #define FUNCTION_TARGET_SSE42
 #endif
@@ -70,3 +82,9 @@
 #ifndef FUNCTION_TARGET_SSE3
 #define FUNCTION_TARGET_SSE3
 #endif
+#ifndef FUNCTION_TARGET_AES
+#define FUNCTION_TARGET_AES
+#endif
+#ifndef FUNCTION_TARGET_SHA
+#define FUNCTION_TARGET_SHA
+#endif
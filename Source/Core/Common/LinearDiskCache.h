@@ -5,29 +5,51 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
-#include <fstream>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/File.h"
 #include "Common/FileUtil.h"
 #include "Common/Version.h"
 
 // On disk format:
 // header{
 // u32 'DCAC';
-// u32 version;  // svn_rev
+// u32 format_version;
 // u16 sizeof(key_type);
 // u16 sizeof(value_type);
+// char version[40];  // git revision
 //}
 
 // key_value_pair{
 // u32 value_size;
 // key_type   key;
 // value_type[value_size]   value;
+// u32 entry_number;  // 1-based, for detecting truncated files
 //}
 
+// The key index is kept next to the cache, in <filename>.index. It is rewritten when the cache is
+// closed, and only describes the start of the cache if Dolphin didn't shut down cleanly:
+// index_header{
+// u32 'DCIX';
+// u32 format_version;
+// u64 size of the cache that the index covers;
+// u32 number of entries in that part of the cache;
+// u32 number of keys;
+// header of the cache;
+//}
+// key_type keys[number of keys];
+// location{u64 value_offset; u32 value_size; u32 padding;}[number of keys];
+
 template <typename K, typename V>
 class LinearDiskCacheReader
 {
@@ -35,14 +57,19 @@ public:
   virtual void Read(const K& key, const V* value, u32 value_size) = 0;
 };
 
-// Dead simple unsorted key-value store with append functionality.
-// No random read functionality, all reading is done in OpenAndRead.
+// Unsorted key-value store with append functionality.
 // Keys and values can contain any characters, including \0.
 //
+// Opening a cache only builds an index of the keys, which is loaded from the index file if it is
+// up to date, so values can be read lazily with Get. OpenAndRead reads all values up front.
+// Appending a key again replaces its value. The replaced entries stay in the file until it is
+// compacted, which happens when opening a cache where they take up more than half the space.
+//
 // Suitable for caching generated shader bytecode between executions.
-// Not tuned for extreme performance but should be reasonably fast.
 // Does not support keys or values larger than 2GB, which should be reasonable.
 // Keys must have non-zero length; values can have zero length.
+// Keys are compared by their bytes, so any padding in them must be zeroed.
+// All methods can be called from any thread.
 
 // K and V are some POD type
 // K : the key type
@@ -51,101 +78,419 @@ template <typename K, typename V>
 class LinearDiskCache
 {
 public:
-  // return number of read entries
+  LinearDiskCache() = default;
+  ~LinearDiskCache() { Close(); }
+
+  LinearDiskCache(const LinearDiskCache&) = delete;
+  LinearDiskCache& operator=(const LinearDiskCache&) = delete;
+
+  // Opens the cache, creating it if it doesn't exist or is invalid, and returns the number of keys.
+  u32 Open(const std::string& filename)
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    OpenInternal(filename);
+    return static_cast<u32>(m_index.size());
+  }
+
+  // Opens the cache like Open, and passes every value to the reader in the order they were
+  // appended. Returns the number of values.
   u32 OpenAndRead(const std::string& filename, LinearDiskCacheReader<K, V>& reader)
   {
-    using std::ios_base;
+    std::lock_guard<std::mutex> lk(m_lock);
+    OpenInternal(filename);
 
-    // Since we're reading/writing directly to the storage of K instances,
-    // K must be trivially copyable.
-    static_assert(std::is_trivially_copyable<K>::value, "K must be a trivially copyable type");
+    u32 num_read = 0;
+    std::vector<V> value;
+    for (const auto* entry : GetEntriesInFileOrder())
+    {
+      if (!ReadValue(entry->second, &value))
+        break;
 
-    // close any currently opened file
-    Close();
-    m_num_entries = 0;
+      reader.Read(entry->first, value.data(), entry->second.value_size);
+      num_read++;
+    }
+    return num_read;
+  }
 
-    // try opening for reading/writing
-    File::OpenFStream(m_file, filename, ios_base::in | ios_base::out | ios_base::binary);
+  bool Contains(const K& key) const
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    return m_index.find(key) != m_index.end();
+  }
+
+  // Reads the value of a key from the file. Returns false if the key isn't in the cache.
+  bool Get(const K& key, std::vector<V>* value)
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    const auto it = m_index.find(key);
+    return it != m_index.end() && ReadValue(it->second, value);
+  }
 
-    m_file.seekg(0, std::ios::end);
-    std::fstream::pos_type end_pos = m_file.tellg();
-    m_file.seekg(0, std::ios::beg);
-    std::fstream::pos_type start_pos = m_file.tellg();
-    std::streamoff file_size = end_pos - start_pos;
+  // Calls func for every key in the cache, in no particular order.
+  template <typename F>
+  void ForEachKey(F func) const
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    for (const auto& entry : m_index)
+      func(entry.first);
+  }
 
-    m_header.Init();
-    if (m_file.is_open() && ValidateHeader())
+  // Removes a key, e.g. because its value turned out to be unusable. The value stays in the file
+  // until it is compacted, so it comes back if the index file is lost before that.
+  void Erase(const K& key)
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    const auto it = m_index.find(key);
+    if (it == m_index.end())
+      return;
+
+    m_live_size -= GetEntrySize(it->second.value_size);
+    m_index.erase(it);
+    m_index_dirty = true;
+  }
+
+  // Rewrites the file without the values which have been replaced.
+  void Compact()
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    CompactInternal();
+  }
+
+  void Sync()
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    m_file.Flush();
+  }
+
+  void Close()
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    CloseInternal();
+  }
+
+  // Appends a key-value pair to the store, replacing any value the key had.
+  void Append(const K& key, const V* value, u32 value_size)
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    const u32 entry_number = m_num_entries + 1;
+    if (!m_file.Seek(m_size, SEEK_SET) || !Write(&value_size) || !Write(&key) ||
+        !Write(value, value_size) || !Write(&entry_number))
     {
-      // good header, read some key/value pairs
-      K key;
+      // The next entry overwrites whatever part of this one was written.
+      m_file.Clear();
+      return;
+    }
+
+    AddToIndex(key, {m_size + sizeof(value_size) + sizeof(K), value_size, 0});
+    m_size += GetEntrySize(value_size);
+    m_num_entries = entry_number;
+    m_index_dirty = true;
+  }
+
+private:
+  static constexpr u32 FORMAT_VERSION = 2;
+  static constexpr u32 INDEX_ID = 0x58494344;  // DCIX
+
+  // Since we're reading/writing directly to the storage of K instances,
+  // K must be trivially copyable.
+  static_assert(std::is_trivially_copyable<K>::value, "K must be a trivially copyable type");
+
+  struct Location
+  {
+    u64 value_offset;
+    u32 value_size;
+    u32 padding;
+  };
+
+  struct KeyHash
+  {
+    size_t operator()(const K& key) const
+    {
+      return std::hash<std::string_view>()(
+          std::string_view(reinterpret_cast<const char*>(&key), sizeof(K)));
+    }
+  };
+
+  struct KeyEqual
+  {
+    bool operator()(const K& a, const K& b) const { return std::memcmp(&a, &b, sizeof(K)) == 0; }
+  };
 
-      V* value = nullptr;
-      u32 value_size = 0;
-      u32 entry_number = 0;
+  using Index = std::unordered_map<K, Location, KeyHash, KeyEqual>;
 
-      std::fstream::pos_type last_pos = m_file.tellg();
+  struct IndexHeader
+  {
+    u32 id;
+    u32 format_version;
+    u64 cache_size;
+    u32 num_entries;
+    u32 num_keys;
+  };
+
+  static u64 GetEntrySize(u32 value_size)
+  {
+    return sizeof(u32) + sizeof(K) + u64{value_size} * sizeof(V) + sizeof(u32);
+  }
 
-      while (Read(&value_size))
+  void OpenInternal(const std::string& filename)
+  {
+    CloseInternal();
+    m_filename = filename;
+    m_header.Init();
+
+    // try opening for reading/writing
+    if (m_file.Open(filename, "r+b") && ValidateHeader())
+    {
+      if (!ReadIndexFile())
+        ResetIndex();
+      ReadEntries();
+
+      // Don't keep anything after the last valid entry, e.g. a partially written one.
+      if (m_file.GetSize() != m_size)
       {
-        std::streamoff next_extent = (last_pos - start_pos) + sizeof(value_size) + value_size;
-        if (next_extent > file_size)
-          break;
-
-        delete[] value;
-        value = new V[value_size];
-
-        // read key/value and pass to reader
-        if (Read(&key) && Read(value, value_size) && Read(&entry_number) &&
-            entry_number == m_num_entries + 1)
-        {
-          reader.Read(key, value, value_size);
-        }
-        else
-        {
-          break;
-        }
-
-        m_num_entries++;
-        last_pos = m_file.tellg();
+        m_file.Resize(m_size);
+        m_file.Clear();
       }
-      m_file.seekp(last_pos);
-      m_file.clear();
 
-      delete[] value;
-      return m_num_entries;
+      if (m_size - sizeof(Header) - m_live_size > m_live_size)
+        CompactInternal();
+      return;
     }
 
     // failed to open file for reading or bad header
     // close and recreate file
-    Close();
-    File::OpenFStream(m_file, filename, ios_base::out | ios_base::trunc | ios_base::binary);
+    m_file.Close();
+    DeleteIndexFile();
+    m_file.Open(filename, "w+b");
     WriteHeader();
-    return 0;
+    ResetIndex();
   }
 
-  void Sync() { m_file.flush(); }
-  void Close()
+  void CloseInternal()
   {
-    if (m_file.is_open())
-      m_file.close();
-    // clear any error flags
-    m_file.clear();
+    if (m_file.IsOpen())
+    {
+      if (m_index_dirty)
+        WriteIndexFile();
+      m_file.Close();
+    }
+    m_index.clear();
+    m_index_dirty = false;
   }
 
-  // Appends a key-value pair to the store.
-  void Append(const K& key, const V* value, u32 value_size)
+  void ResetIndex()
   {
-    // TODO: Should do a check that we don't already have "key"? (I think each caller does that
-    // already.)
-    Write(&value_size);
-    Write(&key);
-    Write(value, value_size);
-    m_num_entries++;
-    Write(&m_num_entries);
+    m_index.clear();
+    m_size = sizeof(Header);
+    m_live_size = 0;
+    m_num_entries = 0;
+    m_index_dirty = false;
+  }
+
+  void AddToIndex(const K& key, const Location& location)
+  {
+    const auto result = m_index.try_emplace(key, location);
+    if (!result.second)
+    {
+      m_live_size -= GetEntrySize(result.first->second.value_size);
+      result.first->second = location;
+    }
+    m_live_size += GetEntrySize(location.value_size);
+  }
+
+  // Adds the entries after the part of the file which the index covers.
+  void ReadEntries()
+  {
+    const u64 file_size = m_file.GetSize();
+    u64 position = m_size;
+    m_file.Seek(position, SEEK_SET);
+
+    u32 value_size;
+    K key;
+    u32 entry_number;
+    while (Read(&value_size))
+    {
+      const u64 next_position = position + GetEntrySize(value_size);
+      if (next_position > file_size || !Read(&key) ||
+          !m_file.Seek(s64{value_size} * sizeof(V), SEEK_CUR) || !Read(&entry_number) ||
+          entry_number != m_num_entries + 1)
+      {
+        break;
+      }
+
+      AddToIndex(key, {position + sizeof(value_size) + sizeof(K), value_size, 0});
+      m_num_entries = entry_number;
+      m_index_dirty = true;
+      position = next_position;
+    }
+    m_file.Clear();
+    m_size = position;
+  }
+
+  bool ReadValue(const Location& location, std::vector<V>* value)
+  {
+    value->resize(location.value_size);
+    if (!m_file.Seek(location.value_offset, SEEK_SET) || !Read(value->data(), location.value_size))
+    {
+      m_file.Clear();
+      return false;
+    }
+    return true;
+  }
+
+  std::vector<const typename Index::value_type*> GetEntriesInFileOrder() const
+  {
+    std::vector<const typename Index::value_type*> entries;
+    entries.reserve(m_index.size());
+    for (const auto& entry : m_index)
+      entries.push_back(&entry);
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) {
+      return a->second.value_offset < b->second.value_offset;
+    });
+    return entries;
+  }
+
+  void CompactInternal()
+  {
+    if (!m_file.IsOpen())
+      return;
+
+    const std::string temp_filename = m_filename + ".tmp";
+    File::IOFile temp_file(temp_filename, "wb");
+    bool success = temp_file.WriteBytes(&m_header, sizeof(Header));
+
+    std::vector<std::pair<K, Location>> new_locations;
+    new_locations.reserve(m_index.size());
+    u64 position = sizeof(Header);
+    std::vector<V> value;
+    for (const auto* entry : GetEntriesInFileOrder())
+    {
+      const u32 value_size = entry->second.value_size;
+      const u32 entry_number = static_cast<u32>(new_locations.size()) + 1;
+      success = success && ReadValue(entry->second, &value) &&
+                temp_file.WriteArray(&value_size, 1) && temp_file.WriteArray(&entry->first, 1) &&
+                (value_size == 0 || temp_file.WriteArray(value.data(), value_size)) &&
+                temp_file.WriteArray(&entry_number, 1);
+      if (!success)
+        break;
+
+      const Location location{position + sizeof(value_size) + sizeof(K), value_size, 0};
+      new_locations.emplace_back(entry->first, location);
+      position += GetEntrySize(value_size);
+    }
+
+    success = temp_file.Close() && success;
+    if (success)
+    {
+      m_file.Close();
+      DeleteIndexFile();
+      success = File::Rename(temp_filename, m_filename);
+      m_file.Open(m_filename, "r+b");
+    }
+    if (!success)
+    {
+      File::Delete(temp_filename);
+      return;
+    }
+
+    for (const auto& location : new_locations)
+      m_index[location.first] = location.second;
+    m_size = position;
+    m_live_size = position - sizeof(Header);
+    m_num_entries = static_cast<u32>(new_locations.size());
+    m_index_dirty = true;
+  }
+
+  std::string GetIndexFilename() const { return m_filename + ".index"; }
+
+  void DeleteIndexFile() const
+  {
+    const std::string index_filename = GetIndexFilename();
+    if (File::Exists(index_filename))
+      File::Delete(index_filename);
+  }
+
+  bool ReadIndexFile()
+  {
+    File::IOFile index_file(GetIndexFilename(), "rb");
+    IndexHeader header;
+    char cache_header[sizeof(Header)];
+    if (!index_file.ReadArray(&header, 1) || !index_file.ReadBytes(cache_header, sizeof(Header)) ||
+        header.id != INDEX_ID || header.format_version != FORMAT_VERSION ||
+        std::memcmp(&m_header, cache_header, sizeof(Header)) != 0)
+    {
+      return false;
+    }
+
+    // The index is only rewritten on close, so the cache may have grown since. If it is smaller
+    // or its entry count doesn't match, it was replaced without going through this class.
+    const u64 keys_size = u64{header.num_keys} * (sizeof(K) + sizeof(Location));
+    u32 last_entry_number = 0;
+    if (index_file.GetSize() != sizeof(header) + sizeof(Header) + keys_size ||
+        header.cache_size < sizeof(Header) || header.cache_size > m_file.GetSize() ||
+        header.num_keys > header.num_entries ||
+        (header.num_entries != 0 &&
+         (!m_file.Seek(header.cache_size - sizeof(u32), SEEK_SET) || !Read(&last_entry_number) ||
+          last_entry_number != header.num_entries)))
+    {
+      m_file.Clear();
+      return false;
+    }
+
+    std::vector<K> keys(header.num_keys);
+    std::vector<Location> locations(header.num_keys);
+    if (!index_file.ReadArray(keys.data(), keys.size()) ||
+        !index_file.ReadArray(locations.data(), locations.size()))
+    {
+      return false;
+    }
+
+    ResetIndex();
+    m_index.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+      if (locations[i].value_offset + u64{locations[i].value_size} * sizeof(V) >
+          header.cache_size)
+      {
+        return false;
+      }
+      AddToIndex(keys[i], locations[i]);
+    }
+    m_size = header.cache_size;
+    m_num_entries = header.num_entries;
+    return true;
+  }
+
+  void WriteIndexFile()
+  {
+    std::vector<K> keys;
+    std::vector<Location> locations;
+    keys.reserve(m_index.size());
+    locations.reserve(m_index.size());
+    for (const auto& entry : m_index)
+    {
+      keys.push_back(entry.first);
+      locations.push_back(entry.second);
+    }
+
+    const IndexHeader header{INDEX_ID, FORMAT_VERSION, m_size, m_num_entries,
+                             static_cast<u32>(keys.size())};
+    File::IOFile index_file(GetIndexFilename(), "wb");
+    if (!index_file.WriteArray(&header, 1) || !index_file.WriteBytes(&m_header, sizeof(Header)) ||
+        !index_file.WriteArray(keys.data(), keys.size()) ||
+        !index_file.WriteArray(locations.data(), locations.size()))
+    {
+      index_file.Close();
+      DeleteIndexFile();
+    }
+  }
+
+  void WriteHeader()
+  {
+    Write(&m_header);
+    m_file.Flush();
   }
 
-private:
-  void WriteHeader() { Write(&m_header); }
   bool ValidateHeader()
   {
     char file_header[sizeof(Header)];
@@ -154,16 +499,17 @@ private:
             !memcmp((const char*)&m_header, file_header, sizeof(Header)));
   }
 
+  // Empty values can have a null pointer, which mustn't be passed to fread and fwrite.
   template <typename D>
   bool Write(const D* data, u32 count = 1)
   {
-    return m_file.write(reinterpret_cast<const char*>(data), count * sizeof(D)).good();
+    return count == 0 || m_file.WriteArray(data, count);
   }
 
   template <typename D>
   bool Read(D* data, u32 count = 1)
   {
-    return m_file.read(reinterpret_cast<char*>(data), count * sizeof(D)).good();
+    return count == 0 || m_file.ReadArray(data, count);
   }
 
   struct Header
@@ -177,12 +523,21 @@ private:
     }
 
     u32 id;
+    const u32 format_version = FORMAT_VERSION;
     const u16 key_t_size = sizeof(K);
     const u16 value_t_size = sizeof(V);
     char ver[40] = {};
 
   } m_header;
 
-  std::fstream m_file;
-  u32 m_num_entries;
+  mutable std::mutex m_lock;
+  File::IOFile m_file;
+  std::string m_filename;
+
+  Index m_index;
+  // The size of the valid part of the file, and of the entries in it which are in the index.
+  u64 m_size = 0;
+  u64 m_live_size = 0;
+  u32 m_num_entries = 0;
+  bool m_index_dirty = false;
 };
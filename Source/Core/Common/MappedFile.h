@@ -0,0 +1,41 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// A read-only view of a whole file. The contents are paged in by the OS when they are accessed, so
+// opening even a huge file is cheap and reading from it doesn't need any copies.
+class MappedFile final
+{
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  bool Open(const std::string& filename);
+  void Close();
+
+  bool IsOpen() const { return m_data != nullptr; }
+  explicit operator bool() const { return IsOpen(); }
+
+  const u8* GetData() const { return m_data; }
+  size_t GetSize() const { return m_size; }
+
+private:
+  const u8* m_data = nullptr;
+  size_t m_size = 0;
+};
+}  // namespace Common
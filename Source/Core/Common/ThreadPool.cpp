@@ -0,0 +1,105 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "Common/Thread.h"
+
+namespace Common
+{
+ThreadPool::ThreadPool(u32 num_workers, std::string name) : m_name(std::move(name))
+{
+  m_workers.reserve(num_workers);
+  for (u32 i = 0; i < num_workers; i++)
+    m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    m_exit = true;
+  }
+  m_work_available.notify_all();
+
+  for (std::thread& worker : m_workers)
+    worker.join();
+}
+
+u32 ThreadPool::GetDefaultNumWorkers(u32 max_free_threads)
+{
+  const u32 num_cores = std::max(std::thread::hardware_concurrency(), 1u);
+  // With few cores, using all of them for the pool still beats running the tasks serially.
+  const u32 free_threads = std::min(max_free_threads, num_cores / 4);
+  return num_cores - free_threads - 1;
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& func)
+{
+  if (count == 0)
+    return;
+
+  if (count == 1 || m_workers.empty())
+  {
+    for (size_t i = 0; i < count; i++)
+      func(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> parallel_for_lk(m_parallel_for_lock);
+
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    m_func = &func;
+    m_count = count;
+    m_next_index = 0;
+    m_generation++;
+  }
+  m_work_available.notify_all();
+
+  RunTasks(func, count);
+
+  // Workers which haven't picked up the work yet mustn't see func after it has been returned from.
+  std::unique_lock<std::mutex> lk(m_lock);
+  m_func = nullptr;
+  m_work_done.wait(lk, [this] { return m_active_workers == 0; });
+}
+
+void ThreadPool::RunTasks(const std::function<void(size_t)>& func, size_t count)
+{
+  for (size_t i = m_next_index++; i < count; i = m_next_index++)
+    func(i);
+}
+
+void ThreadPool::WorkerLoop()
+{
+  Common::SetCurrentThreadName(m_name.c_str());
+
+  u64 seen_generation = 0;
+  std::unique_lock<std::mutex> lk(m_lock);
+  while (true)
+  {
+    m_work_available.wait(lk, [&] { return m_exit || m_generation != seen_generation; });
+    if (m_exit)
+      return;
+
+    seen_generation = m_generation;
+    if (!m_func)
+      continue;
+
+    const std::function<void(size_t)>& func = *m_func;
+    const size_t count = m_count;
+    m_active_workers++;
+    lk.unlock();
+    RunTasks(func, count);
+    lk.lock();
+
+    if (--m_active_workers == 0)
+      m_work_done.notify_one();
+  }
+}
+}  // namespace Common
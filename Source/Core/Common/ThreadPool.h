@@ -0,0 +1,65 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// A fixed set of worker threads for splitting a piece of work into parallel tasks. The thread which
+// calls ParallelFor works on the tasks as well, so a pool without workers runs them serially.
+class ThreadPool final
+{
+public:
+  ThreadPool(u32 num_workers, std::string name);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // The number of threads that tasks run on, including the calling thread.
+  u32 GetNumThreads() const { return static_cast<u32>(m_workers.size()) + 1; }
+
+  // Calls func(i) for every i in [0, count) and returns once all calls have finished. The calls
+  // happen in no particular order and on any of the threads. Calls from several threads are
+  // serialized, and func must not call ParallelFor on the same pool.
+  void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
+  // The number of workers for a pool that should use all cores, leaving max_free_threads cores
+  // for other threads if there are enough of them.
+  static u32 GetDefaultNumWorkers(u32 max_free_threads = 1);
+
+private:
+  void WorkerLoop();
+  void RunTasks(const std::function<void(size_t)>& func, size_t count);
+
+  std::string m_name;
+  std::vector<std::thread> m_workers;
+
+  // Only one ParallelFor runs at a time.
+  std::mutex m_parallel_for_lock;
+
+  std::mutex m_lock;
+  std::condition_variable m_work_available;
+  std::condition_variable m_work_done;
+  const std::function<void(size_t)>* m_func = nullptr;
+  size_t m_count = 0;
+  std::atomic<size_t> m_next_index{0};
+  // Bumped for every ParallelFor, so that workers don't join the same one twice.
+  u64 m_generation = 0;
+  // Workers which are running tasks of the current ParallelFor.
+  u32 m_active_workers = 0;
+  bool m_exit = false;
+};
+}  // namespace Common
@@ -67,6 +67,9 @@ struct BootParameters
   struct DFF
   {
     std::string dff_path;
+    // FIFO logs don't record which game they come from. If set, playback runs as this game,
+    // so that the game's shader cache is used and added to.
+    std::string game_id;
   };
 
   static std::unique_ptr<BootParameters>
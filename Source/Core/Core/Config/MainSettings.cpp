@@ -109,6 +109,15 @@ const Info<u32> MAIN_CUSTOM_RTC_VALUE{{System::Main, "Core", "CustomRTCValue"},
 const Info<bool> MAIN_AUTO_DISC_CHANGE{{System::Main, "Core", "AutoDiscChange"}, false};
 const Info<bool> MAIN_ALLOW_SD_WRITES{{System::Main, "Core", "WiiSDCardAllowWrites"}, true};
 const Info<bool> MAIN_ENABLE_SAVESTATES{{System::Main, "Core", "EnableSaveStates"}, false};
+const Info<bool> MAIN_REWIND_ENABLE{{System::Main, "Core", "RewindEnable"}, false};
+// In frames
+const Info<int> MAIN_REWIND_INTERVAL{{System::Main, "Core", "RewindInterval"}, 1};
+// In MiB
+const Info<int> MAIN_REWIND_BUFFER_SIZE{{System::Main, "Core", "RewindBufferSize"}, 256};
+const Info<bool> MAIN_JIT_BLOCK_METADATA_CACHE{{System::Main, "Core", "JITBlockMetadataCache"},
+                                               true};
+// In MiB
+const Info<int> MAIN_WIA_RVZ_CACHE_SIZE{{System::Main, "Core", "WIARVZCacheSize"}, 32};
 
 // Main.Display
 
@@ -88,6 +88,11 @@ extern const Info<u32> MAIN_CUSTOM_RTC_VALUE;
 extern const Info<bool> MAIN_AUTO_DISC_CHANGE;
 extern const Info<bool> MAIN_ALLOW_SD_WRITES;
 extern const Info<bool> MAIN_ENABLE_SAVESTATES;
+extern const Info<bool> MAIN_REWIND_ENABLE;
+extern const Info<int> MAIN_REWIND_INTERVAL;
+extern const Info<int> MAIN_REWIND_BUFFER_SIZE;
+extern const Info<bool> MAIN_JIT_BLOCK_METADATA_CACHE;
+extern const Info<int> MAIN_WIA_RVZ_CACHE_SIZE;
 
 // Main.DSP
 
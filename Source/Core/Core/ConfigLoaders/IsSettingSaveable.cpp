@@ -33,7 +33,7 @@ bool IsSettingSaveable(const Config::Location& config_location)
     }
   }
 
-  static constexpr std::array<const Config::Location*, 25> s_setting_saveable = {
+  static constexpr std::array<const Config::Location*, 30> s_setting_saveable = {
       // Main.Core
 
       &Config::MAIN_DEFAULT_ISO.location,
@@ -48,6 +48,11 @@ bool IsSettingSaveable(const Config::Location& config_location)
       &Config::MAIN_MEM2_SIZE.location,
       &Config::MAIN_GFX_BACKEND.location,
       &Config::MAIN_ENABLE_SAVESTATES.location,
+      &Config::MAIN_REWIND_ENABLE.location,
+      &Config::MAIN_REWIND_INTERVAL.location,
+      &Config::MAIN_REWIND_BUFFER_SIZE.location,
+      &Config::MAIN_JIT_BLOCK_METADATA_CACHE.location,
+      &Config::MAIN_WIA_RVZ_CACHE_SIZE.location,
 
       // Main.Interface
 
@@ -897,6 +897,8 @@ struct SetGameMetadata
 
     config->bWii = dff_file->GetIsWii();
     *region = DiscIO::Region::NTSC_U;
+    if (!dff.game_id.empty())
+      config->SetRunningGameMetadata(dff.game_id, dff.game_id, 0, 0, *region);
     return true;
   }
 
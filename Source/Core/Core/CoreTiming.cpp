@@ -5,6 +5,7 @@
 #include "Core/CoreTiming.h"
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <mutex>
 #include <string>
@@ -14,8 +15,10 @@
 #include <fmt/format.h>
 
 #include "Common/Assert.h"
+#include "Common/BitSet.h"
 #include "Common/ChunkFile.h"
 #include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
 #include "Common/SPSCQueue.h"
 
 #include "Core/ConfigManager.h"
@@ -51,16 +54,224 @@ static bool operator<(const Event& left, const Event& right)
   return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
 }
 
+// Pending events are kept in a hierarchical timing wheel, which makes scheduling and dispatching
+// an event O(1) amortized, independent of the number of pending events.
+//
+// Every level of the wheel has 64 slots, and a slot of level n covers 64^n cycles. An event is
+// stored in the lowest level at which its time shares all higher bits with the current time of the
+// wheel, so level 0 holds the events of the current 64 cycle window, one slot per cycle. Once the
+// lower levels have no more events, the next occupied slot of a higher level is redistributed into
+// the lower levels ("cascaded"). Each level has a bitmap of its occupied slots so that empty slots
+// can be skipped.
+//
+// The current time of the wheel never passes the global timer. Events scheduled before it (from
+// another thread, or with a negative delay) are kept in a separate sorted list, as they always
+// have to be dispatched before any of the events in the wheel.
+class EventQueue
+{
+public:
+  bool Empty() const { return m_size == 0; }
+
+  void Clear(s64 time)
+  {
+    for (int level = 0; level < NUM_LEVELS; level++)
+    {
+      for (u64 occupied = m_occupied[level]; occupied != 0; occupied &= occupied - 1)
+        m_slots[level][Common::LeastSignificantSetBit(occupied)].clear();
+      m_occupied[level] = 0;
+    }
+    m_late.clear();
+    m_time = static_cast<u64>(time);
+    m_size = 0;
+  }
+
+  void Push(const Event& event)
+  {
+    Insert(event);
+    m_size++;
+  }
+
+  // Removes the next event and returns true if it is due at the given time.
+  bool PopDue(s64 time, Event* event)
+  {
+    if (!m_late.empty())
+    {
+      if (m_late.back().time > time)
+        return false;
+
+      *event = m_late.back();
+      m_late.pop_back();
+      m_size--;
+      return true;
+    }
+
+    while (true)
+    {
+      const u64 occupied = m_occupied[0] & (~0ULL << SlotIndex(m_time, 0));
+      if (occupied != 0)
+      {
+        const int slot = Common::LeastSignificantSetBit(occupied);
+        const s64 slot_time = static_cast<s64>((m_time & ~(NUM_SLOTS - 1)) | slot);
+        if (slot_time > time)
+          return false;
+
+        // Level 0 slots are sorted by the order the events were scheduled in.
+        std::vector<Event>& events = m_slots[0][slot];
+        *event = events.front();
+        events.erase(events.begin());
+        if (events.empty())
+          m_occupied[0] &= ~(1ULL << slot);
+
+        m_time = slot_time;
+        m_size--;
+        return true;
+      }
+
+      if (!Cascade(time))
+        return false;
+    }
+  }
+
+  // Returns the time of the earliest pending event. The queue must not be empty.
+  s64 GetNextTime() const
+  {
+    if (!m_late.empty())
+      return m_late.back().time;
+
+    for (int level = 0; level < NUM_LEVELS; level++)
+    {
+      const u64 occupied = m_occupied[level] & SlotsFrom(level);
+      if (occupied == 0)
+        continue;
+
+      const std::vector<Event>& events = m_slots[level][Common::LeastSignificantSetBit(occupied)];
+      return std::min_element(events.begin(), events.end())->time;
+    }
+
+    ASSERT_MSG(POWERPC, false, "GetNextTime called on an empty event queue");
+    return m_time;
+  }
+
+  // Returns all pending events in no particular order.
+  std::vector<Event> GetEvents() const
+  {
+    std::vector<Event> result = m_late;
+    result.reserve(m_size);
+    for (int level = 0; level < NUM_LEVELS; level++)
+    {
+      for (u64 occupied = m_occupied[level]; occupied != 0; occupied &= occupied - 1)
+      {
+        const std::vector<Event>& events = m_slots[level][Common::LeastSignificantSetBit(occupied)];
+        result.insert(result.end(), events.begin(), events.end());
+      }
+    }
+    return result;
+  }
+
+  template <typename Predicate>
+  void RemoveIf(Predicate predicate)
+  {
+    const auto remove = [&](std::vector<Event>& events) {
+      const auto itr = std::remove_if(events.begin(), events.end(), predicate);
+      m_size -= events.end() - itr;
+      events.erase(itr, events.end());
+    };
+
+    remove(m_late);
+    for (int level = 0; level < NUM_LEVELS; level++)
+    {
+      for (u64 occupied = m_occupied[level]; occupied != 0; occupied &= occupied - 1)
+      {
+        const int slot = Common::LeastSignificantSetBit(occupied);
+        remove(m_slots[level][slot]);
+        if (m_slots[level][slot].empty())
+          m_occupied[level] &= ~(1ULL << slot);
+      }
+    }
+  }
+
+private:
+  static constexpr int SLOT_BITS = 6;
+  static constexpr u64 NUM_SLOTS = 1 << SLOT_BITS;
+  static constexpr int NUM_LEVELS = (64 + SLOT_BITS - 1) / SLOT_BITS;
+
+  static int SlotIndex(u64 time, int level)
+  {
+    return static_cast<int>((time >> (level * SLOT_BITS)) & (NUM_SLOTS - 1));
+  }
+
+  // Mask of the slots of a level that can hold events. At level 0 the slot of the current time
+  // is included; higher levels only hold events that are after the current slot.
+  u64 SlotsFrom(int level) const
+  {
+    const int index = SlotIndex(m_time, level);
+    return level == 0 ? ~0ULL << index : ~1ULL << index;
+  }
+
+  void Insert(const Event& event)
+  {
+    if (event.time < static_cast<s64>(m_time))
+    {
+      // Sorted in descending order, so that the earliest event is at the back.
+      m_late.insert(std::upper_bound(m_late.begin(), m_late.end(), event, std::greater<Event>()),
+                    event);
+      return;
+    }
+
+    const u64 time = static_cast<u64>(event.time);
+    const u64 diff = time ^ m_time;
+    const int level = diff < NUM_SLOTS ? 0 : IntLog2(diff) / SLOT_BITS;
+    const int slot = SlotIndex(time, level);
+
+    std::vector<Event>& events = m_slots[level][slot];
+    if (level == 0)
+      events.insert(std::upper_bound(events.begin(), events.end(), event), event);
+    else
+      events.push_back(event);
+    m_occupied[level] |= 1ULL << slot;
+  }
+
+  // Moves the events of the next occupied slot into the lower levels, if that slot starts at or
+  // before the given time. The lower levels must be empty.
+  bool Cascade(s64 time)
+  {
+    for (int level = 1; level < NUM_LEVELS; level++)
+    {
+      const u64 occupied = m_occupied[level] & SlotsFrom(level);
+      if (occupied == 0)
+        continue;
+
+      const int slot = Common::LeastSignificantSetBit(occupied);
+      const int shift = level * SLOT_BITS;
+      const u64 upper_bits = shift + SLOT_BITS < 64 ? m_time & (~0ULL << (shift + SLOT_BITS)) : 0;
+      const u64 slot_start = upper_bits | (static_cast<u64>(slot) << shift);
+      if (static_cast<s64>(slot_start) > time)
+        return false;
+
+      m_time = slot_start;
+      m_occupied[level] &= ~(1ULL << slot);
+      std::vector<Event> events = std::move(m_slots[level][slot]);
+      m_slots[level][slot].clear();
+      for (const Event& event : events)
+        Insert(event);
+      return true;
+    }
+    return false;
+  }
+
+  std::array<std::array<std::vector<Event>, NUM_SLOTS>, NUM_LEVELS> m_slots;
+  std::array<u64, NUM_LEVELS> m_occupied{};
+  std::vector<Event> m_late;
+  u64 m_time = 0;
+  size_t m_size = 0;
+};
+
 // unordered_map stores each element separately as a linked list node so pointers to elements
 // remain stable regardless of rehashes/resizing.
 static std::unordered_map<std::string, EventType> s_event_types;
 
 // STATE_TO_SAVE
-// The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-// We don't use std::priority_queue because we need to be able to serialize, unserialize and
-// erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't accomodated
-// by the standard adaptor class.
-static std::vector<Event> s_event_queue;
+static EventQueue s_event_queue;
 static u64 s_event_fifo_id;
 static std::mutex s_ts_write_lock;
 static Common::SPSCQueue<Event, false> s_ts_queue;
@@ -117,7 +328,7 @@ EventType* RegisterEvent(const std::string& name, TimedCallback callback)
 
 void UnregisterAllEvents()
 {
-  ASSERT_MSG(POWERPC, s_event_queue.empty(), "Cannot unregister events with events pending");
+  ASSERT_MSG(POWERPC, s_event_queue.Empty(), "Cannot unregister events with events pending");
   s_event_types.clear();
 }
 
@@ -136,6 +347,7 @@ void Init()
   // that slice.
   s_is_global_timer_sane = true;
 
+  s_event_queue.Clear(g.global_timer);
   s_event_fifo_id = 0;
   s_ev_lost = RegisterEvent("_lost_event", &EmptyTimedCallback);
 }
@@ -165,7 +377,8 @@ void DoState(PointerWrap& p)
   p.DoMarker("CoreTimingData");
 
   MoveEvents();
-  p.DoEachElement(s_event_queue, [](PointerWrap& pw, Event& ev) {
+  std::vector<Event> events = s_event_queue.GetEvents();
+  p.DoEachElement(events, [](PointerWrap& pw, Event& ev) {
     pw.Do(ev.time);
     pw.Do(ev.fifo_order);
 
@@ -198,11 +411,14 @@ void DoState(PointerWrap& p)
   });
   p.DoMarker("CoreTimingEvents");
 
-  // When loading from a save state, we must assume the Event order is random and meaningless.
-  // The exact layout of the heap in memory is implementation defined, therefore it is platform
-  // and library version specific.
+  // The events are saved in no particular order, the fifo_order of each event is what keeps the
+  // order of events scheduled for the same time.
   if (p.GetMode() == PointerWrap::MODE_READ)
-    std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+  {
+    s_event_queue.Clear(g.global_timer);
+    for (const Event& ev : events)
+      s_event_queue.Push(ev);
+  }
 }
 
 // This should only be called from the CPU thread. If you are calling
@@ -225,7 +441,7 @@ u64 GetIdleTicks()
 
 void ClearPendingEvents()
 {
-  s_event_queue.clear();
+  s_event_queue.Clear(g.global_timer);
 }
 
 void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata, FromThread from)
@@ -253,8 +469,7 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
     if (!s_is_global_timer_sane)
       ForceExceptionCheck(cycles_into_future);
 
-    s_event_queue.emplace_back(Event{timeout, s_event_fifo_id++, userdata, event_type});
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    s_event_queue.Push(Event{timeout, s_event_fifo_id++, userdata, event_type});
   }
   else
   {
@@ -273,15 +488,7 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
 
 void RemoveEvent(EventType* event_type)
 {
-  auto itr = std::remove_if(s_event_queue.begin(), s_event_queue.end(),
-                            [&](const Event& e) { return e.type == event_type; });
-
-  // Removing random items breaks the invariant so we have to re-establish it.
-  if (itr != s_event_queue.end())
-  {
-    s_event_queue.erase(itr, s_event_queue.end());
-    std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-  }
+  s_event_queue.RemoveIf([&](const Event& e) { return e.type == event_type; });
 }
 
 void RemoveAllEvents(EventType* event_type)
@@ -307,8 +514,7 @@ void MoveEvents()
   for (Event ev; s_ts_queue.Pop(ev);)
   {
     ev.fifo_order = s_event_fifo_id++;
-    s_event_queue.emplace_back(std::move(ev));
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    s_event_queue.Push(ev);
   }
 }
 
@@ -324,11 +530,8 @@ void Advance()
 
   s_is_global_timer_sane = true;
 
-  while (!s_event_queue.empty() && s_event_queue.front().time <= g.global_timer)
+  for (Event evt; s_event_queue.PopDue(g.global_timer, &evt);)
   {
-    Event evt = std::move(s_event_queue.front());
-    std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-    s_event_queue.pop_back();
     // NOTICE_LOG(POWERPC, "[Scheduler] %-20s (%lld, %lld)", evt.type->name->c_str(),
     //            g.global_timer, evt.time);
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
@@ -337,10 +540,10 @@ void Advance()
   s_is_global_timer_sane = false;
 
   // Still events left (scheduled in the future)
-  if (!s_event_queue.empty())
+  if (!s_event_queue.Empty())
   {
     g.slice_length = static_cast<int>(
-        std::min<s64>(s_event_queue.front().time - g.global_timer, MAX_SLICE_LENGTH));
+        std::min<s64>(s_event_queue.GetNextTime() - g.global_timer, MAX_SLICE_LENGTH));
   }
 
   PowerPC::ppcState.downcount = CyclesToDowncount(g.slice_length);
@@ -354,7 +557,7 @@ void Advance()
 
 void LogPendingEvents()
 {
-  auto clone = s_event_queue;
+  auto clone = s_event_queue.GetEvents();
   std::sort(clone.begin(), clone.end());
   for (const Event& ev : clone)
   {
@@ -366,10 +569,13 @@ void LogPendingEvents()
 // Should only be called from the CPU thread after the PPC clock has changed
 void AdjustEventQueueTimes(u32 new_ppc_clock, u32 old_ppc_clock)
 {
-  for (Event& ev : s_event_queue)
+  std::vector<Event> events = s_event_queue.GetEvents();
+  s_event_queue.Clear(g.global_timer);
+  for (Event& ev : events)
   {
     const s64 ticks = (ev.time - g.global_timer) * new_ppc_clock / old_ppc_clock;
     ev.time = g.global_timer + ticks;
+    s_event_queue.Push(ev);
   }
 }
 
@@ -392,7 +598,7 @@ std::string GetScheduledEventsSummary()
   std::string text = "Scheduled events\n";
   text.reserve(1000);
 
-  auto clone = s_event_queue;
+  auto clone = s_event_queue.GetEvents();
   std::sort(clone.begin(), clone.end());
   for (const Event& ev : clone)
   {
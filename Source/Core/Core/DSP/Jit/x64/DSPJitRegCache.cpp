@@ -23,6 +23,13 @@ namespace DSP::JIT::x64
 constexpr std::array<X64Reg, 15> s_allocation_order = {
     {R8, R9, R10, R11, R12, R13, R14, R15, RSI, RDI, RBX, RCX, RDX, RAX, RBP}};
 
+// offsetof only accepts constant array indices, so the offset of an element of one of the register
+// arrays is computed from the offset of the first element.
+static Gen::OpArg GetArrayRegisterPointer(size_t first_offset, size_t element_size, size_t index)
+{
+  return MDisp(R15, static_cast<int>(first_offset + index * element_size));
+}
+
 static Gen::OpArg GetRegisterPointer(size_t reg)
 {
   switch (reg)
@@ -31,25 +38,30 @@ static Gen::OpArg GetRegisterPointer(size_t reg)
   case DSP_REG_AR1:
   case DSP_REG_AR2:
   case DSP_REG_AR3:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ar[reg - DSP_REG_AR0])));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.ar[0]), sizeof(DSP_Regs::ar[0]),
+                                   reg - DSP_REG_AR0);
   case DSP_REG_IX0:
   case DSP_REG_IX1:
   case DSP_REG_IX2:
   case DSP_REG_IX3:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ix[reg - DSP_REG_IX0])));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.ix[0]), sizeof(DSP_Regs::ix[0]),
+                                   reg - DSP_REG_IX0);
   case DSP_REG_WR0:
   case DSP_REG_WR1:
   case DSP_REG_WR2:
   case DSP_REG_WR3:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.wr[reg - DSP_REG_WR0])));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.wr[0]), sizeof(DSP_Regs::wr[0]),
+                                   reg - DSP_REG_WR0);
   case DSP_REG_ST0:
   case DSP_REG_ST1:
   case DSP_REG_ST2:
   case DSP_REG_ST3:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.st[reg - DSP_REG_ST0])));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.st[0]), sizeof(DSP_Regs::st[0]),
+                                   reg - DSP_REG_ST0);
   case DSP_REG_ACH0:
   case DSP_REG_ACH1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ac[reg - DSP_REG_ACH0].h)));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.ac[0].h), sizeof(DSP_Regs::ac[0]),
+                                   reg - DSP_REG_ACH0);
   case DSP_REG_CR:
     return MDisp(R15, static_cast<int>(offsetof(SDSP, r.cr)));
   case DSP_REG_SR:
@@ -64,22 +76,28 @@ static Gen::OpArg GetRegisterPointer(size_t reg)
     return MDisp(R15, static_cast<int>(offsetof(SDSP, r.prod.m2)));
   case DSP_REG_AXL0:
   case DSP_REG_AXL1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ax[reg - DSP_REG_AXL0].l)));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.ax[0].l), sizeof(DSP_Regs::ax[0]),
+                                   reg - DSP_REG_AXL0);
   case DSP_REG_AXH0:
   case DSP_REG_AXH1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ax[reg - DSP_REG_AXH0].h)));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.ax[0].h), sizeof(DSP_Regs::ax[0]),
+                                   reg - DSP_REG_AXH0);
   case DSP_REG_ACL0:
   case DSP_REG_ACL1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ac[reg - DSP_REG_ACL0].l)));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.ac[0].l), sizeof(DSP_Regs::ac[0]),
+                                   reg - DSP_REG_ACL0);
   case DSP_REG_ACM0:
   case DSP_REG_ACM1:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ac[reg - DSP_REG_ACM0].m)));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.ac[0].m), sizeof(DSP_Regs::ac[0]),
+                                   reg - DSP_REG_ACM0);
   case DSP_REG_AX0_32:
   case DSP_REG_AX1_32:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ax[reg - DSP_REG_AX0_32].val)));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.ax[0].val), sizeof(DSP_Regs::ax[0]),
+                                   reg - DSP_REG_AX0_32);
   case DSP_REG_ACC0_64:
   case DSP_REG_ACC1_64:
-    return MDisp(R15, static_cast<int>(offsetof(SDSP, r.ac[reg - DSP_REG_ACC0_64].val)));
+    return GetArrayRegisterPointer(offsetof(SDSP, r.ac[0].val), sizeof(DSP_Regs::ac[0]),
+                                   reg - DSP_REG_ACC0_64);
   case DSP_REG_PROD_64:
     return MDisp(R15, static_cast<int>(offsetof(SDSP, r.prod.val)));
   default:
@@ -40,6 +40,8 @@
 #include "DiscIO/Enums.h"
 #include "DiscIO/VolumeDisc.h"
 #include "DiscIO/VolumeWii.h"
+#include "DiscIO/WIABlob.h"
+#include "DiscIO/WiiEncryptionCache.h"
 
 #include "VideoCommon/OnScreenDisplay.h"
 
@@ -433,13 +435,27 @@ void SetDisc(std::unique_ptr<DiscIO::VolumeDisc> disc,
 
   if (has_disc)
   {
-    const DiscIO::BlobReader& blob = disc->GetBlobReader();
+    DiscIO::BlobReader& blob = disc->GetBlobReader();
     if (!blob.HasFastRandomAccessInBlock() && blob.GetBlockSize() > 0x200000)
     {
       OSD::AddMessage("You are running a disc image with a very large block size.", 60000);
       OSD::AddMessage("This will likely lead to performance problems.", 60000);
       OSD::AddMessage("You can use Dolphin's convert feature to reduce the block size.", 60000);
     }
+
+    // WIA and RVZ keep recently decompressed chunks around, since games often reread data.
+    const u64 cache_size =
+        static_cast<u64>(std::max(Config::Get(Config::MAIN_WIA_RVZ_CACHE_SIZE), 0)) << 20;
+    if (blob.GetBlobType() == DiscIO::BlobType::WIA)
+    {
+      static_cast<DiscIO::WIAFileReader&>(blob).SetCacheCapacity(
+          cache_size, DiscIO::WiiEncryptionCache::DEFAULT_CAPACITY);
+    }
+    else if (blob.GetBlobType() == DiscIO::BlobType::RVZ)
+    {
+      static_cast<DiscIO::RVZFileReader&>(blob).SetCacheCapacity(
+          cache_size, DiscIO::WiiEncryptionCache::DEFAULT_CAPACITY);
+    }
   }
 
   if (auto_disc_change_paths)
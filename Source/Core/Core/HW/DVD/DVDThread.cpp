@@ -4,7 +4,12 @@
 
 #include "Core/HW/DVD/DVDThread.h"
 
+#include <algorithm>
+#include <array>
 #include <cinttypes>
+#include <cstring>
+#include <deque>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -63,6 +68,24 @@ struct ReadRequest
 
 using ReadResult = std::pair<ReadRequest, std::vector<u8>>;
 
+// A prediction of the reads that will follow a read, made by the CPU thread. It covers count
+// ranges of length bytes, starting at offset and spaced stride bytes apart.
+struct ReadAheadHint
+{
+  DiscIO::Partition partition;
+  u64 offset;
+  u64 stride;
+  u32 length;
+  u32 count;
+};
+
+// The disc is read ahead in blocks of this size, so that a read which is split over several
+// requests by the emulated software can be served from blocks that were read ahead.
+constexpr u64 READ_AHEAD_BLOCK_SIZE = 0x8000;
+// How far ahead of the emulated software the DVD thread reads, and how much it keeps.
+constexpr u64 READ_AHEAD_SIZE = 0x100000;
+constexpr size_t READ_AHEAD_CACHE_BLOCKS = 0x800000 / READ_AHEAD_BLOCK_SIZE;
+
 static void StartDVDThread();
 static void StopDVDThread();
 
@@ -73,6 +96,13 @@ static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offs
                               const DiscIO::Partition& partition,
                               DVDInterface::ReplyType reply_type, s64 ticks_until_completion);
 
+static void PredictReadAhead(u64 dvd_offset, u32 length, const DiscIO::Partition& partition,
+                             DVDInterface::ReplyType reply_type);
+static bool ReadFromReadAheadCache(u64 dvd_offset, u32 length, u8* buffer,
+                                   const DiscIO::Partition& partition);
+static bool ReadAhead();
+static void ClearReadAhead();
+
 static void FinishRead(u64 id, s64 cycles_late);
 static CoreTiming::EventType* s_finish_read;
 
@@ -89,6 +119,37 @@ static std::map<u64, ReadResult> s_result_map;
 
 static std::unique_ptr<DiscIO::Volume> s_disc;
 
+// Used only by the CPU thread. Streamed audio is tracked separately from other reads, since the
+// two are interleaved.
+struct LastRead
+{
+  DiscIO::Partition partition;
+  u64 offset = 0;
+  u32 length = 0;
+  u64 stride = 0;
+};
+static std::array<LastRead, 2> s_last_reads;
+
+static Common::SPSCQueue<ReadAheadHint, false> s_read_ahead_hint_queue;
+
+// Used only by the DVD thread, which reads ahead whenever it has no requests to handle. Reading
+// ahead decompresses the disc ahead of time for compressed formats, and hides the latency of
+// slow storage.
+struct ReadAheadBlock
+{
+  DiscIO::Partition partition;
+  u64 offset;
+  std::vector<u8> data;
+};
+using ReadAheadBlockList = std::list<ReadAheadBlock>;
+static ReadAheadBlockList s_read_ahead_cache;  // Most recently used first
+static std::map<std::pair<DiscIO::Partition, u64>, ReadAheadBlockList::iterator>
+    s_read_ahead_cache_map;
+static DiscIO::Partition s_read_ahead_partition;
+static std::deque<u64> s_read_ahead_blocks;
+static u64 s_read_ahead_hits = 0;
+static u64 s_read_ahead_misses = 0;
+
 void Start()
 {
   s_finish_read = CoreTiming::RegisterEvent("FinishReadDVDThread", FinishRead);
@@ -97,6 +158,10 @@ void Start()
   s_result_queue_expanded.Reset();
   s_request_queue.Clear();
   s_result_queue.Clear();
+  s_last_reads = {};
+  ClearReadAhead();
+  s_read_ahead_hits = 0;
+  s_read_ahead_misses = 0;
 
   // This is reset on every launch for determinism, but it doesn't matter
   // much, because this will never get exposed to the emulated game.
@@ -116,6 +181,13 @@ void Stop()
 {
   StopDVDThread();
   s_disc.reset();
+
+  if (s_read_ahead_hits != 0)
+  {
+    INFO_LOG(DVDINTERFACE, "%" PRIu64 " of %" PRIu64 " disc reads were served from read-ahead",
+             s_read_ahead_hits, s_read_ahead_hits + s_read_ahead_misses);
+  }
+  ClearReadAhead();
 }
 
 static void StopDVDThread()
@@ -252,6 +324,10 @@ void WaitUntilIdle()
     s_result_queue_expanded.Wait();
 
   StopDVDThread();
+
+  // The caller may change the disc, so the read-ahead state must not outlive the DVD thread.
+  ClearReadAhead();
+
   StartDVDThread();
 }
 
@@ -291,11 +367,165 @@ static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offs
   request.realtime_started_us = Common::Timer::GetTimeUs();
 
   s_request_queue.Push(std::move(request));
+  PredictReadAhead(dvd_offset, length, partition, reply_type);
   s_request_queue_expanded.Set();
 
   CoreTiming::ScheduleEvent(ticks_until_completion, s_finish_read, id);
 }
 
+// Returns how many reads of length bytes, spaced stride bytes apart, can be read ahead without
+// touching more than READ_AHEAD_SIZE bytes worth of blocks.
+static u32 GetStridedReadAheadCount(u64 stride, u32 length)
+{
+  constexpr u64 max_blocks = READ_AHEAD_SIZE / READ_AHEAD_BLOCK_SIZE;
+
+  // A read which doesn't start at the start of a block can touch one block more than its length
+  // needs. Reads which don't share any blocks touch this many blocks each.
+  const u64 blocks_per_read = (length + READ_AHEAD_BLOCK_SIZE - 2) / READ_AHEAD_BLOCK_SIZE + 1;
+  u64 count = max_blocks / blocks_per_read;
+
+  // Reads which are close together share blocks, so it's enough to limit the span from the start
+  // of the first read to the end of the last one.
+  constexpr u64 max_span = (max_blocks - 1) * READ_AHEAD_BLOCK_SIZE;
+  if (length <= max_span)
+    count = std::max(count, (max_span - length) / stride + 1);
+
+  return static_cast<u32>(std::min(count, READ_AHEAD_SIZE / length));
+}
+
+static void PredictReadAhead(u64 dvd_offset, u32 length, const DiscIO::Partition& partition,
+                             DVDInterface::ReplyType reply_type)
+{
+  if (length == 0)
+    return;
+
+  LastRead& last = s_last_reads[reply_type == DVDInterface::ReplyType::DTK];
+  const bool same_partition = last.length != 0 && last.partition == partition;
+  const u64 stride = same_partition && dvd_offset > last.offset ? dvd_offset - last.offset : 0;
+
+  if (same_partition && dvd_offset == last.offset + last.length)
+  {
+    // Sequential reads: Read ahead of the end of this read.
+    s_read_ahead_hint_queue.Push(
+        ReadAheadHint{partition, dvd_offset + length, 0, static_cast<u32>(READ_AHEAD_SIZE), 1});
+  }
+  else if (stride != 0 && stride == last.stride && length == last.length)
+  {
+    // Reads of the same length with a fixed gap between them, like the reads of a file with
+    // interleaved streams: Read ahead where the following reads will be.
+    const u32 count = GetStridedReadAheadCount(stride, length);
+    if (count != 0)
+    {
+      s_read_ahead_hint_queue.Push(ReadAheadHint{partition, dvd_offset + stride, stride, length,
+                                                 count});
+    }
+  }
+
+  last.partition = partition;
+  last.offset = dvd_offset;
+  last.length = length;
+  last.stride = stride;
+}
+
+static void ClearReadAhead()
+{
+  s_read_ahead_hint_queue.Clear();
+  s_read_ahead_blocks.clear();
+  s_read_ahead_cache.clear();
+  s_read_ahead_cache_map.clear();
+}
+
+static ReadAheadBlockList::iterator FindReadAheadBlock(const DiscIO::Partition& partition,
+                                                       u64 block_offset)
+{
+  const auto it = s_read_ahead_cache_map.find({partition, block_offset});
+  return it != s_read_ahead_cache_map.end() ? it->second : s_read_ahead_cache.end();
+}
+
+static bool ReadFromReadAheadCache(u64 dvd_offset, u32 length, u8* buffer,
+                                   const DiscIO::Partition& partition)
+{
+  const u64 first_block = dvd_offset - dvd_offset % READ_AHEAD_BLOCK_SIZE;
+  const u64 end_offset = dvd_offset + length;
+  for (u64 block = first_block; block < end_offset; block += READ_AHEAD_BLOCK_SIZE)
+  {
+    if (FindReadAheadBlock(partition, block) == s_read_ahead_cache.end())
+      return false;
+  }
+
+  for (u64 block = first_block; block < end_offset; block += READ_AHEAD_BLOCK_SIZE)
+  {
+    const auto it = FindReadAheadBlock(partition, block);
+    s_read_ahead_cache.splice(s_read_ahead_cache.begin(), s_read_ahead_cache, it);
+
+    const u64 start = std::max(block, dvd_offset);
+    const u64 end = std::min(block + READ_AHEAD_BLOCK_SIZE, end_offset);
+    std::memcpy(buffer + (start - dvd_offset), it->data.data() + (start - block), end - start);
+  }
+
+  return true;
+}
+
+// Takes the latest hint from the CPU thread, and reads one block of it. Returns false if there
+// is nothing left to read ahead.
+static bool ReadAhead()
+{
+  ReadAheadHint hint;
+  bool has_hint = false;
+  while (s_read_ahead_hint_queue.Pop(hint))
+    has_hint = true;
+
+  if (has_hint)
+  {
+    s_read_ahead_partition = hint.partition;
+    s_read_ahead_blocks.clear();
+    for (u32 i = 0; i < hint.count; i++)
+    {
+      const u64 offset = hint.offset + i * hint.stride;
+      const u64 first_block = offset - offset % READ_AHEAD_BLOCK_SIZE;
+      for (u64 block = first_block; block < offset + hint.length; block += READ_AHEAD_BLOCK_SIZE)
+      {
+        if (s_read_ahead_blocks.empty() || block > s_read_ahead_blocks.back())
+          s_read_ahead_blocks.push_back(block);
+      }
+    }
+  }
+
+  while (!s_read_ahead_blocks.empty())
+  {
+    const u64 block = s_read_ahead_blocks.front();
+    s_read_ahead_blocks.pop_front();
+
+    const auto it = FindReadAheadBlock(s_read_ahead_partition, block);
+    if (it != s_read_ahead_cache.end())
+    {
+      s_read_ahead_cache.splice(s_read_ahead_cache.begin(), s_read_ahead_cache, it);
+      continue;
+    }
+
+    std::vector<u8> data(READ_AHEAD_BLOCK_SIZE);
+    if (!s_disc->Read(block, READ_AHEAD_BLOCK_SIZE, data.data(), s_read_ahead_partition))
+    {
+      // Most likely the end of the disc or partition. Nothing after this can be read either.
+      s_read_ahead_blocks.clear();
+      return false;
+    }
+
+    if (s_read_ahead_cache.size() >= READ_AHEAD_CACHE_BLOCKS)
+    {
+      const ReadAheadBlock& oldest = s_read_ahead_cache.back();
+      s_read_ahead_cache_map.erase({oldest.partition, oldest.offset});
+      s_read_ahead_cache.pop_back();
+    }
+    s_read_ahead_cache.push_front(ReadAheadBlock{s_read_ahead_partition, block, std::move(data)});
+    s_read_ahead_cache_map.emplace(std::make_pair(s_read_ahead_partition, block),
+                                   s_read_ahead_cache.begin());
+    return true;
+  }
+
+  return false;
+}
+
 static void FinishRead(u64 id, s64 cycles_late)
 {
   // We can't simply pop s_result_queue and always get the ReadResult
@@ -374,14 +604,33 @@ static void DVDThread()
     if (s_dvd_thread_exiting.IsSet())
       return;
 
-    ReadRequest request;
-    while (s_request_queue.Pop(request))
+    while (true)
     {
+      ReadRequest request;
+      if (!s_request_queue.Pop(request))
+      {
+        // Read ahead until a request comes in. A request only has to wait for one block.
+        if (s_dvd_thread_exiting.IsSet())
+          return;
+        if (ReadAhead())
+          continue;
+        break;
+      }
+
       FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
 
       std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
+      if (ReadFromReadAheadCache(request.dvd_offset, request.length, buffer.data(),
+                                 request.partition))
+      {
+        s_read_ahead_hits++;
+      }
+      else
+      {
+        s_read_ahead_misses++;
+        if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
+          buffer.resize(0);
+      }
 
       request.realtime_done_us = Common::Timer::GetTimeUs();
 
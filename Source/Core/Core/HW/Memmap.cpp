@@ -389,16 +389,17 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
   }
 }
 
-void DoState(PointerWrap& p)
+void DoState(PointerWrap& p, bool include_ram)
 {
   bool wii = SConfig::GetInstance().bWii;
-  p.DoArray(m_pRAM, GetRamSize());
+  if (include_ram)
+    p.DoArray(m_pRAM, GetRamSize());
   p.DoArray(m_pL1Cache, GetL1CacheSize());
   p.DoMarker("Memory RAM");
-  if (m_pFakeVMEM)
+  if (m_pFakeVMEM && include_ram)
     p.DoArray(m_pFakeVMEM, GetFakeVMemSize());
   p.DoMarker("Memory FakeVMEM");
-  if (wii)
+  if (wii && include_ram)
     p.DoArray(m_pEXRAM, GetExRamSize());
   p.DoMarker("Memory EXRAM");
 }
@@ -65,7 +65,8 @@ void Init();
 void Shutdown();
 bool InitFastmemArena();
 void ShutdownFastmemArena();
-void DoState(PointerWrap& p);
+// Without include_ram, MEM1, MEM2 and the fake VMEM are left to the caller.
+void DoState(PointerWrap& p, bool include_ram = true);
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
@@ -46,6 +46,7 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 #include "Core/HW/SystemTimers.h"
 
 #include <cfloat>
+#include <chrono>
 #include <cinttypes>
 #include <cmath>
 #include <cstdlib>
@@ -65,6 +66,7 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 #include "Core/HW/VideoInterface.h"
 #include "Core/IOS/IOS.h"
 #include "Core/PatchEngine.h"
+#include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "VideoCommon/Fifo.h"
 
@@ -199,7 +201,12 @@ void ThrottleCallback(u64 last_time, s64 cyclesLate)
     }
     else if (diff > 1000)
     {
-      Common::SleepCurrentThread(diff / 1000);
+      // Spend the time the emulation is ahead on compiling blocks that previous runs of the game
+      // needed, and sleep for whatever is left of it.
+      JitInterface::PrecompileCachedBlocks(std::chrono::microseconds(diff));
+      const s64 remaining = last_time - Common::Timer::GetTimeUs();
+      if (remaining > 1000)
+        Common::SleepCurrentThread(remaining / 1000);
       s_time_spent_sleeping += Common::Timer::GetTimeUs() - time;
     }
   }
@@ -24,7 +24,7 @@
 #include "InputCommon/GCPadStatus.h"
 
 // clang-format off
-constexpr std::array<const char*, 142> s_hotkey_labels{{
+constexpr std::array<const char*, 143> s_hotkey_labels{{
     _trans("Open"),
     _trans("Change Disc"),
     _trans("Eject Disc"),
@@ -189,6 +189,7 @@ constexpr std::array<const char*, 142> s_hotkey_labels{{
     _trans("Save Oldest State"),
     _trans("Undo Load State"),
     _trans("Undo Save State"),
+    _trans("Rewind"),
     _trans("Save State"),
     _trans("Load State"),
 
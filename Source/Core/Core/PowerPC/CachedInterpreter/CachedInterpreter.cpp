@@ -4,6 +4,9 @@
 
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 
+#include <algorithm>
+#include <array>
+
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
@@ -11,6 +14,7 @@
 #include "Core/HLE/HLE.h"
 #include "Core/HW/CPU.h"
 #include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
 #include "Core/PowerPC/Jit64Common/Jit64Constants.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -19,6 +23,7 @@ struct CachedInterpreter::Instruction
 {
   using CommonCallback = void (*)(UGeckoInstruction);
   using ConditionalCallback = bool (*)(u32);
+  using FusedCallback = void (*)(UGeckoInstruction, UGeckoInstruction);
 
   Instruction() {}
   Instruction(const CommonCallback c, UGeckoInstruction i)
@@ -31,17 +36,36 @@ struct CachedInterpreter::Instruction
   {
   }
 
+  // A fused instruction is followed by an Operand holding the second instruction of the pair.
+  Instruction(const FusedCallback c, UGeckoInstruction i)
+      : fused_callback(c), data(i.hex), type(Type::Fused)
+  {
+  }
+
+  explicit Instruction(UGeckoInstruction i) : data(i.hex), type(Type::Operand) {}
+
+  Instruction(const u8* target, u32 exit_address)
+      : link_target(target), data(exit_address), type(Type::Link)
+  {
+  }
+
   enum class Type
   {
     Abort,
     Common,
     Conditional,
+    Fused,
+    Operand,
+    Link,
   };
 
   union
   {
     const CommonCallback common_callback;
     const ConditionalCallback conditional_callback;
+    const FusedCallback fused_callback;
+    // Entry of the block this exit is linked to, written by BlockCache::WriteLinkBlock.
+    const u8* link_target;
   };
 
   u32 data = 0;
@@ -56,7 +80,10 @@ void CachedInterpreter::Init()
 {
   m_code.reserve(CODE_SIZE / sizeof(Instruction));
 
-  jo.enableBlocklink = false;
+  jo.enableBlocklink = !SConfig::GetInstance().bJITNoBlockLinking;
+
+  // Moves compares next to the branches using them, so that they can be fused.
+  analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_MERGE);
 
   m_block_cache.Init();
   UpdateMemoryOptions();
@@ -85,9 +112,10 @@ void CachedInterpreter::ExecuteOneBlock()
     return;
   }
 
+  const CPU::State* state_ptr = CPU::GetStatePtr();
   const Instruction* code = reinterpret_cast<const Instruction*>(normal_entry);
 
-  for (; code->type != Instruction::Type::Abort; ++code)
+  while (code->type != Instruction::Type::Abort)
   {
     switch (code->type)
     {
@@ -100,10 +128,29 @@ void CachedInterpreter::ExecuteOneBlock()
         return;
       break;
 
+    case Instruction::Type::Fused:
+      code->fused_callback(UGeckoInstruction(code->data), UGeckoInstruction(code[1].data));
+      ++code;
+      break;
+
+    case Instruction::Type::Link:
+      // Go straight to the next block if it is the one this block exited to, as long as the run
+      // loop would have dispatched another block. Only branches get linked exits, and those can't
+      // change the MSR, so the linked block is the one the dispatcher would have found.
+      if (code->link_target && PC == code->data && PowerPC::ppcState.downcount > 0 &&
+          *state_ptr == CPU::State::Running)
+      {
+        code = reinterpret_cast<const Instruction*>(code->link_target);
+        continue;
+      }
+      break;
+
     default:
       ERROR_LOG(POWERPC, "Unknown CachedInterpreter Instruction: %d", static_cast<int>(code->type));
       break;
     }
+
+    ++code;
   }
 }
 
@@ -190,6 +237,93 @@ static bool CheckIdle(u32 idle_pc)
   return false;
 }
 
+template <Interpreter::Instruction first, Interpreter::Instruction second>
+static void FusedPair(UGeckoInstruction inst1, UGeckoInstruction inst2)
+{
+  first(inst1);
+  second(inst2);
+}
+
+struct FusedPairInfo
+{
+  Interpreter::Instruction first;
+  Interpreter::Instruction second;
+  void (*callback)(UGeckoInstruction, UGeckoInstruction);
+};
+
+using FusedCallback = decltype(FusedPairInfo::callback);
+
+template <Interpreter::Instruction first, Interpreter::Instruction second>
+constexpr FusedPairInfo MakeFusedPair()
+{
+  return {first, second, FusedPair<first, second>};
+}
+
+// Common instruction sequences that get executed by a single handler.
+static constexpr std::array<FusedPairInfo, 13> s_fused_pairs{{
+    // Compares followed by the branches using them.
+    MakeFusedPair<Interpreter::cmp, Interpreter::bcx>(),
+    MakeFusedPair<Interpreter::cmpi, Interpreter::bcx>(),
+    MakeFusedPair<Interpreter::cmpl, Interpreter::bcx>(),
+    MakeFusedPair<Interpreter::cmpli, Interpreter::bcx>(),
+    MakeFusedPair<Interpreter::cmp, Interpreter::bclrx>(),
+    MakeFusedPair<Interpreter::cmpi, Interpreter::bclrx>(),
+    MakeFusedPair<Interpreter::cmpl, Interpreter::bclrx>(),
+    MakeFusedPair<Interpreter::cmpli, Interpreter::bclrx>(),
+    // Loads and stores with update, as found in copy loops.
+    MakeFusedPair<Interpreter::lwzu, Interpreter::stwu>(),
+    MakeFusedPair<Interpreter::lhzu, Interpreter::sthu>(),
+    MakeFusedPair<Interpreter::lbzu, Interpreter::stbu>(),
+    MakeFusedPair<Interpreter::lwzu, Interpreter::lwzu>(),
+    MakeFusedPair<Interpreter::stwu, Interpreter::stwu>(),
+}};
+
+static FusedCallback GetFusedCallback(const PPCAnalyst::CodeOp& first,
+                                      const PPCAnalyst::CodeOp& second)
+{
+  const Interpreter::Instruction first_op = PPCTables::GetInterpreterOp(first.inst);
+  const Interpreter::Instruction second_op = PPCTables::GetInterpreterOp(second.inst);
+  const auto it = std::find_if(s_fused_pairs.begin(), s_fused_pairs.end(), [&](const auto& pair) {
+    return pair.first == first_op && pair.second == second_op;
+  });
+  return it != s_fused_pairs.end() ? it->callback : nullptr;
+}
+
+// Returns the addresses a block ending with the given instruction can statically exit to.
+static void AddBranchExits(const PPCAnalyst::CodeOp& op, std::vector<u32>* exits)
+{
+  const UGeckoInstruction inst = op.inst;
+  const bool is_bx = inst.OPCD == 18;
+  const bool is_bcx = inst.OPCD == 16;
+  const bool is_bclrx_or_bcctrx = inst.OPCD == 19 && (inst.SUBOP10 == 16 || inst.SUBOP10 == 528);
+
+  // Conditional branches may fall through to the next instruction.
+  const bool unconditional =
+      (inst.BO & BO_DONT_DECREMENT_FLAG) && (inst.BO & BO_DONT_CHECK_CONDITION);
+
+  if ((is_bx || is_bcx) && op.branchTo != UINT32_MAX)
+    exits->push_back(op.branchTo);
+  if ((is_bcx || is_bclrx_or_bcctrx) && !unconditional)
+    exits->push_back(op.address + 4);
+}
+
+bool CachedInterpreter::IsBreakpoint(u32 address) const
+{
+  return SConfig::GetInstance().bEnableDebugging &&
+         PowerPC::breakpoints.IsAddressBreakPoint(address);
+}
+
+// Whether an instruction can be executed as the second half of a fused pair, which skips all of
+// the checks that would otherwise be emitted before it.
+bool CachedInterpreter::CanBeFused(const PPCAnalyst::CodeOp& op) const
+{
+  if (op.skip || IsBreakpoint(op.address) || (op.opinfo->flags & FL_USE_FPU))
+    return false;
+  if ((op.opinfo->flags & FL_LOADSTORE) && jo.memcheck)
+    return false;
+  return HLE::GetHookByFunctionAddress(op.address) == 0;
+}
+
 bool CachedInterpreter::HandleFunctionHooking(u32 address)
 {
   return HLE::ReplaceFunctionIfPossible(address, [&](u32 hook_index, HLE::HookType type) {
@@ -235,6 +369,8 @@ void CachedInterpreter::Jit(u32 address)
   b->checkedEntry = GetCodePtr();
   b->normalEntry = GetCodePtr();
 
+  std::vector<u32> exits;
+
   for (u32 i = 0; i < code_block.m_num_instructions; i++)
   {
     PPCAnalyst::CodeOp& op = m_code_buffer[i];
@@ -246,8 +382,7 @@ void CachedInterpreter::Jit(u32 address)
 
     if (!op.skip)
     {
-      const bool breakpoint = SConfig::GetInstance().bEnableDebugging &&
-                              PowerPC::breakpoints.IsAddressBreakPoint(op.address);
+      const bool breakpoint = IsBreakpoint(op.address);
       const bool check_fpu = (op.opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound;
       const bool endblock = (op.opinfo->flags & FL_ENDBLOCK) != 0;
       const bool memcheck = (op.opinfo->flags & FL_LOADSTORE) && jo.memcheck;
@@ -266,6 +401,33 @@ void CachedInterpreter::Jit(u32 address)
         js.firstFPInstructionFound = true;
       }
 
+      if (!breakpoint && !check_fpu && !endblock && !memcheck && !idle_loop &&
+          i + 1 < code_block.m_num_instructions && CanBeFused(m_code_buffer[i + 1]))
+      {
+        const PPCAnalyst::CodeOp& next = m_code_buffer[i + 1];
+        const FusedCallback fused_callback = GetFusedCallback(op, next);
+        if (fused_callback)
+        {
+          js.downcountAmount += next.opinfo->numCycles;
+
+          const bool next_endblock = (next.opinfo->flags & FL_ENDBLOCK) != 0;
+          if (next_endblock)
+            m_code.emplace_back(WritePC, next.address);
+          m_code.emplace_back(fused_callback, op.inst);
+          m_code.emplace_back(next.inst);
+          if (next.branchIsIdleLoop)
+            m_code.emplace_back(CheckIdle, js.blockStart);
+          if (next_endblock)
+          {
+            m_code.emplace_back(EndBlock, js.downcountAmount);
+            AddBranchExits(next, &exits);
+          }
+
+          i++;
+          continue;
+        }
+      }
+
       if (endblock || memcheck)
         m_code.emplace_back(WritePC, op.address);
       m_code.emplace_back(PPCTables::GetInterpreterOp(op.inst), op.inst);
@@ -274,13 +436,33 @@ void CachedInterpreter::Jit(u32 address)
       if (idle_loop)
         m_code.emplace_back(CheckIdle, js.blockStart);
       if (endblock)
+      {
         m_code.emplace_back(EndBlock, js.downcountAmount);
+        AddBranchExits(op, &exits);
+      }
     }
   }
   if (code_block.m_broken)
   {
     m_code.emplace_back(WriteBrokenBlockNPC, nextPC);
     m_code.emplace_back(EndBlock, js.downcountAmount);
+    exits.push_back(nextPC);
+  }
+
+  // The exits are tried in order once the block has ended, and get linked to their destination
+  // blocks by the block cache.
+  std::sort(exits.begin(), exits.end());
+  exits.erase(std::unique(exits.begin(), exits.end()), exits.end());
+  for (const u32 exit_address : exits)
+  {
+    m_code.emplace_back(static_cast<const u8*>(nullptr), exit_address);
+
+    JitBlock::LinkData link_data;
+    link_data.exitPtrs = reinterpret_cast<u8*>(&m_code.back().link_target);
+    link_data.exitAddress = exit_address;
+    link_data.linkStatus = false;
+    link_data.call = false;
+    b->linkData.push_back(link_data);
   }
   m_code.emplace_back();
 
@@ -292,7 +474,8 @@ void CachedInterpreter::Jit(u32 address)
 
 void CachedInterpreter::ClearCache()
 {
-  m_code.clear();
+  // Clearing the block cache unlinks the blocks, which writes to their code.
   m_block_cache.Clear();
+  m_code.clear();
   UpdateMemoryOptions();
 }
@@ -38,6 +38,8 @@ private:
   u8* GetCodePtr();
   void ExecuteOneBlock();
 
+  bool IsBreakpoint(u32 address) const;
+  bool CanBeFused(const PPCAnalyst::CodeOp& op) const;
   bool HandleFunctionHooking(u32 address);
 
   BlockCache m_block_cache{*this};
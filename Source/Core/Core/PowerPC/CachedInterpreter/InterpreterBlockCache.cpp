@@ -4,6 +4,8 @@
 
 #include "Core/PowerPC/CachedInterpreter/InterpreterBlockCache.h"
 
+#include <cstring>
+
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 BlockCache::BlockCache(JitBase& jit) : JitBaseBlockCache{jit}
@@ -12,4 +14,8 @@ BlockCache::BlockCache(JitBase& jit) : JitBaseBlockCache{jit}
 
 void BlockCache::WriteLinkBlock(const JitBlock::LinkData& source, const JitBlock* dest)
 {
+  // exitPtrs points to the target of a link instruction, which is followed once the block exits
+  // to the address of the link. Unlinked exits go through the dispatcher.
+  const u8* const target = dest ? dest->normalEntry : nullptr;
+  std::memcpy(source.exitPtrs, &target, sizeof(target));
 }
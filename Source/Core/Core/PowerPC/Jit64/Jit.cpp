@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/Jit64/Jit.h"
 
+#include <chrono>
 #include <map>
 #include <sstream>
 #include <string>
@@ -25,6 +26,8 @@
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Common/x64ABI.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HLE/HLE.h"
@@ -378,6 +381,10 @@ void Jit64::Init()
   EnableOptimization();
 
   ResetFreeMemoryRanges();
+
+  const std::string& game_id = SConfig::GetInstance().GetGameID();
+  if (Config::Get(Config::MAIN_JIT_BLOCK_METADATA_CACHE) && !game_id.empty())
+    m_block_metadata_cache.Open(File::GetUserPath(D_CACHE_IDX) + "Jit64-" + game_id + ".cache");
 }
 
 void Jit64::ClearCache()
@@ -412,6 +419,8 @@ void Jit64::Shutdown()
   blocks.Shutdown();
   m_far_code.Shutdown();
   m_const_pool.Shutdown();
+
+  m_block_metadata_cache.Close();
 }
 
 void Jit64::FallBackToInterpreter(UGeckoInstruction inst)
@@ -809,35 +818,8 @@ void Jit64::Jit(u32 em_address, bool clear_cache_and_retry_on_failure)
     return;
   }
 
-  if (SetEmitterStateToFreeCodeRegion())
-  {
-    u8* near_start = GetWritableCodePtr();
-    u8* far_start = m_far_code.GetWritableCodePtr();
-
-    JitBlock* b = blocks.AllocateBlock(em_address);
-    if (DoJit(em_address, b, nextPC))
-    {
-      // Code generation succeeded.
-
-      // Mark the memory regions that this code block uses as used in the local rangesets.
-      u8* near_end = GetWritableCodePtr();
-      if (near_start != near_end)
-        m_free_ranges_near.erase(near_start, near_end);
-      u8* far_end = m_far_code.GetWritableCodePtr();
-      if (far_start != far_end)
-        m_free_ranges_far.erase(far_start, far_end);
-
-      // Store the used memory regions in the block so we know what to mark as unused when the
-      // block gets invalidated.
-      b->near_begin = near_start;
-      b->near_end = near_end;
-      b->far_begin = far_start;
-      b->far_end = far_end;
-
-      blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
-      return;
-    }
-  }
+  if (CompileBlock(em_address, nextPC))
+    return;
 
   if (clear_cache_and_retry_on_failure)
   {
@@ -877,6 +859,130 @@ bool Jit64::SetEmitterStateToFreeCodeRegion()
   return true;
 }
 
+bool Jit64::CompileBlock(u32 em_address, u32 nextPC)
+{
+  if (!SetEmitterStateToFreeCodeRegion())
+    return false;
+
+  u8* near_start = GetWritableCodePtr();
+  u8* far_start = m_far_code.GetWritableCodePtr();
+
+  JitBlock* b = blocks.AllocateBlock(em_address);
+  if (!DoJit(em_address, b, nextPC))
+  {
+    blocks.DiscardBlock(*b);
+    return false;
+  }
+
+  // Code generation succeeded.
+
+  // Mark the memory regions that this code block uses as used in the local rangesets.
+  u8* near_end = GetWritableCodePtr();
+  if (near_start != near_end)
+    m_free_ranges_near.erase(near_start, near_end);
+  u8* far_end = m_far_code.GetWritableCodePtr();
+  if (far_start != far_end)
+    m_free_ranges_far.erase(far_start, far_end);
+
+  // Store the used memory regions in the block so we know what to mark as unused when the
+  // block gets invalidated.
+  b->near_begin = near_start;
+  b->near_end = near_end;
+  b->far_begin = far_start;
+  b->far_end = far_end;
+
+  blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+  RecordBlockMetadata(*b);
+  return true;
+}
+
+void Jit64::RecordBlockMetadata(const JitBlock& b)
+{
+  if (!m_block_metadata_cache.IsOpen())
+    return;
+
+  JitBlockMetadataCache::Block block;
+  block.effective_address = b.effectiveAddress;
+  block.msr_bits = b.msrBits;
+  if (js.pairedQuantizeAddresses.count(b.effectiveAddress))
+    block.flags |= JitBlockMetadataCache::FLAG_NO_PAIRED_QUANTIZE_ASSUMPTION;
+  if (js.noSpeculativeConstantsAddresses.count(b.effectiveAddress))
+    block.flags |= JitBlockMetadataCache::FLAG_NO_SPECULATIVE_CONSTANTS;
+
+  block.instruction_addresses.reserve(code_block.m_num_instructions);
+  for (u32 i = 0; i < code_block.m_num_instructions; i++)
+  {
+    const u32 address = m_code_buffer[i].address;
+    block.instruction_addresses.push_back(address);
+    if (js.fifoWriteAddresses.count(address))
+      block.fifo_write_addresses.push_back(address);
+  }
+
+  m_block_metadata_cache.RecordBlock(block);
+}
+
+void Jit64::PrecompileCachedBlocks(std::chrono::microseconds time_budget)
+{
+  // Leave enough code space for the blocks the game actually runs.
+  constexpr size_t MIN_FREE_CODE_SPACE = 1024 * 1024;
+
+  if (!m_block_metadata_cache.IsOpen() || SConfig::GetInstance().bEnableDebugging)
+    return;
+
+  const u32 msr_bits = MSR.Hex & JitBaseBlockCache::JIT_CACHE_MSR_MASK;
+  const auto deadline = std::chrono::steady_clock::now() + time_budget;
+  JitBlockMetadataCache::Block block;
+  while (std::chrono::steady_clock::now() < deadline)
+  {
+    auto free_near = m_free_ranges_near.by_size_begin();
+    auto free_far = m_free_ranges_far.by_size_begin();
+    if (free_near == m_free_ranges_near.by_size_end() ||
+        free_far == m_free_ranges_far.by_size_end() ||
+        static_cast<size_t>(free_near.to() - free_near.from()) < MIN_FREE_CODE_SPACE ||
+        static_cast<size_t>(free_far.to() - free_far.from()) < MIN_FREE_CODE_SPACE)
+    {
+      return;
+    }
+
+    if (!m_block_metadata_cache.GetNextPrecompileCandidate(msr_bits, &block))
+      return;
+
+    if (blocks.GetBlockFromStartAddress(block.effective_address, MSR.Hex))
+      continue;
+
+    // Restore what the exception checks of the previous runs found out about this block, so that
+    // it doesn't have to fail them again.
+    js.fifoWriteAddresses.insert(block.fifo_write_addresses.begin(),
+                                 block.fifo_write_addresses.end());
+    if (block.flags & JitBlockMetadataCache::FLAG_NO_PAIRED_QUANTIZE_ASSUMPTION)
+      js.pairedQuantizeAddresses.insert(block.effective_address);
+    if (block.flags & JitBlockMetadataCache::FLAG_NO_SPECULATIVE_CONSTANTS)
+      js.noSpeculativeConstantsAddresses.insert(block.effective_address);
+
+    const u32 nextPC = analyzer.Analyze(block.effective_address, &code_block, &m_code_buffer,
+                                        m_code_buffer.size());
+    if (code_block.m_memory_exception)
+      continue;
+
+    // The GQR and gather pipe speculation is based on the register values the block is entered
+    // with, which we don't know yet. Leave those blocks for when they actually get executed.
+    if (!block.fifo_write_addresses.empty() ||
+        (ComputeStaticGQRs(code_block) &&
+         !js.pairedQuantizeAddresses.count(block.effective_address)))
+    {
+      continue;
+    }
+
+    // Blocks compiled earlier, including the one for the current miss, stay valid if this runs out
+    // of code space. Leave the flushing to the next block that actually has to be compiled.
+    m_precompiling = true;
+    const bool success = CompileBlock(block.effective_address, nextPC);
+    m_precompiling = false;
+    if (!success)
+      return;
+  }
+}
+
 bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
 {
   js.firstFPInstructionFound = false;
@@ -959,8 +1065,8 @@ bool Jit64::DoJit(u32 em_address, JitBlock* b, u32 nextPC)
     }
   }
 
-  if (js.noSpeculativeConstantsAddresses.find(js.blockStart) ==
-      js.noSpeculativeConstantsAddresses.end())
+  if (!m_precompiling && js.noSpeculativeConstantsAddresses.find(js.blockStart) ==
+                             js.noSpeculativeConstantsAddresses.end())
   {
     IntializeSpeculativeConstants();
   }
@@ -31,6 +31,7 @@
 #include "Core/PowerPC/Jit64Common/Jit64AsmCommon.h"
 #include "Core/PowerPC/Jit64Common/TrampolineCache.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitBlockMetadataCache.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
 
 namespace PPCAnalyst
@@ -52,6 +53,9 @@ public:
   bool HandleStackFault() override;
   bool BackPatch(u32 emAddress, SContext* ctx);
 
+  // Compiles some of the blocks the game has used in previous runs before they get executed.
+  void PrecompileCachedBlocks(std::chrono::microseconds time_budget) override;
+
   void EnableOptimization();
   void EnableBlockLink();
 
@@ -65,6 +69,10 @@ public:
   // Returns false if no free memory region can be found for either of the two.
   bool SetEmitterStateToFreeCodeRegion();
 
+  // Compiles the block that has just been analyzed into code_block and adds it to the block
+  // cache. Returns false if there wasn't enough free code space.
+  bool CompileBlock(u32 em_address, u32 nextPC);
+
   BitSet32 CallerSavedRegistersInUse() const;
   BitSet8 ComputeStaticGQRs(const PPCAnalyst::CodeBlock&) const;
 
@@ -252,6 +260,8 @@ private:
 
   void ResetFreeMemoryRanges();
 
+  void RecordBlockMetadata(const JitBlock& b);
+
   JitBlockCache blocks{*this};
   TrampolineCache trampolines{*this};
 
@@ -266,6 +276,9 @@ private:
 
   HyoutaUtilities::RangeSizeSet<u8*> m_free_ranges_near;
   HyoutaUtilities::RangeSizeSet<u8*> m_free_ranges_far;
+
+  JitBlockMetadataCache m_block_metadata_cache;
+  bool m_precompiling = false;
 };
 
 void LogGeneratedX86(size_t size, const PPCAnalyst::CodeBuffer& code_buffer, const u8* normalEntry,
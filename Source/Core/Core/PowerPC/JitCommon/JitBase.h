@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <map>
 #include <unordered_set>
@@ -116,6 +117,9 @@ public:
   virtual bool HandleFault(uintptr_t access_address, SContext* ctx) = 0;
   virtual bool HandleStackFault() { return false; }
 
+  // Compiles blocks which are expected to be executed later, for about the given time.
+  virtual void PrecompileCachedBlocks(std::chrono::microseconds time_budget) {}
+
   static constexpr std::size_t code_buffer_size = 32000;
 
   // This should probably be removed from public:
@@ -0,0 +1,166 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/PowerPC/JitCommon/JitBlockMetadataCache.h"
+
+#include <tuple>
+
+#include <xxhash.h>
+
+#include "Common/Logging/Log.h"
+#include "Common/Swap.h"
+#include "Core/PowerPC/MMU.h"
+
+// Each entry stores, as an array of u32:
+// flags, number of instructions, the instruction addresses, the FIFO write addresses.
+
+bool JitBlockMetadataCache::Key::operator<(const Key& other) const
+{
+  return std::tie(effective_address, msr_bits, code_hash) <
+         std::tie(other.effective_address, other.msr_bits, other.code_hash);
+}
+
+class JitBlockMetadataCache::Reader final : public LinearDiskCacheReader<Key, u32>
+{
+public:
+  Reader(std::map<Key, std::vector<u32>>* blocks, std::vector<Key>* queue)
+      : m_blocks(blocks), m_queue(queue)
+  {
+  }
+
+  void Read(const Key& key, const u32* value, u32 value_size) override
+  {
+    // A block which changed its metadata is appended again, and the last entry wins.
+    const auto result =
+        m_blocks->insert_or_assign(key, std::vector<u32>(value, value + value_size));
+    if (result.second)
+      m_queue->push_back(key);
+  }
+
+private:
+  std::map<Key, std::vector<u32>>* m_blocks;
+  std::vector<Key>* m_queue;
+};
+
+JitBlockMetadataCache::JitBlockMetadataCache() = default;
+
+JitBlockMetadataCache::~JitBlockMetadataCache()
+{
+  Close();
+}
+
+void JitBlockMetadataCache::Open(const std::string& filename)
+{
+  Close();
+
+  Reader reader(&m_blocks, &m_precompile_queue);
+  const u32 entries = m_disk_cache.OpenAndRead(filename, reader);
+  INFO_LOG(DYNA_REC, "Loaded %u JIT block metadata entries (%zu blocks) from %s", entries,
+           m_blocks.size(), filename.c_str());
+
+  m_precompile_position = 0;
+  m_is_open = true;
+}
+
+void JitBlockMetadataCache::Close()
+{
+  if (!m_is_open)
+    return;
+
+  m_disk_cache.Sync();
+  m_disk_cache.Close();
+  m_blocks.clear();
+  m_precompile_queue.clear();
+  m_precompile_position = 0;
+  m_is_open = false;
+}
+
+void JitBlockMetadataCache::RecordBlock(const Block& block)
+{
+  if (!m_is_open || block.instruction_addresses.empty())
+    return;
+
+  Key key{block.effective_address, block.msr_bits, 0};
+  if (!HashInstructions(block, &key.code_hash))
+    return;
+
+  std::vector<u32> value = Serialize(block);
+
+  const auto it = m_blocks.find(key);
+  if (it != m_blocks.end() && it->second == value)
+    return;
+
+  m_disk_cache.Append(key, value.data(), static_cast<u32>(value.size()));
+  m_blocks.insert_or_assign(key, std::move(value));
+}
+
+bool JitBlockMetadataCache::GetNextPrecompileCandidate(u32 msr_bits, Block* block)
+{
+  while (m_precompile_position < m_precompile_queue.size())
+  {
+    const Key& key = m_precompile_queue[m_precompile_position++];
+    if (key.msr_bits != msr_bits)
+      continue;
+
+    const std::vector<u32>& value = m_blocks[key];
+    if (!Deserialize(key, value.data(), static_cast<u32>(value.size()), block))
+      continue;
+
+    u64 code_hash;
+    if (HashInstructions(*block, &code_hash) && code_hash == key.code_hash)
+      return true;
+  }
+
+  return false;
+}
+
+bool JitBlockMetadataCache::HashInstructions(const Block& block, u64* hash)
+{
+  std::vector<u32> instructions;
+  instructions.reserve(block.instruction_addresses.size());
+  for (u32 address : block.instruction_addresses)
+  {
+    if (!PowerPC::HostIsInstructionRAMAddress(address))
+      return false;
+    instructions.push_back(Common::swap32(PowerPC::HostRead_Instruction(address)));
+  }
+
+  // The cache files can be shared between hosts, so this hashes the instructions as they are stored
+  // in guest memory, with a hash that doesn't depend on the host CPU.
+  *hash = XXH64(instructions.data(), instructions.size() * sizeof(u32), 0);
+  return true;
+}
+
+std::vector<u32> JitBlockMetadataCache::Serialize(const Block& block)
+{
+  std::vector<u32> value;
+  value.reserve(2 + block.instruction_addresses.size() + block.fifo_write_addresses.size());
+  value.push_back(block.flags);
+  value.push_back(static_cast<u32>(block.instruction_addresses.size()));
+  value.insert(value.end(), block.instruction_addresses.begin(),
+               block.instruction_addresses.end());
+  value.insert(value.end(), block.fifo_write_addresses.begin(), block.fifo_write_addresses.end());
+  return value;
+}
+
+bool JitBlockMetadataCache::Deserialize(const Key& key, const u32* value, u32 value_size,
+                                        Block* block)
+{
+  if (value_size < 2)
+    return false;
+
+  const u32 num_instructions = value[1];
+  if (num_instructions > value_size - 2)
+    return false;
+
+  const u32* const addresses = value + 2;
+  const u32* const end = value + value_size;
+
+  block->effective_address = key.effective_address;
+  block->msr_bits = key.msr_bits;
+  block->flags = value[0];
+  block->instruction_addresses.assign(addresses, addresses + num_instructions);
+  block->fifo_write_addresses.assign(addresses + num_instructions, end);
+  return true;
+}
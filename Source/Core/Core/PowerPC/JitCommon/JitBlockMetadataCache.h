@@ -0,0 +1,84 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/LinearDiskCache.h"
+
+// Remembers which blocks a game has compiled, and what the JIT learned about them while running
+// them (the exception check addresses in JitState), so that the next boot can compile them before
+// they are first executed instead of when the game gets there.
+//
+// Blocks are keyed by a hash of their instructions and are only used again while the code in
+// memory still matches. The JIT analyzes a block again when it compiles it, so a stale entry
+// can only cost compile time, never correctness.
+class JitBlockMetadataCache
+{
+public:
+  enum Flags : u32
+  {
+    // The block's address is in JitState::pairedQuantizeAddresses.
+    FLAG_NO_PAIRED_QUANTIZE_ASSUMPTION = 1 << 0,
+    // The block's address is in JitState::noSpeculativeConstantsAddresses.
+    FLAG_NO_SPECULATIVE_CONSTANTS = 1 << 1,
+  };
+
+  struct Block
+  {
+    u32 effective_address = 0;
+    u32 msr_bits = 0;
+    u32 flags = 0;
+    // Addresses of the instructions the block was made of, in the order they were compiled.
+    std::vector<u32> instruction_addresses;
+    // Instructions of the block which are in JitState::fifoWriteAddresses.
+    std::vector<u32> fifo_write_addresses;
+  };
+
+  JitBlockMetadataCache();
+  ~JitBlockMetadataCache();
+
+  void Open(const std::string& filename);
+  void Close();
+  bool IsOpen() const { return m_is_open; }
+
+  // Adds a block that has just been compiled, unless it is already known. Must be called while
+  // the instruction address translation the block was compiled with is active.
+  void RecordBlock(const Block& block);
+
+  // Hands out the blocks recorded by previous runs, in the order they were first compiled in.
+  // Blocks compiled for other MSR bits or whose instructions have changed are skipped. Returns
+  // false once all of them have been handed out.
+  bool GetNextPrecompileCandidate(u32 msr_bits, Block* block);
+
+private:
+  struct Key
+  {
+    bool operator<(const Key& other) const;
+
+    // The disk cache compares keys bytewise, so this must not contain any padding. The number of
+    // instructions is part of the hash.
+    u32 effective_address;
+    u32 msr_bits;
+    u64 code_hash;
+  };
+
+  class Reader;
+
+  static bool HashInstructions(const Block& block, u64* hash);
+  static std::vector<u32> Serialize(const Block& block);
+  static bool Deserialize(const Key& key, const u32* value, u32 value_size, Block* block);
+
+  LinearDiskCache<Key, u32> m_disk_cache;
+  std::map<Key, std::vector<u32>> m_blocks;
+  // Blocks from previous runs in the order they were first recorded in.
+  std::vector<Key> m_precompile_queue;
+  size_t m_precompile_position = 0;
+  bool m_is_open = false;
+};
@@ -38,6 +38,142 @@ bool JitBlock::OverlapsPhysicalRange(u32 address, u32 length) const
          physical_addresses.lower_bound(address + length);
 }
 
+BlockRangeIndex::BlockRangeIndex()
+{
+  Clear();
+}
+
+BlockRangeIndex::~BlockRangeIndex() = default;
+
+void BlockRangeIndex::Add(JitBlock& block)
+{
+  // physical_addresses is sorted, so each granule only needs to be compared with the last one.
+  u32 last_granule = 0;
+  bool first = true;
+  for (u32 addr : block.physical_addresses)
+  {
+    const u32 granule = addr >> GRANULE_SHIFT;
+    if (!first && granule == last_granule)
+      continue;
+    first = false;
+    last_granule = granule;
+
+    const u32 node = AllocateNode();
+    u32& head = GetListHead(granule);
+    m_nodes[node] = {&block, head};
+    head = node;
+  }
+}
+
+void BlockRangeIndex::Remove(const JitBlock& block)
+{
+  u32 last_granule = 0;
+  bool first = true;
+  for (u32 addr : block.physical_addresses)
+  {
+    const u32 granule = addr >> GRANULE_SHIFT;
+    if (!first && granule == last_granule)
+      continue;
+    first = false;
+    last_granule = granule;
+
+    for (u32* link = &GetListHead(granule); *link != 0; link = &m_nodes[*link].next)
+    {
+      const u32 node = *link;
+      if (m_nodes[node].block == &block)
+      {
+        *link = m_nodes[node].next;
+        m_nodes[node].next = m_free_nodes;
+        m_free_nodes = node;
+        break;
+      }
+    }
+  }
+}
+
+void BlockRangeIndex::Clear()
+{
+  for (const Page& page : m_pages)
+    m_directory[page.directory_index / PAGES_PER_CHUNK][page.directory_index % PAGES_PER_CHUNK] = 0;
+  m_pages.clear();
+  m_nodes.clear();
+  m_nodes.push_back({nullptr, 0});
+  m_free_nodes = 0;
+}
+
+void BlockRangeIndex::FindOverlappingBlocks(u32 address, u32 length,
+                                            std::vector<JitBlock*>* blocks) const
+{
+  if (length == 0)
+    return;
+
+  const size_t first_result = blocks->size();
+  const u64 end_granule = std::min<u64>(((u64{address} + length - 1) >> GRANULE_SHIFT) + 1,
+                                        u64{1} << (32 - GRANULE_SHIFT));
+  u64 granule = address >> GRANULE_SHIFT;
+  while (granule < end_granule)
+  {
+    const u64 page_index = granule / GRANULES_PER_PAGE;
+    const u64 page_end = std::min(end_granule, (page_index + 1) * GRANULES_PER_PAGE);
+    const u32 directory_entry = GetDirectoryEntry(static_cast<u32>(page_index));
+    if (directory_entry == 0)
+    {
+      granule = page_end;
+      continue;
+    }
+
+    const Page& page = m_pages[directory_entry - 1];
+    for (; granule < page_end; granule++)
+    {
+      for (u32 node = page.heads[granule % GRANULES_PER_PAGE]; node != 0; node = m_nodes[node].next)
+      {
+        JitBlock* block = m_nodes[node].block;
+        if (block->OverlapsPhysicalRange(address, length))
+          blocks->push_back(block);
+      }
+    }
+  }
+
+  // Blocks which span several granules are found once per granule.
+  std::sort(blocks->begin() + first_result, blocks->end());
+  blocks->erase(std::unique(blocks->begin() + first_result, blocks->end()), blocks->end());
+}
+
+u32 BlockRangeIndex::GetDirectoryEntry(u32 page_index) const
+{
+  const std::unique_ptr<u32[]>& chunk = m_directory[page_index / PAGES_PER_CHUNK];
+  return chunk ? chunk[page_index % PAGES_PER_CHUNK] : 0;
+}
+
+u32& BlockRangeIndex::GetListHead(u32 granule)
+{
+  const u32 page_index = granule / GRANULES_PER_PAGE;
+  std::unique_ptr<u32[]>& chunk = m_directory[page_index / PAGES_PER_CHUNK];
+  if (!chunk)
+    chunk.reset(new u32[PAGES_PER_CHUNK]());
+
+  u32& directory_entry = chunk[page_index % PAGES_PER_CHUNK];
+  if (directory_entry == 0)
+  {
+    m_pages.push_back({page_index, {}});
+    directory_entry = static_cast<u32>(m_pages.size());
+  }
+  return m_pages[directory_entry - 1].heads[granule % GRANULES_PER_PAGE];
+}
+
+u32 BlockRangeIndex::AllocateNode()
+{
+  if (m_free_nodes == 0)
+  {
+    m_nodes.push_back({nullptr, 0});
+    return static_cast<u32>(m_nodes.size() - 1);
+  }
+
+  const u32 node = m_free_nodes;
+  m_free_nodes = m_nodes[node].next;
+  return node;
+}
+
 JitBaseBlockCache::JitBaseBlockCache(JitBase& jit) : m_jit{jit}
 {
 }
@@ -71,7 +207,7 @@ void JitBaseBlockCache::Clear()
   }
   block_map.clear();
   links_to.clear();
-  block_range_map.clear();
+  block_range_index.Clear();
 
   valid_block.ClearAll();
 
@@ -107,6 +243,19 @@ JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
   return &b;
 }
 
+void JitBaseBlockCache::DiscardBlock(JitBlock& block)
+{
+  const auto range = block_map.equal_range(block.physicalAddress);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (&it->second == &block)
+    {
+      block_map.erase(it);
+      return;
+    }
+  }
+}
+
 void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
                                       const std::set<u32>& physical_addresses)
 {
@@ -116,12 +265,9 @@ void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
 
   block.physical_addresses = physical_addresses;
 
-  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
   for (u32 addr : physical_addresses)
-  {
     valid_block.Set(addr / 32);
-    block_range_map[addr & range_mask].insert(&block);
-  }
+  block_range_index.Add(block);
 
   if (block_link)
   {
@@ -223,50 +369,24 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
 
 void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
 {
-  // Iterate over all macro blocks which overlap the given range.
-  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
-  auto start = block_range_map.lower_bound(address & range_mask);
-  auto end = block_range_map.lower_bound(address + length);
-  while (start != end)
+  std::vector<JitBlock*> blocks;
+  block_range_index.FindOverlappingBlocks(address, length, &blocks);
+  for (JitBlock* block : blocks)
   {
-    // Iterate over all blocks in the macro block.
-    auto iter = start->second.begin();
-    while (iter != start->second.end())
+    block_range_index.Remove(*block);
+
+    // And remove the block.
+    DestroyBlock(*block);
+    auto block_map_iter = block_map.equal_range(block->physicalAddress);
+    while (block_map_iter.first != block_map_iter.second)
     {
-      JitBlock* block = *iter;
-      if (block->OverlapsPhysicalRange(address, length))
+      if (&block_map_iter.first->second == block)
       {
-        // If the block overlaps, also remove all other occupied slots in the other macro blocks.
-        // This will leak empty macro blocks, but they may be reused or cleared later on.
-        for (u32 addr : block->physical_addresses)
-          if ((addr & range_mask) != start->first)
-            block_range_map[addr & range_mask].erase(block);
-
-        // And remove the block.
-        DestroyBlock(*block);
-        auto block_map_iter = block_map.equal_range(block->physicalAddress);
-        while (block_map_iter.first != block_map_iter.second)
-        {
-          if (&block_map_iter.first->second == block)
-          {
-            block_map.erase(block_map_iter.first);
-            break;
-          }
-          block_map_iter.first++;
-        }
-        iter = start->second.erase(iter);
-      }
-      else
-      {
-        iter++;
+        block_map.erase(block_map_iter.first);
+        break;
       }
+      block_map_iter.first++;
     }
-
-    // If the macro block is empty, drop it.
-    if (start->second.empty())
-      start = block_range_map.erase(start);
-    else
-      start++;
   }
 }
 
@@ -123,6 +123,60 @@ public:
   bool Test(u32 bit) { return (m_valid_block[bit / 32] & (1u << (bit % 32))) != 0; }
 };
 
+// Index of the blocks which overlap each 0x100 byte granule of the physical address space, used
+// to find the blocks that need to be invalidated when code memory is written to.
+//
+// The granules are looked up through a two-level table (a directory of 4 KiB pages, each with the
+// list heads of its granules), and the lists are singly linked through a pooled node array, so
+// adding and removing blocks doesn't allocate once the pool has grown large enough. The directory
+// is allocated in chunks covering 4 MiB each as blocks get added to them, so only the parts of the
+// address space that contain code take up memory.
+class BlockRangeIndex final
+{
+public:
+  static constexpr u32 GRANULE_SHIFT = 8;
+  static constexpr u32 PAGE_SHIFT = 12;
+  static constexpr u32 GRANULES_PER_PAGE = 1 << (PAGE_SHIFT - GRANULE_SHIFT);
+  static constexpr u32 CHUNK_SHIFT = 22;
+  static constexpr u32 PAGES_PER_CHUNK = 1 << (CHUNK_SHIFT - PAGE_SHIFT);
+
+  BlockRangeIndex();
+  ~BlockRangeIndex();
+
+  void Add(JitBlock& block);
+  void Remove(const JitBlock& block);
+  void Clear();
+
+  // Appends each block which overlaps [address, address + length) to blocks once.
+  void FindOverlappingBlocks(u32 address, u32 length, std::vector<JitBlock*>* blocks) const;
+
+private:
+  struct Node
+  {
+    JitBlock* block;
+    u32 next;
+  };
+
+  struct Page
+  {
+    u32 directory_index;
+    std::array<u32, GRANULES_PER_PAGE> heads;
+  };
+
+  u32& GetListHead(u32 granule);
+  u32 AllocateNode();
+
+  u32 GetDirectoryEntry(u32 page_index) const;
+
+  // Page index + 1 for every 4 KiB page of the address space, or 0 if no block overlaps it. A null
+  // chunk means that no block has ever been added to that part of the address space.
+  std::array<std::unique_ptr<u32[]>, 1 << (32 - CHUNK_SHIFT)> m_directory;
+  std::vector<Page> m_pages;
+  // Node 0 is never used so that 0 can terminate the lists.
+  std::vector<Node> m_nodes;
+  u32 m_free_nodes = 0;
+};
+
 class JitBaseBlockCache
 {
 public:
@@ -147,6 +201,8 @@ public:
 
   JitBlock* AllocateBlock(u32 em_address);
   void FinalizeBlock(JitBlock& block, bool block_link, const std::set<u32>& physical_addresses);
+  // Removes a block returned by AllocateBlock which couldn't be compiled and never got finalized.
+  void DiscardBlock(JitBlock& block);
 
   // Look for the block in the slow but accurate way.
   // This function shall be used if FastLookupIndexForAddress() failed.
@@ -190,11 +246,9 @@ private:
   // This is used to query the block based on the current PC in a slow way.
   std::multimap<u32, JitBlock> block_map;  // start_addr -> block
 
-  // Range of overlapping code indexed by a masked physical address.
-  // This is used for invalidation of memory regions. The range is grouped
-  // in macro blocks of each 0x100 bytes.
-  static constexpr u32 BLOCK_RANGE_MAP_ELEMENTS = 0x100;
-  std::map<u32, std::set<JitBlock*>> block_range_map;
+  // Blocks indexed by the physical addresses they overlap.
+  // This is used for invalidation of memory regions.
+  BlockRangeIndex block_range_index;
 
   // This bitsets shows which cachelines overlap with any blocks.
   // It is used to provide a fast way to query if no icache invalidation is needed.
@@ -214,6 +214,12 @@ void ClearCache()
   if (g_jit)
     g_jit->ClearCache();
 }
+
+void PrecompileCachedBlocks(std::chrono::microseconds time_budget)
+{
+  if (g_jit)
+    g_jit->PrecompileCachedBlocks(time_budget);
+}
 void ClearSafe()
 {
   if (g_jit)
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 
 #include "Common/CommonTypes.h"
@@ -56,6 +57,10 @@ bool HandleStackFault();
 // Clearing CodeCache
 void ClearCache();
 
+// Compiles blocks which are expected to be executed later, for about the given time. Must be called
+// on the CPU thread, outside of JIT code.
+void PrecompileCachedBlocks(std::chrono::microseconds time_budget);
+
 // This clear is "safe" in the sense that it's okay to run from
 // inside a JIT'ed block: it clears the instruction cache, but not
 // the JIT'ed code.
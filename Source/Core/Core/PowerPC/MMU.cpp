@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/MMU.h"
 
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <string>
@@ -166,11 +167,138 @@ BatTable dbat_table;
 
 static void GenerateDSIException(u32 effective_address, bool write);
 
+// Software TLB
+// A direct-mapped cache of translated data pages and the host memory backing them. Loads and
+// stores which hit it skip the BAT and TLB lookups as well as the memory region checks below,
+// which is what makes the interpreters slow in MMU titles when fastmem isn't available.
+// Every entry mirrors either a DBAT mapping or an entry of the emulated data TLB and gets
+// invalidated along with it, so using it doesn't change anything the emulated CPU can observe.
+// Reads and writes use separate tables, since a write has to go through the page table until the
+// C bit of the page has been set.
+constexpr u32 SOFTWARE_TLB_SIZE = 1024;
+
+struct SoftwareTLBEntry
+{
+  static constexpr u32 INVALID_TAG = 0xffffffff;
+
+  u32 tag = INVALID_TAG;
+  // The way of the emulated TLB entry the translation came from, or -1 for BAT translations.
+  s32 tlb_way = -1;
+  u8* host_page = nullptr;
+};
+
+using SoftwareTLB = std::array<SoftwareTLBEntry, SOFTWARE_TLB_SIZE>;
+
+static SoftwareTLB s_software_tlb_read;
+static SoftwareTLB s_software_tlb_write;
+
+static constexpr bool UsesSoftwareTLB(XCheckTLBFlag flag)
+{
+  return flag == XCheckTLBFlag::Read || flag == XCheckTLBFlag::Write;
+}
+
+template <XCheckTLBFlag flag>
+static SoftwareTLB& GetSoftwareTLB()
+{
+  return flag == XCheckTLBFlag::Write ? s_software_tlb_write : s_software_tlb_read;
+}
+
+static void InvalidateSoftwareTLB()
+{
+  s_software_tlb_read.fill({});
+  s_software_tlb_write.fill({});
+}
+
+static void InvalidateSoftwareTLBPage(u32 tag)
+{
+  for (SoftwareTLB* software_tlb : {&s_software_tlb_read, &s_software_tlb_write})
+  {
+    SoftwareTLBEntry& entry = (*software_tlb)[tag & (SOFTWARE_TLB_SIZE - 1)];
+    if (entry.tag == tag)
+      entry = {};
+  }
+}
+
+// Returns the host memory backing a physical page, or nullptr if it isn't backed by memory.
+// This has to match the address decoding in ReadFromHardware and WriteToHardware.
+static u8* GetHostPagePointer(u32 page_address)
+{
+  if ((page_address & 0xF8000000) == 0x00000000)
+    return &Memory::m_pRAM[page_address & Memory::GetRamMask()];
+
+  if (Memory::m_pEXRAM && (page_address >> 28) == 0x1 &&
+      (page_address & 0x0FFFFFFF) < Memory::GetExRamSizeReal())
+  {
+    return &Memory::m_pEXRAM[page_address & 0x0FFFFFFF];
+  }
+
+  if ((page_address >> 28) == 0xE && (page_address < (0xE0000000 + Memory::GetL1CacheSize())))
+    return &Memory::m_pL1Cache[page_address & 0x0FFFFFFF];
+
+  if (Memory::m_pFakeVMEM && ((page_address & 0xFE000000) == 0x7E000000))
+    return &Memory::m_pFakeVMEM[page_address & Memory::GetRamMask()];
+
+  return nullptr;
+}
+
+template <XCheckTLBFlag flag, typename T>
+static u8* LookupSoftwareTLB(u32 address)
+{
+  if (!UsesSoftwareTLB(flag) || (address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - sizeof(T))
+    return nullptr;
+
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  const SoftwareTLBEntry& entry = GetSoftwareTLB<flag>()[tag & (SOFTWARE_TLB_SIZE - 1)];
+  if (entry.tag != tag)
+    return nullptr;
+
+  // Update the replacement state of the emulated TLB like a lookup in it would have.
+  if (entry.tlb_way >= 0)
+    ppcState.tlb[0][tag & HW_PAGE_INDEX_MASK].recent = static_cast<u8>(entry.tlb_way);
+
+  return entry.host_page + (address & (HW_PAGE_SIZE - 1));
+}
+
+template <XCheckTLBFlag flag>
+static void UpdateSoftwareTLB(u32 address, const TranslateAddressResult& translated_addr)
+{
+  if (!UsesSoftwareTLB(flag))
+    return;
+
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  s32 tlb_way = -1;
+  if (translated_addr.result == TranslateAddressResult::PAGE_TABLE_TRANSLATED)
+  {
+    // A successful translation through the page table leaves the page in the emulated TLB, and
+    // for writes, with its C bit set.
+    const TLBEntry& tlbe = ppcState.tlb[0][tag & HW_PAGE_INDEX_MASK];
+    if (tlbe.tag[0] == tag)
+      tlb_way = 0;
+    else if (tlbe.tag[1] == tag)
+      tlb_way = 1;
+    else
+      return;
+  }
+
+  u8* const host_page = GetHostPagePointer(translated_addr.address & ~(HW_PAGE_SIZE - 1));
+  if (!host_page)
+    return;
+
+  GetSoftwareTLB<flag>()[tag & (SOFTWARE_TLB_SIZE - 1)] = {tag, tlb_way, host_page};
+}
+
 template <XCheckTLBFlag flag, typename T, bool never_translate = false>
 static T ReadFromHardware(u32 em_address)
 {
   if (!never_translate && MSR.DR)
   {
+    if (const u8* host_ptr = LookupSoftwareTLB<flag, T>(em_address))
+    {
+      T value;
+      std::memcpy(&value, host_ptr, sizeof(T));
+      return bswap(value);
+    }
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -178,6 +306,7 @@ static T ReadFromHardware(u32 em_address)
         GenerateDSIException(em_address, false);
       return 0;
     }
+    UpdateSoftwareTLB<flag>(em_address, translated_addr);
     if ((em_address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - sizeof(T))
     {
       // This could be unaligned down to the byte level... hopefully this is rare, so doing it this
@@ -259,6 +388,13 @@ static void WriteToHardware(u32 em_address, const T data)
 {
   if (!never_translate && MSR.DR)
   {
+    if (u8* host_ptr = LookupSoftwareTLB<flag, T>(em_address))
+    {
+      const T swapped_data = bswap(data);
+      std::memcpy(host_ptr, &swapped_data, sizeof(T));
+      return;
+    }
+
     auto translated_addr = TranslateAddress<flag>(em_address);
     if (!translated_addr.Success())
     {
@@ -266,6 +402,7 @@ static void WriteToHardware(u32 em_address, const T data)
         GenerateDSIException(em_address, true);
       return;
     }
+    UpdateSoftwareTLB<flag>(em_address, translated_addr);
     if ((em_address & (sizeof(T) - 1)) &&
         (em_address & (HW_PAGE_SIZE - 1)) > HW_PAGE_SIZE - sizeof(T))
     {
@@ -980,6 +1117,8 @@ void SDRUpdated()
   }
   PowerPC::ppcState.pagetable_base = htaborg << 16;
   PowerPC::ppcState.pagetable_hashmask = ((htabmask << 10) | 0x3ff);
+
+  InvalidateSoftwareTLB();
 }
 
 enum class TLBLookupResult
@@ -1049,6 +1188,8 @@ static void UpdateTLBEntry(const XCheckTLBFlag flag, UPTE2 PTE2, const u32 addre
   const int tag = address >> HW_PAGE_INDEX_SHIFT;
   TLBEntry& tlbe = ppcState.tlb[IsOpcodeFlag(flag)][tag & HW_PAGE_INDEX_MASK];
   const int index = tlbe.recent == 0 && tlbe.tag[0] != TLBEntry::INVALID_TAG;
+  if (!IsOpcodeFlag(flag) && tlbe.tag[index] != TLBEntry::INVALID_TAG)
+    InvalidateSoftwareTLBPage(tlbe.tag[index]);
   tlbe.recent = index;
   tlbe.paddr[index] = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
   tlbe.pte[index] = PTE2.Hex;
@@ -1066,6 +1207,17 @@ void InvalidateTLBEntry(u32 address)
   TLBEntry& tlbe_i = ppcState.tlb[1][entry_index];
   tlbe_i.tag[0] = TLBEntry::INVALID_TAG;
   tlbe_i.tag[1] = TLBEntry::INVALID_TAG;
+
+  // BAT translations aren't affected by tlbie.
+  for (SoftwareTLB* software_tlb : {&s_software_tlb_read, &s_software_tlb_write})
+  {
+    for (u32 i = entry_index; i < SOFTWARE_TLB_SIZE; i += HW_PAGE_INDEX_MASK + 1)
+    {
+      SoftwareTLBEntry& entry = (*software_tlb)[i];
+      if (entry.tlb_way >= 0)
+        entry = {};
+    }
+  }
 }
 
 // Page Address Translation
@@ -1251,6 +1403,8 @@ static void UpdateFakeMMUBat(BatTable& bat_table, u32 start_addr)
 
 void DBATUpdated()
 {
+  InvalidateSoftwareTLB();
+
   dbat_table = {};
   UpdateBATs(dbat_table, SPR_DBAT0U);
   bool extended_bats = SConfig::GetInstance().bWii && HID4.SBE;
@@ -29,6 +29,7 @@
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/MMU.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/Profiler.h"
 
 namespace PowerPC
 {
@@ -253,6 +254,7 @@ void Init(CPUCore cpu_core)
 
   s_invalidate_cache_thread_safe =
       CoreTiming::RegisterEvent("invalidateEmulatedCache", InvalidateCacheThreadSafe);
+  Profiler::Init();
 
   Reset();
 
@@ -288,6 +290,7 @@ void ScheduleInvalidateCacheThreadSafe(u32 address)
 
 void Shutdown()
 {
+  Profiler::Shutdown();
   InjectExternalCPUCore(nullptr);
   JitInterface::Shutdown();
   s_interpreter->Shutdown();
@@ -0,0 +1,175 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/PowerPC/Profiler.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/StringUtil.h"
+#include "Common/SymbolDB.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/SystemTimers.h"
+#include "Core/PowerPC/MMU.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/PowerPC.h"
+
+namespace Profiler
+{
+constexpr u32 SAMPLES_PER_SECOND = 1000;
+constexpr int MAX_STACK_DEPTH = 64;
+
+static CoreTiming::EventType* s_event_sample;
+static std::atomic<bool> s_sampling{false};
+// Lets a sample event which is still pending from a previous run of the profiler be told apart.
+static std::atomic<u64> s_generation{0};
+
+static std::mutex s_samples_lock;
+// Sampled stacks and how often each was seen. The first element is the address of the block which
+// was about to run, followed by the addresses of the functions on the stack, innermost first.
+static std::map<std::vector<u32>, u64> s_samples;
+
+static bool IsStackFrame(u32 address)
+{
+  return address != 0 && PowerPC::HostIsRAMAddress(address) &&
+         PowerPC::HostIsRAMAddress(address + 4);
+}
+
+static u32 GetFunctionAddress(u32 address)
+{
+  const Common::Symbol* symbol = g_symbolDB.GetSymbolFromAddr(address);
+  return symbol ? symbol->address : address;
+}
+
+static void AddFrame(std::vector<u32>* stack, u32 address)
+{
+  // Recursion and functions which have already saved LR would otherwise show up several times.
+  const u32 function = GetFunctionAddress(address);
+  if (stack->size() < 2 || stack->back() != function)
+    stack->push_back(function);
+}
+
+static std::vector<u32> GetGuestCallStack()
+{
+  std::vector<u32> stack;
+  stack.push_back(PC);
+  AddFrame(&stack, PC);
+
+  // Leaf functions don't necessarily store LR in a stack frame, so the caller is only in LR.
+  AddFrame(&stack, LR);
+
+  u32 frame = GPR(1);
+  for (int depth = 0; depth < MAX_STACK_DEPTH && IsStackFrame(frame); depth++)
+  {
+    const u32 caller_frame = PowerPC::HostRead_U32(frame);
+    // The stack grows downwards, anything else means the chain is broken.
+    if (caller_frame <= frame || !IsStackFrame(caller_frame))
+      break;
+
+    AddFrame(&stack, PowerPC::HostRead_U32(caller_frame + 4));
+    frame = caller_frame;
+  }
+
+  return stack;
+}
+
+static s64 GetSamplePeriod()
+{
+  return static_cast<s64>(SystemTimers::GetTicksPerSecond() / SAMPLES_PER_SECOND);
+}
+
+static void SampleCallback(u64 generation, s64 cycles_late)
+{
+  if (!s_sampling || generation != s_generation)
+    return;
+
+  std::vector<u32> stack = GetGuestCallStack();
+  {
+    std::lock_guard<std::mutex> lk(s_samples_lock);
+    s_samples[std::move(stack)]++;
+  }
+
+  CoreTiming::ScheduleEvent(GetSamplePeriod() - cycles_late, s_event_sample, generation);
+}
+
+void Init()
+{
+  s_event_sample = CoreTiming::RegisterEvent("ProfilerSample", SampleCallback);
+}
+
+void Shutdown()
+{
+  // The samples are kept so that they can still be written after emulation has stopped.
+  s_sampling = false;
+}
+
+void StartSampling()
+{
+  if (s_sampling)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lk(s_samples_lock);
+    s_samples.clear();
+  }
+
+  s_sampling = true;
+  CoreTiming::ScheduleEvent(0, s_event_sample, ++s_generation, CoreTiming::FromThread::ANY);
+}
+
+void StopSampling()
+{
+  s_sampling = false;
+}
+
+bool IsSampling()
+{
+  return s_sampling;
+}
+
+static std::string GetFrameName(u32 address)
+{
+  const Common::Symbol* symbol = g_symbolDB.GetSymbolFromAddr(address);
+  if (!symbol)
+    return fmt::format("{:08x}", address);
+
+  // Semicolons separate the frames in the folded format.
+  return ReplaceAll(symbol->name, ";", ":");
+}
+
+bool WriteFoldedStacks(const std::string& filename)
+{
+  std::lock_guard<std::mutex> lk(s_samples_lock);
+  if (s_samples.empty())
+    return false;
+
+  File::IOFile f(filename, "w");
+  if (!f)
+    return false;
+
+  std::string line;
+  for (const auto& sample : s_samples)
+  {
+    const std::vector<u32>& stack = sample.first;
+
+    // Outermost function first, then the block.
+    line.clear();
+    for (auto it = stack.rbegin(); it != stack.rend() - 1; ++it)
+      line += GetFrameName(*it) + ';';
+    line += fmt::format("block_{:08x} {}\n", stack.front(), sample.second);
+
+    if (!f.WriteBytes(line.data(), line.size()))
+      return false;
+  }
+
+  return true;
+}
+}  // namespace Profiler
@@ -34,4 +34,19 @@ struct ProfileStats
   u64 countsPerSec;
 };
 
+// Sampling profiler for the emulated code. While it runs, the guest call stack (the current
+// block, LR and the stack frame chain) is recorded at a fixed rate of emulated time. This works
+// with every CPU core, unlike the JIT block profiling above.
+void Init();
+void Shutdown();
+
+void StartSampling();
+void StopSampling();
+bool IsSampling();
+
+// Writes the samples in the folded stack format used by flamegraph.pl and speedscope, with the
+// functions from g_symbolDB as frames and the sampled block as the leaf. Returns false if there
+// are no samples or the file couldn't be written.
+bool WriteFoldedStacks(const std::string& filename);
+
 }  // namespace Profiler
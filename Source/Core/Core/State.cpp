@@ -4,6 +4,10 @@
 
 #include "Core/State.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
 #include <lzo/lzo1x.h>
 #include <map>
 #include <mutex>
@@ -13,9 +17,11 @@
 #include <vector>
 
 #include <fmt/format.h>
+#include <zstd.h>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/Event.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
@@ -25,6 +31,7 @@
 #include "Common/Timer.h"
 #include "Common/Version.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -37,6 +44,8 @@
 #include "Core/NetPlayClient.h"
 #include "Core/PowerPC/PowerPC.h"
 
+#include "DiscIO/MultithreadedCompressor.h"
+
 #include "VideoCommon/FrameDump.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -58,7 +67,24 @@ static unsigned char __LZO_MMODEL out[OUT_LEN];
 #define HEAP_ALLOC(var, size)                                                                      \
   lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
 
-static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
+// Compressed states are stored as a sequence of independently compressed zstd frames, so that they
+// can be compressed and decompressed on several threads. Each frame is preceded by a
+// ZstdFrameHeader. States saved by older versions consist of LZO chunks instead, each preceded by
+// its compressed size. StateHeader::compression tells them apart.
+
+// The upper bits of StateHeader::version are a magic value, as older versions left that field
+// uninitialized. The lower bits are the version of the header.
+static constexpr u32 STATE_HEADER_MAGIC = 0x53484400;  // "SHD"
+static constexpr u32 STATE_HEADER_MAGIC_MASK = 0xFFFFFF00;
+static constexpr u32 STATE_HEADER_VERSION = STATE_HEADER_MAGIC | 1;
+static constexpr size_t ZSTD_STATE_FRAME_SIZE = 4 * 1024 * 1024;
+static constexpr int ZSTD_STATE_COMPRESSION_LEVEL = 1;
+
+struct ZstdFrameHeader
+{
+  u32 compressed_size;
+  u32 uncompressed_size;
+};
 
 static AfterLoadCallbackFunc s_on_after_load_callback;
 
@@ -73,6 +99,41 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 
 static std::thread g_save_thread;
 
+// Rewind buffer. Each entry turns a snapshot back into the one taken before it: it holds the pages
+// of the older snapshot that differ from the newer one. Newer entries are at the back.
+//
+// A snapshot consists of the state without the emulated RAM, and a copy of the RAM. Only the former
+// goes through DoState; the RAM is compared against the copy of the previous snapshot directly.
+struct RewindDelta
+{
+  size_t state_size;
+  std::vector<u32> state_pages;
+  std::vector<u32> ram_pages;
+  std::vector<u8> compressed_data;
+};
+
+struct RewindRAMRegion
+{
+  u8* data;
+  size_t size;
+};
+
+static constexpr size_t REWIND_PAGE_SIZE = 4096;
+// Snapshots are held off for a moment after rewinding, so that holding the rewind hotkey keeps
+// going back instead of recording the frames in between.
+static constexpr int REWIND_HOLD_OFF_FRAMES = 15;
+
+static std::mutex s_rewind_mutex;
+static std::deque<RewindDelta> s_rewind_deltas;
+static size_t s_rewind_deltas_size;
+// The most recent snapshot, which the newest delta applies to.
+static std::vector<u8> s_rewind_reference;
+static std::vector<u8> s_rewind_ram_reference;
+static std::vector<u8> s_rewind_scratch;
+static int s_rewind_frames_until_snapshot;
+static bool s_rewind_snapshot_pending;
+static HEAP_ALLOC(s_rewind_wrkmem, LZO1X_1_MEM_COMPRESS);
+
 // Don't forget to increase this after doing changes on the savestate system
 constexpr u32 STATE_VERSION = 124;  // Last changed in PR 9097
 
@@ -146,7 +207,7 @@ static bool DoStateVersion(PointerWrap& p, std::string* version_created_by)
   return true;
 }
 
-static void DoState(PointerWrap& p)
+static void DoState(PointerWrap& p, bool include_ram = true)
 {
   std::string version_created_by;
   if (!DoStateVersion(p, &version_created_by))
@@ -206,7 +267,7 @@ static void DoState(PointerWrap& p)
   // the controller code might need to schedule an event if the controller has changed.
   CoreTiming::DoState(p);
   p.DoMarker("CoreTiming");
-  HW::DoState(p);
+  HW::DoState(p, include_ram);
   p.DoMarker("HW");
   if (SConfig::GetInstance().bWii)
     Wiimote::DoState(p);
@@ -309,6 +370,80 @@ struct CompressAndDumpState_args
   bool wait;
 };
 
+struct ZstdCompressThreadState
+{
+  ZstdCompressThreadState() = default;
+  ~ZstdCompressThreadState() { ZSTD_freeCCtx(context); }
+
+  ZstdCompressThreadState(const ZstdCompressThreadState&) = delete;
+  ZstdCompressThreadState& operator=(const ZstdCompressThreadState&) = delete;
+
+  ZSTD_CCtx* context = nullptr;
+};
+
+struct ZstdCompressParameters
+{
+  const u8* data;
+  size_t size;
+};
+
+struct ZstdCompressedFrame
+{
+  std::vector<u8> data;
+  u32 uncompressed_size;
+};
+
+static bool WriteCompressedState(File::IOFile& f, const u8* data, size_t size)
+{
+  using DiscIO::ConversionResult;
+  using DiscIO::ConversionResultCode;
+
+  const auto set_up_thread_state = [](ZstdCompressThreadState* state) {
+    state->context = ZSTD_createCCtx();
+    return state->context ? ConversionResultCode::Success : ConversionResultCode::InternalError;
+  };
+
+  const auto compress =
+      [](ZstdCompressThreadState* state,
+         ZstdCompressParameters parameters) -> ConversionResult<ZstdCompressedFrame> {
+    ZstdCompressedFrame frame;
+    frame.data.resize(ZSTD_compressBound(parameters.size));
+    frame.uncompressed_size = static_cast<u32>(parameters.size);
+
+    const size_t result =
+        ZSTD_compressCCtx(state->context, frame.data.data(), frame.data.size(), parameters.data,
+                          parameters.size, ZSTD_STATE_COMPRESSION_LEVEL);
+    if (ZSTD_isError(result))
+      return ConversionResultCode::InternalError;
+
+    frame.data.resize(result);
+    return frame;
+  };
+
+  const auto output = [&f](ZstdCompressedFrame frame) {
+    const ZstdFrameHeader frame_header{static_cast<u32>(frame.data.size()),
+                                       frame.uncompressed_size};
+    if (!f.WriteArray(&frame_header, 1) || !f.WriteBytes(frame.data.data(), frame.data.size()))
+      return ConversionResultCode::WriteFailed;
+    return ConversionResultCode::Success;
+  };
+
+  DiscIO::MultithreadedCompressor<ZstdCompressThreadState, ZstdCompressParameters,
+                                  ZstdCompressedFrame>
+      compressor(set_up_thread_state, compress, output);
+
+  for (size_t offset = 0; offset < size; offset += ZSTD_STATE_FRAME_SIZE)
+  {
+    if (compressor.GetStatus() != ConversionResultCode::Success)
+      break;
+
+    compressor.CompressAndWrite({data + offset, std::min(ZSTD_STATE_FRAME_SIZE, size - offset)});
+  }
+
+  compressor.Shutdown();
+  return compressor.GetStatus() == ConversionResultCode::Success;
+}
+
 static void CompressAndDumpState(CompressAndDumpState_args save_args)
 {
   std::lock_guard<std::mutex> lk(*save_args.buffer_mutex);
@@ -333,6 +468,40 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
   // For easy debugging
   Common::SetCurrentThreadName("SaveState thread");
 
+  // Write to a temporary file first, so that a failed save doesn't leave a partial state behind or
+  // replace the previous one.
+  const std::string temp_filename = filename + ".tmp";
+  {
+    File::IOFile f(temp_filename, "wb");
+    if (!f)
+    {
+      Core::DisplayMessage("Could not save state", 2000);
+      return;
+    }
+
+    // Setting up the header
+    StateHeader header{};
+    SConfig::GetInstance().GetGameID().copy(header.gameID, std::size(header.gameID));
+    header.compression = static_cast<u16>(StateCompression::Zstd);
+    header.size = g_use_compression ? (u32)buffer_size : 0;
+    header.version = STATE_HEADER_VERSION;
+    header.time = Common::Timer::GetDoubleTime();
+
+    bool success = f.WriteArray(&header, 1);
+    if (header.size != 0)  // non-zero header size means the state is compressed
+      success = success && WriteCompressedState(f, buffer_data, buffer_size);
+    else  // uncompressed
+      success = success && f.WriteBytes(buffer_data, buffer_size);
+
+    success = f.Close() && success;
+    if (!success)
+    {
+      File::Delete(temp_filename);
+      Core::DisplayMessage("Could not save state", 2000);
+      return;
+    }
+  }
+
   // Moving to last overwritten save-state
   if (File::Exists(filename))
   {
@@ -352,56 +521,13 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
   else if (!Movie::IsMovieActive())
     File::Delete(filename + ".dtm");
 
-  File::IOFile f(filename, "wb");
-  if (!f)
+  if (!File::Rename(temp_filename, filename))
   {
+    File::Delete(temp_filename);
     Core::DisplayMessage("Could not save state", 2000);
     return;
   }
 
-  // Setting up the header
-  StateHeader header{};
-  SConfig::GetInstance().GetGameID().copy(header.gameID, std::size(header.gameID));
-  header.size = g_use_compression ? (u32)buffer_size : 0;
-  header.time = Common::Timer::GetDoubleTime();
-
-  f.WriteArray(&header, 1);
-
-  if (header.size != 0)  // non-zero header size means the state is compressed
-  {
-    lzo_uint i = 0;
-    while (true)
-    {
-      lzo_uint32 cur_len = 0;
-      lzo_uint out_len = 0;
-
-      if ((i + IN_LEN) >= buffer_size)
-      {
-        cur_len = (lzo_uint32)(buffer_size - i);
-      }
-      else
-      {
-        cur_len = IN_LEN;
-      }
-
-      if (lzo1x_1_compress(buffer_data + i, cur_len, out, &out_len, wrkmem) != LZO_E_OK)
-        PanicAlertT("Internal LZO Error - compression failed");
-
-      // The size of the data to write is 'out_len'
-      f.WriteArray((lzo_uint32*)&out_len, 1);
-      f.WriteBytes(out, out_len);
-
-      if (cur_len != IN_LEN)
-        break;
-
-      i += cur_len;
-    }
-  }
-  else  // uncompressed
-  {
-    f.WriteBytes(buffer_data, buffer_size);
-  }
-
   Core::DisplayMessage(fmt::format("Saved State to {}", filename), 2000);
   Host_UpdateMainFrame();
 }
@@ -455,6 +581,20 @@ void SaveAs(const std::string& filename, bool wait)
   s_load_or_save_in_progress = false;
 }
 
+static bool ReadHeader(File::IOFile& f, StateHeader& header)
+{
+  if (!f.ReadArray(&header, 1))
+    return false;
+
+  if ((header.version & STATE_HEADER_MAGIC_MASK) != STATE_HEADER_MAGIC)
+  {
+    // Saved by a version from before the header had a version
+    header.compression = static_cast<u16>(StateCompression::LZO);
+    header.version = 0;
+  }
+  return true;
+}
+
 bool ReadHeader(const std::string& filename, StateHeader& header)
 {
   Flush();
@@ -465,8 +605,7 @@ bool ReadHeader(const std::string& filename, StateHeader& header)
     return false;
   }
 
-  f.ReadArray(&header, 1);
-  return true;
+  return ReadHeader(f, header);
 }
 
 std::string GetInfoStringOfSlot(int slot, bool translate)
@@ -482,6 +621,89 @@ std::string GetInfoStringOfSlot(int slot, bool translate)
   return Common::Timer::GetDateTimeFormatted(header.time);
 }
 
+struct ZstdDecompressThreadState
+{
+  ZstdDecompressThreadState() = default;
+  ~ZstdDecompressThreadState() { ZSTD_freeDCtx(context); }
+
+  ZstdDecompressThreadState(const ZstdDecompressThreadState&) = delete;
+  ZstdDecompressThreadState& operator=(const ZstdDecompressThreadState&) = delete;
+
+  ZSTD_DCtx* context = nullptr;
+};
+
+struct ZstdDecompressParameters
+{
+  std::vector<u8> compressed_data;
+  u8* out;
+  size_t out_size;
+};
+
+// The decompressed frames are written directly to their place in the buffer, so there is nothing
+// left to do on the output thread.
+struct ZstdDecompressedFrame
+{
+};
+
+static bool ReadCompressedState(File::IOFile& f, std::vector<u8>& buffer)
+{
+  using DiscIO::ConversionResult;
+  using DiscIO::ConversionResultCode;
+
+  const auto set_up_thread_state = [](ZstdDecompressThreadState* state) {
+    state->context = ZSTD_createDCtx();
+    return state->context ? ConversionResultCode::Success : ConversionResultCode::InternalError;
+  };
+
+  const auto decompress =
+      [](ZstdDecompressThreadState* state,
+         ZstdDecompressParameters parameters) -> ConversionResult<ZstdDecompressedFrame> {
+    const size_t result =
+        ZSTD_decompressDCtx(state->context, parameters.out, parameters.out_size,
+                            parameters.compressed_data.data(), parameters.compressed_data.size());
+    if (ZSTD_isError(result) || result != parameters.out_size)
+      return ConversionResultCode::InternalError;
+    return ZstdDecompressedFrame{};
+  };
+
+  const auto output = [](ZstdDecompressedFrame) { return ConversionResultCode::Success; };
+
+  DiscIO::MultithreadedCompressor<ZstdDecompressThreadState, ZstdDecompressParameters,
+                                  ZstdDecompressedFrame>
+      decompressor(set_up_thread_state, decompress, output);
+
+  size_t offset = 0;
+  bool read_succeeded = true;
+  while (offset < buffer.size())
+  {
+    if (decompressor.GetStatus() != ConversionResultCode::Success)
+      break;
+
+    ZstdFrameHeader frame_header;
+    if (!f.ReadArray(&frame_header, 1) || frame_header.uncompressed_size > buffer.size() - offset)
+    {
+      read_succeeded = false;
+      break;
+    }
+
+    ZstdDecompressParameters parameters;
+    parameters.compressed_data.resize(frame_header.compressed_size);
+    parameters.out = buffer.data() + offset;
+    parameters.out_size = frame_header.uncompressed_size;
+    if (!f.ReadBytes(parameters.compressed_data.data(), parameters.compressed_data.size()))
+    {
+      read_succeeded = false;
+      break;
+    }
+
+    decompressor.CompressAndWrite(std::move(parameters));
+    offset += frame_header.uncompressed_size;
+  }
+
+  decompressor.Shutdown();
+  return read_succeeded && decompressor.GetStatus() == ConversionResultCode::Success;
+}
+
 static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_data)
 {
   Flush();
@@ -493,7 +715,17 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
   }
 
   StateHeader header;
-  f.ReadArray(&header, 1);
+  if (!ReadHeader(f, header))
+  {
+    Core::DisplayMessage("State is not valid", 2000);
+    return;
+  }
+
+  if (header.version > STATE_HEADER_VERSION)
+  {
+    Core::DisplayMessage("State was saved by a newer version of Dolphin", 2000);
+    return;
+  }
 
   if (strncmp(SConfig::GetInstance().GetGameID().c_str(), header.gameID, 6))
   {
@@ -511,6 +743,24 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
 
     buffer.resize(header.size);
 
+    switch (static_cast<StateCompression>(header.compression))
+    {
+    case StateCompression::Zstd:
+      if (!ReadCompressedState(f, buffer))
+      {
+        Core::DisplayMessage("Could not decompress state", 2000);
+        return;
+      }
+
+      ret_data.swap(buffer);
+      return;
+    case StateCompression::LZO:
+      break;
+    default:
+      Core::DisplayMessage("State uses an unknown compression format", 2000);
+      return;
+    }
+
     lzo_uint i = 0;
     while (true)
     {
@@ -650,6 +900,8 @@ void Shutdown()
     std::lock_guard<std::mutex> lk(g_cs_undo_load_buffer);
     std::vector<u8>().swap(g_undo_load_buffer);
   }
+
+  ClearRewindBuffer();
 }
 
 static std::string MakeStateFilename(int number)
@@ -735,4 +987,245 @@ void UndoSaveState()
   LoadAs(File::GetUserPath(D_STATESAVES_IDX) + "lastState.sav");
 }
 
+// s_rewind_mutex must be locked.
+static void ResetRewindBuffer()
+{
+  s_rewind_deltas.clear();
+  s_rewind_deltas_size = 0;
+  std::vector<u8>().swap(s_rewind_reference);
+  std::vector<u8>().swap(s_rewind_ram_reference);
+  std::vector<u8>().swap(s_rewind_scratch);
+  s_rewind_frames_until_snapshot = 0;
+  s_rewind_snapshot_pending = false;
+}
+
+static size_t GetRewindDeltaSize(const RewindDelta& delta)
+{
+  return sizeof(RewindDelta) + (delta.state_pages.size() + delta.ram_pages.size()) * sizeof(u32) +
+         delta.compressed_data.size();
+}
+
+// The parts of the emulated RAM which are kept out of the serialized state, in the order they
+// are laid out in s_rewind_ram_reference. They are all multiples of the page size.
+static std::array<RewindRAMRegion, 3> GetRewindRAMRegions()
+{
+  return {{{Memory::m_pRAM, Memory::GetRamSize()},
+           {Memory::m_pFakeVMEM, Memory::m_pFakeVMEM ? Memory::GetFakeVMemSize() : 0},
+           {Memory::m_pEXRAM, SConfig::GetInstance().bWii ? Memory::GetExRamSize() : 0}}};
+}
+
+static void SaveRewindSnapshot()
+{
+  std::vector<u8>& snapshot = s_rewind_scratch;
+
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  DoState(p, false);
+  snapshot.resize(reinterpret_cast<size_t>(ptr));
+
+  ptr = snapshot.data();
+  p.SetMode(PointerWrap::MODE_WRITE);
+  DoState(p, false);
+  if (p.GetMode() != PointerWrap::MODE_WRITE)
+    return;
+
+  const auto ram_regions = GetRewindRAMRegions();
+  if (s_rewind_reference.empty())
+  {
+    s_rewind_reference.swap(snapshot);
+    s_rewind_ram_reference.clear();
+    for (const RewindRAMRegion& region : ram_regions)
+      s_rewind_ram_reference.insert(s_rewind_ram_reference.end(), region.data,
+                                    region.data + region.size);
+    return;
+  }
+
+  // Collect the pages of the previous snapshot that this one changed. Every page is stored whole,
+  // so that the RAM pages which follow the state pages are at fixed offsets.
+  const std::vector<u8>& previous = s_rewind_reference;
+  RewindDelta delta;
+  delta.state_size = previous.size();
+  std::vector<u8> page_data;
+  for (size_t offset = 0; offset < previous.size(); offset += REWIND_PAGE_SIZE)
+  {
+    const size_t length = std::min(REWIND_PAGE_SIZE, previous.size() - offset);
+    if (offset + length <= snapshot.size() &&
+        std::memcmp(&previous[offset], &snapshot[offset], length) == 0)
+    {
+      continue;
+    }
+
+    delta.state_pages.push_back(static_cast<u32>(offset / REWIND_PAGE_SIZE));
+    page_data.insert(page_data.end(), previous.begin() + offset,
+                     previous.begin() + offset + length);
+    page_data.resize(delta.state_pages.size() * REWIND_PAGE_SIZE);
+  }
+  s_rewind_reference.swap(snapshot);
+
+  // Only a small part of the RAM gets written between two snapshots. The copy of the RAM is
+  // brought up to date at the same time.
+  size_t base = 0;
+  for (const RewindRAMRegion& region : ram_regions)
+  {
+    for (size_t offset = 0; offset < region.size; offset += REWIND_PAGE_SIZE)
+    {
+      u8* const reference = &s_rewind_ram_reference[base + offset];
+      if (std::memcmp(reference, region.data + offset, REWIND_PAGE_SIZE) == 0)
+        continue;
+
+      delta.ram_pages.push_back(static_cast<u32>((base + offset) / REWIND_PAGE_SIZE));
+      page_data.insert(page_data.end(), reference, reference + REWIND_PAGE_SIZE);
+      std::memcpy(reference, region.data + offset, REWIND_PAGE_SIZE);
+    }
+    base += region.size;
+  }
+
+  lzo_uint compressed_size = 0;
+  delta.compressed_data.resize(page_data.size() + page_data.size() / 16 + 64 + 3);
+  if (lzo1x_1_compress(page_data.data(), page_data.size(), delta.compressed_data.data(),
+                       &compressed_size, s_rewind_wrkmem) != LZO_E_OK)
+  {
+    PanicAlertT("Internal LZO Error - compression failed");
+    ResetRewindBuffer();
+    return;
+  }
+  delta.compressed_data.resize(compressed_size);
+  delta.compressed_data.shrink_to_fit();
+
+  s_rewind_deltas_size += GetRewindDeltaSize(delta);
+  s_rewind_deltas.push_back(std::move(delta));
+
+  // The reference snapshot and the scratch buffer are as large as a full state together, so they
+  // count towards the budget as well.
+  const size_t max_size = static_cast<size_t>(Config::Get(Config::MAIN_REWIND_BUFFER_SIZE)) << 20;
+  const size_t fixed_size = s_rewind_reference.capacity() + s_rewind_ram_reference.capacity() +
+                            s_rewind_scratch.capacity();
+  while (!s_rewind_deltas.empty() && fixed_size + s_rewind_deltas_size > max_size)
+  {
+    s_rewind_deltas_size -= GetRewindDeltaSize(s_rewind_deltas.front());
+    s_rewind_deltas.pop_front();
+  }
+}
+
+static bool IsRewindAllowed()
+{
+  return Config::Get(Config::MAIN_REWIND_ENABLE) && !NetPlay::IsNetPlayRunning() &&
+         !Movie::IsMovieActive();
+}
+
+void UpdateRewindBuffer()
+{
+  if (!IsRewindAllowed())
+    return;
+
+  std::lock_guard<std::mutex> lk(s_rewind_mutex);
+  if (s_rewind_snapshot_pending || --s_rewind_frames_until_snapshot > 0)
+    return;
+
+  s_rewind_frames_until_snapshot = std::max(Config::Get(Config::MAIN_REWIND_INTERVAL), 1);
+  s_rewind_snapshot_pending = true;
+
+  // This is called from the VI event before it has been rescheduled, so the snapshot can't be
+  // taken here. Take it from the host thread instead, with the CPU and GPU paused like for any
+  // other savestate.
+  Core::QueueHostJob([] {
+    Core::RunAsCPUThread([] {
+      std::lock_guard<std::mutex> guard(s_rewind_mutex);
+      if (!s_rewind_snapshot_pending)
+        return;
+
+      s_rewind_snapshot_pending = false;
+      if (IsRewindAllowed())
+        SaveRewindSnapshot();
+    });
+  });
+}
+
+void Rewind()
+{
+  if (NetPlay::IsNetPlayRunning() || Movie::IsMovieActive())
+    return;
+
+  Core::RunOnCPUThread(
+      [] {
+        std::lock_guard<std::mutex> lk(s_rewind_mutex);
+        if (s_rewind_deltas.empty())
+          return;
+
+        const RewindDelta delta = std::move(s_rewind_deltas.back());
+        s_rewind_deltas.pop_back();
+        s_rewind_deltas_size -= GetRewindDeltaSize(delta);
+
+        std::vector<u8>& page_data = s_rewind_scratch;
+        page_data.resize((delta.state_pages.size() + delta.ram_pages.size()) * REWIND_PAGE_SIZE);
+        lzo_uint page_data_size = page_data.size();
+        if (lzo1x_decompress_safe(delta.compressed_data.data(), delta.compressed_data.size(),
+                                  page_data.data(), &page_data_size, nullptr) != LZO_E_OK)
+        {
+          PanicAlertT("Internal LZO Error - decompression failed");
+          ResetRewindBuffer();
+          return;
+        }
+
+        // Apply the delta to a copy, so the newer snapshot is still around if loading fails.
+        std::vector<u8> state(s_rewind_reference.begin(),
+                              s_rewind_reference.begin() +
+                                  std::min(delta.state_size, s_rewind_reference.size()));
+        state.resize(delta.state_size);
+        for (size_t i = 0; i < delta.state_pages.size(); i++)
+        {
+          const size_t offset = delta.state_pages[i] * REWIND_PAGE_SIZE;
+          const size_t length = std::min(REWIND_PAGE_SIZE, state.size() - offset);
+          std::memcpy(&state[offset], &page_data[i * REWIND_PAGE_SIZE], length);
+        }
+
+        // Copies the RAM of the reference snapshot into the emulated RAM. Like Memory::DoState,
+        // this happens after the video backend has had a chance to write back to RAM.
+        const auto restore_ram = [] {
+          size_t base = 0;
+          for (const RewindRAMRegion& region : GetRewindRAMRegions())
+          {
+            std::memcpy(region.data, &s_rewind_ram_reference[base], region.size);
+            base += region.size;
+          }
+        };
+
+        u8* ptr = state.data();
+        PointerWrap p(&ptr, PointerWrap::MODE_READ);
+        DoState(p, false);
+
+        if (p.GetMode() != PointerWrap::MODE_READ)
+        {
+          Core::DisplayMessage("The rewind snapshot could not be loaded", OSD::Duration::NORMAL);
+
+          // We could be in an inconsistent state now, so go back to the snapshot we started from.
+          ptr = s_rewind_reference.data();
+          PointerWrap undo(&ptr, PointerWrap::MODE_READ);
+          DoState(undo, false);
+          restore_ram();
+          ResetRewindBuffer();
+          return;
+        }
+
+        const u8* ram_page = &page_data[delta.state_pages.size() * REWIND_PAGE_SIZE];
+        for (u32 page : delta.ram_pages)
+        {
+          std::memcpy(&s_rewind_ram_reference[page * REWIND_PAGE_SIZE], ram_page, REWIND_PAGE_SIZE);
+          ram_page += REWIND_PAGE_SIZE;
+        }
+        restore_ram();
+
+        s_rewind_reference.swap(state);
+        s_rewind_frames_until_snapshot = REWIND_HOLD_OFF_FRAMES;
+        s_rewind_snapshot_pending = false;
+      },
+      true);
+}
+
+void ClearRewindBuffer()
+{
+  std::lock_guard<std::mutex> lk(s_rewind_mutex);
+  ResetRewindBuffer();
+}
+
 }  // namespace State
@@ -17,12 +17,24 @@ namespace State
 // number of states
 static const u32 NUM_STATES = 10;
 
+enum class StateCompression : u16
+{
+  LZO = 0,
+  Zstd = 1,
+};
+
 struct StateHeader
 {
   char gameID[6];
+  // One of the StateCompression values. Only meaningful for compressed states (non-zero size).
+  u16 compression;
   u32 size;
+  // Tells which of the fields above are valid. compression and version used to be padding, which
+  // older versions didn't initialize; ReadHeader treats those states as LZO compressed.
+  u32 version;
   double time;
 };
+static_assert(sizeof(StateHeader) == 24, "StateHeader must keep the layout of older versions");
 
 void Init();
 
@@ -55,6 +67,14 @@ void SaveFirstSaved();
 void UndoSaveState();
 void UndoLoadState();
 
+// Rewind support. While enabled, a snapshot of the emulated machine is taken every few frames and
+// kept in memory as the pages that differ from the following snapshot, up to a configurable size.
+// Called on the CPU thread at the end of every frame.
+void UpdateRewindBuffer();
+// Goes back to the previous snapshot.
+void Rewind();
+void ClearRewindBuffer();
+
 // wait until previously scheduled savestate event (if any) is done
 void Flush();
 
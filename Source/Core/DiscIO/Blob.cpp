@@ -58,65 +58,83 @@ std::string GetName(BlobType blob_type, bool translate)
 void SectorReader::SetSectorSize(int blocksize)
 {
   m_block_size = std::max(blocksize, 0);
-  for (auto& cache_entry : m_cache)
-  {
-    cache_entry.Reset();
-    cache_entry.data.resize(m_chunk_blocks * m_block_size);
-  }
+  ResetCache();
 }
 
 void SectorReader::SetChunkSize(int block_cnt)
 {
   m_chunk_blocks = std::max(block_cnt, 1);
-  // Clear cache and resize the data arrays
-  SetSectorSize(m_block_size);
+  ResetCache();
 }
 
 SectorReader::~SectorReader()
 {
 }
 
-const SectorReader::Cache* SectorReader::FindCacheLine(u64 block_num)
+void SectorReader::ResetCache()
 {
-  auto itr = std::find_if(m_cache.begin(), m_cache.end(),
-                          [&](const Cache& entry) { return entry.Contains(block_num); });
-  if (itr == m_cache.end())
+  const u64 line_size = std::max<u64>(u64(m_chunk_blocks) * m_block_size, 1);
+  const u64 max_sets = std::clamp<u64>(CACHE_SIZE / (CACHE_WAYS * line_size), 1, MAX_CACHE_SETS);
+
+  // Round down to a power of two, so that the set of a chunk is just its lowest bits.
+  m_cache_sets = 1;
+  while (m_cache_sets * 2 <= max_sets)
+    m_cache_sets *= 2;
+
+  m_cache.assign(m_cache_sets * CACHE_WAYS, CacheLine());
+  m_cache_data.reset();
+  m_cache_tick = 0;
+}
+
+const SectorReader::CacheLine* SectorReader::FindCacheLine(u64 block_num)
+{
+  const u64 set = block_num / m_chunk_blocks & (m_cache_sets - 1);
+  const auto begin = m_cache.begin() + set * CACHE_WAYS;
+  const auto itr = std::find_if(begin, begin + CACHE_WAYS,
+                                [&](const CacheLine& entry) { return entry.Contains(block_num); });
+  if (itr == begin + CACHE_WAYS)
     return nullptr;
 
-  itr->MarkUsed();
+  itr->last_used = ++m_cache_tick;
   return &*itr;
 }
 
-SectorReader::Cache* SectorReader::GetEmptyCacheLine()
+SectorReader::CacheLine* SectorReader::GetEmptyCacheLine(u64 chunk_num)
 {
-  Cache* oldest = &m_cache[0];
+  const u64 set = chunk_num & (m_cache_sets - 1);
+  const auto begin = m_cache.begin() + set * CACHE_WAYS;
   // Find the Least Recently Used cache line to replace.
-  std::for_each(m_cache.begin() + 1, m_cache.end(), [&](Cache& line) {
-    if (line.IsLessRecentlyUsedThan(*oldest))
-    {
-      oldest->ShiftLRU();
-      oldest = &line;
-      return;
-    }
-    line.ShiftLRU();
-  });
-  oldest->Reset();
-  return oldest;
+  CacheLine& oldest = *std::min_element(
+      begin, begin + CACHE_WAYS,
+      [](const CacheLine& a, const CacheLine& b) { return a.last_used < b.last_used; });
+  oldest = CacheLine();
+  return &oldest;
 }
 
-const SectorReader::Cache* SectorReader::GetCacheLine(u64 block_num)
+u8* SectorReader::GetCacheLineData(const CacheLine* line)
+{
+  const size_t line_size = size_t(m_chunk_blocks) * m_block_size;
+  if (!m_cache_data)
+    m_cache_data.reset(new u8[m_cache.size() * line_size]);
+
+  return m_cache_data.get() + (line - m_cache.data()) * line_size;
+}
+
+const SectorReader::CacheLine* SectorReader::GetCacheLine(u64 block_num)
 {
   if (auto entry = FindCacheLine(block_num))
     return entry;
 
   // Cache miss. Fault in the missing entry.
-  Cache* cache = GetEmptyCacheLine();
   // We only read aligned chunks, this avoids duplicate overlapping entries.
   u64 chunk_idx = block_num / m_chunk_blocks;
-  u32 blocks_read = ReadChunk(cache->data.data(), chunk_idx);
+  CacheLine* cache = GetEmptyCacheLine(chunk_idx);
+  u32 blocks_read = ReadChunk(GetCacheLineData(cache), chunk_idx);
   if (!blocks_read)
     return nullptr;
-  cache->Fill(chunk_idx * m_chunk_blocks, blocks_read);
+  cache->block_idx = chunk_idx * m_chunk_blocks;
+  cache->num_blocks = blocks_read;
+  cache->last_used = ++m_cache_tick;
 
   // Secondary check for out-of-bounds read.
   // If we got less than m_chunk_blocks, we may still have missed.
@@ -130,6 +148,7 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
   if (offset + size > GetDataSize())
     return false;
 
+  const u64 chunk_size = u64(m_chunk_blocks) * m_block_size;
   u64 remain = size;
   u64 block = 0;
   u32 position_in_block = static_cast<u32>(offset % m_block_size);
@@ -138,7 +157,28 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
   {
     block = offset / m_block_size;
 
-    const Cache* cache = GetCacheLine(block);
+    // Whole chunks that aren't cached are read straight into the output. This saves a copy, and
+    // keeps large reads from pushing everything else out of the cache.
+    if (position_in_block == 0 && block % m_chunk_blocks == 0)
+    {
+      u64 num_blocks = 0;
+      while (remain - num_blocks * m_block_size >= chunk_size &&
+             !FindCacheLine(block + num_blocks))
+      {
+        num_blocks += m_chunk_blocks;
+      }
+
+      if (num_blocks != 0 && ReadMultipleAlignedBlocks(block, num_blocks, out_ptr))
+      {
+        const u64 bytes_read = num_blocks * m_block_size;
+        offset += bytes_read;
+        out_ptr += bytes_read;
+        remain -= bytes_read;
+        continue;
+      }
+    }
+
+    const CacheLine* cache = GetCacheLine(block);
     if (!cache)
       return false;
 
@@ -147,8 +187,8 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
     u32 can_read = m_block_size * cache->num_blocks - read_offset;
     u32 was_read = static_cast<u32>(std::min<u64>(can_read, remain));
 
-    std::copy(cache->data.begin() + read_offset, cache->data.begin() + read_offset + was_read,
-              out_ptr);
+    const u8* data = GetCacheLineData(cache);
+    std::copy(data + read_offset, data + read_offset + was_read, out_ptr);
 
     offset += was_read;
     out_ptr += was_read;
@@ -244,7 +284,7 @@ std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename)
     if (auto directory_blob = DirectoryBlobReader::Create(filename))
       return std::move(directory_blob);
 
-    return PlainFileReader::Create(std::move(file));
+    return PlainFileReader::Create(std::move(file), filename);
   }
 }
 
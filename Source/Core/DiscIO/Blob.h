@@ -114,52 +114,30 @@ protected:
   virtual bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr);
 
 private:
-  struct Cache
+  struct CacheLine
   {
-    std::vector<u8> data;
     u64 block_idx = 0;
     u32 num_blocks = 0;
+    // The value of m_cache_tick when the line was last used. Empty lines are used first.
+    u64 last_used = 0;
 
-    // [Pseudo-] Least Recently Used Shift Register
-    // When an empty cache line is needed, the line with the lowest value
-    // is taken and reset; the LRU register is then shifted down 1 place
-    // on all lines (low bit discarded). When a line is used, the high bit
-    // is set marking it as most recently used.
-    u32 lru_sreg = 0;
-
-    void Reset()
-    {
-      block_idx = 0;
-      num_blocks = 0;
-      lru_sreg = 0;
-    }
-    void Fill(u64 block, u32 count)
-    {
-      block_idx = block;
-      num_blocks = count;
-      // NOTE: Setting only the high bit means the newest line will
-      //   be selected for eviction if every line in the cache was
-      //   touched. This gives MRU behavior which is probably
-      //   desirable in that case.
-      MarkUsed();
-    }
     bool Contains(u64 block) const { return block >= block_idx && block - block_idx < num_blocks; }
-    void MarkUsed() { lru_sreg |= 0x80000000; }
-    void ShiftLRU() { lru_sreg >>= 1; }
-    bool IsLessRecentlyUsedThan(const Cache& other) const { return lru_sreg < other.lru_sreg; }
   };
 
   // Gets the cache line that contains the given block, or nullptr.
   // NOTE: The cache record only lasts until it expires (next GetEmptyCacheLine)
-  const Cache* FindCacheLine(u64 block_num);
+  const CacheLine* FindCacheLine(u64 block_num);
 
-  // Finds the least recently used cache line, resets and returns it.
-  Cache* GetEmptyCacheLine();
+  // Finds the least recently used cache line of the set that the chunk belongs to, resets and
+  // returns it.
+  CacheLine* GetEmptyCacheLine(u64 chunk_num);
 
   // Combines FindCacheLine with GetEmptyCacheLine and ReadChunk.
   // Always returns a valid cache line (loading the data if needed).
   // May return nullptr only if the cache missed and the read failed.
-  const Cache* GetCacheLine(u64 block_num);
+  const CacheLine* GetCacheLine(u64 block_num);
+
+  u8* GetCacheLineData(const CacheLine* line);
 
   // Read all bytes from a chunk of blocks into a buffer.
   // Returns the number of blocks read (may be less than m_chunk_blocks
@@ -167,10 +145,22 @@ private:
   // evenly divisible into chunks). Returns zero if it fails.
   u32 ReadChunk(u8* buffer, u64 chunk_num);
 
-  static constexpr int CACHE_LINES = 32;
+  // Empties the cache and sizes it for the current chunk size.
+  void ResetCache();
+
+  // The cache is set-associative: A chunk can only be stored in the CACHE_WAYS lines of the set
+  // that its chunk number maps to, so a lookup only has to check those lines. As many sets are
+  // used as fit in CACHE_SIZE bytes, up to MAX_CACHE_SETS.
+  static constexpr u32 CACHE_WAYS = 4;
+  static constexpr u32 MAX_CACHE_SETS = 64;
+  static constexpr u64 CACHE_SIZE = 0x1000000;
   u32 m_block_size = 0;    // Bytes in a sector/block
   u32 m_chunk_blocks = 1;  // Number of sectors/blocks in a chunk
-  std::array<Cache, CACHE_LINES> m_cache;
+  u32 m_cache_sets = 1;
+  u64 m_cache_tick = 0;
+  std::vector<CacheLine> m_cache;
+  // Allocated on the first cache miss, since many readers only ever read the disc header.
+  std::unique_ptr<u8[]> m_cache_data;
 };
 
 // Factory function - examines the path to choose the right type of BlobReader, and returns one.
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -15,21 +16,36 @@
 
 namespace DiscIO
 {
-PlainFileReader::PlainFileReader(File::IOFile file) : m_file(std::move(file))
+PlainFileReader::PlainFileReader(File::IOFile file, const std::string& path)
+    : m_file(std::move(file)), m_mapping(path)
 {
   m_size = m_file.GetSize();
+
+  // Don't trust the mapping if the file was replaced in the meantime.
+  if (m_mapping && m_mapping.GetSize() != static_cast<u64>(m_size))
+    m_mapping.Close();
 }
 
-std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
+std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file,
+                                                         const std::string& path)
 {
   if (file)
-    return std::unique_ptr<PlainFileReader>(new PlainFileReader(std::move(file)));
+    return std::unique_ptr<PlainFileReader>(new PlainFileReader(std::move(file), path));
 
   return nullptr;
 }
 
 bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
 {
+  if (m_mapping)
+  {
+    if (offset > m_mapping.GetSize() || nbytes > m_mapping.GetSize() - offset)
+      return false;
+
+    std::memcpy(out_ptr, m_mapping.GetData() + offset, nbytes);
+    return true;
+  }
+
   if (m_file.Seek(offset, SEEK_SET) && m_file.ReadBytes(out_ptr, nbytes))
   {
     return true;
@@ -10,6 +10,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
+#include "Common/MappedFile.h"
 #include "DiscIO/Blob.h"
 
 namespace DiscIO
@@ -17,7 +18,7 @@ namespace DiscIO
 class PlainFileReader : public BlobReader
 {
 public:
-  static std::unique_ptr<PlainFileReader> Create(File::IOFile file);
+  static std::unique_ptr<PlainFileReader> Create(File::IOFile file, const std::string& path);
 
   BlobType GetBlobType() const override { return BlobType::PLAIN; }
 
@@ -32,9 +33,11 @@ public:
   bool Read(u64 offset, u64 nbytes, u8* out_ptr) override;
 
 private:
-  PlainFileReader(File::IOFile file);
+  PlainFileReader(File::IOFile file, const std::string& path);
 
   File::IOFile m_file;
+  // If the file could be mapped, reads are copied straight out of the mapping instead.
+  Common::MappedFile m_mapping;
   s64 m_size;
 };
 
@@ -126,7 +126,11 @@ public:
   virtual bool IsNKit() const = 0;
   virtual bool SupportsIntegrityCheck() const { return false; }
   virtual bool CheckH3TableIntegrity(const Partition& partition) const { return false; }
-  virtual bool CheckBlockIntegrity(u64 block_index, const std::vector<u8>& encrypted_data,
+  // Loads what CheckBlockIntegrity needs for the partition. Until this has been called,
+  // CheckBlockIntegrity must not be called for the partition from several threads at once.
+  virtual void PrepareBlockIntegrityCheck(const Partition& partition) const {}
+  // encrypted_data must contain a whole block (VolumeWii::BLOCK_TOTAL_SIZE bytes)
+  virtual bool CheckBlockIntegrity(u64 block_index, const u8* encrypted_data,
                                    const Partition& partition) const
   {
     return false;
@@ -144,6 +148,7 @@ public:
   // Size on disc (compressed size)
   virtual u64 GetRawSize() const = 0;
   virtual const BlobReader& GetBlobReader() const = 0;
+  virtual BlobReader& GetBlobReader() = 0;
 
   // This hash is intended to be (but is not guaranteed to be):
   // 1. Identical for discs with no differences that affect netplay/TAS sync
@@ -129,6 +129,11 @@ const BlobReader& VolumeGC::GetBlobReader() const
   return *m_reader;
 }
 
+BlobReader& VolumeGC::GetBlobReader()
+{
+  return *m_reader;
+}
+
 Platform VolumeGC::GetVolumeType() const
 {
   return Platform::GameCubeDisc;
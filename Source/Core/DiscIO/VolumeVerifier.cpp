@@ -17,7 +17,6 @@
 #include <unordered_set>
 
 #include <mbedtls/md5.h>
-#include <mbedtls/sha1.h>
 #include <pugixml.hpp>
 #include <unzip.h>
 #include <zlib.h>
@@ -26,6 +25,7 @@
 #include "Common/Assert.h"
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
 #include "Common/HttpRequest.h"
@@ -361,7 +361,30 @@ constexpr u64 SL_DVD_R_SIZE = 4707319808;  // Wii RVT-R
 constexpr u64 DL_DVD_SIZE = 8511160320;    // Wii retail
 constexpr u64 DL_DVD_R_SIZE = 8543666176;  // Wii RVT-R
 
-constexpr u64 BLOCK_SIZE = 0x20000;
+// Big enough for the CRC32 to be split into a shard for each core
+constexpr u64 BLOCK_SIZE = 0x200000;
+constexpr u64 CRC32_SHARD_SIZE = 0x20000;
+
+// CRC32s of consecutive pieces of data can be combined, so unlike MD5 and SHA-1,
+// the CRC32 of a chunk can be calculated on several threads. It shares the threads which check the
+// blocks of Wii partitions, so that the two don't compete for the cores.
+static unsigned long UpdateCRC32(unsigned long crc, const u8* data, size_t size)
+{
+  const size_t num_shards = Common::AlignUp(size, CRC32_SHARD_SIZE) / CRC32_SHARD_SIZE;
+  std::vector<unsigned long> shard_crcs(num_shards);
+  VolumeWii::ProcessBlocksInParallel(num_shards, [&](size_t i) {
+    const size_t shard_size = std::min<size_t>(CRC32_SHARD_SIZE, size - i * CRC32_SHARD_SIZE);
+    // It would be nice to use crc32_z here instead of crc32, but it isn't available on Android
+    shard_crcs[i] = crc32(0, data + i * CRC32_SHARD_SIZE, static_cast<unsigned int>(shard_size));
+  });
+
+  for (size_t i = 0; i < num_shards; ++i)
+  {
+    const size_t shard_size = std::min<size_t>(CRC32_SHARD_SIZE, size - i * CRC32_SHARD_SIZE);
+    crc = crc32_combine(crc, shard_crcs[i], static_cast<z_off_t>(shard_size));
+  }
+  return crc;
+}
 
 VolumeVerifier::VolumeVerifier(const Volume& volume, bool redump_verification,
                                Hashes<bool> hashes_to_calculate)
@@ -599,6 +622,9 @@ bool VolumeVerifier::CheckPartition(const Partition& partition)
       m_blocks.emplace_back(BlockToVerify{partition, offset, i});
 
     m_block_errors.emplace(partition, 0);
+
+    // The blocks are checked in parallel later on
+    m_volume.PrepareBlockIntegrityCheck(partition);
   }
 
   const DiscIO::FileSystem* filesystem = m_volume.GetFileSystem(partition);
@@ -1074,10 +1100,7 @@ void VolumeVerifier::SetUpHashing()
   }
 
   if (m_hashes_to_calculate.sha1)
-  {
-    mbedtls_sha1_init(&m_sha1_context);
-    mbedtls_sha1_starts_ret(&m_sha1_context);
-  }
+    m_sha1_context = std::make_unique<Common::SHA1::Context>();
 }
 
 void VolumeVerifier::WaitForAsyncOperations() const
@@ -1096,15 +1119,15 @@ void VolumeVerifier::WaitForAsyncOperations() const
 
 bool VolumeVerifier::ReadChunkAndWaitForAsyncOperations(u64 bytes_to_read)
 {
-  std::vector<u8> data(bytes_to_read);
+  m_read_buffer.resize(bytes_to_read);
   {
     std::lock_guard lk(m_volume_mutex);
-    if (!m_volume.Read(m_progress, bytes_to_read, data.data(), PARTITION_NONE))
+    if (!m_volume.Read(m_progress, bytes_to_read, m_read_buffer.data(), PARTITION_NONE))
       return false;
   }
 
   WaitForAsyncOperations();
-  m_data = std::move(data);
+  std::swap(m_data, m_read_buffer);
   return true;
 }
 
@@ -1134,7 +1157,16 @@ void VolumeVerifier::Process()
   }
   else if (m_block_index < m_blocks.size() && m_blocks[m_block_index].offset == m_progress)
   {
-    bytes_to_read = VolumeWii::BLOCK_TOTAL_SIZE;
+    // Read up to a group of consecutive blocks at once so that they can be checked in parallel
+    size_t blocks_to_read = 1;
+    while (blocks_to_read < VolumeWii::BLOCKS_PER_GROUP &&
+           m_block_index + blocks_to_read < m_blocks.size() &&
+           m_blocks[m_block_index + blocks_to_read].offset ==
+               m_progress + blocks_to_read * VolumeWii::BLOCK_TOTAL_SIZE)
+    {
+      blocks_to_read++;
+    }
+    bytes_to_read = blocks_to_read * VolumeWii::BLOCK_TOTAL_SIZE;
     block_read = true;
   }
   else if (m_block_index < m_blocks.size() && m_blocks[m_block_index].offset > m_progress)
@@ -1160,9 +1192,7 @@ void VolumeVerifier::Process()
     if (m_hashes_to_calculate.crc32)
     {
       m_crc32_future = std::async(std::launch::async, [this] {
-        // It would be nice to use crc32_z here instead of crc32, but it isn't available on Android
-        m_crc32_context =
-            crc32(m_crc32_context, m_data.data(), static_cast<unsigned int>(m_data.size()));
+        m_crc32_context = UpdateCRC32(m_crc32_context, m_data.data(), m_data.size());
       });
     }
 
@@ -1175,9 +1205,8 @@ void VolumeVerifier::Process()
 
     if (m_hashes_to_calculate.sha1)
     {
-      m_sha1_future = std::async(std::launch::async, [this] {
-        mbedtls_sha1_update_ret(&m_sha1_context, m_data.data(), m_data.size());
-      });
+      m_sha1_future = std::async(std::launch::async,
+                                 [this] { m_sha1_context->Update(m_data.data(), m_data.size()); });
     }
   }
 
@@ -1200,25 +1229,44 @@ void VolumeVerifier::Process()
   {
     m_block_future = std::async(
         std::launch::async,
-        [this, read_succeeded, bytes_to_read](size_t block_index, u64 progress) {
-          while (block_index < m_blocks.size() &&
-                 m_blocks[block_index].offset < progress + bytes_to_read)
+        [this, read_succeeded, bytes_to_read](size_t first_block_index, u64 progress) {
+          size_t end_block_index = first_block_index;
+          while (end_block_index < m_blocks.size() &&
+                 m_blocks[end_block_index].offset < progress + bytes_to_read)
           {
-            bool success;
-            if (m_blocks[block_index].offset == progress)
+            end_block_index++;
+          }
+
+          const auto is_in_data = [&](const BlockToVerify& block) {
+            return read_succeeded &&
+                   block.offset + VolumeWii::BLOCK_TOTAL_SIZE <= progress + m_data.size();
+          };
+
+          // Blocks that were read along with m_data are checked in parallel. Blocks that extend
+          // past the end of m_data have to be read separately.
+          std::vector<u8> results(end_block_index - first_block_index);
+          VolumeWii::ProcessBlocksInParallel(results.size(), [&](size_t i) {
+            const BlockToVerify& block = m_blocks[first_block_index + i];
+            if (is_in_data(block))
             {
-              success = read_succeeded &&
-                        m_volume.CheckBlockIntegrity(m_blocks[block_index].block_index, m_data,
-                                                     m_blocks[block_index].partition);
+              results[i] = m_volume.CheckBlockIntegrity(
+                  block.block_index, m_data.data() + (block.offset - progress), block.partition);
             }
-            else
+          });
+
+          for (size_t block_index = first_block_index; block_index < end_block_index;
+               ++block_index)
+          {
+            const BlockToVerify& block = m_blocks[block_index];
+
+            bool success = results[block_index - first_block_index];
+            if (!is_in_data(block))
             {
               std::lock_guard lk(m_volume_mutex);
-              success = m_volume.CheckBlockIntegrity(m_blocks[block_index].block_index,
-                                                     m_blocks[block_index].partition);
+              success = m_volume.CheckBlockIntegrity(block.block_index, block.partition);
             }
 
-            const u64 offset = m_blocks[block_index].offset;
+            const u64 offset = block.offset;
             if (success)
             {
               m_biggest_verified_offset =
@@ -1229,15 +1277,14 @@ void VolumeVerifier::Process()
               if (m_scrubber.CanBlockBeScrubbed(offset))
               {
                 WARN_LOG(DISCIO, "Integrity check failed for unused block at 0x%" PRIx64, offset);
-                m_unused_block_errors[m_blocks[block_index].partition]++;
+                m_unused_block_errors[block.partition]++;
               }
               else
               {
                 WARN_LOG(DISCIO, "Integrity check failed for block at 0x%" PRIx64, offset);
-                m_block_errors[m_blocks[block_index].partition]++;
+                m_block_errors[block.partition]++;
               }
             }
-            block_index++;
           }
         },
         m_block_index, m_progress);
@@ -1288,8 +1335,8 @@ void VolumeVerifier::Finish()
 
     if (m_hashes_to_calculate.sha1)
     {
-      m_result.hashes.sha1 = std::vector<u8>(20);
-      mbedtls_sha1_finish_ret(&m_sha1_context, m_result.hashes.sha1.data());
+      const Common::SHA1::Digest sha1 = m_sha1_context->Finish();
+      m_result.hashes.sha1 = std::vector<u8>(sha1.begin(), sha1.end());
     }
   }
 
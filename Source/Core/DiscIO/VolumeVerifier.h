@@ -6,15 +6,16 @@
 
 #include <future>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include <mbedtls/md5.h>
-#include <mbedtls/sha1.h>
 
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
 #include "Core/IOS/ES/Formats.h"
 #include "DiscIO/DiscScrubber.h"
 #include "DiscIO/Volume.h"
@@ -179,9 +180,12 @@ private:
   bool m_calculating_any_hash = false;
   unsigned long m_crc32_context = 0;
   mbedtls_md5_context m_md5_context;
-  mbedtls_sha1_context m_sha1_context;
+  std::unique_ptr<Common::SHA1::Context> m_sha1_context;
 
+  // The chunk that the asynchronous operations work on, and the buffer that the next chunk is read
+  // into while they run
   std::vector<u8> m_data;
+  std::vector<u8> m_read_buffer;
   std::mutex m_volume_mutex;
   std::future<void> m_crc32_future;
   std::future<void> m_md5_future;
@@ -8,24 +8,24 @@
 #include <array>
 #include <cstddef>
 #include <cstring>
-#include <future>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
-#include <thread>
 #include <utility>
 #include <vector>
 
-#include <mbedtls/aes.h>
 #include <mbedtls/sha1.h>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+#include "Common/Crypto/SHA1.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscExtractor.h"
@@ -37,6 +37,13 @@
 
 namespace DiscIO
 {
+static Common::ThreadPool& GetGroupThreadPool()
+{
+  static Common::ThreadPool pool(Common::ThreadPool::GetDefaultNumWorkers(),
+                                 "Wii Group Processing");
+  return pool;
+}
+
 VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
     : m_reader(std::move(reader)), m_game_partition(PARTITION_NONE),
       m_last_decrypted_block(UINT64_MAX)
@@ -126,14 +133,12 @@ VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
         return h3_table;
       };
 
-      auto get_key = [this, partition]() -> std::unique_ptr<mbedtls_aes_context> {
+      auto get_key = [this, partition]() -> std::unique_ptr<Common::AES::Context> {
         const IOS::ES::TicketReader& ticket = *m_partitions[partition].ticket;
         if (!ticket.IsValid())
           return nullptr;
         const std::array<u8, AES_KEY_SIZE> key = ticket.GetTitleKey();
-        std::unique_ptr<mbedtls_aes_context> aes_context = std::make_unique<mbedtls_aes_context>();
-        mbedtls_aes_setkey_dec(aes_context.get(), key.data(), 128);
-        return aes_context;
+        return Common::AES::CreateContext(key.data(), Common::AES::Mode::Decrypt);
       };
 
       auto get_file_system = [this, partition]() -> std::unique_ptr<FileSystem> {
@@ -146,7 +151,7 @@ VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
       };
 
       m_partitions.emplace(
-          partition, PartitionDetails{Common::Lazy<std::unique_ptr<mbedtls_aes_context>>(get_key),
+          partition, PartitionDetails{Common::Lazy<std::unique_ptr<Common::AES::Context>>(get_key),
                                       Common::Lazy<IOS::ES::TicketReader>(get_ticket),
                                       Common::Lazy<IOS::ES::TMDReader>(get_tmd),
                                       Common::Lazy<std::vector<u8>>(get_cert_chain),
@@ -181,7 +186,7 @@ bool VolumeWii::Read(u64 offset, u64 length, u8* buffer, const Partition& partit
                           buffer);
   }
 
-  mbedtls_aes_context* aes_context = partition_details.key->get();
+  const Common::AES::Context* aes_context = partition_details.key->get();
   if (!aes_context)
     return false;
 
@@ -193,6 +198,27 @@ bool VolumeWii::Read(u64 offset, u64 length, u8* buffer, const Partition& partit
                                offset / BLOCK_DATA_SIZE * BLOCK_TOTAL_SIZE;
     u64 data_offset_in_block = offset % BLOCK_DATA_SIZE;
 
+    // Whole blocks are read together and decrypted straight into the buffer in parallel, up to a
+    // group at a time.
+    const u64 whole_blocks = data_offset_in_block == 0 ? length / BLOCK_DATA_SIZE : 0;
+    if (whole_blocks >= 2)
+    {
+      const size_t num_blocks = static_cast<size_t>(std::min<u64>(whole_blocks, BLOCKS_PER_GROUP));
+      read_buffer.resize(num_blocks * BLOCK_TOTAL_SIZE);
+      if (!m_reader->Read(block_offset_on_disc, read_buffer.size(), read_buffer.data()))
+        return false;
+
+      ProcessBlocksInParallel(num_blocks, [&](size_t i) {
+        DecryptBlockData(read_buffer.data() + i * BLOCK_TOTAL_SIZE, buffer + i * BLOCK_DATA_SIZE,
+                         aes_context);
+      });
+
+      length -= num_blocks * BLOCK_DATA_SIZE;
+      buffer += num_blocks * BLOCK_DATA_SIZE;
+      offset += num_blocks * BLOCK_DATA_SIZE;
+      continue;
+    }
+
     if (m_last_decrypted_block != block_offset_on_disc)
     {
       // Read the current block
@@ -362,6 +388,11 @@ const BlobReader& VolumeWii::GetBlobReader() const
   return *m_reader;
 }
 
+BlobReader& VolumeWii::GetBlobReader()
+{
+  return *m_reader;
+}
+
 std::array<u8, 20> VolumeWii::GetSyncHash() const
 {
   mbedtls_sha1_context context;
@@ -413,12 +444,22 @@ bool VolumeWii::CheckH3TableIntegrity(const Partition& partition) const
   return h3_table_sha1 == contents[0].sha1;
 }
 
-bool VolumeWii::CheckBlockIntegrity(u64 block_index, const std::vector<u8>& encrypted_data,
-                                    const Partition& partition) const
+void VolumeWii::PrepareBlockIntegrityCheck(const Partition& partition) const
 {
-  if (encrypted_data.size() != BLOCK_TOTAL_SIZE)
-    return false;
+  auto it = m_partitions.find(partition);
+  if (it == m_partitions.end())
+    return;
+  const PartitionDetails& partition_details = it->second;
+
+  // The lazily loaded values aren't safe to load from several threads at once. Read doesn't load
+  // the key for blobs which support ReadWiiDecrypted, so it has to be loaded here.
+  partition_details.h3_table->size();
+  partition_details.key->get();
+}
 
+bool VolumeWii::CheckBlockIntegrity(u64 block_index, const u8* encrypted_data,
+                                    const Partition& partition) const
+{
   auto it = m_partitions.find(partition);
   if (it == m_partitions.end())
     return false;
@@ -427,36 +468,36 @@ bool VolumeWii::CheckBlockIntegrity(u64 block_index, const std::vector<u8>& encr
   if (block_index / BLOCKS_PER_GROUP * SHA1_SIZE >= partition_details.h3_table->size())
     return false;
 
-  mbedtls_aes_context* aes_context = partition_details.key->get();
+  const Common::AES::Context* aes_context = partition_details.key->get();
   if (!aes_context)
     return false;
 
   HashBlock hashes;
-  DecryptBlockHashes(encrypted_data.data(), &hashes, aes_context);
+  DecryptBlockHashes(encrypted_data, &hashes, aes_context);
 
   u8 cluster_data[BLOCK_DATA_SIZE];
-  DecryptBlockData(encrypted_data.data(), cluster_data, aes_context);
+  DecryptBlockData(encrypted_data, cluster_data, aes_context);
 
   for (u32 hash_index = 0; hash_index < 31; ++hash_index)
   {
     u8 h0_hash[SHA1_SIZE];
-    mbedtls_sha1_ret(cluster_data + hash_index * 0x400, 0x400, h0_hash);
+    Common::SHA1::CalculateDigest(cluster_data + hash_index * 0x400, 0x400, h0_hash);
     if (memcmp(h0_hash, hashes.h0[hash_index], SHA1_SIZE))
       return false;
   }
 
   u8 h1_hash[SHA1_SIZE];
-  mbedtls_sha1_ret(reinterpret_cast<u8*>(hashes.h0), sizeof(hashes.h0), h1_hash);
+  Common::SHA1::CalculateDigest(reinterpret_cast<u8*>(hashes.h0), sizeof(hashes.h0), h1_hash);
   if (memcmp(h1_hash, hashes.h1[block_index % 8], SHA1_SIZE))
     return false;
 
   u8 h2_hash[SHA1_SIZE];
-  mbedtls_sha1_ret(reinterpret_cast<u8*>(hashes.h1), sizeof(hashes.h1), h2_hash);
+  Common::SHA1::CalculateDigest(reinterpret_cast<u8*>(hashes.h1), sizeof(hashes.h1), h2_hash);
   if (memcmp(h2_hash, hashes.h2[block_index / 8 % 8], SHA1_SIZE))
     return false;
 
   u8 h3_hash[SHA1_SIZE];
-  mbedtls_sha1_ret(reinterpret_cast<u8*>(hashes.h2), sizeof(hashes.h2), h3_hash);
+  Common::SHA1::CalculateDigest(reinterpret_cast<u8*>(hashes.h2), sizeof(hashes.h2), h3_hash);
   if (memcmp(h3_hash, partition_details.h3_table->data() + block_index / 64 * SHA1_SIZE, SHA1_SIZE))
     return false;
 
@@ -475,80 +516,65 @@ bool VolumeWii::CheckBlockIntegrity(u64 block_index, const Partition& partition)
   std::vector<u8> cluster(BLOCK_TOTAL_SIZE);
   if (!m_reader->Read(cluster_offset, cluster.size(), cluster.data()))
     return false;
-  return CheckBlockIntegrity(block_index, cluster, partition);
+  return CheckBlockIntegrity(block_index, cluster.data(), partition);
+}
+
+void VolumeWii::ProcessBlocksInParallel(size_t num_blocks,
+                                        const std::function<void(size_t block)>& func)
+{
+  GetGroupThreadPool().ParallelFor(num_blocks, func);
 }
 
 bool VolumeWii::HashGroup(const std::array<u8, BLOCK_DATA_SIZE> in[BLOCKS_PER_GROUP],
                           HashBlock out[BLOCKS_PER_GROUP],
                           const std::function<bool(size_t block)>& read_function)
 {
-  std::array<std::future<void>, BLOCKS_PER_GROUP> hash_futures;
-  bool success = true;
-
-  for (size_t i = 0; i < BLOCKS_PER_GROUP; ++i)
+  if (read_function)
   {
-    if (read_function && success)
-      success = read_function(i);
-
-    hash_futures[i] = std::async(std::launch::async, [&in, &out, &hash_futures, success, i]() {
-      const size_t h1_base = Common::AlignDown(i, 8);
-
-      if (success)
-      {
-        // H0 hashes
-        for (size_t j = 0; j < 31; ++j)
-          mbedtls_sha1_ret(in[i].data() + j * 0x400, 0x400, out[i].h0[j]);
-
-        // H0 padding
-        std::memset(out[i].padding_0, 0, sizeof(HashBlock::padding_0));
-
-        // H1 hash
-        mbedtls_sha1_ret(reinterpret_cast<u8*>(out[i].h0), sizeof(HashBlock::h0),
-                         out[h1_base].h1[i - h1_base]);
-      }
+    for (size_t i = 0; i < BLOCKS_PER_GROUP; ++i)
+    {
+      if (!read_function(i))
+        return false;
+    }
+  }
 
-      if (i % 8 == 7)
-      {
-        for (size_t j = 0; j < 7; ++j)
-          hash_futures[h1_base + j].get();
+  ProcessBlocksInParallel(BLOCKS_PER_GROUP, [&in, &out](size_t i) {
+    const size_t h1_base = Common::AlignDown(i, 8);
 
-        if (success)
-        {
-          // H1 padding
-          std::memset(out[h1_base].padding_1, 0, sizeof(HashBlock::padding_1));
+    // H0 hashes
+    for (size_t j = 0; j < 31; ++j)
+      Common::SHA1::CalculateDigest(in[i].data() + j * 0x400, 0x400, out[i].h0[j]);
 
-          // H1 copies
-          for (size_t j = 1; j < 8; ++j)
-            std::memcpy(out[h1_base + j].h1, out[h1_base].h1, sizeof(HashBlock::h1));
+    // H0 padding
+    std::memset(out[i].padding_0, 0, sizeof(HashBlock::padding_0));
 
-          // H2 hash
-          mbedtls_sha1_ret(reinterpret_cast<u8*>(out[i].h1), sizeof(HashBlock::h1),
-                           out[0].h2[h1_base / 8]);
-        }
+    // H1 hash
+    Common::SHA1::CalculateDigest(reinterpret_cast<u8*>(out[i].h0), sizeof(HashBlock::h0),
+                                  out[h1_base].h1[i - h1_base]);
+  });
 
-        if (i == BLOCKS_PER_GROUP - 1)
-        {
-          for (size_t j = 0; j < 7; ++j)
-            hash_futures[j * 8 + 7].get();
+  for (size_t h1_base = 0; h1_base < BLOCKS_PER_GROUP; h1_base += 8)
+  {
+    // H1 padding
+    std::memset(out[h1_base].padding_1, 0, sizeof(HashBlock::padding_1));
 
-          if (success)
-          {
-            // H2 padding
-            std::memset(out[0].padding_2, 0, sizeof(HashBlock::padding_2));
+    // H1 copies
+    for (size_t j = 1; j < 8; ++j)
+      std::memcpy(out[h1_base + j].h1, out[h1_base].h1, sizeof(HashBlock::h1));
 
-            // H2 copies
-            for (size_t j = 1; j < BLOCKS_PER_GROUP; ++j)
-              std::memcpy(out[j].h2, out[0].h2, sizeof(HashBlock::h2));
-          }
-        }
-      }
-    });
+    // H2 hash
+    Common::SHA1::CalculateDigest(reinterpret_cast<u8*>(out[h1_base].h1), sizeof(HashBlock::h1),
+                                  out[0].h2[h1_base / 8]);
   }
 
-  // Wait for all the async tasks to finish
-  hash_futures.back().get();
+  // H2 padding
+  std::memset(out[0].padding_2, 0, sizeof(HashBlock::padding_2));
+
+  // H2 copies
+  for (size_t j = 1; j < BLOCKS_PER_GROUP; ++j)
+    std::memcpy(out[j].h2, out[0].h2, sizeof(HashBlock::h2));
 
-  return success;
+  return true;
 }
 
 bool VolumeWii::EncryptGroup(
@@ -583,55 +609,49 @@ bool VolumeWii::EncryptGroup(
   if (hash_exception_callback)
     hash_exception_callback(unencrypted_hashes.data());
 
-  const unsigned int threads =
-      std::min(BLOCKS_PER_GROUP, std::max<unsigned int>(1, std::thread::hardware_concurrency()));
+  const std::unique_ptr<Common::AES::Context> aes_context =
+      Common::AES::CreateContext(key.data(), Common::AES::Mode::Encrypt);
 
-  std::vector<std::future<void>> encryption_futures(threads);
+  ProcessBlocksInParallel(BLOCKS_PER_GROUP, [&](size_t i) {
+    u8* out_ptr = out->data() + i * BLOCK_TOTAL_SIZE;
 
-  mbedtls_aes_context aes_context;
-  mbedtls_aes_setkey_enc(&aes_context, key.data(), 128);
+    u8 iv[16] = {};
+    aes_context->Crypt(iv, reinterpret_cast<const u8*>(&unencrypted_hashes[i]), out_ptr,
+                       BLOCK_HEADER_SIZE);
 
-  for (size_t i = 0; i < threads; ++i)
-  {
-    encryption_futures[i] = std::async(
-        std::launch::async,
-        [&unencrypted_data, &unencrypted_hashes, &aes_context, &out](size_t start, size_t end) {
-          for (size_t j = start; j < end; ++j)
-          {
-            u8* out_ptr = out->data() + j * BLOCK_TOTAL_SIZE;
-
-            u8 iv[16] = {};
-            mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_ENCRYPT, BLOCK_HEADER_SIZE, iv,
-                                  reinterpret_cast<u8*>(&unencrypted_hashes[j]), out_ptr);
-
-            std::memcpy(iv, out_ptr + 0x3D0, sizeof(iv));
-            mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_ENCRYPT, BLOCK_DATA_SIZE, iv,
-                                  unencrypted_data[j].data(), out_ptr + BLOCK_HEADER_SIZE);
-          }
-        },
-        i * BLOCKS_PER_GROUP / threads, (i + 1) * BLOCKS_PER_GROUP / threads);
-  }
-
-  for (std::future<void>& future : encryption_futures)
-    future.get();
+    std::memcpy(iv, out_ptr + 0x3D0, sizeof(iv));
+    aes_context->Crypt(iv, unencrypted_data[i].data(), out_ptr + BLOCK_HEADER_SIZE,
+                       BLOCK_DATA_SIZE);
+  });
 
   return true;
 }
 
-void VolumeWii::DecryptBlockHashes(const u8* in, HashBlock* out, mbedtls_aes_context* aes_context)
+void VolumeWii::DecryptGroupData(const u8* in,
+                                 std::array<u8, BLOCK_DATA_SIZE> out[BLOCKS_PER_GROUP],
+                                 size_t num_blocks, const Common::AES::Context* aes_context)
+{
+  ProcessBlocksInParallel(BLOCKS_PER_GROUP, [&](size_t i) {
+    if (i < num_blocks)
+      DecryptBlockData(in + i * BLOCK_TOTAL_SIZE, out[i].data(), aes_context);
+    else
+      out[i].fill(0);
+  });
+}
+
+void VolumeWii::DecryptBlockHashes(const u8* in, HashBlock* out,
+                                   const Common::AES::Context* aes_context)
 {
   std::array<u8, 16> iv;
   iv.fill(0);
-  mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, sizeof(HashBlock), iv.data(), in,
-                        reinterpret_cast<u8*>(out));
+  aes_context->Crypt(iv.data(), in, reinterpret_cast<u8*>(out), sizeof(HashBlock));
 }
 
-void VolumeWii::DecryptBlockData(const u8* in, u8* out, mbedtls_aes_context* aes_context)
+void VolumeWii::DecryptBlockData(const u8* in, u8* out, const Common::AES::Context* aes_context)
 {
   std::array<u8, 16> iv;
   std::copy(&in[0x3d0], &in[0x3e0], iv.data());
-  mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, BLOCK_DATA_SIZE, iv.data(),
-                        &in[BLOCK_HEADER_SIZE], out);
+  aes_context->Crypt(iv.data(), &in[BLOCK_HEADER_SIZE], out, BLOCK_DATA_SIZE);
 }
 
 }  // namespace DiscIO
@@ -12,9 +12,8 @@
 #include <string>
 #include <vector>
 
-#include <mbedtls/aes.h>
-
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
 #include "Common/Lazy.h"
 #include "Core/IOS/ES/Formats.h"
 #include "DiscIO/Filesystem.h"
@@ -82,7 +81,8 @@ public:
   bool IsDatelDisc() const override;
   bool SupportsIntegrityCheck() const override { return m_encrypted; }
   bool CheckH3TableIntegrity(const Partition& partition) const override;
-  bool CheckBlockIntegrity(u64 block_index, const std::vector<u8>& encrypted_data,
+  void PrepareBlockIntegrityCheck(const Partition& partition) const override;
+  bool CheckBlockIntegrity(u64 block_index, const u8* encrypted_data,
                            const Partition& partition) const override;
   bool CheckBlockIntegrity(u64 block_index, const Partition& partition) const override;
 
@@ -92,11 +92,17 @@ public:
   bool IsSizeAccurate() const override;
   u64 GetRawSize() const override;
   const BlobReader& GetBlobReader() const override;
+  BlobReader& GetBlobReader() override;
   std::array<u8, 20> GetSyncHash() const override;
 
+  // Runs func for every block on the thread pool that hashes, encrypts and decrypts groups, so that
+  // the callers of these functions share the CPU cores instead of competing for them.
+  static void ProcessBlocksInParallel(size_t num_blocks,
+                                      const std::function<void(size_t block)>& func);
+
   // The in parameter can either contain all the data to begin with,
   // or read_function can write data into the in parameter when called.
-  // The latter lets reading run in parallel with hashing.
+  // All blocks are read before hashing starts.
   // This function returns false iff read_function returns false.
   static bool HashGroup(const std::array<u8, BLOCK_DATA_SIZE> in[BLOCKS_PER_GROUP],
                         HashBlock out[BLOCKS_PER_GROUP],
@@ -108,8 +114,13 @@ public:
                            const std::function<void(HashBlock hash_blocks[BLOCKS_PER_GROUP])>&
                                hash_exception_callback = {});
 
-  static void DecryptBlockHashes(const u8* in, HashBlock* out, mbedtls_aes_context* aes_context);
-  static void DecryptBlockData(const u8* in, u8* out, mbedtls_aes_context* aes_context);
+  // Decrypts the data of the first num_blocks blocks of a group. The other blocks are zeroed.
+  static void DecryptGroupData(const u8* in, std::array<u8, BLOCK_DATA_SIZE> out[BLOCKS_PER_GROUP],
+                               size_t num_blocks, const Common::AES::Context* aes_context);
+
+  static void DecryptBlockHashes(const u8* in, HashBlock* out,
+                                 const Common::AES::Context* aes_context);
+  static void DecryptBlockData(const u8* in, u8* out, const Common::AES::Context* aes_context);
 
 protected:
   u32 GetOffsetShift() const override { return 2; }
@@ -117,7 +128,7 @@ protected:
 private:
   struct PartitionDetails
   {
-    Common::Lazy<std::unique_ptr<mbedtls_aes_context>> key;
+    Common::Lazy<std::unique_ptr<Common::AES::Context>> key;
     Common::Lazy<IOS::ES::TicketReader> ticket;
     Common::Lazy<IOS::ES::TMDReader> tmd;
     Common::Lazy<std::vector<u8>> cert_chain;
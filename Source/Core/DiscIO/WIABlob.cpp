@@ -22,6 +22,7 @@
 #include "Common/Align.h"
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
@@ -29,6 +30,7 @@
 #include "Common/ScopeGuard.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscExtractor.h"
@@ -76,15 +78,55 @@ std::pair<int, int> GetAllowedCompressionLevels(WIARVZCompressionType compressio
   }
 }
 
+static Common::ThreadPool& GetDecompressionThreadPool()
+{
+  static Common::ThreadPool pool(Common::ThreadPool::GetDefaultNumWorkers(),
+                                 "WIA/RVZ Decompression");
+  return pool;
+}
+
 template <bool RVZ>
 WIARVZFileReader<RVZ>::WIARVZFileReader(File::IOFile file, const std::string& path)
     : m_file(std::move(file)), m_encryption_cache(this)
 {
   m_valid = Initialize(path);
+
+  SetCacheCapacity(DEFAULT_CHUNK_CACHE_SIZE, WiiEncryptionCache::DEFAULT_CAPACITY);
+}
+
+template <bool RVZ>
+WIARVZFileReader<RVZ>::~WIARVZFileReader()
+{
+  const CacheStatistics statistics = GetCacheStatistics();
+  if (statistics.chunk_misses != 0)
+  {
+    INFO_LOG(DISCIO,
+             "%s cache: %" PRIu64 " of %" PRIu64 " chunks and %" PRIu64 " of %" PRIu64
+             " groups were already decompressed",
+             RVZ ? "RVZ" : "WIA", statistics.chunk_hits,
+             statistics.chunk_hits + statistics.chunk_misses, statistics.group_hits,
+             statistics.group_hits + statistics.group_misses);
+  }
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::SetCacheCapacity(u64 chunk_cache_size, size_t groups)
+{
+  const u64 chunk_size = std::max<u32>(Common::swap32(m_header_2.chunk_size), 1);
+  m_chunk_cache_capacity = std::clamp<u64>(chunk_cache_size / chunk_size, 2, 64);
+  while (m_cached_chunks.size() > m_chunk_cache_capacity)
+    m_cached_chunks.pop_back();
+
+  m_encryption_cache.SetCapacity(groups);
 }
 
 template <bool RVZ>
-WIARVZFileReader<RVZ>::~WIARVZFileReader() = default;
+typename WIARVZFileReader<RVZ>::CacheStatistics
+WIARVZFileReader<RVZ>::GetCacheStatistics() const
+{
+  return {m_chunk_cache_hits, m_chunk_cache_misses, m_encryption_cache.GetHits(),
+          m_encryption_cache.GetMisses()};
+}
 
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Initialize(const std::string& path)
@@ -498,71 +540,131 @@ bool WIARVZFileReader<RVZ>::ReadFromGroups(u64* offset, u64* size, u8** out_ptr,
   data_offset -= skipped_data;
   data_size += skipped_data;
 
-  const u64 start_group_index = (*offset - data_offset) / chunk_size;
-  for (u64 i = start_group_index; i < number_of_groups && (*size) > 0; ++i)
-  {
-    const u64 total_group_index = group_index + i;
-    if (total_group_index >= m_group_entries.size())
-      return false;
-
-    const GroupEntry group = m_group_entries[total_group_index];
-    const u64 group_offset_in_data = i * chunk_size;
-    const u64 offset_in_group = *offset - group_offset_in_data - data_offset;
+  const u64 end_offset_in_data = *offset - data_offset + *size;
+  std::vector<Chunk*> chunks;
 
-    chunk_size = std::min(chunk_size, data_size - group_offset_in_data);
-
-    const u64 bytes_to_read = std::min(chunk_size - offset_in_group, *size);
-    u32 group_data_size = Common::swap32(group.data_size);
-
-    WIARVZCompressionType compression_type = m_compression_type;
-    u32 rvz_packed_size = 0;
-    if constexpr (RVZ)
+  u64 i = (*offset - data_offset) / chunk_size;
+  while (i < number_of_groups && (*size) > 0)
+  {
+    // Look up the chunks of as many of the following groups as the cache can hold, so that the
+    // ones which haven't been read yet can be decompressed in parallel.
+    chunks.clear();
+    for (u64 j = i; j < number_of_groups && j * chunk_size < end_offset_in_data &&
+                    chunks.size() < m_chunk_cache_capacity;
+         ++j)
     {
-      if ((group_data_size & 0x80000000) == 0)
-        compression_type = WIARVZCompressionType::None;
-
-      group_data_size &= 0x7FFFFFFF;
+      const u64 total_group_index = group_index + j;
+      if (total_group_index >= m_group_entries.size())
+        return false;
 
-      rvz_packed_size = Common::swap32(group.rvz_packed_size);
+      const u64 group_offset_in_data = j * chunk_size;
+      chunks.push_back(GetGroupChunk(m_group_entries[total_group_index],
+                                     std::min(chunk_size, data_size - group_offset_in_data),
+                                     group_offset_in_data, exception_lists));
     }
 
-    if (group_data_size == 0)
-    {
-      std::memset(*out_ptr, 0, bytes_to_read);
-    }
-    else
-    {
-      const u64 group_offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
+    DecompressChunks(chunks);
 
-      Chunk& chunk =
-          ReadCompressedData(group_offset_in_file, group_data_size, chunk_size, compression_type,
-                             exception_lists, rvz_packed_size, group_offset_in_data);
+    for (Chunk* chunk : chunks)
+    {
+      const u64 total_group_index = group_index + i;
+      const u64 group_offset_in_data = i * chunk_size;
+      const u64 offset_in_group = *offset - group_offset_in_data - data_offset;
+      const u64 group_chunk_size = std::min(chunk_size, data_size - group_offset_in_data);
+      const u64 bytes_to_read = std::min(group_chunk_size - offset_in_group, *size);
 
-      if (!chunk.Read(offset_in_group, bytes_to_read, *out_ptr))
+      if (!chunk)
       {
-        m_cached_chunk_offset = std::numeric_limits<u64>::max();  // Invalidate the cache
-        return false;
+        std::memset(*out_ptr, 0, bytes_to_read);
       }
-
-      if (m_write_to_exception_list && m_exception_list_last_group_index != total_group_index)
+      else
       {
-        const u64 exception_list_index = offset_in_group / VolumeWii::GROUP_DATA_SIZE;
-        const u16 additional_offset =
-            static_cast<u16>(group_offset_in_data % VolumeWii::GROUP_DATA_SIZE /
-                             VolumeWii::BLOCK_DATA_SIZE * VolumeWii::BLOCK_HEADER_SIZE);
-        chunk.GetHashExceptions(&m_exception_list, exception_list_index, additional_offset);
-        m_exception_list_last_group_index = total_group_index;
+        if (!chunk->Read(offset_in_group, bytes_to_read, *out_ptr))
+        {
+          EvictChunk(chunk);
+          return false;
+        }
+
+        if (m_write_to_exception_list && m_exception_list_last_group_index != total_group_index)
+        {
+          const u64 exception_list_index = offset_in_group / VolumeWii::GROUP_DATA_SIZE;
+          const u16 additional_offset =
+              static_cast<u16>(group_offset_in_data % VolumeWii::GROUP_DATA_SIZE /
+                               VolumeWii::BLOCK_DATA_SIZE * VolumeWii::BLOCK_HEADER_SIZE);
+          chunk->GetHashExceptions(&m_exception_list, exception_list_index, additional_offset);
+          m_exception_list_last_group_index = total_group_index;
+        }
       }
-    }
 
-    *offset += bytes_to_read;
-    *size -= bytes_to_read;
-    *out_ptr += bytes_to_read;
+      *offset += bytes_to_read;
+      *size -= bytes_to_read;
+      *out_ptr += bytes_to_read;
+      ++i;
+    }
   }
 
   return true;
 }
 
+template <bool RVZ>
+typename WIARVZFileReader<RVZ>::Chunk*
+WIARVZFileReader<RVZ>::GetGroupChunk(const GroupEntry& group, u64 chunk_size,
+                                     u64 group_offset_in_data, u32 exception_lists)
+{
+  u32 group_data_size = Common::swap32(group.data_size);
+
+  WIARVZCompressionType compression_type = m_compression_type;
+  u32 rvz_packed_size = 0;
+  if constexpr (RVZ)
+  {
+    if ((group_data_size & 0x80000000) == 0)
+      compression_type = WIARVZCompressionType::None;
+
+    group_data_size &= 0x7FFFFFFF;
+
+    rvz_packed_size = Common::swap32(group.rvz_packed_size);
+  }
+
+  if (group_data_size == 0)
+    return nullptr;
+
+  const u64 group_offset_in_file = static_cast<u64>(Common::swap32(group.data_offset)) << 2;
+  return &ReadCompressedData(group_offset_in_file, group_data_size, chunk_size, compression_type,
+                             exception_lists, rvz_packed_size, group_offset_in_data);
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::DecompressChunks(const std::vector<Chunk*>& chunks)
+{
+  std::vector<Chunk*> chunks_to_decompress;
+  for (Chunk* chunk : chunks)
+  {
+    if (chunk && !chunk->IsCompressedDataLoaded())
+      chunks_to_decompress.push_back(chunk);
+  }
+
+  if (chunks_to_decompress.size() < 2)
+    return;
+
+  // The file can only be accessed from one thread at a time, so the compressed data is read
+  // first. Chunks which fail here or during decompression report the error when they're read.
+  for (Chunk* chunk : chunks_to_decompress)
+    chunk->LoadCompressedData();
+
+  GetDecompressionThreadPool().ParallelFor(
+      chunks_to_decompress.size(), [&chunks_to_decompress](size_t i) {
+        Chunk* chunk = chunks_to_decompress[i];
+        if (chunk->IsCompressedDataLoaded())
+          chunk->DecompressAll();
+      });
+}
+
+template <bool RVZ>
+void WIARVZFileReader<RVZ>::EvictChunk(const Chunk* chunk)
+{
+  m_cached_chunks.remove_if([chunk](const CachedChunk& entry) { return &entry.chunk == chunk; });
+}
+
 template <bool RVZ>
 typename WIARVZFileReader<RVZ>::Chunk&
 WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_size,
@@ -570,8 +672,21 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
                                           WIARVZCompressionType compression_type,
                                           u32 exception_lists, u32 rvz_packed_size, u64 data_offset)
 {
-  if (offset_in_file == m_cached_chunk_offset)
-    return m_cached_chunk;
+  // Chunks with only zeroes or a single repeated byte can be shared between groups, but a group at
+  // the end of the data may use a shorter part of it.
+  const auto it = std::find_if(
+      m_cached_chunks.begin(), m_cached_chunks.end(), [&](const CachedChunk& entry) {
+        return entry.offset_in_file == offset_in_file &&
+               entry.decompressed_size == decompressed_size && entry.data_offset == data_offset;
+      });
+  if (it != m_cached_chunks.end())
+  {
+    m_chunk_cache_hits++;
+    m_cached_chunks.splice(m_cached_chunks.begin(), m_cached_chunks, it);
+    return m_cached_chunks.front().chunk;
+  }
+
+  m_chunk_cache_misses++;
 
   std::unique_ptr<Decompressor> decompressor;
   switch (compression_type)
@@ -601,11 +716,14 @@ WIARVZFileReader<RVZ>::ReadCompressedData(u64 offset_in_file, u64 compressed_siz
 
   const bool compressed_exception_lists = compression_type > WIARVZCompressionType::Purge;
 
-  m_cached_chunk =
+  if (m_cached_chunks.size() >= m_chunk_cache_capacity)
+    m_cached_chunks.pop_back();
+
+  m_cached_chunks.push_front(CachedChunk{
+      offset_in_file, decompressed_size, data_offset,
       Chunk(&m_file, offset_in_file, compressed_size, decompressed_size, exception_lists,
-            compressed_exception_lists, rvz_packed_size, data_offset, std::move(decompressor));
-  m_cached_chunk_offset = offset_in_file;
-  return m_cached_chunk;
+            compressed_exception_lists, rvz_packed_size, data_offset, std::move(decompressor))});
+  return m_cached_chunks.front().chunk;
 }
 
 template <bool RVZ>
@@ -646,15 +764,43 @@ WIARVZFileReader<RVZ>::Chunk::Chunk(File::IOFile* file, u64 offset_in_file, u64
   m_out.data.resize(decompressed_size + m_out_bytes_allocated_for_exceptions);
 }
 
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::Chunk::LoadCompressedData()
+{
+  const size_t bytes_to_load = m_in.data.size() - m_in_bytes_loaded;
+  if (bytes_to_load == 0)
+    return true;
+
+  if (!m_file || !m_file->Seek(m_offset_in_file, SEEK_SET) ||
+      !m_file->ReadBytes(m_in.data.data() + m_in_bytes_loaded, bytes_to_load))
+  {
+    m_error = true;
+    return false;
+  }
+
+  m_offset_in_file += bytes_to_load;
+  m_in_bytes_loaded += bytes_to_load;
+  return true;
+}
+
+template <bool RVZ>
+bool WIARVZFileReader<RVZ>::Chunk::DecompressAll()
+{
+  return Read(0, m_out.data.size() - m_out_bytes_allocated_for_exceptions, nullptr);
+}
+
 template <bool RVZ>
 bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
 {
-  if (!m_decompressor || !m_file ||
+  if (m_error || !m_decompressor || !m_file ||
       offset + size > m_out.data.size() - m_out_bytes_allocated_for_exceptions)
   {
     return false;
   }
 
+  // Once an error has happened, the state of the chunk can't be trusted.
+  Common::ScopeGuard error_guard([this] { m_error = true; });
+
   while (offset + size > m_out.bytes_written - m_out_bytes_used_for_exceptions)
   {
     u64 bytes_to_read;
@@ -689,12 +835,18 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
       return false;
     }
 
-    if (!m_file->Seek(m_offset_in_file, SEEK_SET))
-      return false;
-    if (!m_file->ReadBytes(m_in.data.data() + m_in.bytes_written, bytes_to_read))
-      return false;
+    if (m_in.bytes_written + bytes_to_read > m_in_bytes_loaded)
+    {
+      const u64 bytes_to_load = m_in.bytes_written + bytes_to_read - m_in_bytes_loaded;
+      if (!m_file->Seek(m_offset_in_file, SEEK_SET))
+        return false;
+      if (!m_file->ReadBytes(m_in.data.data() + m_in_bytes_loaded, bytes_to_load))
+        return false;
+
+      m_offset_in_file += bytes_to_load;
+      m_in_bytes_loaded += bytes_to_load;
+    }
 
-    m_offset_in_file += bytes_to_read;
     m_in.bytes_written += bytes_to_read;
 
     if (m_exception_lists > 0 && !m_compressed_exception_lists)
@@ -751,7 +903,10 @@ bool WIARVZFileReader<RVZ>::Chunk::Read(u64 offset, u64 size, u8* out_ptr)
     }
   }
 
-  std::memcpy(out_ptr, m_out.data.data() + offset + m_out_bytes_used_for_exceptions, size);
+  error_guard.Dismiss();
+
+  if (out_ptr)
+    std::memcpy(out_ptr, m_out.data.data() + offset + m_out_bytes_used_for_exceptions, size);
   return true;
 }
 
@@ -1317,8 +1472,8 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
   {
     const PartitionEntry& partition_entry = partition_entries[parameters.data_entry->index];
 
-    mbedtls_aes_context aes_context;
-    mbedtls_aes_setkey_dec(&aes_context, partition_entry.partition_key.data(), 128);
+    const std::unique_ptr<Common::AES::Context> aes_context = Common::AES::CreateContext(
+        partition_entry.partition_key.data(), Common::AES::Mode::Decrypt);
 
     const u64 groups = Common::AlignUp(parameters.data.size(), VolumeWii::GROUP_TOTAL_SIZE) /
                        VolumeWii::GROUP_TOTAL_SIZE;
@@ -1381,19 +1536,9 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
         const u64 blocks_in_this_group =
             std::min<u64>(VolumeWii::BLOCKS_PER_GROUP, blocks - i * VolumeWii::BLOCKS_PER_GROUP);
 
-        for (u32 j = 0; j < VolumeWii::BLOCKS_PER_GROUP; ++j)
-        {
-          if (j < blocks_in_this_group)
-          {
-            const u64 offset_of_block = offset_of_group + j * VolumeWii::BLOCK_TOTAL_SIZE;
-            VolumeWii::DecryptBlockData(parameters.data.data() + offset_of_block,
-                                        state->decryption_buffer[j].data(), &aes_context);
-          }
-          else
-          {
-            state->decryption_buffer[j].fill(0);
-          }
-        }
+        VolumeWii::DecryptGroupData(parameters.data.data() + offset_of_group,
+                                    state->decryption_buffer.data(), blocks_in_this_group,
+                                    aes_context.get());
 
         VolumeWii::HashGroup(state->decryption_buffer.data(), state->hash_buffer.data());
 
@@ -1412,7 +1557,7 @@ WIARVZFileReader<RVZ>::ProcessAndCompress(CompressThreadState* state, CompressPa
 
           VolumeWii::HashBlock hashes;
           VolumeWii::DecryptBlockHashes(parameters.data.data() + offset_of_block, &hashes,
-                                        &aes_context);
+                                        aes_context.get());
 
           const auto compare_hash = [&](size_t offset_in_block) {
             ASSERT(offset_in_block + sizeof(SHA1) <= VolumeWii::BLOCK_HEADER_SIZE);
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -66,6 +67,21 @@ public:
                                       File::IOFile* outfile, WIARVZCompressionType compression_type,
                                       int compression_level, int chunk_size, CompressCB callback);
 
+  // Sets how many bytes of decompressed chunks (but at least two chunks) and how many encrypted
+  // Wii groups are kept in memory. The least recently used ones are evicted first.
+  void SetCacheCapacity(u64 chunk_cache_size, size_t groups);
+
+  struct CacheStatistics
+  {
+    u64 chunk_hits;
+    u64 chunk_misses;
+    u64 group_hits;
+    u64 group_misses;
+  };
+  CacheStatistics GetCacheStatistics() const;
+
+  static constexpr u64 DEFAULT_CHUNK_CACHE_SIZE = 0x2000000;
+
 private:
   using SHA1 = std::array<u8, 20>;
   using WiiKey = std::array<u8, 16>;
@@ -185,8 +201,15 @@ private:
           u32 exception_lists, bool compressed_exception_lists, u32 rvz_packed_size,
           u64 data_offset, std::unique_ptr<Decompressor> decompressor);
 
+    // If out_ptr is nullptr, the data is only decompressed.
     bool Read(u64 offset, u64 size, u8* out_ptr);
 
+    // Reads all of the compressed data from the file. Once this has been done, decompressing
+    // doesn't access the file, so it can be done on any thread.
+    bool LoadCompressedData();
+    bool IsCompressedDataLoaded() const { return m_in_bytes_loaded == m_in.data.size(); }
+    bool DecompressAll();
+
     // This can only be called once at least one byte of data has been read
     void GetHashExceptions(std::vector<HashExceptionEntry>* exception_list,
                            u64 exception_list_index, u16 additional_offset) const;
@@ -205,6 +228,8 @@ private:
     DecompressionBuffer m_in;
     DecompressionBuffer m_out;
     size_t m_in_bytes_read = 0;
+    size_t m_in_bytes_loaded = 0;
+    bool m_error = false;
 
     std::unique_ptr<Decompressor> m_decompressor = nullptr;
     File::IOFile* m_file = nullptr;
@@ -228,6 +253,11 @@ private:
   bool ReadFromGroups(u64* offset, u64* size, u8** out_ptr, u64 chunk_size, u32 sector_size,
                       u64 data_offset, u64 data_size, u32 group_index, u32 number_of_groups,
                       u32 exception_lists);
+  // Returns nullptr if the group only contains zeroes.
+  Chunk* GetGroupChunk(const GroupEntry& group, u64 chunk_size, u64 group_offset_in_data,
+                       u32 exception_lists);
+  static void DecompressChunks(const std::vector<Chunk*>& chunks);
+  void EvictChunk(const Chunk* chunk);
   Chunk& ReadCompressedData(u64 offset_in_file, u64 compressed_size, u64 decompressed_size,
                             WIARVZCompressionType compression_type, u32 exception_lists = 0,
                             u32 rvz_packed_size = 0, u64 data_offset = 0);
@@ -356,8 +386,18 @@ private:
   WIARVZCompressionType m_compression_type;
 
   File::IOFile m_file;
-  Chunk m_cached_chunk;
-  u64 m_cached_chunk_offset = std::numeric_limits<u64>::max();
+
+  struct CachedChunk
+  {
+    u64 offset_in_file;
+    u64 decompressed_size;
+    u64 data_offset;
+    Chunk chunk;
+  };
+  std::list<CachedChunk> m_cached_chunks;  // Most recently used first
+  size_t m_chunk_cache_capacity = 1;
+  u64 m_chunk_cache_hits = 0;
+  u64 m_chunk_cache_misses = 0;
   WiiEncryptionCache m_encryption_cache;
 
   std::vector<HashExceptionEntry> m_exception_list;
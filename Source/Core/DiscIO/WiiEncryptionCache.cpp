@@ -4,9 +4,9 @@
 
 #include "DiscIO/WiiEncryptionCache.h"
 
+#include <algorithm>
 #include <array>
 #include <cstring>
-#include <limits>
 #include <memory>
 
 #include "Common/Align.h"
@@ -22,45 +22,69 @@ WiiEncryptionCache::WiiEncryptionCache(BlobReader* blob) : m_blob(blob)
 
 WiiEncryptionCache::~WiiEncryptionCache() = default;
 
+void WiiEncryptionCache::SetCapacity(size_t capacity)
+{
+  m_capacity = std::max<size_t>(capacity, 1);
+  while (m_cache.size() > m_capacity)
+    m_cache.pop_back();
+}
+
 const std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>*
 WiiEncryptionCache::EncryptGroup(u64 offset, u64 partition_data_offset,
                                  u64 partition_data_decrypted_size, const Key& key,
                                  const HashExceptionCallback& hash_exception_callback)
 {
-  // Only allocate memory if this function actually ends up getting called
-  if (!m_cache)
-    m_cache = std::make_unique<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>>();
-
   ASSERT(offset % VolumeWii::GROUP_TOTAL_SIZE == 0);
   const u64 group_offset_in_partition =
       offset / VolumeWii::GROUP_TOTAL_SIZE * VolumeWii::GROUP_DATA_SIZE;
   const u64 group_offset_on_disc = partition_data_offset + offset;
 
-  if (m_cached_offset != group_offset_on_disc)
+  const auto it = std::find_if(m_cache.begin(), m_cache.end(), [&](const CachedGroup& group) {
+    return group.offset_on_disc == group_offset_on_disc;
+  });
+  if (it != m_cache.end())
+  {
+    m_hits++;
+    m_cache.splice(m_cache.begin(), m_cache, it);
+    return m_cache.front().data.get();
+  }
+
+  m_misses++;
+
+  // Reuse the memory of the least recently used group if the cache is full. Memory is only
+  // allocated if this function actually ends up getting called.
+  CachedGroup group;
+  if (m_cache.size() >= m_capacity)
+  {
+    group = std::move(m_cache.back());
+    m_cache.pop_back();
+  }
+  else
+  {
+    group.data = std::make_unique<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>>();
+  }
+
+  std::function<void(VolumeWii::HashBlock * hash_blocks)> hash_exception_callback_2;
+
+  if (hash_exception_callback)
+  {
+    hash_exception_callback_2 =
+        [offset, &hash_exception_callback](
+            VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]) {
+          return hash_exception_callback(hash_blocks, offset);
+        };
+  }
+
+  if (!VolumeWii::EncryptGroup(group_offset_in_partition, partition_data_offset,
+                               partition_data_decrypted_size, key, m_blob, group.data.get(),
+                               hash_exception_callback_2))
   {
-    std::function<void(VolumeWii::HashBlock * hash_blocks)> hash_exception_callback_2;
-
-    if (hash_exception_callback)
-    {
-      hash_exception_callback_2 =
-          [offset, &hash_exception_callback](
-              VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]) {
-            return hash_exception_callback(hash_blocks, offset);
-          };
-    }
-
-    if (!VolumeWii::EncryptGroup(group_offset_in_partition, partition_data_offset,
-                                 partition_data_decrypted_size, key, m_blob, m_cache.get(),
-                                 hash_exception_callback_2))
-    {
-      m_cached_offset = std::numeric_limits<u64>::max();  // Invalidate the cache
-      return nullptr;
-    }
-
-    m_cached_offset = group_offset_on_disc;
+    return nullptr;
   }
 
-  return m_cache.get();
+  group.offset_on_disc = group_offset_on_disc;
+  m_cache.push_front(std::move(group));
+  return m_cache.front().data.get();
 }
 
 bool WiiEncryptionCache::EncryptGroups(u64 offset, u64 size, u8* out_ptr, u64 partition_data_offset,
@@ -5,7 +5,8 @@
 #pragma once
 
 #include <array>
-#include <limits>
+#include <functional>
+#include <list>
 #include <memory>
 
 #include "Common/CommonTypes.h"
@@ -22,10 +23,19 @@ public:
   using HashExceptionCallback = std::function<void(
       VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP], u64 offset)>;
 
+  static constexpr size_t DEFAULT_CAPACITY = 4;
+
   // The blob pointer is kept around for the lifetime of this object.
   explicit WiiEncryptionCache(BlobReader* blob);
   ~WiiEncryptionCache();
 
+  // Sets how many encrypted groups are kept, starting with the most recently used one.
+  void SetCapacity(size_t capacity);
+  size_t GetCapacity() const { return m_capacity; }
+
+  u64 GetHits() const { return m_hits; }
+  u64 GetMisses() const { return m_misses; }
+
   // Encrypts exactly one group.
   // If the returned pointer is nullptr, reading from the blob failed.
   // If the returned pointer is not nullptr, it is guaranteed to be valid until
@@ -41,9 +51,17 @@ public:
                      const HashExceptionCallback& hash_exception_callback = {});
 
 private:
+  struct CachedGroup
+  {
+    u64 offset_on_disc;
+    std::unique_ptr<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>> data;
+  };
+
   BlobReader* m_blob;
-  std::unique_ptr<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>> m_cache;
-  u64 m_cached_offset = std::numeric_limits<u64>::max();
+  std::list<CachedGroup> m_cache;  // Most recently used first
+  size_t m_capacity = DEFAULT_CAPACITY;
+  u64 m_hits = 0;
+  u64 m_misses = 0;
 };
 
 }  // namespace DiscIO
@@ -10,16 +10,21 @@
 #include <cstring>
 #include <signal.h>
 #include <string>
+#include <variant>
+#include <vector>
 #ifndef _WIN32
 #include <unistd.h>
 #else
 #include <Windows.h>
 #endif
 
+#include "Common/Config/Config.h"
 #include "Common/StringUtil.h"
 #include "Core/Analytics.h"
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/Host.h"
 
@@ -31,6 +36,7 @@
 
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/VideoBackendBase.h"
+#include "VideoCommon/VideoConfig.h"
 
 static std::unique_ptr<Platform> s_platform;
 
@@ -131,6 +137,53 @@ static std::unique_ptr<Platform> GetPlatform(const optparse::Values& options)
   return nullptr;
 }
 
+// Plays each FIFO log once as the given game with the shader cache enabled, which adds the
+// pipelines they use to the game's UID cache, and to the pipeline cache of the video backend if it
+// has one. The null backend only builds the UID cache, but doesn't need a GPU.
+static bool BuildShaderCache(const std::string& game_id, const std::vector<std::string>& fifo_logs)
+{
+  SConfig& config = SConfig::GetInstance();
+  const bool loop_fifo_replay = config.bLoopFifoReplay;
+  config.bLoopFifoReplay = false;
+
+  bool success = true;
+  for (const std::string& path : fifo_logs)
+  {
+    std::unique_ptr<BootParameters> boot = BootParameters::GenerateFromFile(path);
+    auto* dff = boot ? std::get_if<BootParameters::DFF>(&boot->parameters) : nullptr;
+    if (!dff)
+    {
+      fprintf(stderr, "%s is not a FIFO log\n", path.c_str());
+      success = false;
+      break;
+    }
+    dff->game_id = game_id;
+
+    // The current run layer is cleared when emulation stops, so these have to be set every time.
+    // Compiling synchronously makes sure that no pipeline is still pending when the log ends.
+    Config::SetCurrent(Config::GFX_SHADER_CACHE, true);
+    Config::SetCurrent(Config::GFX_SHADER_COMPILATION_MODE, ShaderCompilationMode::Synchronous);
+
+    if (!s_platform->Restart())
+      break;
+
+    fprintf(stdout, "Playing %s\n", path.c_str());
+    if (!BootManager::BootCore(std::move(boot), s_platform->GetWindowSystemInfo()))
+    {
+      fprintf(stderr, "Could not boot %s\n", path.c_str());
+      success = false;
+      break;
+    }
+
+    s_platform->MainLoop();
+    Core::Stop();
+    Core::Shutdown();
+  }
+
+  config.bLoopFifoReplay = loop_fifo_replay;
+  return success;
+}
+
 int main(int argc, char* argv[])
 {
   auto parser = CommandLineParse::CreateParser(CommandLineParse::ParserOptions::OmitGUIOptions);
@@ -152,6 +205,12 @@ int main(int argc, char* argv[])
             "win32"
 #endif
       });
+  parser->add_option("--build-shader-cache")
+      .action("store")
+      .metavar("<game ID>")
+      .type("string")
+      .help("Play each given FIFO log once, adding the pipelines it uses to the shader cache of "
+            "the given game, then exit");
 
   optparse::Values& options = CommandLineParse::ParseArguments(parser.get(), argc, argv);
   std::vector<std::string> args = parser->args();
@@ -164,7 +223,22 @@ int main(int argc, char* argv[])
 
   std::unique_ptr<BootParameters> boot;
   bool game_specified = false;
-  if (options.is_set("exec"))
+  std::vector<std::string> fifo_logs;
+  if (options.is_set("build_shader_cache"))
+  {
+    if (options.is_set("exec"))
+    {
+      const std::list<std::string> paths_list = options.all("exec");
+      fifo_logs.assign(paths_list.begin(), paths_list.end());
+    }
+    fifo_logs.insert(fifo_logs.end(), args.begin(), args.end());
+    if (fifo_logs.empty())
+    {
+      fprintf(stderr, "No FIFO logs to build the shader cache from\n");
+      return 1;
+    }
+  }
+  else if (options.is_set("exec"))
   {
     const std::list<std::string> paths_list = options.all("exec");
     const std::vector<std::string> paths{std::make_move_iterator(std::begin(paths_list)),
@@ -236,6 +310,15 @@ int main(int argc, char* argv[])
 
   DolphinAnalytics::Instance().ReportDolphinStart("nogui");
 
+  if (!fifo_logs.empty())
+  {
+    const bool success =
+        BuildShaderCache(static_cast<const char*>(options.get("build_shader_cache")), fifo_logs);
+    s_platform.reset();
+    UICommon::Shutdown();
+    return success ? 0 : 1;
+  }
+
   if (!BootManager::BootCore(std::move(boot), s_platform->GetWindowSystemInfo()))
   {
     fprintf(stderr, "Could not boot the specified file\n");
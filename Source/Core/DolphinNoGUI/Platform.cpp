@@ -47,7 +47,19 @@ void Platform::Stop()
   m_running.Clear();
 }
 
+bool Platform::Restart()
+{
+  if (m_quit_requested.IsSet())
+    return false;
+
+  m_shutdown_requested.Clear();
+  m_tried_graceful_shutdown.Clear();
+  m_running.Set();
+  return true;
+}
+
 void Platform::RequestShutdown()
 {
+  m_quit_requested.Set();
   m_shutdown_requested.Set();
 }
@@ -31,6 +31,10 @@ public:
   // Request an immediate shutdown.
   void Stop();
 
+  // Allows MainLoop to run again once the emulation it ran for has stopped. Returns false if a
+  // shutdown was requested by a signal, in which case nothing else should be started.
+  bool Restart();
+
   static std::unique_ptr<Platform> CreateHeadlessPlatform();
 #ifdef HAVE_X11
   static std::unique_ptr<Platform> CreateX11Platform();
@@ -50,6 +54,7 @@ protected:
   Common::Flag m_running{true};
   Common::Flag m_shutdown_requested{false};
   Common::Flag m_tried_graceful_shutdown{false};
+  Common::Flag m_quit_requested{false};
 
   bool m_window_focus = true;
   bool m_window_fullscreen = false;
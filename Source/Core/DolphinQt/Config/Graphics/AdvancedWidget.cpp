@@ -68,6 +68,8 @@ void AdvancedWidget::CreateWidgets()
   m_load_custom_textures = new GraphicsBool(tr("Load Custom Textures"), Config::GFX_HIRES_TEXTURES);
   m_prefetch_custom_textures =
       new GraphicsBool(tr("Prefetch Custom Textures"), Config::GFX_CACHE_HIRES_TEXTURES);
+  m_stream_custom_textures =
+      new GraphicsBool(tr("Stream Custom Textures"), Config::GFX_STREAM_HIRES_TEXTURES);
   m_dump_efb_target = new GraphicsBool(tr("Dump EFB Target"), Config::GFX_DUMP_EFB_TARGET);
   m_disable_vram_copies =
       new GraphicsBool(tr("Disable EFB VRAM Copies"), Config::GFX_HACK_DISABLE_COPY_TO_VRAM);
@@ -79,6 +81,8 @@ void AdvancedWidget::CreateWidgets()
 
   utility_layout->addWidget(m_dump_efb_target, 1, 1);
 
+  utility_layout->addWidget(m_stream_custom_textures, 2, 0);
+
   // Freelook
   auto* freelook_box = new QGroupBox(tr("Free Look"));
   auto* freelook_layout = new QGridLayout();
@@ -114,6 +118,10 @@ void AdvancedWidget::CreateWidgets()
                                               Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS);
   m_dump_use_ffv1 = new GraphicsBool(tr("Use Lossless Codec (FFV1)"), Config::GFX_USE_FFV1);
   m_dump_bitrate = new GraphicsInteger(0, 1000000, Config::GFX_BITRATE_KBPS, 1000);
+  m_dump_drop_frames =
+      new GraphicsBool(tr("Drop Frames Instead of Waiting"), Config::GFX_DUMP_DROP_FRAMES);
+  m_dump_duplicate_frames = new GraphicsBool(tr("Repeat Frames to Fill Skipped Frames"),
+                                             Config::GFX_DUMP_DUPLICATE_FRAMES);
 
   dump_layout->addWidget(m_use_fullres_framedumps, 0, 0);
 #if defined(HAVE_FFMPEG)
@@ -121,6 +129,10 @@ void AdvancedWidget::CreateWidgets()
   dump_layout->addWidget(new QLabel(tr("Bitrate (kbps):")), 1, 0);
   dump_layout->addWidget(m_dump_bitrate, 1, 1);
 #endif
+  dump_layout->addWidget(m_dump_drop_frames, 2, 0);
+#if defined(HAVE_FFMPEG)
+  dump_layout->addWidget(m_dump_duplicate_frames, 2, 1);
+#endif
 
   // Misc.
   auto* misc_box = new QGroupBox(tr("Misc"));
@@ -167,6 +179,7 @@ void AdvancedWidget::CreateWidgets()
 void AdvancedWidget::ConnectWidgets()
 {
   connect(m_load_custom_textures, &QCheckBox::toggled, this, &AdvancedWidget::SaveSettings);
+  connect(m_prefetch_custom_textures, &QCheckBox::toggled, this, &AdvancedWidget::SaveSettings);
   connect(m_dump_use_ffv1, &QCheckBox::toggled, this, &AdvancedWidget::SaveSettings);
   connect(m_enable_prog_scan, &QCheckBox::toggled, this, &AdvancedWidget::SaveSettings);
   connect(m_enable_freelook, &QCheckBox::toggled, this, &AdvancedWidget::SaveSettings);
@@ -176,6 +189,8 @@ void AdvancedWidget::ConnectWidgets()
 void AdvancedWidget::LoadSettings()
 {
   m_prefetch_custom_textures->setEnabled(Config::Get(Config::GFX_HIRES_TEXTURES));
+  m_stream_custom_textures->setEnabled(Config::Get(Config::GFX_HIRES_TEXTURES) &&
+                                       !Config::Get(Config::GFX_CACHE_HIRES_TEXTURES));
   m_dump_bitrate->setEnabled(!Config::Get(Config::GFX_USE_FFV1));
 
   m_enable_prog_scan->setChecked(Config::Get(Config::SYSCONF_PROGRESSIVE_SCAN));
@@ -188,6 +203,8 @@ void AdvancedWidget::LoadSettings()
 void AdvancedWidget::SaveSettings()
 {
   m_prefetch_custom_textures->setEnabled(Config::Get(Config::GFX_HIRES_TEXTURES));
+  m_stream_custom_textures->setEnabled(Config::Get(Config::GFX_HIRES_TEXTURES) &&
+                                       !Config::Get(Config::GFX_CACHE_HIRES_TEXTURES));
   m_dump_bitrate->setEnabled(!Config::Get(Config::GFX_USE_FFV1));
 
   Config::SetBase(Config::SYSCONF_PROGRESSIVE_SCAN, m_enable_prog_scan->isChecked());
@@ -238,6 +255,11 @@ void AdvancedWidget::AddDescriptions()
   static const char TR_CACHE_CUSTOM_TEXTURE_DESCRIPTION[] = QT_TR_NOOP(
       "Caches custom textures to system RAM on startup.\n\nThis can require exponentially "
       "more RAM but fixes possible stuttering.\n\nIf unsure, leave this unchecked.");
+  static const char TR_STREAM_CUSTOM_TEXTURE_DESCRIPTION[] = QT_TR_NOOP(
+      "Loads custom textures in the background when they are first used, instead of pausing "
+      "emulation until they are loaded. The original texture is shown until the custom texture "
+      "is ready.\n\nThis reduces stuttering without the RAM usage of prefetching, but custom "
+      "textures may briefly pop in.\n\nIf unsure, leave this unchecked.");
   static const char TR_DUMP_EFB_DESCRIPTION[] = QT_TR_NOOP(
       "Dumps the contents of EFB copies to User/Dump/Textures/.\n\nIf unsure, leave this "
       "unchecked.");
@@ -249,7 +271,15 @@ void AdvancedWidget::AddDescriptions()
       "the size of the window it is displayed within.\n\nIf the aspect ratio is widescreen, the "
       "output image will be scaled horizontally to preserve the vertical resolution.\n\nIf "
       "unsure, leave this unchecked.");
+  static const char TR_DUMP_DROP_FRAMES_DESCRIPTION[] = QT_TR_NOOP(
+      "Skips frames when frame dumping can't keep up, instead of slowing down emulation until it "
+      "has caught up. The skipped frames are covered by showing the previous frame for longer."
+      "\n\nIf unsure, leave this unchecked.");
 #if defined(HAVE_FFMPEG)
+  static const char TR_DUMP_DUPLICATE_FRAMES_DESCRIPTION[] = QT_TR_NOOP(
+      "Fills the gaps left by skipped frames with copies of the previous frame, so that the video "
+      "has a constant frame rate. Some video editors require this.\n\nIf unsure, leave this "
+      "unchecked.");
   static const char TR_USE_FFV1_DESCRIPTION[] =
       QT_TR_NOOP("Encodes frame dumps using the FFV1 codec.\n\nIf unsure, leave this unchecked.");
 #endif
@@ -300,10 +330,13 @@ void AdvancedWidget::AddDescriptions()
   AddDescription(m_dump_base_textures, TR_DUMP_BASE_TEXTURE_DESCRIPTION);
   AddDescription(m_load_custom_textures, TR_LOAD_CUSTOM_TEXTURE_DESCRIPTION);
   AddDescription(m_prefetch_custom_textures, TR_CACHE_CUSTOM_TEXTURE_DESCRIPTION);
+  AddDescription(m_stream_custom_textures, TR_STREAM_CUSTOM_TEXTURE_DESCRIPTION);
   AddDescription(m_dump_efb_target, TR_DUMP_EFB_DESCRIPTION);
   AddDescription(m_disable_vram_copies, TR_DISABLE_VRAM_COPIES_DESCRIPTION);
   AddDescription(m_use_fullres_framedumps, TR_INTERNAL_RESOLUTION_FRAME_DUMPING_DESCRIPTION);
+  AddDescription(m_dump_drop_frames, TR_DUMP_DROP_FRAMES_DESCRIPTION);
 #ifdef HAVE_FFMPEG
+  AddDescription(m_dump_duplicate_frames, TR_DUMP_DUPLICATE_FRAMES_DESCRIPTION);
   AddDescription(m_dump_use_ffv1, TR_USE_FFV1_DESCRIPTION);
 #endif
   AddDescription(m_enable_cropping, TR_CROPPING_DESCRIPTION);
@@ -35,6 +35,7 @@ private:
 
   // Utility
   QCheckBox* m_prefetch_custom_textures;
+  QCheckBox* m_stream_custom_textures;
   QCheckBox* m_dump_efb_target;
   QCheckBox* m_disable_vram_copies;
   QCheckBox* m_load_custom_textures;
@@ -49,6 +50,8 @@ private:
   // Frame dumping
   QCheckBox* m_dump_use_ffv1;
   QCheckBox* m_use_fullres_framedumps;
+  QCheckBox* m_dump_drop_frames;
+  QCheckBox* m_dump_duplicate_frames;
   QSpinBox* m_dump_bitrate;
 
   // Misc
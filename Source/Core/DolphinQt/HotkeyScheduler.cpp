@@ -644,6 +644,9 @@ void HotkeyScheduler::Run()
     if (IsHotkey(HK_UNDO_SAVE_STATE))
       emit StateSaveUndo();
 
+    if (IsHotkey(HK_REWIND, true))
+      State::Rewind();
+
     if (IsHotkey(HK_LOAD_STATE_FILE))
       emit StateLoadFile();
 
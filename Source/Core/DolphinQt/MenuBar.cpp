@@ -39,6 +39,7 @@
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Profiler.h"
 #include "Core/PowerPC/SignatureDB/SignatureDB.h"
 #include "Core/State.h"
 #include "Core/TitleDatabase.h"
@@ -140,6 +141,9 @@ void MenuBar::OnEmulationStateChanged(Core::State state)
   m_jit_clear_cache->setEnabled(running);
   m_jit_log_coverage->setEnabled(!running);
   m_jit_search_instruction->setEnabled(running);
+  m_jit_sample_call_stacks->setEnabled(running);
+  if (!running)
+    m_jit_sample_call_stacks->setChecked(false);
 
   for (QAction* action :
        {m_jit_off, m_jit_loadstore_off, m_jit_loadstore_lbzx_off, m_jit_loadstore_lxz_off,
@@ -830,6 +834,9 @@ void MenuBar::AddJITMenu()
       m_jit->addAction(tr("Log JIT Instruction Coverage"), this, &MenuBar::LogInstructions);
   m_jit_search_instruction =
       m_jit->addAction(tr("Search for an Instruction"), this, &MenuBar::SearchInstruction);
+  m_jit_sample_call_stacks = m_jit->addAction(tr("Sample Guest Call Stacks"));
+  m_jit_sample_call_stacks->setCheckable(true);
+  connect(m_jit_sample_call_stacks, &QAction::toggled, this, &MenuBar::ToggleCallStackSampling);
 
   m_jit->addSeparator();
 
@@ -1569,6 +1576,21 @@ void MenuBar::LogInstructions()
   PPCTables::LogCompiledInstructions();
 }
 
+void MenuBar::ToggleCallStackSampling(bool enabled)
+{
+  if (enabled)
+  {
+    Profiler::StartSampling();
+    return;
+  }
+
+  Profiler::StopSampling();
+
+  const std::string path = File::GetUserPath(D_LOGS_IDX) + "guest_call_stacks.folded";
+  if (Profiler::WriteFoldedStacks(path))
+    NOTICE_LOG(POWERPC, "Wrote guest call stack samples to %s", path.c_str());
+}
+
 void MenuBar::SearchInstruction()
 {
   bool good;
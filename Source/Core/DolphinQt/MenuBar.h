@@ -170,6 +170,7 @@ private:
   void ClearCache();
   void LogInstructions();
   void SearchInstruction();
+  void ToggleCallStackSampling(bool enabled);
 
   void OnSelectionChanged(std::shared_ptr<const UICommon::GameFile> game_file);
   void OnRecordingStatusChanged(bool recording);
@@ -253,6 +254,7 @@ private:
   QAction* m_jit_clear_cache;
   QAction* m_jit_log_coverage;
   QAction* m_jit_search_instruction;
+  QAction* m_jit_sample_call_stacks;
   QAction* m_jit_off;
   QAction* m_jit_loadstore_off;
   QAction* m_jit_loadstore_lbzx_off;
@@ -698,16 +698,16 @@ void ResetPerfQuery()
   perf_values = {};
 }
 
-void IncPerfCounterQuadCount(PerfQueryType type)
+void IncPerfCounterQuadCount(PerfQueryType type, u32 num_pixels)
 {
   // NOTE: hardware doesn't process individual pixels but quads instead.
   // Current software renderer architecture works on pixels though, so
   // we have this "quad" hack here to only increment the registers on
-  // every fourth rendered pixel
+  // every fourth rendered pixel. Pixels are counted in bulk once per batch,
+  // which gives the same result as counting them one at a time.
   static u32 quad[PQ_NUM_MEMBERS];
-  if (++quad[type] != 3)
-    return;
-  quad[type] = 0;
-  ++perf_values[type];
+  const u32 pixels = quad[type] + num_pixels;
+  perf_values[type] += pixels / 3;
+  quad[type] = pixels % 3;
 }
 }  // namespace EfbInterface
@@ -5,12 +5,21 @@
 #include "VideoBackends/Software/Rasterizer.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Thread.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/NativeVertexFormat.h"
 #include "VideoBackends/Software/Tev.h"
+#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoCommon.h"
@@ -21,28 +30,123 @@ namespace Rasterizer
 {
 static constexpr int BLOCK_SIZE = 2;
 
+// The EFB is split into tiles which are rasterized independently of each other, possibly on
+// different threads. Tiles are a multiple of the block size, so no block straddles two tiles.
+static constexpr s32 TILE_SIZE = 32;
+static constexpr s32 NUM_TILES_X = (EFB_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+static constexpr s32 NUM_TILES_Y = (EFB_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+static_assert(TILE_SIZE % BLOCK_SIZE == 0, "Tiles must consist of whole blocks");
+
+// Waking up the worker threads isn't worth it for batches that only touch a few tiles.
+static constexpr size_t MIN_TILES_FOR_WORKERS = 4;
+
+// Everything needed to rasterize a triangle, captured when it is submitted.
+struct TriangleSetup
+{
+  Slope ZSlope;
+  Slope WSlope;
+  Slope ColorSlopes[2][4];
+  Slope TexSlopes[8][3];
+
+  s32 vertex0X;
+  s32 vertex0Y;
+  float vertexOffsetX;
+  float vertexOffsetY;
+
+  // Edge deltas and half-edge constants in 28.4 fixed point
+  s32 DX12, DX23, DX31;
+  s32 DY12, DY23, DY31;
+  s32 C1, C2, C3;
+
+  // Block aligned bounding rectangle in pixels
+  s32 minx, maxx, miny, maxy;
+};
+
+// Per-thread rasterization state
+struct RasterContext
+{
+  // One per pixel of a block, shaded together by Tev::DrawBlock
+  std::array<Tev, BLOCK_SIZE * BLOCK_SIZE> tev;
+  RasterBlock rasterBlock;
+  u32 rasterizedPixels;
+
+  // The block this context shaded that comes last in rasterization order, and the carried inputs
+  // that its last pixel left behind. A key of 0 means that no block was shaded.
+  u64 lastBlockKey;
+  Tev::CarriedInputs lastBlockInputs;
+};
+
+// z reference plane, kept across triangles for zfreeze
 static Slope ZSlope;
-static Slope WSlope;
-static Slope ColorSlopes[2][4];
-static Slope TexSlopes[8][3];
 
-static s32 vertex0X;
-static s32 vertex0Y;
-static float vertexOffsetX;
-static float vertexOffsetY;
+// The carried TEV inputs as the last pixel in rasterization order left them. Pixels are shaded as
+// if they all went through a single Tev, one after the other.
+static Tev::CarriedInputs s_carried_inputs;
+
+// Index 0 is used by the GPU thread, the others by the worker threads.
+static std::vector<std::unique_ptr<RasterContext>> s_contexts;
 
-static Tev tev;
-static RasterBlock rasterBlock;
+static std::vector<TriangleSetup> s_triangles;
+static std::array<std::vector<u32>, NUM_TILES_X * NUM_TILES_Y> s_tile_bins;
+static std::vector<u32> s_binned_tiles;
+static std::atomic<size_t> s_next_binned_tile;
+
+static std::vector<std::thread> s_workers;
+static std::mutex s_workers_mutex;
+static std::condition_variable s_workers_wake;
+static std::condition_variable s_workers_done;
+static u32 s_workers_generation;
+static u32 s_workers_running;
+static bool s_workers_exit;
+
+static void WorkerThread(RasterContext* context);
 
 void Init()
 {
-  tev.Init();
+  const u32 num_workers = g_ActiveConfig.GetSWRasterizerThreads();
+
+  s_contexts.clear();
+  for (u32 i = 0; i <= num_workers; i++)
+  {
+    auto context = std::make_unique<RasterContext>();
+    for (Tev& tev : context->tev)
+      tev.Init();
+    context->rasterizedPixels = 0;
+    context->lastBlockKey = 0;
+    s_contexts.push_back(std::move(context));
+  }
 
   // Set initial z reference plane in the unlikely case that zfreeze is enabled when drawing the
   // first primitive.
   // TODO: This is just a guess!
   ZSlope.dfdx = ZSlope.dfdy = 0.f;
   ZSlope.f0 = 1.f;
+
+  s_carried_inputs = {};
+
+  s_workers_exit = false;
+  s_workers_generation = 0;
+  s_workers_running = 0;
+  for (u32 i = 1; i <= num_workers; i++)
+    s_workers.emplace_back(WorkerThread, s_contexts[i].get());
+}
+
+void Shutdown()
+{
+  {
+    std::lock_guard lk(s_workers_mutex);
+    s_workers_exit = true;
+  }
+  s_workers_wake.notify_all();
+  for (std::thread& worker : s_workers)
+    worker.join();
+  s_workers.clear();
+
+  for (u32 tile : s_binned_tiles)
+    s_tile_bins[tile].clear();
+  s_binned_tiles.clear();
+  s_triangles.clear();
+  s_contexts.clear();
 }
 
 // Returns approximation of log2(f) in s28.4
@@ -69,32 +173,40 @@ static inline int iround(float x)
 
 void SetTevReg(int reg, int comp, s16 color)
 {
-  tev.SetRegColor(reg, comp, color);
+  for (auto& context : s_contexts)
+  {
+    for (Tev& tev : context->tev)
+      tev.SetRegColor(reg, comp, color);
+  }
 }
 
-static void Draw(s32 x, s32 y, s32 xi, s32 yi)
+// Sets up the TEV inputs of a pixel, returns false if it fails the early depth test
+static bool SetupPixel(RasterContext& context, Tev& tev, const TriangleSetup& setup, s32 x, s32 y,
+                       s32 xi, s32 yi)
 {
-  INCSTAT(g_stats.this_frame.rasterized_pixels);
+  const RasterBlock& rasterBlock = context.rasterBlock;
+
+  context.rasterizedPixels++;
 
-  float dx = vertexOffsetX + (float)(x - vertex0X);
-  float dy = vertexOffsetY + (float)(y - vertex0Y);
+  float dx = setup.vertexOffsetX + (float)(x - setup.vertex0X);
+  float dy = setup.vertexOffsetY + (float)(y - setup.vertex0Y);
 
-  s32 z = (s32)std::clamp<float>(ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
+  s32 z = (s32)std::clamp<float>(setup.ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
 
   if (bpmem.UseEarlyDepthTest() && g_ActiveConfig.bZComploc)
   {
     // TODO: Test if perf regs are incremented even if test is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT_ZCOMPLOC);
+    tev.PerfQuadCounts[PQ_ZCOMP_INPUT_ZCOMPLOC]++;
     if (bpmem.zmode.testenable)
     {
       // early z
       if (!EfbInterface::ZCompare(x, y, z))
-        return;
+        return false;
     }
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
+    tev.PerfQuadCounts[PQ_ZCOMP_OUTPUT_ZCOMPLOC]++;
   }
 
-  RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
+  const RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
   tev.Position[0] = x;
   tev.Position[1] = y;
@@ -105,7 +217,7 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
   {
     for (int comp = 0; comp < 4; comp++)
     {
-      u16 color = (u16)ColorSlopes[i][comp].GetValue(dx, dy);
+      u16 color = (u16)setup.ColorSlopes[i][comp].GetValue(dx, dy);
 
       // clamp color value to 0
       u16 mask = ~(color >> 8);
@@ -134,19 +246,19 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
     tev.TextureLinear[i] = rasterBlock.TextureLinear[i];
   }
 
-  tev.Draw();
+  return true;
 }
 
-static void InitTriangle(float X1, float Y1, s32 xi, s32 yi)
+static void InitTriangle(TriangleSetup* setup, float X1, float Y1, s32 xi, s32 yi)
 {
-  vertex0X = xi;
-  vertex0Y = yi;
+  setup->vertex0X = xi;
+  setup->vertex0Y = yi;
 
   // adjust a little less than 0.5
   const float adjust = 0.495f;
 
-  vertexOffsetX = ((float)xi - X1) + adjust;
-  vertexOffsetY = ((float)yi - Y1) + adjust;
+  setup->vertexOffsetX = ((float)xi - X1) + adjust;
+  setup->vertexOffsetY = ((float)yi - Y1) + adjust;
 }
 
 static void InitSlope(Slope* slope, float f1, float f2, float f3, float DX31, float DX12,
@@ -162,7 +274,8 @@ static void InitSlope(Slope* slope, float f1, float f2, float f3, float DX31, fl
   slope->f0 = f1;
 }
 
-static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoord)
+static inline void CalculateLOD(const RasterBlock& rasterBlock, s32* lodp, bool* linear, u32 texmap,
+                                u32 texcoord)
 {
   const FourTexUnits& texUnit = bpmem.tex[(texmap >> 2) & 1];
   const u8 subTexmap = texmap & 3;
@@ -175,17 +288,17 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   float sDelta, tDelta;
   if (tm0.diag_lod)
   {
-    float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float* uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
+    const float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float* uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
 
     sDelta = fabsf(uv0[0] - uv1[0]);
     tDelta = fabsf(uv0[1] - uv1[1]);
   }
   else
   {
-    float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float* uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
-    float* uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
+    const float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float* uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
+    const float* uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
 
     sDelta = std::max(fabsf(uv0[0] - uv1[0]), fabsf(uv0[0] - uv2[0]));
     tDelta = std::max(fabsf(uv0[1] - uv1[1]), fabsf(uv0[1] - uv2[1]));
@@ -210,7 +323,8 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   *lodp = lod;
 }
 
-static void BuildBlock(s32 blockX, s32 blockY)
+static void BuildBlock(RasterBlock& rasterBlock, const TriangleSetup& setup, s32 blockX,
+                       s32 blockY)
 {
   for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
   {
@@ -218,10 +332,10 @@ static void BuildBlock(s32 blockX, s32 blockY)
     {
       RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
-      float dx = vertexOffsetX + (float)(xi + blockX - vertex0X);
-      float dy = vertexOffsetY + (float)(yi + blockY - vertex0Y);
+      float dx = setup.vertexOffsetX + (float)(xi + blockX - setup.vertex0X);
+      float dy = setup.vertexOffsetY + (float)(yi + blockY - setup.vertex0Y);
 
-      float invW = 1.0f / WSlope.GetValue(dx, dy);
+      float invW = 1.0f / setup.WSlope.GetValue(dx, dy);
       pixel.InvW = invW;
 
       // tex coords
@@ -230,13 +344,13 @@ static void BuildBlock(s32 blockX, s32 blockY)
         float projection = invW;
         if (xfmem.texMtxInfo[i].projection)
         {
-          float q = TexSlopes[i][2].GetValue(dx, dy) * invW;
+          float q = setup.TexSlopes[i][2].GetValue(dx, dy) * invW;
           if (q != 0.0f)
             projection = invW / q;
         }
 
-        pixel.Uv[i][0] = TexSlopes[i][0].GetValue(dx, dy) * projection;
-        pixel.Uv[i][1] = TexSlopes[i][1].GetValue(dx, dy) * projection;
+        pixel.Uv[i][0] = setup.TexSlopes[i][0].GetValue(dx, dy) * projection;
+        pixel.Uv[i][1] = setup.TexSlopes[i][1].GetValue(dx, dy) * projection;
       }
     }
   }
@@ -249,7 +363,8 @@ static void BuildBlock(s32 blockX, s32 blockY)
     u32 texcoord = indref & 3;
     indref >>= 3;
 
-    CalculateLOD(&rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
+    CalculateLOD(rasterBlock, &rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap,
+                 texcoord);
   }
 
   for (unsigned int i = 0; i <= bpmem.genMode.numtevstages; i++)
@@ -261,7 +376,332 @@ static void BuildBlock(s32 blockX, s32 blockY)
       u32 texmap = order.getTexMap(stageOdd);
       u32 texcoord = order.getTexCoord(stageOdd);
 
-      CalculateLOD(&rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
+      CalculateLOD(rasterBlock, &rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap,
+                   texcoord);
+    }
+  }
+}
+
+// Rasterizes the part of a triangle that lies within the given block aligned rectangle. If
+// carried_inputs is given, the pixels are shaded in order, starting from its inputs.
+static void RasterizeTriangle(RasterContext& context, const TriangleSetup& setup, u32 index,
+                              s32 minx, s32 maxx, s32 miny, s32 maxy,
+                              Tev::CarriedInputs* carried_inputs)
+{
+  const s32 DX12 = setup.DX12;
+  const s32 DX23 = setup.DX23;
+  const s32 DX31 = setup.DX31;
+
+  const s32 DY12 = setup.DY12;
+  const s32 DY23 = setup.DY23;
+  const s32 DY31 = setup.DY31;
+
+  // Fixed-pos32 deltas
+  const s32 FDX12 = DX12 * 16;
+  const s32 FDX23 = DX23 * 16;
+  const s32 FDX31 = DX31 * 16;
+
+  const s32 FDY12 = DY12 * 16;
+  const s32 FDY23 = DY23 * 16;
+  const s32 FDY31 = DY31 * 16;
+
+  const s32 C1 = setup.C1;
+  const s32 C2 = setup.C2;
+  const s32 C3 = setup.C3;
+
+  // Loop through blocks
+  for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
+  {
+    for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
+    {
+      // Corners of block
+      s32 x0 = x << 4;
+      s32 x1 = (x + BLOCK_SIZE - 1) << 4;
+      s32 y0 = y << 4;
+      s32 y1 = (y + BLOCK_SIZE - 1) << 4;
+
+      // Evaluate half-space functions
+      bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
+      bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
+      bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
+      bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
+      int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
+
+      bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
+      bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
+      bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
+      bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
+      int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
+
+      bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
+      bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
+      bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
+      bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
+      int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
+
+      // Skip block when outside an edge
+      if (a == 0x0 || b == 0x0 || c == 0x0)
+        continue;
+
+      BuildBlock(context.rasterBlock, setup, x, y);
+
+      int num_pixels = 0;
+
+      // Accept whole block when totally covered
+      if (a == 0xF && b == 0xF && c == 0xF)
+      {
+        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+        {
+          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+          {
+            if (SetupPixel(context, context.tev[num_pixels], setup, x + ix, y + iy, ix, iy))
+              num_pixels++;
+          }
+        }
+      }
+      else  // Partially covered block
+      {
+        s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
+        s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
+        s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
+
+        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+        {
+          s32 CX1 = CY1;
+          s32 CX2 = CY2;
+          s32 CX3 = CY3;
+
+          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+          {
+            if (CX1 > 0 && CX2 > 0 && CX3 > 0)
+            {
+              if (SetupPixel(context, context.tev[num_pixels], setup, x + ix, y + iy, ix, iy))
+                num_pixels++;
+            }
+
+            CX1 -= FDY12;
+            CX2 -= FDY23;
+            CX3 -= FDY31;
+          }
+
+          CY1 += FDX12;
+          CY2 += FDX23;
+          CY3 += FDX31;
+        }
+      }
+
+      if (num_pixels == 0)
+        continue;
+
+      Tev::DrawBlock(context.tev.data(), num_pixels, carried_inputs);
+
+      if (!carried_inputs)
+      {
+        const u64 key = (u64{index} + 1) << 32 | static_cast<u64>(y) << 16 | static_cast<u64>(x);
+        if (key > context.lastBlockKey)
+        {
+          context.lastBlockKey = key;
+          context.tev[num_pixels - 1].StoreCarriedInputs(&context.lastBlockInputs);
+        }
+      }
+    }
+  }
+}
+
+// Returns true if all blocks RasterizeTriangle would visit in the given rectangle are skipped
+static bool IsRectOutsideTriangle(const TriangleSetup& setup, s32 minx, s32 maxx, s32 miny,
+                                  s32 maxy)
+{
+  // The last block may extend past the end of the rectangle
+  const s32 x0 = minx << 4;
+  const s32 x1 = (((maxx - 1) & ~(BLOCK_SIZE - 1)) + BLOCK_SIZE - 1) << 4;
+  const s32 y0 = miny << 4;
+  const s32 y1 = (((maxy - 1) & ~(BLOCK_SIZE - 1)) + BLOCK_SIZE - 1) << 4;
+
+  const auto outside = [&](s32 C, s32 DX, s32 DY) {
+    return C + DX * y0 - DY * x0 <= 0 && C + DX * y0 - DY * x1 <= 0 &&
+           C + DX * y1 - DY * x0 <= 0 && C + DX * y1 - DY * x1 <= 0;
+  };
+
+  return outside(setup.C1, setup.DX12, setup.DY12) || outside(setup.C2, setup.DX23, setup.DY23) ||
+         outside(setup.C3, setup.DX31, setup.DY31);
+}
+
+static void BinTriangle(const TriangleSetup& setup)
+{
+  const u32 index = static_cast<u32>(s_triangles.size());
+  s_triangles.push_back(setup);
+
+  const s32 min_tile_x = setup.minx / TILE_SIZE;
+  const s32 max_tile_x = (setup.maxx - 1) / TILE_SIZE;
+  const s32 min_tile_y = setup.miny / TILE_SIZE;
+  const s32 max_tile_y = (setup.maxy - 1) / TILE_SIZE;
+
+  for (s32 tile_y = min_tile_y; tile_y <= max_tile_y; tile_y++)
+  {
+    for (s32 tile_x = min_tile_x; tile_x <= max_tile_x; tile_x++)
+    {
+      const s32 minx = std::max(setup.minx, tile_x * TILE_SIZE);
+      const s32 maxx = std::min(setup.maxx, (tile_x + 1) * TILE_SIZE);
+      const s32 miny = std::max(setup.miny, tile_y * TILE_SIZE);
+      const s32 maxy = std::min(setup.maxy, (tile_y + 1) * TILE_SIZE);
+      if (IsRectOutsideTriangle(setup, minx, maxx, miny, maxy))
+        continue;
+
+      const u32 tile = tile_y * NUM_TILES_X + tile_x;
+      std::vector<u32>& bin = s_tile_bins[tile];
+      if (bin.empty())
+        s_binned_tiles.push_back(tile);
+      bin.push_back(index);
+    }
+  }
+}
+
+static void RasterizeTile(RasterContext& context, u32 tile)
+{
+  const s32 tile_minx = static_cast<s32>(tile % NUM_TILES_X) * TILE_SIZE;
+  const s32 tile_miny = static_cast<s32>(tile / NUM_TILES_X) * TILE_SIZE;
+
+  // Triangles are binned in submission order, so every pixel still sees them in that order.
+  for (u32 index : s_tile_bins[tile])
+  {
+    const TriangleSetup& setup = s_triangles[index];
+    RasterizeTriangle(context, setup, index, std::max(setup.minx, tile_minx),
+                      std::min(setup.maxx, tile_minx + TILE_SIZE), std::max(setup.miny, tile_miny),
+                      std::min(setup.maxy, tile_miny + TILE_SIZE), nullptr);
+  }
+}
+
+static void RasterizeBinnedTiles(RasterContext& context)
+{
+  while (true)
+  {
+    const size_t i = s_next_binned_tile.fetch_add(1, std::memory_order_relaxed);
+    if (i >= s_binned_tiles.size())
+      return;
+
+    RasterizeTile(context, s_binned_tiles[i]);
+  }
+}
+
+static void WorkerThread(RasterContext* context)
+{
+  Common::SetCurrentThreadName("SW Rasterizer");
+
+  u32 generation = 0;
+  std::unique_lock lk(s_workers_mutex);
+  while (true)
+  {
+    s_workers_wake.wait(lk, [&] { return s_workers_exit || s_workers_generation != generation; });
+    if (s_workers_exit)
+      return;
+
+    generation = s_workers_generation;
+    lk.unlock();
+
+    RasterizeBinnedTiles(*context);
+
+    lk.lock();
+    if (--s_workers_running == 0)
+      s_workers_done.notify_one();
+  }
+}
+
+// Shades the pixels of all triangles in the order a single threaded rasterizer visits them, for
+// TEV configurations in which a pixel reads inputs that the previous pixel wrote.
+static void RasterizeTrianglesInOrder()
+{
+  RasterContext& context = *s_contexts[0];
+  for (u32 index = 0; index < static_cast<u32>(s_triangles.size()); index++)
+  {
+    const TriangleSetup& setup = s_triangles[index];
+    RasterizeTriangle(context, setup, index, setup.minx, setup.maxx, setup.miny, setup.maxy,
+                      &s_carried_inputs);
+  }
+}
+
+static void RasterizeTilesInParallel()
+{
+  // No pixel reads what another pixel of this batch wrote, but they all start from the inputs that
+  // the previous batches left behind.
+  for (auto& context : s_contexts)
+  {
+    for (Tev& tev : context->tev)
+      tev.LoadCarriedInputs(s_carried_inputs);
+  }
+
+  s_next_binned_tile.store(0, std::memory_order_relaxed);
+
+  const bool use_workers = !s_workers.empty() && s_binned_tiles.size() >= MIN_TILES_FOR_WORKERS;
+  if (use_workers)
+  {
+    {
+      std::lock_guard lk(s_workers_mutex);
+      s_workers_running = static_cast<u32>(s_workers.size());
+      s_workers_generation++;
+    }
+    s_workers_wake.notify_all();
+  }
+
+  RasterizeBinnedTiles(*s_contexts[0]);
+
+  if (use_workers)
+  {
+    std::unique_lock lk(s_workers_mutex);
+    s_workers_done.wait(lk, [] { return s_workers_running == 0; });
+  }
+
+  // Keep the inputs of the block that a single threaded rasterizer would have shaded last.
+  const auto last = std::max_element(s_contexts.begin(), s_contexts.end(), [](auto& a, auto& b) {
+    return a->lastBlockKey < b->lastBlockKey;
+  });
+  if ((*last)->lastBlockKey != 0)
+    s_carried_inputs = (*last)->lastBlockInputs;
+
+  for (auto& context : s_contexts)
+    context->lastBlockKey = 0;
+}
+
+void Flush()
+{
+  if (!s_binned_tiles.empty())
+  {
+    if (Tev::ReadsCarriedInputs())
+      RasterizeTrianglesInOrder();
+    else
+      RasterizeTilesInParallel();
+
+    for (u32 tile : s_binned_tiles)
+      s_tile_bins[tile].clear();
+    s_binned_tiles.clear();
+  }
+  s_triangles.clear();
+
+  // Merge the counters of all contexts. The results don't depend on which thread drew a pixel.
+  for (auto& context : s_contexts)
+  {
+    ADDSTAT(g_stats.this_frame.rasterized_pixels, context->rasterizedPixels);
+    context->rasterizedPixels = 0;
+
+    for (Tev& tev : context->tev)
+    {
+      ADDSTAT(g_stats.this_frame.tev_pixels_in, tev.PixelsIn);
+      ADDSTAT(g_stats.this_frame.tev_pixels_out, tev.PixelsOut);
+
+      for (int type = 0; type < PQ_NUM_MEMBERS; type++)
+      {
+        if (tev.PerfQuadCounts[type] != 0)
+          EfbInterface::IncPerfCounterQuadCount(static_cast<PerfQueryType>(type),
+                                                tev.PerfQuadCounts[type]);
+      }
+
+      if (tev.PixelsOut != 0)
+      {
+        BoundingBox::Update(tev.PixelBounds[0], tev.PixelBounds[1], tev.PixelBounds[2],
+                            tev.PixelBounds[3]);
+      }
+
+      tev.ResetCounters();
     }
   }
 }
@@ -292,15 +732,6 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   const s32 DY23 = Y2 - Y3;
   const s32 DY31 = Y3 - Y1;
 
-  // Fixed-pos32 deltas
-  const s32 FDX12 = DX12 * 16;
-  const s32 FDX23 = DX23 * 16;
-  const s32 FDX31 = DX31 * 16;
-
-  const s32 FDY12 = DY12 * 16;
-  const s32 FDY23 = DY23 * 16;
-  const s32 FDY31 = DY31 * 16;
-
   // Bounding rectangle
   s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
   s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
@@ -335,6 +766,8 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (minx >= maxx || miny >= maxy)
     return;
 
+  TriangleSetup setup;
+
   // Setup slopes
   float fltx1 = v0->screenPosition.x;
   float flty1 = v0->screenPosition.y;
@@ -343,11 +776,11 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   float fltdy12 = flty1 - v1->screenPosition.y;
   float fltdy31 = v2->screenPosition.y - flty1;
 
-  InitTriangle(fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
+  InitTriangle(&setup, fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
 
   float w[3] = {1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w,
                 1.0f / v2->projectedPosition.w};
-  InitSlope(&WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+  InitSlope(&setup.WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
 
   // TODO: The zfreeze emulation is not quite correct, yet!
   // Many things might prevent us from reaching this line (culling, clipping, scissoring).
@@ -358,19 +791,21 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (!bpmem.genMode.zfreeze || !g_ActiveConfig.bZFreeze)
     InitSlope(&ZSlope, v0->screenPosition[2], v1->screenPosition[2], v2->screenPosition[2], fltdx31,
               fltdx12, fltdy12, fltdy31);
+  setup.ZSlope = ZSlope;
 
   for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
   {
     for (int comp = 0; comp < 4; comp++)
-      InitSlope(&ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp],
-                fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&setup.ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp],
+                v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
   }
 
   for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
   {
     for (int comp = 0; comp < 3; comp++)
-      InitSlope(&TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1],
-                v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&setup.TexSlopes[i][comp], v0->texCoords[i][comp] * w[0],
+                v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12,
+                fltdy12, fltdy31);
   }
 
   // Half-edge constants
@@ -386,87 +821,31 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (DY31 < 0 || (DY31 == 0 && DX31 > 0))
     C3++;
 
-  // Start in corner of 8x8 block
-  minx &= ~(BLOCK_SIZE - 1);
-  miny &= ~(BLOCK_SIZE - 1);
+  setup.DX12 = DX12;
+  setup.DX23 = DX23;
+  setup.DX31 = DX31;
+  setup.DY12 = DY12;
+  setup.DY23 = DY23;
+  setup.DY31 = DY31;
+  setup.C1 = C1;
+  setup.C2 = C2;
+  setup.C3 = C3;
 
-  // Loop through blocks
-  for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
+  // Start in corner of 8x8 block
+  setup.minx = minx & ~(BLOCK_SIZE - 1);
+  setup.miny = miny & ~(BLOCK_SIZE - 1);
+  setup.maxx = maxx;
+  setup.maxy = maxy;
+
+  // The TEV stage dumps are written per pixel and can't be shared between threads. Without
+  // worker threads, binning would only add overhead.
+  if (s_workers.empty() || g_ActiveConfig.bDumpTevStages || g_ActiveConfig.bDumpTevTextureFetches)
   {
-    for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
-    {
-      // Corners of block
-      s32 x0 = x << 4;
-      s32 x1 = (x + BLOCK_SIZE - 1) << 4;
-      s32 y0 = y << 4;
-      s32 y1 = (y + BLOCK_SIZE - 1) << 4;
-
-      // Evaluate half-space functions
-      bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
-      bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
-      bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
-      bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
-      int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
-
-      bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
-      bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
-      bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
-      bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
-      int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
-
-      bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
-      bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
-      bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
-      bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
-      int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
-
-      // Skip block when outside an edge
-      if (a == 0x0 || b == 0x0 || c == 0x0)
-        continue;
-
-      BuildBlock(x, y);
-
-      // Accept whole block when totally covered
-      if (a == 0xF && b == 0xF && c == 0xF)
-      {
-        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-        {
-          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-          {
-            Draw(x + ix, y + iy, ix, iy);
-          }
-        }
-      }
-      else  // Partially covered block
-      {
-        s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
-        s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
-        s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
-
-        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-        {
-          s32 CX1 = CY1;
-          s32 CX2 = CY2;
-          s32 CX3 = CY3;
-
-          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-          {
-            if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-            {
-              Draw(x + ix, y + iy, ix, iy);
-            }
-
-            CX1 -= FDY12;
-            CX2 -= FDY23;
-            CX3 -= FDY31;
-          }
-
-          CY1 += FDX12;
-          CY2 += FDX23;
-          CY3 += FDX31;
-        }
-      }
-    }
+    RasterizeTriangle(*s_contexts[0], setup, 0, setup.minx, setup.maxx, setup.miny, setup.maxy,
+                      &s_carried_inputs);
+    return;
   }
+
+  BinTriangle(setup);
 }
 }  // namespace Rasterizer
@@ -11,10 +11,16 @@ struct OutputVertexData;
 namespace Rasterizer
 {
 void Init();
+void Shutdown();
 
+// Triangles may be binned and rasterized later, so Flush() must be called before the EFB or the
+// render state are accessed again.
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
                            const OutputVertexData* v2);
 
+// Finishes rasterizing all binned triangles and updates the EFB statistics and counters.
+void Flush();
+
 void SetTevReg(int reg, int comp, s16 color);
 
 struct Slope
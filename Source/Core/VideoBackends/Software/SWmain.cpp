@@ -130,6 +130,7 @@ void VideoSoftware::Shutdown()
     g_renderer->Shutdown();
 
   DebugUtil::Shutdown();
+  Rasterizer::Shutdown();
   g_texture_cache.reset();
   g_perf_query.reset();
   g_framebuffer_manager.reset();
@@ -13,10 +13,8 @@
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/TextureSampler.h"
 
-#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/PixelShaderManager.h"
-#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
@@ -146,30 +144,93 @@ void Tev::Init()
     m_KonstLUT[31][comp] = &KonstantColors[3][ALP_C];
   }
 
-  m_BiasLUT[0] = 0;
-  m_BiasLUT[1] = 128;
-  m_BiasLUT[2] = -128;
-  m_BiasLUT[3] = 0;
+  ResetCounters();
+}
+
+bool Tev::ReadsCarriedInputs()
+{
+  // The indirect maps and color channels which aren't set up for a pixel are never written while
+  // shading, so they keep the same value for a whole draw. Only the texture coordinate and texture
+  // color can hold a value which depends on the previous pixel.
+  bool tex_coord_written = false;
+  bool tex_coord_read_first = false;
+  bool tex_color_written = false;
+  bool tex_color_read_first = false;
+
+  for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
+  {
+    const int stageOdd = stageNum & 1;
+    const TwoTevStageOrders& order = bpmem.tevorders[stageNum >> 1];
+    const TevStageIndirect& indirect = bpmem.tevind[stageNum];
+    const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
+    const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
+
+    // Indirect leaves the texture coordinate alone for invalid matrices
+    if ((indirect.mid & 3) == 0 || (indirect.mid & 12) != 12)
+    {
+      if (indirect.fb_addprev && !tex_coord_written)
+        tex_coord_read_first = true;
+      tex_coord_written = true;
+    }
+
+    if (order.getEnable(stageOdd))
+    {
+      if (!tex_coord_written)
+        tex_coord_read_first = true;
+      tex_color_written = true;
+    }
+
+    const auto reads_color = [&cc](u32 arg) {
+      return cc.a == arg || cc.b == arg || cc.c == arg || cc.d == arg;
+    };
+    const bool reads_tex_color = reads_color(TEVCOLORARG_TEXC) ||
+                                 reads_color(TEVCOLORARG_TEXA) || ac.a == TEVALPHAARG_TEXA ||
+                                 ac.b == TEVALPHAARG_TEXA || ac.c == TEVALPHAARG_TEXA ||
+                                 ac.d == TEVALPHAARG_TEXA;
+    if (reads_tex_color && !tex_color_written)
+      tex_color_read_first = true;
+  }
 
-  m_ScaleLShiftLUT[0] = 0;
-  m_ScaleLShiftLUT[1] = 1;
-  m_ScaleLShiftLUT[2] = 2;
-  m_ScaleLShiftLUT[3] = 0;
+  // The z texture is taken from the texture color which the last stage left behind
+  if (bpmem.ztex2.op != ZTEXTURE_DISABLE && !tex_color_written)
+    tex_color_read_first = true;
+
+  return (tex_coord_read_first && tex_coord_written) ||
+         (tex_color_read_first && tex_color_written);
+}
 
-  m_ScaleRShiftLUT[0] = 0;
-  m_ScaleRShiftLUT[1] = 0;
-  m_ScaleRShiftLUT[2] = 0;
-  m_ScaleRShiftLUT[3] = 1;
+void Tev::LoadCarriedInputs(const CarriedInputs& inputs)
+{
+  std::copy_n(inputs.tex_color, 4, TexColor);
+  std::copy_n(&inputs.indirect_tex[0][0], 4 * 4, &IndirectTex[0][0]);
+  TexCoord = inputs.tex_coord;
+  for (u32 i = bpmem.genMode.numcolchans; i < 2; i++)
+    std::copy_n(inputs.color[i], 4, Color[i]);
+  for (u32 i = bpmem.genMode.numtexgens; i < 8; i++)
+    Uv[i] = inputs.uv[i];
 }
 
-static inline s16 Clamp255(s16 in)
+void Tev::StoreCarriedInputs(CarriedInputs* inputs) const
 {
-  return in > 255 ? 255 : (in < 0 ? 0 : in);
+  std::copy_n(TexColor, 4, inputs->tex_color);
+  std::copy_n(&IndirectTex[0][0], 4 * 4, &inputs->indirect_tex[0][0]);
+  inputs->tex_coord = TexCoord;
+  std::copy_n(&Color[0][0], 2 * 4, &inputs->color[0][0]);
+  std::copy_n(Uv, 8, inputs->uv);
 }
 
-static inline s16 Clamp1024(s16 in)
+void Tev::ResetCounters()
 {
-  return in > 1023 ? 1023 : (in < -1024 ? -1024 : in);
+  for (u32& count : PerfQuadCounts)
+    count = 0;
+
+  PixelsIn = 0;
+  PixelsOut = 0;
+
+  PixelBounds[0] = 0xFFFF;
+  PixelBounds[1] = 0;
+  PixelBounds[2] = 0xFFFF;
+  PixelBounds[3] = 0;
 }
 
 void Tev::SetRasColor(int colorChan, int swaptable)
@@ -224,159 +285,6 @@ void Tev::SetRasColor(int colorChan, int swaptable)
   }
 }
 
-void Tev::DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
-{
-  for (int i = 0; i < 3; i++)
-  {
-    const InputRegType& InputReg = inputs[BLU_C + i];
-
-    const u16 c = InputReg.c + (InputReg.c >> 7);
-
-    s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-    temp <<= m_ScaleLShiftLUT[cc.shift];
-    temp += (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
-    temp >>= 8;
-    temp = cc.op ? -temp : temp;
-
-    s32 result = ((InputReg.d + m_BiasLUT[cc.bias]) << m_ScaleLShiftLUT[cc.shift]) + temp;
-    result = result >> m_ScaleRShiftLUT[cc.shift];
-
-    Reg[cc.dest][BLU_C + i] = result;
-  }
-}
-
-void Tev::DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4])
-{
-  for (int i = BLU_C; i <= RED_C; i++)
-  {
-    switch ((cc.shift << 1) | cc.op | 8)  // encoded compare mode
-    {
-    case TEVCMP_R8_GT:
-      Reg[cc.dest][i] = inputs[i].d + ((inputs[RED_C].a > inputs[RED_C].b) ? inputs[i].c : 0);
-      break;
-
-    case TEVCMP_R8_EQ:
-      Reg[cc.dest][i] = inputs[i].d + ((inputs[RED_C].a == inputs[RED_C].b) ? inputs[i].c : 0);
-      break;
-
-    case TEVCMP_GR16_GT:
-    {
-      const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      Reg[cc.dest][i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
-    }
-    break;
-
-    case TEVCMP_GR16_EQ:
-    {
-      const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      Reg[cc.dest][i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
-    }
-    break;
-
-    case TEVCMP_BGR24_GT:
-    {
-      const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      Reg[cc.dest][i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
-    }
-    break;
-
-    case TEVCMP_BGR24_EQ:
-    {
-      const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-      const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-      Reg[cc.dest][i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
-    }
-    break;
-
-    case TEVCMP_RGB8_GT:
-      Reg[cc.dest][i] = inputs[i].d + ((inputs[i].a > inputs[i].b) ? inputs[i].c : 0);
-      break;
-
-    case TEVCMP_RGB8_EQ:
-      Reg[cc.dest][i] = inputs[i].d + ((inputs[i].a == inputs[i].b) ? inputs[i].c : 0);
-      break;
-    }
-  }
-}
-
-void Tev::DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
-{
-  const InputRegType& InputReg = inputs[ALP_C];
-
-  const u16 c = InputReg.c + (InputReg.c >> 7);
-
-  s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-  temp <<= m_ScaleLShiftLUT[ac.shift];
-  temp += (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
-  temp = ac.op ? (-temp >> 8) : (temp >> 8);
-
-  s32 result = ((InputReg.d + m_BiasLUT[ac.bias]) << m_ScaleLShiftLUT[ac.shift]) + temp;
-  result = result >> m_ScaleRShiftLUT[ac.shift];
-
-  Reg[ac.dest][ALP_C] = result;
-}
-
-void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
-{
-  switch ((ac.shift << 1) | ac.op | 8)  // encoded compare mode
-  {
-  case TEVCMP_R8_GT:
-    Reg[ac.dest][ALP_C] =
-        inputs[ALP_C].d + ((inputs[RED_C].a > inputs[RED_C].b) ? inputs[ALP_C].c : 0);
-    break;
-
-  case TEVCMP_R8_EQ:
-    Reg[ac.dest][ALP_C] =
-        inputs[ALP_C].d + ((inputs[RED_C].a == inputs[RED_C].b) ? inputs[ALP_C].c : 0);
-    break;
-
-  case TEVCMP_GR16_GT:
-  {
-    const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    Reg[ac.dest][ALP_C] = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
-  }
-  break;
-
-  case TEVCMP_GR16_EQ:
-  {
-    const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    Reg[ac.dest][ALP_C] = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
-  }
-  break;
-
-  case TEVCMP_BGR24_GT:
-  {
-    const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    Reg[ac.dest][ALP_C] = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
-  }
-  break;
-
-  case TEVCMP_BGR24_EQ:
-  {
-    const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
-    const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
-    Reg[ac.dest][ALP_C] = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
-  }
-  break;
-
-  case TEVCMP_A8_GT:
-    Reg[ac.dest][ALP_C] =
-        inputs[ALP_C].d + ((inputs[ALP_C].a > inputs[ALP_C].b) ? inputs[ALP_C].c : 0);
-    break;
-
-  case TEVCMP_A8_EQ:
-    Reg[ac.dest][ALP_C] =
-        inputs[ALP_C].d + ((inputs[ALP_C].a == inputs[ALP_C].b) ? inputs[ALP_C].c : 0);
-    break;
-  }
-}
-
 static bool AlphaCompare(int alpha, int ref, AlphaTest::CompareMode comp)
 {
   switch (comp)
@@ -565,12 +473,12 @@ void Tev::Indirect(unsigned int stageNum, s32 s, s32 t)
   }
 }
 
-void Tev::Draw()
+void Tev::BeginDraw()
 {
   ASSERT(Position[0] >= 0 && Position[0] < s32(EFB_WIDTH));
   ASSERT(Position[1] >= 0 && Position[1] < s32(EFB_HEIGHT));
 
-  INCSTAT(g_stats.this_frame.tev_pixels_in);
+  PixelsIn++;
 
   // initial color values
   for (int i = 0; i < 4; i++)
@@ -607,108 +515,94 @@ void Tev::Draw()
     }
 #endif
   }
+}
 
-  for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
-  {
-    const int stageNum2 = stageNum >> 1;
-    const int stageOdd = stageNum & 1;
-    const TwoTevStageOrders& order = bpmem.tevorders[stageNum2];
-    const TevKSel& kSel = bpmem.tevksel[stageNum2];
+void Tev::FetchStageInputs(unsigned int stageNum, TevCombiner::Inputs* inputs, int pixel)
+{
+  const int stageNum2 = stageNum >> 1;
+  const int stageOdd = stageNum & 1;
+  const TwoTevStageOrders& order = bpmem.tevorders[stageNum2];
+  const TevKSel& kSel = bpmem.tevksel[stageNum2];
 
-    // stage combiners
-    const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
-    const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
+  // stage combiners
+  const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
+  const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
 
-    const int texcoordSel = order.getTexCoord(stageOdd);
-    const int texmap = order.getTexMap(stageOdd);
+  const int texcoordSel = order.getTexCoord(stageOdd);
+  const int texmap = order.getTexMap(stageOdd);
 
-    Indirect(stageNum, Uv[texcoordSel].s, Uv[texcoordSel].t);
+  Indirect(stageNum, Uv[texcoordSel].s, Uv[texcoordSel].t);
 
-    // sample texture
-    if (order.getEnable(stageOdd))
-    {
-      // RGBA
-      u8 texel[4];
+  // sample texture
+  if (order.getEnable(stageOdd))
+  {
+    // RGBA
+    u8 texel[4];
 
-      TextureSampler::Sample(TexCoord.s, TexCoord.t, TextureLod[stageNum], TextureLinear[stageNum],
-                             texmap, texel);
+    TextureSampler::Sample(TexCoord.s, TexCoord.t, TextureLod[stageNum], TextureLinear[stageNum],
+                           texmap, texel);
 
 #if ALLOW_TEV_DUMPS
-      if (g_ActiveConfig.bDumpTevTextureFetches)
-        DebugUtil::DrawTempBuffer(texel, DIRECT_TFETCH + stageNum);
+    if (g_ActiveConfig.bDumpTevTextureFetches)
+      DebugUtil::DrawTempBuffer(texel, DIRECT_TFETCH + stageNum);
 #endif
 
-      int swaptable = ac.tswap * 2;
-
-      TexColor[RED_C] = texel[bpmem.tevksel[swaptable].swap1];
-      TexColor[GRN_C] = texel[bpmem.tevksel[swaptable].swap2];
-      swaptable++;
-      TexColor[BLU_C] = texel[bpmem.tevksel[swaptable].swap1];
-      TexColor[ALP_C] = texel[bpmem.tevksel[swaptable].swap2];
-    }
-
-    // set konst for this stage
-    const int kc = kSel.getKC(stageOdd);
-    const int ka = kSel.getKA(stageOdd);
-    StageKonst[RED_C] = *(m_KonstLUT[kc][RED_C]);
-    StageKonst[GRN_C] = *(m_KonstLUT[kc][GRN_C]);
-    StageKonst[BLU_C] = *(m_KonstLUT[kc][BLU_C]);
-    StageKonst[ALP_C] = *(m_KonstLUT[ka][ALP_C]);
+    int swaptable = ac.tswap * 2;
 
-    // set color
-    SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
+    TexColor[RED_C] = texel[bpmem.tevksel[swaptable].swap1];
+    TexColor[GRN_C] = texel[bpmem.tevksel[swaptable].swap2];
+    swaptable++;
+    TexColor[BLU_C] = texel[bpmem.tevksel[swaptable].swap1];
+    TexColor[ALP_C] = texel[bpmem.tevksel[swaptable].swap2];
+  }
 
-    // combine inputs
-    InputRegType inputs[4];
-    for (int i = 0; i < 3; i++)
-    {
-      inputs[BLU_C + i].a = *m_ColorInputLUT[cc.a][i];
-      inputs[BLU_C + i].b = *m_ColorInputLUT[cc.b][i];
-      inputs[BLU_C + i].c = *m_ColorInputLUT[cc.c][i];
-      inputs[BLU_C + i].d = *m_ColorInputLUT[cc.d][i];
-    }
-    inputs[ALP_C].a = *m_AlphaInputLUT[ac.a];
-    inputs[ALP_C].b = *m_AlphaInputLUT[ac.b];
-    inputs[ALP_C].c = *m_AlphaInputLUT[ac.c];
-    inputs[ALP_C].d = *m_AlphaInputLUT[ac.d];
+  // set konst for this stage
+  const int kc = kSel.getKC(stageOdd);
+  const int ka = kSel.getKA(stageOdd);
+  StageKonst[RED_C] = *(m_KonstLUT[kc][RED_C]);
+  StageKonst[GRN_C] = *(m_KonstLUT[kc][GRN_C]);
+  StageKonst[BLU_C] = *(m_KonstLUT[kc][BLU_C]);
+  StageKonst[ALP_C] = *(m_KonstLUT[ka][ALP_C]);
 
-    if (cc.bias != 3)
-      DrawColorRegular(cc, inputs);
-    else
-      DrawColorCompare(cc, inputs);
+  // set color
+  SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
 
-    if (cc.clamp)
-    {
-      Reg[cc.dest][RED_C] = Clamp255(Reg[cc.dest][RED_C]);
-      Reg[cc.dest][GRN_C] = Clamp255(Reg[cc.dest][GRN_C]);
-      Reg[cc.dest][BLU_C] = Clamp255(Reg[cc.dest][BLU_C]);
-    }
-    else
-    {
-      Reg[cc.dest][RED_C] = Clamp1024(Reg[cc.dest][RED_C]);
-      Reg[cc.dest][GRN_C] = Clamp1024(Reg[cc.dest][GRN_C]);
-      Reg[cc.dest][BLU_C] = Clamp1024(Reg[cc.dest][BLU_C]);
-    }
+  // combine inputs
+  for (int i = 0; i < 3; i++)
+  {
+    inputs->a[pixel][BLU_C + i] = *m_ColorInputLUT[cc.a][i];
+    inputs->b[pixel][BLU_C + i] = *m_ColorInputLUT[cc.b][i];
+    inputs->c[pixel][BLU_C + i] = *m_ColorInputLUT[cc.c][i];
+    inputs->d[pixel][BLU_C + i] = *m_ColorInputLUT[cc.d][i];
+  }
+  inputs->a[pixel][ALP_C] = *m_AlphaInputLUT[ac.a];
+  inputs->b[pixel][ALP_C] = *m_AlphaInputLUT[ac.b];
+  inputs->c[pixel][ALP_C] = *m_AlphaInputLUT[ac.c];
+  inputs->d[pixel][ALP_C] = *m_AlphaInputLUT[ac.d];
+}
 
-    if (ac.bias != 3)
-      DrawAlphaRegular(ac, inputs);
-    else
-      DrawAlphaCompare(ac, inputs);
+void Tev::StoreStageResults(unsigned int stageNum, const TevCombiner::Outputs& outputs, int pixel)
+{
+  const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
+  const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
+  const s16* result = outputs.result[pixel];
 
-    if (ac.clamp)
-      Reg[ac.dest][ALP_C] = Clamp255(Reg[ac.dest][ALP_C]);
-    else
-      Reg[ac.dest][ALP_C] = Clamp1024(Reg[ac.dest][ALP_C]);
+  Reg[cc.dest][RED_C] = result[RED_C];
+  Reg[cc.dest][GRN_C] = result[GRN_C];
+  Reg[cc.dest][BLU_C] = result[BLU_C];
+  Reg[ac.dest][ALP_C] = result[ALP_C];
 
 #if ALLOW_TEV_DUMPS
-    if (g_ActiveConfig.bDumpTevStages)
-    {
-      u8 stage[4] = {(u8)Reg[0][RED_C], (u8)Reg[0][GRN_C], (u8)Reg[0][BLU_C], (u8)Reg[0][ALP_C]};
-      DebugUtil::DrawTempBuffer(stage, DIRECT + stageNum);
-    }
-#endif
+  if (g_ActiveConfig.bDumpTevStages)
+  {
+    u8 stage[4] = {(u8)Reg[0][RED_C], (u8)Reg[0][GRN_C], (u8)Reg[0][BLU_C], (u8)Reg[0][ALP_C]};
+    DebugUtil::DrawTempBuffer(stage, DIRECT + stageNum);
   }
+#endif
+}
 
+void Tev::EndDraw()
+{
   // convert to 8 bits per component
   // the results of the last tev stage are put onto the screen,
   // regardless of the used destination register - TODO: Verify!
@@ -833,16 +727,18 @@ void Tev::Draw()
   if (late_ztest && bpmem.zmode.testenable)
   {
     // TODO: Check against hw if these values get incremented even if depth testing is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
+    PerfQuadCounts[PQ_ZCOMP_INPUT]++;
 
     if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
       return;
 
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
+    PerfQuadCounts[PQ_ZCOMP_OUTPUT]++;
   }
 
-  BoundingBox::Update(static_cast<u16>(Position[0]), static_cast<u16>(Position[0]),
-                      static_cast<u16>(Position[1]), static_cast<u16>(Position[1]));
+  PixelBounds[0] = std::min(PixelBounds[0], static_cast<u16>(Position[0]));
+  PixelBounds[1] = std::max(PixelBounds[1], static_cast<u16>(Position[0]));
+  PixelBounds[2] = std::min(PixelBounds[2], static_cast<u16>(Position[1]));
+  PixelBounds[3] = std::max(PixelBounds[3], static_cast<u16>(Position[1]));
 
 #if ALLOW_TEV_DUMPS
   if (g_ActiveConfig.bDumpTevStages)
@@ -864,12 +760,57 @@ void Tev::Draw()
   }
 #endif
 
-  INCSTAT(g_stats.this_frame.tev_pixels_out);
-  EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
+  PixelsOut++;
+  PerfQuadCounts[PQ_BLEND_INPUT]++;
 
   EfbInterface::BlendTev(Position[0], Position[1], output);
 }
 
+void Tev::DrawBlock(Tev* pixels, int count, CarriedInputs* carried_inputs)
+{
+  if (carried_inputs)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      pixels[i].LoadCarriedInputs(*carried_inputs);
+      DrawBlock(&pixels[i], 1);
+      pixels[i].StoreCarriedInputs(carried_inputs);
+    }
+    return;
+  }
+
+#if ALLOW_TEV_DUMPS
+  // The dumps go through a single temporary buffer, so pixels have to be shaded one at a time.
+  if (count > 1 && (g_ActiveConfig.bDumpTevStages || g_ActiveConfig.bDumpTevTextureFetches))
+  {
+    for (int i = 0; i < count; i++)
+      DrawBlock(&pixels[i], 1);
+    return;
+  }
+#endif
+
+  for (int i = 0; i < count; i++)
+    pixels[i].BeginDraw();
+
+  for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
+  {
+    // Unused pixels still go through the combiners, so give them defined inputs.
+    TevCombiner::Inputs inputs{};
+    for (int i = 0; i < count; i++)
+      pixels[i].FetchStageInputs(stageNum, &inputs, i);
+
+    TevCombiner::Outputs outputs;
+    TevCombiner::Combine(bpmem.combiners[stageNum].colorC, bpmem.combiners[stageNum].alphaC, inputs,
+                         &outputs);
+
+    for (int i = 0; i < count; i++)
+      pixels[i].StoreStageResults(stageNum, outputs, i);
+  }
+
+  for (int i = 0; i < count; i++)
+    pixels[i].EndDraw();
+}
+
 void Tev::SetRegColor(int reg, int comp, s16 color)
 {
   KonstantColors[reg][comp] = color;
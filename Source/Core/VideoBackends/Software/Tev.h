@@ -4,18 +4,12 @@
 
 #pragma once
 
+#include "VideoBackends/Software/TevCombiner.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PerfQueryBase.h"
 
 class Tev
 {
-  struct InputRegType
-  {
-    unsigned a : 8;
-    unsigned b : 8;
-    unsigned c : 8;
-    signed d : 11;
-  };
-
   struct TextureCoordinateType
   {
     signed s : 24;
@@ -38,9 +32,6 @@ class Tev
   s16* m_ColorInputLUT[16][3];
   s16* m_AlphaInputLUT[8];  // values must point to ABGR color
   s16* m_KonstLUT[32][4];
-  s16 m_BiasLUT[4];
-  u8 m_ScaleLShiftLUT[4];
-  u8 m_ScaleRShiftLUT[4];
 
   // enumeration for color input LUT
   enum
@@ -59,13 +50,13 @@ class Tev
 
   void SetRasColor(int colorChan, int swaptable);
 
-  void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-  void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
-  void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
-
   void Indirect(unsigned int stageNum, s32 s, s32 t);
 
+  void BeginDraw();
+  void FetchStageInputs(unsigned int stageNum, TevCombiner::Inputs* inputs, int pixel);
+  void StoreStageResults(unsigned int stageNum, const TevCombiner::Outputs& outputs, int pixel);
+  void EndDraw();
+
 public:
   s32 Position[3];
   u8 Color[2][4];  // must be RGBA for correct swap table ordering
@@ -75,6 +66,14 @@ public:
   s32 TextureLod[16];
   bool TextureLinear[16];
 
+  // Statistics gathered while shading. Every Tev instance keeps its own copy so that several
+  // instances can shade disjoint parts of the EFB concurrently; the rasterizer merges them into
+  // the global counters once a batch has been drawn.
+  u32 PerfQuadCounts[PQ_NUM_MEMBERS];
+  u32 PixelsIn;
+  u32 PixelsOut;
+  u16 PixelBounds[4];  // left, right, top, bottom of all pixels written
+
   enum
   {
     ALP_C,
@@ -83,9 +82,33 @@ public:
     RED_C
   };
 
+  // The inputs which the rasterizer doesn't set up for every pixel, and which keep what the
+  // previously shaded pixel left in them until a stage writes them. The texture color of a stage
+  // without a texture lookup is one of them.
+  struct CarriedInputs
+  {
+    s16 tex_color[4];
+    u8 indirect_tex[4][4];
+    TextureCoordinateType tex_coord;
+    u8 color[2][4];
+    TextureCoordinateType uv[8];
+  };
+
   void Init();
+  void ResetCounters();
+
+  // Returns true if the current configuration reads a carried input before writing it, and also
+  // writes it, so that the result of a pixel depends on the pixel that was shaded before it.
+  static bool ReadsCarriedInputs();
+
+  // Only loads the color channels and texture coordinates which the rasterizer doesn't set up.
+  void LoadCarriedInputs(const CarriedInputs& inputs);
+  void StoreCarriedInputs(CarriedInputs* inputs) const;
 
-  void Draw();
+  // Shades the pixels of one rasterizer block. The stages are evaluated for all of them together,
+  // so that the combiners can use SIMD instructions. If carried_inputs is given, the pixels are
+  // shaded one at a time instead, each starting from what the previous one left behind.
+  static void DrawBlock(Tev* pixels, int count, CarriedInputs* carried_inputs = nullptr);
 
   void SetRegColor(int reg, int comp, s16 color);
 };
@@ -0,0 +1,435 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoBackends/Software/TevCombiner.h"
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+
+namespace TevCombiner
+{
+namespace
+{
+enum
+{
+  ALP_C,
+  BLU_C,
+  GRN_C,
+  RED_C
+};
+
+struct InputRegType
+{
+  unsigned a : 8;
+  unsigned b : 8;
+  unsigned c : 8;
+  signed d : 11;
+};
+
+constexpr s16 BIAS_LUT[4] = {0, 128, -128, 0};
+constexpr u8 SCALE_LSHIFT_LUT[4] = {0, 1, 2, 0};
+constexpr u8 SCALE_RSHIFT_LUT[4] = {0, 0, 0, 1};
+
+s16 Clamp255(s16 in)
+{
+  return in > 255 ? 255 : (in < 0 ? 0 : in);
+}
+
+s16 Clamp1024(s16 in)
+{
+  return in > 1023 ? 1023 : (in < -1024 ? -1024 : in);
+}
+
+void GetInputRegs(const Inputs& inputs, int pixel, InputRegType regs[4])
+{
+  for (int i = 0; i < 4; i++)
+  {
+    regs[i].a = inputs.a[pixel][i];
+    regs[i].b = inputs.b[pixel][i];
+    regs[i].c = inputs.c[pixel][i];
+    regs[i].d = inputs.d[pixel][i];
+  }
+}
+
+s16 CombineColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType& InputReg)
+{
+  const u16 c = InputReg.c + (InputReg.c >> 7);
+
+  s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
+  temp <<= SCALE_LSHIFT_LUT[cc.shift];
+  temp += (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
+  temp >>= 8;
+  temp = cc.op ? -temp : temp;
+
+  s32 result = ((InputReg.d + BIAS_LUT[cc.bias]) << SCALE_LSHIFT_LUT[cc.shift]) + temp;
+  result = result >> SCALE_RSHIFT_LUT[cc.shift];
+
+  return cc.clamp ? Clamp255(result) : Clamp1024(result);
+}
+
+s16 CombineAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType& InputReg)
+{
+  const u16 c = InputReg.c + (InputReg.c >> 7);
+
+  s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
+  temp <<= SCALE_LSHIFT_LUT[ac.shift];
+  temp += (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
+  temp = ac.op ? (-temp >> 8) : (temp >> 8);
+
+  s32 result = ((InputReg.d + BIAS_LUT[ac.bias]) << SCALE_LSHIFT_LUT[ac.shift]) + temp;
+  result = result >> SCALE_RSHIFT_LUT[ac.shift];
+
+  return ac.clamp ? Clamp255(result) : Clamp1024(result);
+}
+
+void CombineColorCompare(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4],
+                         s16* result)
+{
+  for (int i = BLU_C; i <= RED_C; i++)
+  {
+    switch ((cc.shift << 1) | cc.op | 8)  // encoded compare mode
+    {
+    case TEVCMP_R8_GT:
+      result[i] = inputs[i].d + ((inputs[RED_C].a > inputs[RED_C].b) ? inputs[i].c : 0);
+      break;
+
+    case TEVCMP_R8_EQ:
+      result[i] = inputs[i].d + ((inputs[RED_C].a == inputs[RED_C].b) ? inputs[i].c : 0);
+      break;
+
+    case TEVCMP_GR16_GT:
+    {
+      const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+      const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+      result[i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
+    }
+    break;
+
+    case TEVCMP_GR16_EQ:
+    {
+      const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+      const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+      result[i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
+    }
+    break;
+
+    case TEVCMP_BGR24_GT:
+    {
+      const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+      const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+      result[i] = inputs[i].d + ((a > b) ? inputs[i].c : 0);
+    }
+    break;
+
+    case TEVCMP_BGR24_EQ:
+    {
+      const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+      const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+      result[i] = inputs[i].d + ((a == b) ? inputs[i].c : 0);
+    }
+    break;
+
+    case TEVCMP_RGB8_GT:
+      result[i] = inputs[i].d + ((inputs[i].a > inputs[i].b) ? inputs[i].c : 0);
+      break;
+
+    case TEVCMP_RGB8_EQ:
+      result[i] = inputs[i].d + ((inputs[i].a == inputs[i].b) ? inputs[i].c : 0);
+      break;
+    }
+
+    result[i] = cc.clamp ? Clamp255(result[i]) : Clamp1024(result[i]);
+  }
+}
+
+s16 CombineAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
+{
+  s16 result = 0;
+
+  switch ((ac.shift << 1) | ac.op | 8)  // encoded compare mode
+  {
+  case TEVCMP_R8_GT:
+    result = inputs[ALP_C].d + ((inputs[RED_C].a > inputs[RED_C].b) ? inputs[ALP_C].c : 0);
+    break;
+
+  case TEVCMP_R8_EQ:
+    result = inputs[ALP_C].d + ((inputs[RED_C].a == inputs[RED_C].b) ? inputs[ALP_C].c : 0);
+    break;
+
+  case TEVCMP_GR16_GT:
+  {
+    const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+    const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+    result = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
+  }
+  break;
+
+  case TEVCMP_GR16_EQ:
+  {
+    const u32 a = (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+    const u32 b = (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+    result = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
+  }
+  break;
+
+  case TEVCMP_BGR24_GT:
+  {
+    const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+    const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+    result = inputs[ALP_C].d + ((a > b) ? inputs[ALP_C].c : 0);
+  }
+  break;
+
+  case TEVCMP_BGR24_EQ:
+  {
+    const u32 a = (inputs[BLU_C].a << 16) | (inputs[GRN_C].a << 8) | inputs[RED_C].a;
+    const u32 b = (inputs[BLU_C].b << 16) | (inputs[GRN_C].b << 8) | inputs[RED_C].b;
+    result = inputs[ALP_C].d + ((a == b) ? inputs[ALP_C].c : 0);
+  }
+  break;
+
+  case TEVCMP_A8_GT:
+    result = inputs[ALP_C].d + ((inputs[ALP_C].a > inputs[ALP_C].b) ? inputs[ALP_C].c : 0);
+    break;
+
+  case TEVCMP_A8_EQ:
+    result = inputs[ALP_C].d + ((inputs[ALP_C].a == inputs[ALP_C].b) ? inputs[ALP_C].c : 0);
+    break;
+  }
+
+  return ac.clamp ? Clamp255(result) : Clamp1024(result);
+}
+
+#ifdef _M_X86
+// Per-component parameters of the regular combiners, in register component order. The alpha
+// combiner rounds and negates differently from the color combiner, and this is preserved here.
+struct alignas(16) LaneParams
+{
+  s16 scale[4];  // 1 << lshift
+  s16 bias[4];
+  s16 clamp_min[4];
+  s16 clamp_max[4];
+  s32 round[4];
+  s32 negate_before_shift[4];  // all bits set to negate
+  s32 negate_after_shift[4];
+  s32 halve[4];  // all bits set for an arithmetic right shift by one
+};
+
+LaneParams GetLaneParams(const TevStageCombiner::ColorCombiner& cc,
+                         const TevStageCombiner::AlphaCombiner& ac)
+{
+  LaneParams params;
+
+  params.scale[ALP_C] = 1 << SCALE_LSHIFT_LUT[ac.shift];
+  params.bias[ALP_C] = BIAS_LUT[ac.bias];
+  params.clamp_min[ALP_C] = ac.clamp ? 0 : -1024;
+  params.clamp_max[ALP_C] = ac.clamp ? 255 : 1023;
+  params.round[ALP_C] = (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
+  params.negate_before_shift[ALP_C] = ac.op ? -1 : 0;
+  params.negate_after_shift[ALP_C] = 0;
+  params.halve[ALP_C] = SCALE_RSHIFT_LUT[ac.shift] ? -1 : 0;
+
+  for (int i = BLU_C; i <= RED_C; i++)
+  {
+    params.scale[i] = 1 << SCALE_LSHIFT_LUT[cc.shift];
+    params.bias[i] = BIAS_LUT[cc.bias];
+    params.clamp_min[i] = cc.clamp ? 0 : -1024;
+    params.clamp_max[i] = cc.clamp ? 255 : 1023;
+    params.round[i] = (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
+    params.negate_before_shift[i] = 0;
+    params.negate_after_shift[i] = cc.op ? -1 : 0;
+    params.halve[i] = SCALE_RSHIFT_LUT[cc.shift] ? -1 : 0;
+  }
+
+  return params;
+}
+
+// Loads four 16-bit parameters into both halves of a vector
+__m128i LoadParams16(const s16* params)
+{
+  const __m128i value = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(params));
+  return _mm_unpacklo_epi64(value, value);
+}
+#endif
+}  // Anonymous namespace
+
+void CombineRegularScalar(const TevStageCombiner::ColorCombiner& cc,
+                          const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs,
+                          Outputs* outputs)
+{
+  for (int pixel = 0; pixel < NUM_PIXELS; pixel++)
+  {
+    InputRegType regs[4];
+    GetInputRegs(inputs, pixel, regs);
+
+    s16* result = outputs->result[pixel];
+    for (int i = BLU_C; i <= RED_C; i++)
+      result[i] = CombineColorRegular(cc, regs[i]);
+    result[ALP_C] = CombineAlphaRegular(ac, regs[ALP_C]);
+  }
+}
+
+#ifdef _M_X86
+// Processes two pixels at a time. The products are computed with pmaddwd from interleaved
+// (a, b) and (256 - c, c) pairs; a and b are scaled beforehand, which is equivalent to scaling
+// the 32-bit sum.
+void CombineRegularSSE2(const TevStageCombiner::ColorCombiner& cc,
+                        const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs,
+                        Outputs* outputs)
+{
+  const LaneParams params = GetLaneParams(cc, ac);
+
+  const __m128i scale = LoadParams16(params.scale);
+  const __m128i bias = LoadParams16(params.bias);
+  const __m128i clamp_min = LoadParams16(params.clamp_min);
+  const __m128i clamp_max = LoadParams16(params.clamp_max);
+  const __m128i round = _mm_load_si128(reinterpret_cast<const __m128i*>(params.round));
+  const __m128i negate_before_shift =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(params.negate_before_shift));
+  const __m128i negate_after_shift =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(params.negate_after_shift));
+  const __m128i halve = _mm_load_si128(reinterpret_cast<const __m128i*>(params.halve));
+
+  const __m128i mask_u8 = _mm_set1_epi16(0xFF);
+  const __m128i c_max = _mm_set1_epi16(256);
+
+  for (int pixel = 0; pixel < NUM_PIXELS; pixel += 2)
+  {
+    __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(inputs.a[pixel]));
+    __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(inputs.b[pixel]));
+    __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(inputs.c[pixel]));
+    __m128i d = _mm_load_si128(reinterpret_cast<const __m128i*>(inputs.d[pixel]));
+
+    // a, b and c are 8-bit unsigned, d is 11-bit signed
+    a = _mm_mullo_epi16(_mm_and_si128(a, mask_u8), scale);
+    b = _mm_mullo_epi16(_mm_and_si128(b, mask_u8), scale);
+    c = _mm_and_si128(c, mask_u8);
+    c = _mm_add_epi16(c, _mm_srli_epi16(c, 7));
+    const __m128i inv_c = _mm_sub_epi16(c_max, c);
+    d = _mm_srai_epi16(_mm_slli_epi16(d, 5), 5);
+    d = _mm_mullo_epi16(_mm_add_epi16(d, bias), scale);
+
+    const __m128i ab[2] = {_mm_unpacklo_epi16(a, b), _mm_unpackhi_epi16(a, b)};
+    const __m128i weights[2] = {_mm_unpacklo_epi16(inv_c, c), _mm_unpackhi_epi16(inv_c, c)};
+    const __m128i d32[2] = {_mm_srai_epi32(_mm_unpacklo_epi16(d, d), 16),
+                            _mm_srai_epi32(_mm_unpackhi_epi16(d, d), 16)};
+
+    __m128i result[2];
+    for (int i = 0; i < 2; i++)
+    {
+      __m128i temp = _mm_madd_epi16(ab[i], weights[i]);
+      temp = _mm_add_epi32(temp, round);
+      temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_before_shift), negate_before_shift);
+      temp = _mm_srai_epi32(temp, 8);
+      temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_after_shift), negate_after_shift);
+
+      const __m128i sum = _mm_add_epi32(d32[i], temp);
+      result[i] = _mm_or_si128(_mm_andnot_si128(halve, sum),
+                               _mm_and_si128(halve, _mm_srai_epi32(sum, 1)));
+    }
+
+    // The results always fit into 16 bits, so the saturation of packssdw never kicks in.
+    __m128i packed = _mm_packs_epi32(result[0], result[1]);
+    packed = _mm_min_epi16(_mm_max_epi16(packed, clamp_min), clamp_max);
+    _mm_store_si128(reinterpret_cast<__m128i*>(outputs->result[pixel]), packed);
+  }
+}
+
+// Same as the SSE2 version, but processes all four pixels at once. Unpacking works within
+// 128-bit lanes, so the low/high halves hold pixels 0 and 2 / 1 and 3 until they are packed
+// back into order.
+FUNCTION_TARGET_AVX2
+void CombineRegularAVX2(const TevStageCombiner::ColorCombiner& cc,
+                        const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs,
+                        Outputs* outputs)
+{
+  const LaneParams params = GetLaneParams(cc, ac);
+
+  const __m256i scale = _mm256_broadcastq_epi64(LoadParams16(params.scale));
+  const __m256i bias = _mm256_broadcastq_epi64(LoadParams16(params.bias));
+  const __m256i clamp_min = _mm256_broadcastq_epi64(LoadParams16(params.clamp_min));
+  const __m256i clamp_max = _mm256_broadcastq_epi64(LoadParams16(params.clamp_max));
+  const __m256i round =
+      _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(params.round)));
+  const __m256i negate_before_shift = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(params.negate_before_shift)));
+  const __m256i negate_after_shift = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(params.negate_after_shift)));
+  const __m256i halve =
+      _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(params.halve)));
+
+  __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(inputs.a));
+  __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(inputs.b));
+  __m256i c = _mm256_load_si256(reinterpret_cast<const __m256i*>(inputs.c));
+  __m256i d = _mm256_load_si256(reinterpret_cast<const __m256i*>(inputs.d));
+
+  // a, b and c are 8-bit unsigned, d is 11-bit signed
+  const __m256i mask_u8 = _mm256_set1_epi16(0xFF);
+  a = _mm256_mullo_epi16(_mm256_and_si256(a, mask_u8), scale);
+  b = _mm256_mullo_epi16(_mm256_and_si256(b, mask_u8), scale);
+  c = _mm256_and_si256(c, mask_u8);
+  c = _mm256_add_epi16(c, _mm256_srli_epi16(c, 7));
+  const __m256i inv_c = _mm256_sub_epi16(_mm256_set1_epi16(256), c);
+  d = _mm256_srai_epi16(_mm256_slli_epi16(d, 5), 5);
+  d = _mm256_mullo_epi16(_mm256_add_epi16(d, bias), scale);
+
+  const __m256i ab[2] = {_mm256_unpacklo_epi16(a, b), _mm256_unpackhi_epi16(a, b)};
+  const __m256i weights[2] = {_mm256_unpacklo_epi16(inv_c, c), _mm256_unpackhi_epi16(inv_c, c)};
+  const __m256i d32[2] = {_mm256_srai_epi32(_mm256_unpacklo_epi16(d, d), 16),
+                          _mm256_srai_epi32(_mm256_unpackhi_epi16(d, d), 16)};
+
+  __m256i result[2];
+  for (int i = 0; i < 2; i++)
+  {
+    __m256i temp = _mm256_madd_epi16(ab[i], weights[i]);
+    temp = _mm256_add_epi32(temp, round);
+    temp = _mm256_sub_epi32(_mm256_xor_si256(temp, negate_before_shift), negate_before_shift);
+    temp = _mm256_srai_epi32(temp, 8);
+    temp = _mm256_sub_epi32(_mm256_xor_si256(temp, negate_after_shift), negate_after_shift);
+
+    const __m256i sum = _mm256_add_epi32(d32[i], temp);
+    result[i] = _mm256_blendv_epi8(sum, _mm256_srai_epi32(sum, 1), halve);
+  }
+
+  __m256i packed = _mm256_packs_epi32(result[0], result[1]);
+  packed = _mm256_min_epi16(_mm256_max_epi16(packed, clamp_min), clamp_max);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(outputs->result), packed);
+}
+#endif
+
+void Combine(const TevStageCombiner::ColorCombiner& cc, const TevStageCombiner::AlphaCombiner& ac,
+             const Inputs& inputs, Outputs* outputs)
+{
+  const bool color_compare = cc.bias == TEVBIAS_COMPARE;
+  const bool alpha_compare = ac.bias == TEVBIAS_COMPARE;
+
+  if (!color_compare || !alpha_compare)
+  {
+#ifdef _M_X86
+    if (cpu_info.bAVX2)
+      CombineRegularAVX2(cc, ac, inputs, outputs);
+    else
+      CombineRegularSSE2(cc, ac, inputs, outputs);
+#else
+    CombineRegularScalar(cc, ac, inputs, outputs);
+#endif
+  }
+
+  if (color_compare || alpha_compare)
+  {
+    for (int pixel = 0; pixel < NUM_PIXELS; pixel++)
+    {
+      InputRegType regs[4];
+      GetInputRegs(inputs, pixel, regs);
+
+      s16* result = outputs->result[pixel];
+      if (color_compare)
+        CombineColorCompare(cc, regs, result);
+      if (alpha_compare)
+        result[ALP_C] = CombineAlphaCompare(ac, regs);
+    }
+  }
+}
+}  // namespace TevCombiner
@@ -0,0 +1,50 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+
+// Evaluates the color and alpha combiners of a TEV stage for all pixels of a rasterizer block
+// at once, so that the regular (non-compare) combiners can be computed with SIMD instructions.
+namespace TevCombiner
+{
+constexpr int NUM_PIXELS = 4;
+
+// Raw register values selected as the a, b, c and d inputs of a stage, indexed by pixel and
+// component (in Tev register order: alpha, blue, green, red). They are truncated to the widths of
+// the combiner inputs by the combiners.
+struct Inputs
+{
+  alignas(32) s16 a[NUM_PIXELS][4];
+  alignas(32) s16 b[NUM_PIXELS][4];
+  alignas(32) s16 c[NUM_PIXELS][4];
+  alignas(32) s16 d[NUM_PIXELS][4];
+};
+
+// Clamped results, laid out like the inputs. The alpha component is the alpha combiner's output,
+// the others are the color combiner's.
+struct Outputs
+{
+  alignas(32) s16 result[NUM_PIXELS][4];
+};
+
+void Combine(const TevStageCombiner::ColorCombiner& cc, const TevStageCombiner::AlphaCombiner& ac,
+             const Inputs& inputs, Outputs* outputs);
+
+// Implementations of the regular combiners, exposed for testing. Combine picks the fastest one
+// the host supports. Components of a compare mode combiner are left undefined.
+void CombineRegularScalar(const TevStageCombiner::ColorCombiner& cc,
+                          const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs,
+                          Outputs* outputs);
+#ifdef _M_X86
+void CombineRegularSSE2(const TevStageCombiner::ColorCombiner& cc,
+                        const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs,
+                        Outputs* outputs);
+void CombineRegularAVX2(const TevStageCombiner::ColorCombiner& cc,
+                        const TevStageCombiner::AlphaCombiner& ac, const Inputs& inputs,
+                        Outputs* outputs);
+#endif
+}  // namespace TevCombiner
@@ -6,15 +6,19 @@
 #define __STDC_CONSTANT_MACROS 1
 #endif
 
+#include <algorithm>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <fmt/format.h>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
+#include <libavutil/imgutils.h>
 #include <libavutil/mathematics.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
@@ -22,6 +26,7 @@ extern "C" {
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/ThreadPool.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/HW/SystemTimers.h"
@@ -41,10 +46,8 @@ extern "C" {
 static AVFormatContext* s_format_context = nullptr;
 static AVStream* s_stream = nullptr;
 static AVCodecContext* s_codec_context = nullptr;
-static AVFrame* s_src_frame = nullptr;
 static AVFrame* s_scaled_frame = nullptr;
 static AVPixelFormat s_pix_fmt = AV_PIX_FMT_BGR24;
-static SwsContext* s_sws_context = nullptr;
 static int s_width;
 static int s_height;
 static u64 s_last_frame;
@@ -54,6 +57,40 @@ static u64 s_last_pts;
 static int s_file_index = 0;
 static int s_savestate_index = 0;
 static int s_last_savestate_index = 0;
+// The last packet which was written, so that it can be repeated for pts slots without a frame.
+static std::vector<u8> s_last_packet;
+static s64 s_last_packet_pts = AV_NOPTS_VALUE;
+
+namespace
+{
+// swscale converts on a single thread, so frames are split into horizontal bands which are
+// converted in parallel. Each band also converts a margin of rows above and below it, so that the
+// vertical chroma filter sees the same input as it would for the whole frame.
+constexpr int MIN_BAND_ROWS = 64;
+constexpr int BAND_MARGIN_ROWS = 16;
+
+struct ConversionBand
+{
+  int first_row;
+  int num_rows;
+  int src_first_row;
+  int src_num_rows;
+  SwsContext* context;
+  // Scratch image for the band and its margins. Unused when there is only one band, which is
+  // converted directly into s_scaled_frame.
+  u8* data[4];
+  int linesize[4];
+};
+}  // namespace
+
+static std::vector<ConversionBand> s_conversion_bands;
+
+static Common::ThreadPool& GetConversionThreadPool()
+{
+  static Common::ThreadPool pool(Common::ThreadPool::GetDefaultNumWorkers(2),
+                                 "Frame Dump Conversion");
+  return pool;
+}
 
 static void InitAVCodec()
 {
@@ -68,6 +105,81 @@ static void InitAVCodec()
   }
 }
 
+static bool CreateConversionBands()
+{
+  const AVPixelFormat pix_fmt = s_codec_context->pix_fmt;
+  const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(pix_fmt);
+  if (!desc)
+    return false;
+
+  // Bands must start on a row which has its own chroma samples.
+  const int alignment = 1 << desc->log2_chroma_h;
+  const int num_bands = std::clamp<int>(s_height / MIN_BAND_ROWS, 1,
+                                        GetConversionThreadPool().GetNumThreads());
+  const int band_rows = ((s_height + num_bands - 1) / num_bands + alignment - 1) & -alignment;
+
+  for (int first_row = 0; first_row < s_height; first_row += band_rows)
+  {
+    ConversionBand band = {};
+    band.first_row = first_row;
+    band.num_rows = std::min(band_rows, s_height - first_row);
+    if (num_bands > 1)
+    {
+      band.src_first_row = std::max(first_row - BAND_MARGIN_ROWS, 0);
+      band.src_num_rows = std::min(first_row + band.num_rows + BAND_MARGIN_ROWS, s_height) -
+                          band.src_first_row;
+      if (av_image_alloc(band.data, band.linesize, s_width, band.src_num_rows, pix_fmt, 1) < 0)
+        return false;
+    }
+    else
+    {
+      band.src_num_rows = s_height;
+    }
+
+    // Push the band before checking the context, so that CloseVideoFile frees its image.
+    band.context = sws_getContext(s_width, band.src_num_rows, s_pix_fmt, s_width,
+                                  band.src_num_rows, pix_fmt, SWS_BICUBIC, nullptr, nullptr,
+                                  nullptr);
+    s_conversion_bands.push_back(band);
+    if (!band.context)
+      return false;
+  }
+
+  return true;
+}
+
+static void ConvertBand(const ConversionBand& band, const u8* data, int stride)
+{
+  const u8* const src_data[4] = {data + static_cast<size_t>(band.src_first_row) * stride};
+  const int src_linesize[4] = {stride};
+  if (!band.data[0])
+  {
+    sws_scale(band.context, src_data, src_linesize, 0, band.src_num_rows, s_scaled_frame->data,
+              s_scaled_frame->linesize);
+    return;
+  }
+
+  sws_scale(band.context, src_data, src_linesize, 0, band.src_num_rows, band.data,
+            band.linesize);
+
+  // Copy the band without its margins into the frame.
+  const AVPixelFormat pix_fmt = s_codec_context->pix_fmt;
+  const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(pix_fmt);
+  const int num_planes = av_pix_fmt_count_planes(pix_fmt);
+  for (int plane = 0; plane < num_planes; plane++)
+  {
+    const int shift = (plane == 1 || plane == 2) ? desc->log2_chroma_h : 0;
+    const int first_row = band.first_row >> shift;
+    const int end_row = -((-(band.first_row + band.num_rows)) >> shift);
+    const int margin_rows = (band.first_row - band.src_first_row) >> shift;
+    av_image_copy_plane(s_scaled_frame->data[plane] + first_row * s_scaled_frame->linesize[plane],
+                        s_scaled_frame->linesize[plane],
+                        band.data[plane] + margin_rows * band.linesize[plane],
+                        band.linesize[plane], av_image_get_linesize(pix_fmt, s_width, plane),
+                        end_row - first_row);
+  }
+}
+
 static bool AVStreamCopyContext(AVStream* stream, AVCodecContext* codec_context)
 {
 #if (LIBAVCODEC_VERSION_MICRO >= 100 && LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(57, 33, 100)) ||  \
@@ -192,8 +304,13 @@ bool FrameDump::CreateVideoFile()
   s_codec_context->time_base.num = VideoInterface::GetTargetRefreshRateDenominator();
   s_codec_context->time_base.den = VideoInterface::GetTargetRefreshRateNumerator();
   s_codec_context->gop_size = 1;
-  s_codec_context->level = 1;
+  // FFV1 can only encode slices in parallel from version 3 on.
+  s_codec_context->level = g_Config.bUseFFV1 ? 3 : 1;
   s_codec_context->pix_fmt = g_Config.bUseFFV1 ? AV_PIX_FMT_BGR0 : AV_PIX_FMT_YUV420P;
+  // Let the encoder pick a thread count for itself. Only slice threads are allowed, since frame
+  // threads delay each packet by a frame per thread.
+  s_codec_context->thread_count = 0;
+  s_codec_context->thread_type = FF_THREAD_SLICE;
 
   if (output_format->flags & AVFMT_GLOBALHEADER)
     s_codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
@@ -204,7 +321,6 @@ bool FrameDump::CreateVideoFile()
     return false;
   }
 
-  s_src_frame = av_frame_alloc();
   s_scaled_frame = av_frame_alloc();
 
   s_scaled_frame->format = s_codec_context->pix_fmt;
@@ -219,6 +335,12 @@ bool FrameDump::CreateVideoFile()
     return false;
 #endif
 
+  if (!CreateConversionBands())
+  {
+    ERROR_LOG(VIDEO, "Could not create scaling context");
+    return false;
+  }
+
   s_stream = avformat_new_stream(s_format_context, codec);
   if (!s_stream || !AVStreamCopyContext(s_stream, s_codec_context))
   {
@@ -254,7 +376,7 @@ static int ReceivePacket(AVCodecContext* avctx, AVPacket* pkt, int* got_packet)
   int error = avcodec_receive_packet(avctx, pkt);
   if (!error)
     *got_packet = 1;
-  if (error == AVERROR(EAGAIN))
+  if (error == AVERROR(EAGAIN) || error == AVERROR_EOF)
     return 0;
 
   return error;
@@ -276,7 +398,7 @@ static int SendFrameAndReceivePacket(AVCodecContext* avctx, AVPacket* pkt, AVFra
 #endif
 }
 
-static void WritePacket(AVPacket& pkt)
+static void MuxPacket(AVPacket& pkt)
 {
   // Write the compressed frame in the media file.
   if (pkt.pts != (s64)AV_NOPTS_VALUE)
@@ -295,6 +417,48 @@ static void WritePacket(AVPacket& pkt)
   av_interleaved_write_frame(s_format_context, &pkt);
 }
 
+static void WriteRepeatedPackets(s64 pts)
+{
+  if (s_last_packet.empty() || s_last_packet_pts == static_cast<s64>(AV_NOPTS_VALUE))
+    return;
+
+  // Every packet is a key frame (gop_size is 1), so a copy of the last packet shows the same frame
+  // again. Each unit of the codec time base is one refresh of the emulated display.
+  for (s64 repeat_pts = s_last_packet_pts + 1; repeat_pts < pts; repeat_pts++)
+  {
+    AVPacket pkt;
+    PreparePacket(&pkt);
+    if (av_new_packet(&pkt, static_cast<int>(s_last_packet.size())) < 0)
+      return;
+
+    std::copy(s_last_packet.begin(), s_last_packet.end(), pkt.data);
+    pkt.flags |= AV_PKT_FLAG_KEY;
+    pkt.pts = repeat_pts;
+    pkt.dts = repeat_pts;
+    MuxPacket(pkt);
+  }
+}
+
+static void WritePacket(AVPacket& pkt)
+{
+  // Packets come out of the encoder in presentation order, so the slots between the last packet
+  // and this one are the ones which no frame was dumped for.
+  const bool can_repeat = pkt.pts != static_cast<s64>(AV_NOPTS_VALUE) &&
+                          (pkt.flags & AV_PKT_FLAG_KEY) && s_codec_context->gop_size == 1;
+  if (can_repeat && g_Config.bDumpDuplicateFrames)
+  {
+    WriteRepeatedPackets(pkt.pts);
+    s_last_packet.assign(pkt.data, pkt.data + pkt.size);
+    s_last_packet_pts = pkt.pts;
+  }
+  else
+  {
+    s_last_packet.clear();
+  }
+
+  MuxPacket(pkt);
+}
+
 static u64 TicksToTimeBaseUnits(u64 ticks, AVRational time_base, u32 ticks_per_second)
 {
   return ticks * time_base.den / time_base.num / ticks_per_second;
@@ -311,20 +475,19 @@ void FrameDump::AddFrame(const u8* data, int width, int height, int stride, cons
   }
 
   CheckResolution(width, height);
-  s_src_frame->data[0] = const_cast<u8*>(data);
-  s_src_frame->linesize[0] = stride;
-  s_src_frame->format = s_pix_fmt;
-  s_src_frame->width = s_width;
-  s_src_frame->height = s_height;
 
-  // Convert image from {BGR24, RGBA} to desired pixel format
-  s_sws_context =
-      sws_getCachedContext(s_sws_context, width, height, s_pix_fmt, s_width, s_height,
-                           s_codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
-  if (s_sws_context)
+  // Convert image from {BGR24, RGBA} to desired pixel format. A frame with a zero width or height
+  // doesn't change the resolution, and is dumped as a repeat of the last frame.
+  if (width == s_width && height == s_height)
   {
-    sws_scale(s_sws_context, s_src_frame->data, s_src_frame->linesize, 0, height,
-              s_scaled_frame->data, s_scaled_frame->linesize);
+#if LIBAVCODEC_VERSION_MAJOR >= 55
+    // A threaded encoder may still hold a reference to the last frame.
+    av_frame_make_writable(s_scaled_frame);
+#endif
+
+    GetConversionThreadPool().ParallelFor(s_conversion_bands.size(), [data, stride](size_t i) {
+      ConvertBand(s_conversion_bands[i], data, stride);
+    });
   }
 
   // Encode and write the image.
@@ -362,9 +525,16 @@ void FrameDump::AddFrame(const u8* data, int width, int height, int stride, cons
     s_last_pts = pts_in_ticks;
     error = SendFrameAndReceivePacket(s_codec_context, &pkt, s_scaled_frame, &got_packet);
   }
-  if (!error && got_packet)
+  while (!error && got_packet)
   {
     WritePacket(pkt);
+#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 37, 100)
+    break;
+#else
+    // The encoder may have more than one packet ready.
+    PreparePacket(&pkt);
+    error = ReceivePacket(s_codec_context, &pkt, &got_packet);
+#endif
   }
   if (error)
     ERROR_LOG(VIDEO, "Error while encoding video: %d", error);
@@ -372,6 +542,16 @@ void FrameDump::AddFrame(const u8* data, int width, int height, int stride, cons
 
 static void HandleDelayedPackets()
 {
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(57, 37, 100)
+  // Flush the encoder, so that it returns the packets which it is still holding on to.
+  const int flush_error = avcodec_send_frame(s_codec_context, nullptr);
+  if (flush_error)
+  {
+    ERROR_LOG(VIDEO, "Error while stopping video: %d", flush_error);
+    return;
+  }
+#endif
+
   AVPacket pkt;
 
   while (true)
@@ -405,7 +585,6 @@ void FrameDump::Stop()
 
 void FrameDump::CloseVideoFile()
 {
-  av_frame_free(&s_src_frame);
   av_frame_free(&s_scaled_frame);
 
   avcodec_free_context(&s_codec_context);
@@ -417,11 +596,15 @@ void FrameDump::CloseVideoFile()
   avformat_free_context(s_format_context);
   s_format_context = nullptr;
 
-  if (s_sws_context)
+  for (ConversionBand& band : s_conversion_bands)
   {
-    sws_freeContext(s_sws_context);
-    s_sws_context = nullptr;
+    sws_freeContext(band.context);
+    av_freep(&band.data[0]);
   }
+  s_conversion_bands.clear();
+
+  s_last_packet.clear();
+  s_last_packet_pts = AV_NOPTS_VALUE;
 }
 
 void FrameDump::DoState()
@@ -5,12 +5,16 @@
 #include "VideoCommon/HiresTextures.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <xxhash.h>
@@ -32,6 +36,8 @@
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
 #include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/TexturePack.h"
 #include "VideoCommon/VideoConfig.h"
 
 struct DiskTexture
@@ -41,14 +47,50 @@ struct DiskTexture
 };
 
 constexpr std::string_view s_format_prefix{"tex1_"};
+constexpr std::string_view s_texture_pack_extension{".texpack"};
 
 static std::unordered_map<std::string, DiskTexture> s_textureMap;
+// Texture packs are only opened and closed while no textures are being loaded.
+static std::vector<std::shared_ptr<const TexturePack>> s_texture_packs;
 static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_textureCache;
 static std::mutex s_textureCacheMutex;
 static Common::Flag s_textureCacheAbortLoading;
 
 static std::thread s_prefetcher;
 
+// Streaming: instead of loading all custom textures up front, textures are loaded by worker threads
+// when they are first used, and the loaded textures are kept in an LRU cache with a memory budget.
+struct StreamRequest
+{
+  std::string base_filename;
+  u32 width;
+  u32 height;
+  u32 request_time;
+};
+
+struct StreamedTexture
+{
+  // nullptr if the texture couldn't be loaded, so that it isn't requested over and over.
+  std::shared_ptr<HiresTexture> texture;
+  size_t size;
+  std::list<std::string>::iterator lru_iter;
+};
+
+static std::mutex s_stream_mutex;
+static std::condition_variable s_stream_cv;
+static std::vector<std::thread> s_stream_workers;
+static bool s_stream_exit = false;
+static std::deque<StreamRequest> s_stream_queue;
+// Textures which are queued or being loaded.
+static std::unordered_set<std::string> s_stream_pending;
+static std::unordered_map<std::string, StreamedTexture> s_streamed_textures;
+// Names of the streamed textures, the most recently used one first.
+static std::list<std::string> s_stream_lru;
+static size_t s_stream_memory_usage = 0;
+static size_t s_stream_memory_budget = 0;
+static u64 s_stream_num_loaded = 0;
+static u64 s_stream_total_latency = 0;
+
 void HiresTexture::Init()
 {
   Update();
@@ -62,7 +104,10 @@ void HiresTexture::Shutdown()
     s_prefetcher.join();
   }
 
+  StopStreaming();
+
   s_textureMap.clear();
+  s_texture_packs.clear();
   s_textureCache.clear();
 }
 
@@ -74,6 +119,10 @@ void HiresTexture::Update()
     s_prefetcher.join();
   }
 
+  StopStreaming();
+
+  s_texture_packs.clear();
+
   if (!g_ActiveConfig.bHiresTextures)
   {
     s_textureMap.clear();
@@ -87,50 +136,28 @@ void HiresTexture::Update()
   }
 
   const std::string& game_id = SConfig::GetInstance().GetGameID();
-  const std::set<std::string> texture_directories = GetTextureDirectories(game_id);
-  const std::vector<std::string> extensions{".png", ".dds"};
 
-  for (const auto& texture_directory : texture_directories)
+  for (const std::string& path : GetTexturePackPaths(game_id))
   {
-    const auto texture_paths =
-        Common::DoFileSearch({texture_directory}, extensions, /*recursive*/ true);
-
-    bool failed_insert = false;
-    for (auto& path : texture_paths)
-    {
-      std::string filename;
-      SplitPath(path, nullptr, &filename, nullptr);
+    std::unique_ptr<TexturePack> pack = TexturePack::Open(path);
+    if (!pack)
+      continue;
 
-      if (filename.substr(0, s_format_prefix.length()) == s_format_prefix)
-      {
-        const size_t arb_index = filename.rfind("_arb");
-        const bool has_arbitrary_mipmaps = arb_index != std::string::npos;
-        if (has_arbitrary_mipmaps)
-          filename.erase(arb_index, 4);
-
-        const auto [it, inserted] =
-            s_textureMap.try_emplace(filename, DiskTexture{path, has_arbitrary_mipmaps});
-        if (!inserted)
-        {
-          failed_insert = true;
-        }
-      }
-    }
-
-    if (failed_insert)
-    {
-      ERROR_LOG(VIDEO, "One or more textures at path '%s' were already inserted",
-                texture_directory.c_str());
-    }
+    INFO_LOG(VIDEO, "Using texture pack %s with %u textures", path.c_str(),
+             pack->GetNumTextures());
+    s_texture_packs.push_back(std::move(pack));
   }
 
+  for (const auto& texture_directory : GetTextureDirectories(game_id))
+    AddTextureDirectory(texture_directory, &s_textureMap);
+
   if (g_ActiveConfig.bCacheHiresTextures)
   {
     // remove cached but deleted textures
     auto iter = s_textureCache.begin();
     while (iter != s_textureCache.end())
     {
-      if (s_textureMap.find(iter->first) == s_textureMap.end())
+      if (!HasTexture(iter->first))
       {
         iter = s_textureCache.erase(iter);
       }
@@ -143,6 +170,181 @@ void HiresTexture::Update()
     s_textureCacheAbortLoading.Clear();
     s_prefetcher = std::thread(Prefetch);
   }
+  else if (g_ActiveConfig.bStreamHiresTextures)
+  {
+    StartStreaming(size_t(std::max(g_ActiveConfig.iHiresTextureCacheSize, 0)) * 1024 * 1024);
+  }
+}
+
+void HiresTexture::AddTextureDirectory(const std::string& directory,
+                                       DiskTextureMap* texture_map)
+{
+  const std::vector<std::string> extensions{".png", ".dds"};
+  const auto texture_paths = Common::DoFileSearch({directory}, extensions, /*recursive*/ true);
+
+  bool failed_insert = false;
+  for (auto& path : texture_paths)
+  {
+    std::string filename;
+    SplitPath(path, nullptr, &filename, nullptr);
+
+    if (filename.substr(0, s_format_prefix.length()) == s_format_prefix)
+    {
+      const size_t arb_index = filename.rfind("_arb");
+      const bool has_arbitrary_mipmaps = arb_index != std::string::npos;
+      if (has_arbitrary_mipmaps)
+        filename.erase(arb_index, 4);
+
+      const auto [it, inserted] =
+          texture_map->try_emplace(filename, DiskTexture{path, has_arbitrary_mipmaps});
+      if (!inserted)
+      {
+        failed_insert = true;
+      }
+    }
+  }
+
+  if (failed_insert)
+  {
+    ERROR_LOG(VIDEO, "One or more textures at path '%s' were already inserted", directory.c_str());
+  }
+}
+
+bool HiresTexture::HasTexture(const std::string& base_filename)
+{
+  return s_textureMap.find(base_filename) != s_textureMap.end() ||
+         std::any_of(s_texture_packs.begin(), s_texture_packs.end(),
+                     [&base_filename](const auto& pack) { return pack->Contains(base_filename); });
+}
+
+void HiresTexture::StartStreaming(size_t memory_budget)
+{
+  s_stream_memory_budget = memory_budget;
+  s_stream_exit = false;
+
+  // Decoding PNGs is slow, but leave some cores for the CPU and GPU threads.
+  const u32 num_workers = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+  for (u32 i = 0; i < num_workers; i++)
+    s_stream_workers.emplace_back(StreamWorker);
+}
+
+void HiresTexture::StopStreaming()
+{
+  {
+    std::lock_guard<std::mutex> lk(s_stream_mutex);
+    s_stream_exit = true;
+    s_stream_queue.clear();
+  }
+  s_stream_cv.notify_all();
+
+  for (std::thread& worker : s_stream_workers)
+    worker.join();
+  s_stream_workers.clear();
+
+  // The set of textures may change before streaming is started again.
+  s_stream_pending.clear();
+  s_streamed_textures.clear();
+  s_stream_lru.clear();
+  s_stream_memory_usage = 0;
+}
+
+void HiresTexture::StreamWorker()
+{
+  Common::SetCurrentThreadName("Custom Texture Loader");
+
+  std::unique_lock<std::mutex> lk(s_stream_mutex);
+  while (true)
+  {
+    s_stream_cv.wait(lk, [] { return s_stream_exit || !s_stream_queue.empty(); });
+    if (s_stream_exit)
+      return;
+
+    const StreamRequest request = std::move(s_stream_queue.front());
+    s_stream_queue.pop_front();
+
+    // s_textureMap is only changed while the workers are stopped.
+    lk.unlock();
+    std::shared_ptr<HiresTexture> texture =
+        Load(request.base_filename, request.width, request.height);
+    const size_t size = texture ? texture->GetDataSize() : 0;
+    lk.lock();
+
+    if (s_stream_exit)
+      return;
+
+    s_stream_pending.erase(request.base_filename);
+    s_stream_lru.push_front(request.base_filename);
+    s_streamed_textures[request.base_filename] = {std::move(texture), size, s_stream_lru.begin()};
+    s_stream_memory_usage += size;
+    s_stream_num_loaded++;
+    s_stream_total_latency += Common::Timer::GetTimeMs() - request.request_time;
+
+    EvictStreamedTextures();
+  }
+}
+
+void HiresTexture::EvictStreamedTextures()
+{
+  // The texture cache doesn't keep the HiresTextures after uploading them, so evicting one only
+  // means that it has to be loaded again if the texture cache needs it again.
+  while (s_stream_memory_usage > s_stream_memory_budget && s_stream_lru.size() > 1)
+  {
+    const auto iter = s_streamed_textures.find(s_stream_lru.back());
+    s_stream_memory_usage -= iter->second.size;
+    s_streamed_textures.erase(iter);
+    s_stream_lru.pop_back();
+  }
+}
+
+void HiresTexture::UpdateStreamStatistics()
+{
+  SETSTAT(g_stats.num_custom_textures_streamed, s_stream_num_loaded);
+  SETSTAT(g_stats.custom_texture_cache_size_mb, s_stream_memory_usage / (1024 * 1024));
+  if (s_stream_num_loaded != 0)
+    SETSTAT(g_stats.custom_texture_load_latency_ms, s_stream_total_latency / s_stream_num_loaded);
+}
+
+std::shared_ptr<HiresTexture> HiresTexture::SearchStreamed(const std::string& base_filename,
+                                                           u32 width, u32 height,
+                                                           std::string* pending_name)
+{
+  std::lock_guard<std::mutex> lk(s_stream_mutex);
+  UpdateStreamStatistics();
+
+  const auto iter = s_streamed_textures.find(base_filename);
+  if (iter != s_streamed_textures.end())
+  {
+    INCSTAT(g_stats.num_custom_texture_hits);
+    s_stream_lru.splice(s_stream_lru.begin(), s_stream_lru, iter->second.lru_iter);
+    return iter->second.texture;
+  }
+
+  if (pending_name)
+    *pending_name = base_filename;
+
+  if (s_stream_pending.insert(base_filename).second)
+  {
+    INCSTAT(g_stats.num_custom_texture_misses);
+    s_stream_queue.push_back({base_filename, width, height, Common::Timer::GetTimeMs()});
+    s_stream_cv.notify_one();
+  }
+
+  return nullptr;
+}
+
+bool HiresTexture::IsLoading(const std::string& base_name)
+{
+  std::lock_guard<std::mutex> lk(s_stream_mutex);
+  return s_stream_pending.count(base_name) != 0;
+}
+
+static void TouchMappedData(const u8* data, size_t size)
+{
+  constexpr size_t MIN_PAGE_SIZE = 4096;
+  u8 sum = 0;
+  for (size_t i = 0; i < size; i += MIN_PAGE_SIZE)
+    sum += static_cast<const volatile u8*>(data)[i];
+  (void)sum;
 }
 
 void HiresTexture::Prefetch()
@@ -157,10 +359,7 @@ void HiresTexture::Prefetch()
       (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
 
   const u32 start_time = Common::Timer::GetTimeMs();
-  for (const auto& entry : s_textureMap)
-  {
-    const std::string& base_filename = entry.first;
-
+  const auto prefetch = [&size_sum, max_mem](const std::string& base_filename) {
     if (base_filename.find("_mip") == std::string::npos)
     {
       std::unique_lock<std::mutex> lk(s_textureCacheMutex);
@@ -182,13 +381,19 @@ void HiresTexture::Prefetch()
       if (iter != s_textureCache.end())
       {
         for (const Level& l : iter->second->m_levels)
+        {
           size_sum += l.data.size();
+          // Levels from texture packs stay in the page cache, which the OS can reclaim, so they
+          // are read once to get them from the disk but don't count towards the memory limit.
+          if (l.mapped_data)
+            TouchMappedData(l.mapped_data, l.mapped_size);
+        }
       }
     }
 
     if (s_textureCacheAbortLoading.IsSet())
     {
-      return;
+      return false;
     }
 
     if (size_sum > max_mem)
@@ -200,7 +405,26 @@ void HiresTexture::Prefetch()
               "Custom Textures prefetching after {:.1f} MB aborted, not enough RAM available",
               size_sum / (1024.0 * 1024.0)),
           10000);
+      return false;
+    }
+
+    return true;
+  };
+
+  for (const auto& entry : s_textureMap)
+  {
+    if (!prefetch(entry.first))
       return;
+  }
+
+  for (const auto& pack : s_texture_packs)
+  {
+    for (u32 i = 0; i < pack->GetNumTextures(); i++)
+    {
+      const std::string base_filename(pack->GetName(i));
+      // Loose files override textures in packs and have already been loaded.
+      if (s_textureMap.find(base_filename) == s_textureMap.end() && !prefetch(base_filename))
+        return;
     }
   }
 
@@ -214,7 +438,7 @@ std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, co
                                       size_t tlut_size, u32 width, u32 height, TextureFormat format,
                                       bool has_mipmaps, bool dump)
 {
-  if (!dump && s_textureMap.empty())
+  if (!dump && s_textureMap.empty() && s_texture_packs.empty())
     return "";
 
   // checking for min/max on paletted textures
@@ -261,6 +485,8 @@ std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, co
     tlut += 2 * min;
   }
 
+  // Custom texture packs depend on these names, so unlike the texture cache this must keep using
+  // the same hash function.
   const u64 tex_hash = XXH64(texture, texture_size, 0);
   const u64 tlut_hash = tlut_size ? XXH64(tlut, tlut_size, 0) : 0;
 
@@ -274,12 +500,12 @@ std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, co
   if (!dump)
   {
     const std::string texture_name = fmt::format("{}_${}", base_name, format_name);
-    if (s_textureMap.find(texture_name) != s_textureMap.end())
+    if (HasTexture(texture_name))
       return texture_name;
   }
 
   // else generate the complete texture
-  if (dump || s_textureMap.find(full_name) != s_textureMap.end())
+  if (dump || HasTexture(full_name))
     return full_name;
 
   return "";
@@ -303,11 +529,19 @@ u32 HiresTexture::CalculateMipCount(u32 width, u32 height)
 std::shared_ptr<HiresTexture> HiresTexture::Search(const u8* texture, size_t texture_size,
                                                    const u8* tlut, size_t tlut_size, u32 width,
                                                    u32 height, TextureFormat format,
-                                                   bool has_mipmaps)
+                                                   bool has_mipmaps, std::string* pending_name)
 {
   std::string base_filename =
       GenBaseName(texture, texture_size, tlut, tlut_size, width, height, format, has_mipmaps);
 
+  if (!s_stream_workers.empty())
+  {
+    if (base_filename.empty())
+      return nullptr;
+
+    return SearchStreamed(base_filename, width, height, pending_name);
+  }
+
   std::lock_guard<std::mutex> lk(s_textureCacheMutex);
 
   auto iter = s_textureCache.find(base_filename);
@@ -328,10 +562,93 @@ std::shared_ptr<HiresTexture> HiresTexture::Search(const u8* texture, size_t tex
 
 std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filename, u32 width,
                                                  u32 height)
+{
+  return Load(base_filename, width, height, s_textureMap, s_texture_packs);
+}
+
+std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filename, u32 width,
+                                                 u32 height, const DiskTextureMap& texture_map,
+                                                 const TexturePackList& texture_packs)
+{
+  // Loose files take priority over texture packs, so that textures of a pack can be replaced
+  // without converting the pack again.
+  std::string source;
+  std::unique_ptr<HiresTexture> ret = LoadFromFiles(base_filename, texture_map, &source);
+  if (!ret)
+    ret = LoadFromPack(base_filename, texture_packs, &source);
+  if (!ret)
+    return nullptr;
+
+  // Verify that the aspect ratio of the texture hasn't changed, as this could have side-effects.
+  const Level& first_mip = ret->m_levels[0];
+  if (first_mip.width * height != first_mip.height * width)
+  {
+    ERROR_LOG(VIDEO,
+              "Invalid custom texture size %ux%u for texture %s. The aspect differs "
+              "from the native size %ux%u.",
+              first_mip.width, first_mip.height, source.c_str(), width, height);
+  }
+
+  // Same deal if the custom texture isn't a multiple of the native size.
+  if (width != 0 && height != 0 && (first_mip.width % width || first_mip.height % height))
+  {
+    ERROR_LOG(VIDEO,
+              "Invalid custom texture size %ux%u for texture %s. Please use an integer "
+              "upscaling factor based on the native size %ux%u.",
+              first_mip.width, first_mip.height, source.c_str(), width, height);
+  }
+
+  // Verify that each mip level is the correct size (divide by 2 each time).
+  u32 current_mip_width = first_mip.width;
+  u32 current_mip_height = first_mip.height;
+  for (u32 mip_level = 1; mip_level < static_cast<u32>(ret->m_levels.size()); mip_level++)
+  {
+    if (current_mip_width != 1 || current_mip_height != 1)
+    {
+      current_mip_width = std::max(current_mip_width / 2, 1u);
+      current_mip_height = std::max(current_mip_height / 2, 1u);
+
+      const Level& level = ret->m_levels[mip_level];
+      if (current_mip_width == level.width && current_mip_height == level.height)
+        continue;
+
+      ERROR_LOG(VIDEO,
+                "Invalid custom texture size %dx%d for texture %s. Mipmap level %u must be %dx%d.",
+                level.width, level.height, source.c_str(), mip_level, current_mip_width,
+                current_mip_height);
+    }
+    else
+    {
+      // It is invalid to have more than a single 1x1 mipmap.
+      ERROR_LOG(VIDEO, "Custom texture %s has too many 1x1 mipmaps. Skipping extra levels.",
+                source.c_str());
+    }
+
+    // Drop this mip level and any others after it.
+    while (ret->m_levels.size() > mip_level)
+      ret->m_levels.pop_back();
+  }
+
+  // All levels have to have the same format.
+  if (std::any_of(ret->m_levels.begin(), ret->m_levels.end(),
+                  [&ret](const Level& l) { return l.format != ret->m_levels[0].format; }))
+  {
+    ERROR_LOG(VIDEO, "Custom texture %s has inconsistent formats across mip levels.",
+              source.c_str());
+
+    return nullptr;
+  }
+
+  return ret;
+}
+
+std::unique_ptr<HiresTexture> HiresTexture::LoadFromFiles(const std::string& base_filename,
+                                                          const DiskTextureMap& texture_map,
+                                                          std::string* source)
 {
   // We need to have a level 0 custom texture to even consider loading.
-  auto filename_iter = s_textureMap.find(base_filename);
-  if (filename_iter == s_textureMap.end())
+  auto filename_iter = texture_map.find(base_filename);
+  if (filename_iter == texture_map.end())
     return nullptr;
 
   // Try to load level 0 (and any mipmaps) from a DDS file.
@@ -349,8 +666,8 @@ std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filenam
     if (mip_level != 0)
       filename += fmt::format("_mip{}", mip_level);
 
-    filename_iter = s_textureMap.find(filename);
-    if (filename_iter == s_textureMap.end())
+    filename_iter = texture_map.find(filename);
+    if (filename_iter == texture_map.end())
       break;
 
     // Try loading DDS textures first, that way we maintain compression of DXT formats.
@@ -377,67 +694,100 @@ std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filenam
   if (ret->m_levels.empty())
     return nullptr;
 
-  // Verify that the aspect ratio of the texture hasn't changed, as this could have side-effects.
-  const Level& first_mip = ret->m_levels[0];
-  if (first_mip.width * height != first_mip.height * width)
+  *source = first_mip_file.path;
+  return ret;
+}
+
+std::unique_ptr<HiresTexture> HiresTexture::LoadFromPack(const std::string& base_filename,
+                                                         const TexturePackList& texture_packs,
+                                                         std::string* source)
+{
+  for (const auto& pack : texture_packs)
   {
-    ERROR_LOG(VIDEO,
-              "Invalid custom texture size %ux%u for texture %s. The aspect differs "
-              "from the native size %ux%u.",
-              first_mip.width, first_mip.height, first_mip_file.path.c_str(), width, height);
+    const std::optional<u32> index = pack->Find(base_filename);
+    if (!index)
+      continue;
+
+    // The levels are uploaded directly from the mapped pack.
+    const TexturePack::Texture texture = pack->GetTexture(*index);
+    std::unique_ptr<HiresTexture> ret = std::unique_ptr<HiresTexture>(new HiresTexture());
+    ret->m_has_arbitrary_mipmaps = texture.has_arbitrary_mipmaps;
+    ret->m_pack = pack;
+    for (const TexturePack::Level& packed_level : texture.levels)
+    {
+      Level level;
+      level.mapped_data = packed_level.data;
+      level.mapped_size = packed_level.size;
+      level.format = texture.format;
+      level.width = packed_level.width;
+      level.height = packed_level.height;
+      level.row_length = packed_level.row_length;
+      ret->m_levels.push_back(std::move(level));
+    }
+
+    *source = fmt::format("{} in {}", base_filename, pack->GetFilename());
+    return ret;
   }
 
-  // Same deal if the custom texture isn't a multiple of the native size.
-  if (width != 0 && height != 0 && (first_mip.width % width || first_mip.height % height))
+  return nullptr;
+}
+
+bool HiresTexture::ConvertToTexturePack(const std::string& directory,
+                                        const std::string& pack_filename,
+                                        const std::function<void(size_t, size_t)>& progress)
+{
+  // This doesn't touch the textures of the running game, if any.
+  DiskTextureMap texture_map;
+  AddTextureDirectory(directory, &texture_map);
+
+  // Mipmaps which are stored in separate files become levels of their base texture.
+  std::vector<std::string> base_filenames;
+  for (const auto& entry : texture_map)
   {
-    ERROR_LOG(VIDEO,
-              "Invalid custom texture size %ux%u for texture %s. Please use an integer "
-              "upscaling factor based on the native size %ux%u.",
-              first_mip.width, first_mip.height, first_mip_file.path.c_str(), width, height);
+    if (entry.first.find("_mip") == std::string::npos)
+      base_filenames.push_back(entry.first);
   }
+  std::sort(base_filenames.begin(), base_filenames.end());
 
-  // Verify that each mip level is the correct size (divide by 2 each time).
-  u32 current_mip_width = first_mip.width;
-  u32 current_mip_height = first_mip.height;
-  for (u32 mip_level = 1; mip_level < static_cast<u32>(ret->m_levels.size()); mip_level++)
+  TexturePackWriter writer;
+  if (!writer.Open(pack_filename))
   {
-    if (current_mip_width != 1 || current_mip_height != 1)
-    {
-      current_mip_width = std::max(current_mip_width / 2, 1u);
-      current_mip_height = std::max(current_mip_height / 2, 1u);
+    ERROR_LOG(VIDEO, "Failed to create texture pack %s", pack_filename.c_str());
+    return false;
+  }
 
-      const Level& level = ret->m_levels[mip_level];
-      if (current_mip_width == level.width && current_mip_height == level.height)
-        continue;
+  for (size_t i = 0; i < base_filenames.size(); i++)
+  {
+    const std::string& base_filename = base_filenames[i];
+    const std::unique_ptr<HiresTexture> texture = Load(base_filename, 0, 0, texture_map, {});
+    if (texture)
+    {
+      // DDS textures are stored as they are, PNGs are stored decoded as RGBA8.
+      TexturePack::Texture packed_texture;
+      packed_texture.format = texture->GetFormat();
+      packed_texture.has_arbitrary_mipmaps = texture->HasArbitraryMipmaps();
+      for (const Level& level : texture->m_levels)
+      {
+        packed_texture.levels.push_back(
+            {level.GetData(), level.GetSize(), level.width, level.height, level.row_length});
+      }
 
-      ERROR_LOG(VIDEO,
-                "Invalid custom texture size %dx%d for texture %s. Mipmap level %u must be %dx%d.",
-                level.width, level.height, first_mip_file.path.c_str(), mip_level,
-                current_mip_width, current_mip_height);
+      if (!writer.AddTexture(base_filename, packed_texture))
+      {
+        ERROR_LOG(VIDEO, "Failed to write %s to texture pack %s", base_filename.c_str(),
+                  pack_filename.c_str());
+        return false;
+      }
     }
     else
     {
-      // It is invalid to have more than a single 1x1 mipmap.
-      ERROR_LOG(VIDEO, "Custom texture %s has too many 1x1 mipmaps. Skipping extra levels.",
-                first_mip_file.path.c_str());
+      ERROR_LOG(VIDEO, "Skipping custom texture %s which failed to load", base_filename.c_str());
     }
 
-    // Drop this mip level and any others after it.
-    while (ret->m_levels.size() > mip_level)
-      ret->m_levels.pop_back();
-  }
-
-  // All levels have to have the same format.
-  if (std::any_of(ret->m_levels.begin(), ret->m_levels.end(),
-                  [&ret](const Level& l) { return l.format != ret->m_levels[0].format; }))
-  {
-    ERROR_LOG(VIDEO, "Custom texture %s has inconsistent formats across mip levels.",
-              first_mip_file.path.c_str());
-
-    return nullptr;
+    progress(i + 1, base_filenames.size());
   }
 
-  return ret;
+  return writer.Finish();
 }
 
 bool HiresTexture::LoadTexture(Level& level, const std::vector<u8>& buffer)
@@ -501,10 +851,35 @@ std::set<std::string> HiresTexture::GetTextureDirectories(const std::string& gam
   return result;
 }
 
+std::vector<std::string> HiresTexture::GetTexturePackPaths(const std::string& game_id)
+{
+  // Like the texture directories, a pack can be for a specific region or region-free. Both are
+  // used, with the region-specific one taking priority.
+  std::vector<std::string> result;
+  const std::string root_directory = File::GetUserPath(D_HIRESTEXTURES_IDX);
+  for (const std::string& name : {game_id, game_id.substr(0, 3)})
+  {
+    const std::string path = root_directory + name + std::string(s_texture_pack_extension);
+    if (File::Exists(path) && std::find(result.begin(), result.end(), path) == result.end())
+      result.push_back(path);
+  }
+
+  return result;
+}
+
 HiresTexture::~HiresTexture()
 {
 }
 
+size_t HiresTexture::GetDataSize() const
+{
+  // Levels which are mapped from a texture pack are in the page cache rather than in our memory.
+  size_t size = 0;
+  for (const Level& level : m_levels)
+    size += level.data.size();
+  return size;
+}
+
 AbstractTextureFormat HiresTexture::GetFormat() const
 {
   return m_levels.at(0).format;
@@ -4,15 +4,19 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
 #include "VideoCommon/TextureConfig.h"
 
+class TexturePack;
 enum class TextureFormat;
+struct DiskTexture;
 
 class HiresTexture
 {
@@ -21,9 +25,17 @@ public:
   static void Update();
   static void Shutdown();
 
+  // When custom textures are streamed, textures which haven't been loaded yet are queued for
+  // loading in the background and nullptr is returned. In that case, pending_name (if given) is
+  // set to the name that IsLoading can be polled with.
   static std::shared_ptr<HiresTexture> Search(const u8* texture, size_t texture_size,
                                               const u8* tlut, size_t tlut_size, u32 width,
-                                              u32 height, TextureFormat format, bool has_mipmaps);
+                                              u32 height, TextureFormat format, bool has_mipmaps,
+                                              std::string* pending_name = nullptr);
+
+  // Whether a streamed texture is still being loaded. Once this returns false, Search returns the
+  // texture (or nullptr if it couldn't be loaded) until it is evicted from the cache again.
+  static bool IsLoading(const std::string& base_name);
 
   static std::string GenBaseName(const u8* texture, size_t texture_size, const u8* tlut,
                                  size_t tlut_size, u32 width, u32 height, TextureFormat format,
@@ -31,6 +43,11 @@ public:
 
   static u32 CalculateMipCount(u32 width, u32 height);
 
+  // Writes all custom textures in the directory to a texture pack. progress is called with the
+  // number of textures which have been written and the total.
+  static bool ConvertToTexturePack(const std::string& directory, const std::string& pack_filename,
+                                   const std::function<void(size_t, size_t)>& progress);
+
   ~HiresTexture();
 
   AbstractTextureFormat GetFormat() const;
@@ -39,23 +56,58 @@ public:
   struct Level
   {
     std::vector<u8> data;
+    // Set instead of data if the level is stored in a memory-mapped texture pack.
+    const u8* mapped_data = nullptr;
+    size_t mapped_size = 0;
     AbstractTextureFormat format = AbstractTextureFormat::RGBA8;
     u32 width = 0;
     u32 height = 0;
     u32 row_length = 0;
+
+    const u8* GetData() const { return mapped_data ? mapped_data : data.data(); }
+    size_t GetSize() const { return mapped_data ? mapped_size : data.size(); }
   };
   std::vector<Level> m_levels;
 
 private:
+  using DiskTextureMap = std::unordered_map<std::string, DiskTexture>;
+  using TexturePackList = std::vector<std::shared_ptr<const TexturePack>>;
+
+  // Loads from the textures found by Init.
   static std::unique_ptr<HiresTexture> Load(const std::string& base_filename, u32 width,
                                             u32 height);
+  static std::unique_ptr<HiresTexture> Load(const std::string& base_filename, u32 width,
+                                            u32 height, const DiskTextureMap& texture_map,
+                                            const TexturePackList& texture_packs);
+  static std::unique_ptr<HiresTexture> LoadFromFiles(const std::string& base_filename,
+                                                     const DiskTextureMap& texture_map,
+                                                     std::string* source);
+  static std::unique_ptr<HiresTexture> LoadFromPack(const std::string& base_filename,
+                                                    const TexturePackList& texture_packs,
+                                                    std::string* source);
   static bool LoadDDSTexture(HiresTexture* tex, const std::string& filename);
   static bool LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level);
   static bool LoadTexture(Level& level, const std::vector<u8>& buffer);
   static void Prefetch();
 
+  static void AddTextureDirectory(const std::string& directory, DiskTextureMap* texture_map);
+  static bool HasTexture(const std::string& base_filename);
+
+  static void StartStreaming(size_t memory_budget);
+  static void StopStreaming();
+  static void StreamWorker();
+  static std::shared_ptr<HiresTexture> SearchStreamed(const std::string& base_filename, u32 width,
+                                                      u32 height, std::string* pending_name);
+  static void EvictStreamedTextures();
+  static void UpdateStreamStatistics();
+
+  size_t GetDataSize() const;
+
   static std::set<std::string> GetTextureDirectories(const std::string& game_id);
+  static std::vector<std::string> GetTexturePackPaths(const std::string& game_id);
 
   HiresTexture() {}
   bool m_has_arbitrary_mipmaps;
+  // Keeps the pack mapped while levels point into it.
+  std::shared_ptr<const TexturePack> m_pack;
 };
@@ -15,7 +15,12 @@
 
 #include "VideoCommon/OpcodeDecoding.h"
 
+#include <list>
+#include <unordered_map>
+#include <vector>
+
 #include "Common/CommonTypes.h"
+#include "Common/Hash.h"
 #include "Common/Logging/Log.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
 #include "Core/HW/Memmap.h"
@@ -34,6 +39,120 @@ namespace
 {
 bool s_is_fifo_error_seen = false;
 
+// Many games call the same static display lists over and over, so the output of the vertex loader
+// is kept for each draw in a display list. The display lists are identified by their address and
+// size, and the cached vertices are dropped whenever the hash of a display list's contents changes.
+// The other commands in the display list are still run every time.
+//
+// A display list's vertices are only cached once it has been called twice with the same contents,
+// so lists that are rebuilt for every call don't get copied into the cache each time. When the
+// cache is full, the least recently called display lists are evicted first.
+struct DisplayListCacheEntry
+{
+  u64 hash = 0;
+  std::vector<VertexLoaderManager::CachedVertices> draws;
+  std::list<u64>::iterator lru_position;
+};
+
+constexpr size_t MAX_DISPLAY_LIST_CACHE_SIZE = 64 * 1024 * 1024;
+
+std::unordered_map<u64, DisplayListCacheEntry> s_display_list_cache;
+// Keys of s_display_list_cache, most recently called first.
+std::list<u64> s_display_list_lru;
+size_t s_display_list_cache_size = 0;
+
+// The display list which is currently being run, if any.
+DisplayListCacheEntry* s_current_display_list = nullptr;
+const u8* s_current_display_list_start = nullptr;
+size_t s_current_draw = 0;
+
+void ClearDisplayListCache()
+{
+  s_display_list_cache.clear();
+  s_display_list_lru.clear();
+  s_display_list_cache_size = 0;
+}
+
+void ClearDisplayListDraws(DisplayListCacheEntry* entry)
+{
+  for (const VertexLoaderManager::CachedVertices& draw : entry->draws)
+    s_display_list_cache_size -= draw.data.size();
+  entry->draws.clear();
+}
+
+void EvictDisplayListCacheEntries(u64 current_key)
+{
+  while (s_display_list_cache_size > MAX_DISPLAY_LIST_CACHE_SIZE &&
+         s_display_list_lru.back() != current_key)
+  {
+    const auto it = s_display_list_cache.find(s_display_list_lru.back());
+    ClearDisplayListDraws(&it->second);
+    s_display_list_cache_size -= sizeof(DisplayListCacheEntry);
+    s_display_list_cache.erase(it);
+    s_display_list_lru.pop_back();
+  }
+}
+
+// Returns the entry to cache the draws of this call of the display list in, or nullptr if they
+// shouldn't be cached (yet).
+DisplayListCacheEntry* GetDisplayListCacheEntry(u32 address, u32 size, const u8* data)
+{
+  const u64 key = static_cast<u64>(address) << 32 | size;
+  const u64 hash = Common::GetWideHash64(data, size, 0);
+
+  DisplayListCacheEntry* result = nullptr;
+  const auto it = s_display_list_cache.find(key);
+  if (it == s_display_list_cache.end())
+  {
+    // First call. Only remember the contents.
+    DisplayListCacheEntry& entry = s_display_list_cache[key];
+    entry.hash = hash;
+    s_display_list_lru.push_front(key);
+    entry.lru_position = s_display_list_lru.begin();
+    s_display_list_cache_size += sizeof(DisplayListCacheEntry);
+  }
+  else
+  {
+    DisplayListCacheEntry& entry = it->second;
+    s_display_list_lru.splice(s_display_list_lru.begin(), s_display_list_lru, entry.lru_position);
+    if (entry.hash == hash)
+    {
+      result = &entry;
+    }
+    else
+    {
+      ClearDisplayListDraws(&entry);
+      entry.hash = hash;
+    }
+  }
+
+  EvictDisplayListCacheEntries(key);
+  return result;
+}
+
+int RunDisplayListVertices(int vtx_attr_group, int primitive, int count, DataReader src)
+{
+  DisplayListCacheEntry& entry = *s_current_display_list;
+  if (s_current_draw >= entry.draws.size())
+    entry.draws.resize(s_current_draw + 1);
+  VertexLoaderManager::CachedVertices& draw = entry.draws[s_current_draw++];
+
+  // Changes of the vertex formats can move the draws around in the display list.
+  const u32 source_offset = static_cast<u32>(src.GetPointer() - s_current_display_list_start);
+  if (draw.source_offset != source_offset)
+  {
+    s_display_list_cache_size -= draw.data.size();
+    draw = {};
+    draw.source_offset = source_offset;
+  }
+
+  const size_t old_size = draw.data.size();
+  const int bytes =
+      VertexLoaderManager::RunVertices(vtx_attr_group, primitive, count, src, false, &draw);
+  s_display_list_cache_size += draw.data.size() - old_size;
+  return bytes;
+}
+
 u32 InterpretDisplayList(u32 address, u32 size)
 {
   u8* start_address;
@@ -51,9 +170,15 @@ u32 InterpretDisplayList(u32 address, u32 size)
     // temporarily swap dl and non-dl (small "hack" for the stats)
     g_stats.SwapDL();
 
+    s_current_display_list = GetDisplayListCacheEntry(address, size, start_address);
+    s_current_display_list_start = start_address;
+    s_current_draw = 0;
+
     Run(DataReader(start_address, start_address + size), &cycles, true);
     INCSTAT(g_stats.this_frame.num_dlists_called);
 
+    s_current_display_list = nullptr;
+
     // un-swap
     g_stats.SwapDL();
   }
@@ -79,6 +204,9 @@ bool g_record_fifo_data = false;
 void Init()
 {
   s_is_fifo_error_seen = false;
+
+  // The cached vertices refer to vertex loaders, which are recreated along with the backend.
+  ClearDisplayListCache();
 }
 
 template <bool is_preprocess>
@@ -241,9 +369,14 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
           return finish_up();
 
         const u16 num_vertices = src.Read<u16>();
-        const int bytes = VertexLoaderManager::RunVertices(
-            cmd_byte & GX_VAT_MASK,  // Vertex loader index (0 - 7)
-            (cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT, num_vertices, src, is_preprocess);
+        const int vtx_attr_group = cmd_byte & GX_VAT_MASK;  // Vertex loader index (0 - 7)
+        const int primitive = (cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT;
+        int bytes;
+        if (!is_preprocess && in_display_list && s_current_display_list)
+          bytes = RunDisplayListVertices(vtx_attr_group, primitive, num_vertices, src);
+        else
+          bytes = VertexLoaderManager::RunVertices(vtx_attr_group, primitive, num_vertices, src,
+                                                   is_preprocess);
 
         if (bytes < 0)
           return finish_up();
@@ -1456,9 +1456,6 @@ void Renderer::FlushFrameDump()
   if (!m_last_frame_exported)
     return;
 
-  // Ensure the previously-queued frame was encoded.
-  FinishFrameData();
-
   // Queue encoding of the last frame dumped.
   std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_textures[0];
   rbtex->Flush();
@@ -1485,25 +1482,46 @@ void Renderer::ShutdownFrameDumping()
   if (!m_frame_dump_thread_running.IsSet())
     return;
 
-  // Ensure previous frame has been encoded.
+  // Ensure all queued frames have been encoded.
   FinishFrameData();
 
   // Wake thread up, and wait for it to exit.
-  m_frame_dump_thread_running.Clear();
-  m_frame_dump_start.Set();
+  {
+    std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+    m_frame_dump_thread_running.Clear();
+  }
+  m_frame_dump_queue_changed.notify_all();
   if (m_frame_dump_thread.joinable())
     m_frame_dump_thread.join();
   m_frame_dump_render_framebuffer.reset();
   m_frame_dump_render_texture.reset();
   for (auto& tex : m_frame_dump_readback_textures)
     tex.reset();
+
+  if (m_frame_dump_queued_frames != 0 || m_frame_dump_dropped_frames != 0)
+  {
+    NOTICE_LOG(VIDEO, "Frame dump: %u frames queued, %u frames dropped, maximum queue depth %u",
+               m_frame_dump_queued_frames, m_frame_dump_dropped_frames,
+               m_frame_dump_max_pending_frames);
+  }
+  if (m_frame_dump_dropped_frames != 0)
+  {
+    OSD::AddMessage(fmt::format("Frame dump dropped {} of {} frames", m_frame_dump_dropped_frames,
+                                m_frame_dump_queued_frames + m_frame_dump_dropped_frames),
+                    OSD::Duration::NORMAL);
+  }
+  m_frame_dump_free_buffers.clear();
+  m_frame_dump_max_pending_frames = 0;
+  m_frame_dump_queued_frames = 0;
+  m_frame_dump_dropped_frames = 0;
+  SETSTAT(g_stats.frame_dump_queue_depth, 0);
+  SETSTAT(g_stats.frame_dump_max_queue_depth, 0);
+  SETSTAT(g_stats.num_frame_dump_dropped_frames, 0);
 }
 
 void Renderer::DumpFrameData(const u8* data, int w, int h, int stride,
                              const FrameDump::Frame& state)
 {
-  m_frame_dump_config = FrameDumpConfig{data, w, h, stride, state};
-
   if (!m_frame_dump_thread_running.IsSet())
   {
     if (m_frame_dump_thread.joinable())
@@ -1512,18 +1530,57 @@ void Renderer::DumpFrameData(const u8* data, int w, int h, int stride,
     m_frame_dump_thread = std::thread(&Renderer::RunFrameDumps, this);
   }
 
+  std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+
+  // If the encoder can't keep up, either skip this frame or wait for a slot in the queue. The
+  // timestamps of the frames that are dumped are unaffected, so skipping a frame only extends the
+  // duration of the previous one.
+  const u32 queue_size = static_cast<u32>(std::max(g_ActiveConfig.iDumpQueueSize, 1));
+  if (m_frame_dump_pending_frames >= queue_size)
+  {
+    if (g_ActiveConfig.bDumpDropFrames)
+    {
+      m_frame_dump_dropped_frames++;
+      SETSTAT(g_stats.frame_dump_queue_depth, m_frame_dump_pending_frames);
+      SETSTAT(g_stats.num_frame_dump_dropped_frames, m_frame_dump_dropped_frames);
+      return;
+    }
+
+    m_frame_dump_queue_changed.wait(
+        lk, [this, queue_size] { return m_frame_dump_pending_frames < queue_size; });
+  }
+
+  std::vector<u8> buffer;
+  if (!m_frame_dump_free_buffers.empty())
+  {
+    buffer = std::move(m_frame_dump_free_buffers.back());
+    m_frame_dump_free_buffers.pop_back();
+  }
+
+  // Only the video thread adds frames, so the copy doesn't need to hold the lock.
+  lk.unlock();
+  buffer.resize(static_cast<size_t>(h) * stride);
+  std::copy_n(data, buffer.size(), buffer.begin());
+  lk.lock();
+
+  m_frame_dump_queue.push_back({std::move(buffer), FrameDumpConfig{nullptr, w, h, stride, state}});
+  m_frame_dump_pending_frames++;
+  m_frame_dump_queued_frames++;
+  m_frame_dump_max_pending_frames =
+      std::max(m_frame_dump_max_pending_frames, m_frame_dump_pending_frames);
+  SETSTAT(g_stats.frame_dump_queue_depth, m_frame_dump_pending_frames);
+  SETSTAT(g_stats.frame_dump_max_queue_depth, m_frame_dump_max_pending_frames);
+  SETSTAT(g_stats.num_frame_dump_dropped_frames, m_frame_dump_dropped_frames);
+  lk.unlock();
+
   // Wake worker thread up.
-  m_frame_dump_start.Set();
-  m_frame_dump_frame_running = true;
+  m_frame_dump_queue_changed.notify_all();
 }
 
 void Renderer::FinishFrameData()
 {
-  if (!m_frame_dump_frame_running)
-    return;
-
-  m_frame_dump_done.Wait();
-  m_frame_dump_frame_running = false;
+  std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+  m_frame_dump_queue_changed.wait(lk, [this] { return m_frame_dump_pending_frames == 0; });
 }
 
 void Renderer::RunFrameDumps()
@@ -1544,11 +1601,21 @@ void Renderer::RunFrameDumps()
 
   while (true)
   {
-    m_frame_dump_start.Wait();
-    if (!m_frame_dump_thread_running.IsSet())
-      break;
+    QueuedFrameDump frame;
+    {
+      std::unique_lock<std::mutex> lk(m_frame_dump_lock);
+      m_frame_dump_queue_changed.wait(lk, [this] {
+        return !m_frame_dump_queue.empty() || !m_frame_dump_thread_running.IsSet();
+      });
+      if (m_frame_dump_queue.empty())
+        break;
+
+      frame = std::move(m_frame_dump_queue.front());
+      m_frame_dump_queue.pop_front();
+    }
 
-    auto config = m_frame_dump_config;
+    auto config = frame.config;
+    config.data = frame.buffer.data();
 
     // Save screenshot
     if (m_screenshot_request.TestAndClear())
@@ -1588,7 +1655,12 @@ void Renderer::RunFrameDumps()
       }
     }
 
-    m_frame_dump_done.Set();
+    {
+      std::lock_guard<std::mutex> lk(m_frame_dump_lock);
+      m_frame_dump_free_buffers.push_back(std::move(frame.buffer));
+      m_frame_dump_pending_frames--;
+    }
+    m_frame_dump_queue_changed.notify_all();
   }
 
   if (frame_dump_started)
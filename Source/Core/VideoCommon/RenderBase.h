@@ -15,6 +15,8 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -350,11 +352,8 @@ private:
 
   // frame dumping
   std::thread m_frame_dump_thread;
-  Common::Event m_frame_dump_start;
-  Common::Event m_frame_dump_done;
   Common::Flag m_frame_dump_thread_running;
   u32 m_frame_dump_image_counter = 0;
-  bool m_frame_dump_frame_running = false;
   struct FrameDumpConfig
   {
     const u8* data;
@@ -362,7 +361,24 @@ private:
     int height;
     int stride;
     FrameDump::Frame state;
-  } m_frame_dump_config;
+  };
+
+  // Frames waiting to be dumped are copied out of the readback texture, so that the renderer only
+  // has to wait for the dumping thread when the queue is full.
+  struct QueuedFrameDump
+  {
+    std::vector<u8> buffer;
+    FrameDumpConfig config;
+  };
+  std::mutex m_frame_dump_lock;
+  std::condition_variable m_frame_dump_queue_changed;
+  std::deque<QueuedFrameDump> m_frame_dump_queue;
+  std::vector<std::vector<u8>> m_frame_dump_free_buffers;
+  // Frames in the queue or being dumped.
+  u32 m_frame_dump_pending_frames = 0;
+  u32 m_frame_dump_max_pending_frames = 0;
+  u32 m_frame_dump_queued_frames = 0;
+  u32 m_frame_dump_dropped_frames = 0;
 
   // Texture used for screenshot/frame dumping
   std::unique_ptr<AbstractTexture> m_frame_dump_render_texture;
@@ -400,7 +416,7 @@ private:
   void DumpCurrentFrame(const AbstractTexture* src_texture,
                         const MathUtil::Rectangle<int>& src_rect, u64 ticks);
 
-  // Asynchronously encodes the specified pointer of frame data to the frame dump.
+  // Copies the frame data and queues it for encoding to the frame dump.
   void DumpFrameData(const u8* data, int w, int h, int stride, const FrameDump::Frame& state);
 
   // Ensures all rendered frames are queued for encoding.
@@ -49,10 +49,12 @@ void ShaderCache::InitializeShaderCache()
 {
   m_async_shader_compiler->ResizeWorkerThreads(g_ActiveConfig.GetShaderPrecompilerThreads());
 
-  // Load shader and UID caches.
-  if (g_ActiveConfig.bShaderCache && m_api_type != APIType::Nothing)
+  // Load shader and UID caches. The UID cache doesn't depend on the backend, so it is kept even
+  // without one, which allows it to be built by playing back FIFO logs with the null backend.
+  if (g_ActiveConfig.bShaderCache)
   {
-    LoadCaches();
+    if (m_api_type != APIType::Nothing)
+      LoadCaches();
     LoadPipelineUIDCache();
   }
 
@@ -118,7 +120,7 @@ const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
   std::unique_ptr<AbstractPipeline> pipeline;
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXPipelineConfig(uid);
   if (pipeline_config)
-    pipeline = g_renderer->CreatePipeline(*pipeline_config);
+    pipeline = CreatePipeline(uid, *pipeline_config, m_gx_pipeline_disk_cache);
   if (g_ActiveConfig.bShaderCache && !exists_in_cache)
     AppendGXPipelineUID(uid);
   return InsertGXPipeline(uid, std::move(pipeline));
@@ -150,7 +152,7 @@ const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineU
   std::unique_ptr<AbstractPipeline> pipeline;
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXPipelineConfig(uid);
   if (pipeline_config)
-    pipeline = g_renderer->CreatePipeline(*pipeline_config);
+    pipeline = CreatePipeline(uid, *pipeline_config, m_gx_uber_pipeline_disk_cache);
   return InsertGXUberPipeline(uid, std::move(pipeline));
 }
 
@@ -264,60 +266,39 @@ template <typename KeyType, typename DiskKeyType, typename T>
 void ShaderCache::LoadPipelineCache(T& cache, LinearDiskCache<DiskKeyType, u8>& disk_cache,
                                     APIType api_type, const char* type, bool include_gameid)
 {
-  class CacheReader : public LinearDiskCacheReader<DiskKeyType, u8>
-  {
-  public:
-    CacheReader(ShaderCache* this_ptr_, T& cache_) : this_ptr(this_ptr_), cache(cache_) {}
-    bool AnyFailed() const { return failed; }
-    void Read(const DiskKeyType& key, const u8* value, u32 value_size)
-    {
-      KeyType real_uid;
-      UnserializePipelineUid(key, real_uid);
-
-      // Skip those which are already compiled.
-      if (failed || cache.find(real_uid) != cache.end())
-        return;
-
-      auto config = this_ptr->GetGXPipelineConfig(real_uid);
-      if (!config)
-        return;
-
-      auto pipeline = g_renderer->CreatePipeline(*config, value, value_size);
-      if (!pipeline)
-      {
-        // If any of the pipelines fail to create, consider the cache stale.
-        failed = true;
-        return;
-      }
-
-      auto& entry = cache[real_uid];
-      entry.first = std::move(pipeline);
-      entry.second = false;
-    }
-
-  private:
-    ShaderCache* this_ptr;
-    T& cache;
-    bool failed = false;
-  };
-
+  // Only the keys are loaded here. The pipelines are created from the cached data once they are
+  // compiled, which happens in the background for all of them in CompileMissingPipelines.
   std::string filename = GetDiskShaderCacheFileName(api_type, type, include_gameid, true);
-  CacheReader reader(this, cache);
-  u32 count = disk_cache.OpenAndRead(filename, reader);
-  INFO_LOG(VIDEO, "Loaded %u cached pipelines from %s", count, filename.c_str());
-
-  // If any of the pipelines in the cache failed to create, it's likely because of a change of
-  // driver version, or system configuration. In this case, when the UID cache picks up the pipeline
-  // later on, we'll write a duplicate entry to the pipeline cache. There's also no point in keeping
-  // the old cache data around, so discard and recreate the disk cache.
-  if (reader.AnyFailed())
+  u32 count = disk_cache.Open(filename);
+  disk_cache.ForEachKey([&cache](const DiskKeyType& key) {
+    KeyType real_uid;
+    UnserializePipelineUid(key, real_uid);
+    cache.try_emplace(real_uid);
+  });
+  INFO_LOG(VIDEO, "Found %u cached pipelines in %s", count, filename.c_str());
+}
+
+template <typename KeyType, typename DiskKeyType>
+std::unique_ptr<AbstractPipeline>
+ShaderCache::CreatePipeline(const KeyType& uid, const AbstractPipelineConfig& config,
+                            LinearDiskCache<DiskKeyType, u8>& disk_cache)
+{
+  DiskKeyType disk_uid;
+  SerializePipelineUid(uid, disk_uid);
+  std::vector<u8> cache_data;
+  if (disk_cache.Get(disk_uid, &cache_data))
   {
-    WARN_LOG(VIDEO, "Failed to load one or more pipelines from cache '%s'. Discarding.",
-             filename.c_str());
-    disk_cache.Close();
-    File::Delete(filename);
-    disk_cache.OpenAndRead(filename, reader);
+    auto pipeline = g_renderer->CreatePipeline(config, cache_data.data(), cache_data.size());
+    if (pipeline)
+      return pipeline;
+
+    // The data is likely stale because of a driver update or a change of system configuration.
+    // Dropping it makes InsertGXPipeline append the data of the recompiled pipeline.
+    WARN_LOG(VIDEO, "Failed to create a pipeline from cached data, recompiling.");
+    disk_cache.Erase(disk_uid);
   }
+
+  return g_renderer->CreatePipeline(config);
 }
 
 template <typename T, typename Y>
@@ -679,13 +660,14 @@ const AbstractPipeline* ShaderCache::InsertGXPipeline(const GXPipelineUid& confi
   {
     entry.first = std::move(pipeline);
 
-    if (g_ActiveConfig.bShaderCache)
+    // Pipelines which were created from the disk cache are already in it.
+    SerializedGXPipelineUid disk_uid;
+    SerializePipelineUid(config, disk_uid);
+    if (g_ActiveConfig.bShaderCache && !m_gx_pipeline_disk_cache.Contains(disk_uid))
     {
       auto cache_data = entry.first->GetCacheData();
       if (!cache_data.empty())
       {
-        SerializedGXPipelineUid disk_uid;
-        SerializePipelineUid(config, disk_uid);
         m_gx_pipeline_disk_cache.Append(disk_uid, cache_data.data(),
                                         static_cast<u32>(cache_data.size()));
       }
@@ -705,13 +687,14 @@ ShaderCache::InsertGXUberPipeline(const GXUberPipelineUid& config,
   {
     entry.first = std::move(pipeline);
 
-    if (g_ActiveConfig.bShaderCache)
+    // Pipelines which were created from the disk cache are already in it.
+    SerializedGXUberPipelineUid disk_uid;
+    SerializePipelineUid(config, disk_uid);
+    if (g_ActiveConfig.bShaderCache && !m_gx_uber_pipeline_disk_cache.Contains(disk_uid))
     {
       auto cache_data = entry.first->GetCacheData();
       if (!cache_data.empty())
       {
-        SerializedGXUberPipelineUid disk_uid;
-        SerializePipelineUid(config, disk_uid);
         m_gx_uber_pipeline_disk_cache.Append(disk_uid, cache_data.data(),
                                              static_cast<u32>(cache_data.size()));
       }
@@ -982,7 +965,10 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
     bool Compile() override
     {
       if (config)
-        pipeline = g_renderer->CreatePipeline(*config);
+      {
+        pipeline =
+            shader_cache->CreatePipeline(uid, *config, shader_cache->m_gx_pipeline_disk_cache);
+      }
       return true;
     }
 
@@ -1055,7 +1041,10 @@ void ShaderCache::QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 pri
     bool Compile() override
     {
       if (config)
-        UberPipeline = g_renderer->CreatePipeline(*config);
+      {
+        UberPipeline =
+            shader_cache->CreatePipeline(uid, *config, shader_cache->m_gx_uber_pipeline_disk_cache);
+      }
       return true;
     }
 
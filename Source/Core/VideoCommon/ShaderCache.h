@@ -179,6 +179,10 @@ private:
                          const char* type, bool include_gameid);
   template <typename T, typename Y>
   void ClearPipelineCache(T& cache, Y& disk_cache);
+  template <typename KeyType, typename DiskKeyType>
+  std::unique_ptr<AbstractPipeline> CreatePipeline(const KeyType& uid,
+                                                   const AbstractPipelineConfig& config,
+                                                   LinearDiskCache<DiskKeyType, u8>& disk_cache);
 
   // Priorities for compiling. The lower the value, the sooner the pipeline is compiled.
   // The shader cache is compiled last, as it is the least likely to be required. On demand
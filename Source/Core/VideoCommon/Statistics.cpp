@@ -87,6 +87,23 @@ void Statistics::Display() const
   draw_statistic("EFB peeks:", "%d", this_frame.num_efb_peeks);
   draw_statistic("EFB pokes:", "%d", this_frame.num_efb_pokes);
 
+  if (g_ActiveConfig.bHiresTextures && g_ActiveConfig.bStreamHiresTextures)
+  {
+    draw_statistic("Custom texture hits", "%d", num_custom_texture_hits);
+    draw_statistic("Custom texture misses", "%d", num_custom_texture_misses);
+    draw_statistic("Custom textures streamed", "%d", num_custom_textures_streamed);
+    draw_statistic("Custom texture latency", "%d ms", custom_texture_load_latency_ms);
+    draw_statistic("Custom texture cache", "%d MB", custom_texture_cache_size_mb);
+  }
+
+  if (frame_dump_max_queue_depth != 0)
+  {
+    draw_statistic("Frame dump queue", "%d / %d", frame_dump_queue_depth,
+                   g_ActiveConfig.iDumpQueueSize);
+    draw_statistic("Frame dump max queue", "%d", frame_dump_max_queue_depth);
+    draw_statistic("Frame dump dropped", "%d", num_frame_dump_dropped_frames);
+  }
+
   ImGui::Columns(1);
 
   ImGui::End();
@@ -19,6 +19,18 @@ struct Statistics
 
   int num_vertex_loaders;
 
+  // Custom textures which are streamed in the background.
+  int num_custom_texture_hits;
+  int num_custom_texture_misses;
+  int num_custom_textures_streamed;
+  int custom_texture_load_latency_ms;  // Average time from the request until it was loaded
+  int custom_texture_cache_size_mb;
+
+  // Frames which are waiting to be dumped. Only shown while frames are being dumped.
+  int frame_dump_queue_depth;
+  int frame_dump_max_queue_depth;
+  int num_frame_dump_dropped_frames;
+
   std::array<float, 6> proj;
   std::array<float, 16> gproj;
   std::array<float, 16> g2proj;
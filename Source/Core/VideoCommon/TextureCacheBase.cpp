@@ -55,6 +55,8 @@ static const u64 TEXHASH_INVALID = 0;
 // Sonic the Fighters (inside Sonic Gems Collection) loops a 64 frames animation
 static const int TEXTURE_KILL_THRESHOLD = 64;
 static const int TEXTURE_POOL_KILL_THRESHOLD = 3;
+// Lets the AVX2 texture decoders write whole rows without crossing cache lines.
+static const size_t TEMP_ALIGNMENT = 32;
 
 std::unique_ptr<TextureCacheBase> g_texture_cache;
 
@@ -68,8 +70,13 @@ TextureCacheBase::TCacheEntry::TCacheEntry(std::unique_ptr<AbstractTexture> tex,
 
 TextureCacheBase::TCacheEntry::~TCacheEntry()
 {
-  for (auto& reference : references)
-    reference->references.erase(this);
+  for (TCacheEntry* reference : references)
+  {
+    auto& other_references = reference->references;
+    const auto it = std::find(other_references.begin(), other_references.end(), this);
+    if (it != other_references.end())
+      other_references.erase(it);
+  }
 }
 
 void TextureCacheBase::CheckTempSize(size_t required_size)
@@ -79,7 +86,7 @@ void TextureCacheBase::CheckTempSize(size_t required_size)
 
   temp_size = required_size;
   Common::FreeAlignedMemory(temp);
-  temp = static_cast<u8*>(Common::AllocateAlignedMemory(temp_size, 16));
+  temp = static_cast<u8*>(Common::AllocateAlignedMemory(temp_size, TEMP_ALIGNMENT));
 }
 
 TextureCacheBase::TextureCacheBase()
@@ -87,7 +94,7 @@ TextureCacheBase::TextureCacheBase()
   SetBackupConfig(g_ActiveConfig);
 
   temp_size = 2048 * 2048 * 4;
-  temp = static_cast<u8*>(Common::AllocateAlignedMemory(temp_size, 16));
+  temp = static_cast<u8*>(Common::AllocateAlignedMemory(temp_size, TEMP_ALIGNMENT));
 
   TexDecoder_SetTexFmtOverlayOptions(backup_config.texfmt_overlay,
                                      backup_config.texfmt_overlay_center);
@@ -132,7 +139,7 @@ void TextureCacheBase::Invalidate()
     delete tex.second;
   }
   textures_by_address.clear();
-  textures_by_hash.clear();
+  textures_by_hash.Clear();
 
   texture_pool.clear();
 }
@@ -140,7 +147,9 @@ void TextureCacheBase::Invalidate()
 void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
 {
   if (config.bHiresTextures != backup_config.hires_textures ||
-      config.bCacheHiresTextures != backup_config.cache_hires_textures)
+      config.bCacheHiresTextures != backup_config.cache_hires_textures ||
+      config.bStreamHiresTextures != backup_config.stream_hires_textures ||
+      config.iHiresTextureCacheSize != backup_config.hires_texture_cache_size)
   {
     HiresTexture::Update();
   }
@@ -242,6 +251,8 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   backup_config.texfmt_overlay_center = config.bTexFmtOverlayCenter;
   backup_config.hires_textures = config.bHiresTextures;
   backup_config.cache_hires_textures = config.bCacheHiresTextures;
+  backup_config.stream_hires_textures = config.bStreamHiresTextures;
+  backup_config.hires_texture_cache_size = config.iHiresTextureCacheSize;
   backup_config.stereo_3d = config.stereo_mode != StereoMode::Off;
   backup_config.efb_mono_depth = config.bStereoEFBMonoDepth;
   backup_config.gpu_texture_decoding = config.bEnableGPUTextureDecoding;
@@ -555,14 +566,13 @@ void TextureCacheBase::DoSaveState(PointerWrap& p)
         textures_by_address_list.emplace_back(it.first, id);
       }
     }
-    for (const auto& it : textures_by_hash)
-    {
-      if (ShouldSaveEntry(it.second))
+    textures_by_hash.ForEach([&](u64 hash, TCacheEntry* entry) {
+      if (ShouldSaveEntry(entry))
       {
-        const u32 id = AddCacheEntryToMap(it.second);
-        textures_by_hash_list.emplace_back(it.first, id);
+        const u32 id = AddCacheEntryToMap(entry);
+        textures_by_hash_list.emplace_back(hash, id);
       }
-    }
+    });
   }
 
   // Save the texture cache entries out in the order the were referenced.
@@ -652,7 +662,6 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
     // to update the point in the state state. We'll just throw it away if it's invalid.
     auto tex = DeserializeTexture(p);
     TCacheEntry* entry = new TCacheEntry(std::move(tex->texture), std::move(tex->framebuffer));
-    entry->textures_by_hash_iter = textures_by_hash.end();
     entry->DoState(p);
     if (entry->texture && commit_state)
       id_map.emplace(i, entry);
@@ -699,7 +708,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      entry->textures_by_hash_iter = textures_by_hash.emplace(hash, entry);
+      AddToHashIndex(entry, hash);
   }
 }
 
@@ -757,7 +766,7 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
   {
     TCacheEntry* entry = iter.first->second;
     if (entry != entry_to_update && entry->IsCopy() && !entry->tmem_only &&
-        entry->references.count(entry_to_update) == 0 &&
+        !entry->HasReference(entry_to_update) &&
         entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
         entry->memory_stride == numBlocksX * block_size)
     {
@@ -1163,6 +1172,14 @@ private:
   std::vector<Level> levels;
 };
 
+// Whether the custom texture which an entry was created without, because it was still being
+// streamed in, is available now (or has failed to load).
+static bool HasFinishedLoadingCustomTexture(const TextureCacheBase::TCacheEntry* entry)
+{
+  return !entry->pending_custom_texture.empty() &&
+         !HiresTexture::IsLoading(entry->pending_custom_texture);
+}
+
 TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
 {
   // if this stage was not invalidated by changes to texture registers, keep the current texture
@@ -1276,13 +1293,13 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
   // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
   // from the low tmem bank than it should)
-  base_hash = Common::GetHash64(src_data, texture_size, textureCacheSafetyColorSampleSize);
+  base_hash = Common::GetWideHash64(src_data, texture_size, textureCacheSafetyColorSampleSize);
   u32 palette_size = 0;
   if (isPaletteTexture)
   {
     palette_size = TexDecoder_GetPaletteSize(texformat);
-    full_hash = base_hash ^ Common::GetHash64(&texMem[tlutaddr], palette_size,
-                                              textureCacheSafetyColorSampleSize);
+    full_hash = base_hash ^ Common::GetWideHash64(&texMem[tlutaddr], palette_size,
+                                                  textureCacheSafetyColorSampleSize);
   }
   else
   {
@@ -1420,6 +1437,13 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
           entry->native_levels >= tex_levels && entry->native_width == nativeW &&
           entry->native_height == nativeH)
       {
+        // Replace the original texture once its custom texture has been streamed in.
+        if (HasFinishedLoadingCustomTexture(entry))
+        {
+          iter = InvalidateTexture(iter);
+          continue;
+        }
+
         entry = DoPartialTextureUpdates(iter->second, &texMem[tlutaddr], tlutfmt);
         entry->texture->FinishedRendering();
         return entry;
@@ -1474,20 +1498,17 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   if (textureCacheSafetyColorSampleSize == 0 ||
       std::max(texture_size, palette_size) <= (u32)textureCacheSafetyColorSampleSize * 8)
   {
-    auto hash_range = textures_by_hash.equal_range(full_hash);
-    TexHashCache::iterator hash_iter = hash_range.first;
-    while (hash_iter != hash_range.second)
+    // All parameters, except the address, need to match here
+    TCacheEntry* const* match = textures_by_hash.FindIf(full_hash, [&](const TCacheEntry* entry) {
+      return entry->format == full_format && entry->native_levels >= tex_levels &&
+             entry->native_width == nativeW && entry->native_height == nativeH &&
+             !HasFinishedLoadingCustomTexture(entry);
+    });
+    if (match)
     {
-      TCacheEntry* entry = hash_iter->second;
-      // All parameters, except the address, need to match here
-      if (entry->format == full_format && entry->native_levels >= tex_levels &&
-          entry->native_width == nativeW && entry->native_height == nativeH)
-      {
-        entry = DoPartialTextureUpdates(hash_iter->second, &texMem[tlutaddr], tlutfmt);
-        entry->texture->FinishedRendering();
-        return entry;
-      }
-      ++hash_iter;
+      TCacheEntry* entry = DoPartialTextureUpdates(*match, &texMem[tlutaddr], tlutfmt);
+      entry->texture->FinishedRendering();
+      return entry;
     }
   }
 
@@ -1499,10 +1520,11 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   }
 
   std::shared_ptr<HiresTexture> hires_tex;
+  std::string pending_custom_texture;
   if (g_ActiveConfig.bHiresTextures)
   {
     hires_tex = HiresTexture::Search(src_data, texture_size, &texMem[tlutaddr], palette_size, width,
-                                     height, texformat, use_mipmaps);
+                                     height, texformat, use_mipmaps, &pending_custom_texture);
 
     if (hires_tex)
     {
@@ -1540,8 +1562,8 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   if (hires_tex)
   {
     const auto& level = hires_tex->m_levels[0];
-    entry->texture->Load(0, level.width, level.height, level.row_length, level.data.data(),
-                         level.data.size());
+    entry->texture->Load(0, level.width, level.height, level.row_length, level.GetData(),
+                         level.GetSize());
   }
 
   // Initialized to null because only software loading uses this buffer
@@ -1598,13 +1620,14 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   if (textureCacheSafetyColorSampleSize == 0 ||
       std::max(texture_size, palette_size) <= (u32)textureCacheSafetyColorSampleSize * 8)
   {
-    entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, entry);
+    AddToHashIndex(entry, full_hash);
   }
 
   entry->SetGeneralParameters(address, texture_size, full_format, false);
   entry->SetDimensions(nativeW, nativeH, tex_levels);
   entry->SetHashes(base_hash, full_hash);
   entry->is_custom_tex = hires_tex != nullptr;
+  entry->pending_custom_texture = std::move(pending_custom_texture);
   entry->memory_stride = entry->BytesPerRow();
   entry->SetNotCopy();
 
@@ -1621,7 +1644,7 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
     {
       const auto& level = hires_tex->m_levels[level_index];
       entry->texture->Load(level_index, level.width, level.height, level.row_length,
-                           level.data.data(), level.data.size());
+                           level.GetData(), level.GetSize());
     }
   }
   else
@@ -1637,6 +1660,10 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
       ptr_odd = &texMem[tmem_address_odd];
     }
 
+    // The levels which are decoded on the CPU are decoded together, so that they can be decoded
+    // concurrently, and then uploaded in order.
+    std::vector<TextureDecodeLevel> mips_to_decode;
+    std::vector<u32> mip_indices;
     for (u32 level = 1; level != texLevels; ++level)
     {
       const u32 mip_width = CalculateLevelSize(width, level);
@@ -1654,19 +1681,29 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
                               bytes_per_block * (expanded_mip_width / bsw), tlut, tlutfmt))
       {
         // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
-        const u32 decoded_mip_size = expanded_mip_width * sizeof(u32) * expanded_mip_height;
-        TexDecoder_Decode(dst_buffer, mip_src_data, expanded_mip_width, expanded_mip_height,
-                          texformat, tlut, tlutfmt);
-        entry->texture->Load(level, mip_width, mip_height, expanded_mip_width, dst_buffer,
-                             decoded_mip_size);
-
-        arbitrary_mip_detector.AddLevel(mip_width, mip_height, expanded_mip_width, dst_buffer);
-
-        dst_buffer += decoded_mip_size;
+        mips_to_decode.push_back({dst_buffer, mip_src_data, static_cast<int>(expanded_mip_width),
+                                  static_cast<int>(expanded_mip_height)});
+        mip_indices.push_back(level);
+        dst_buffer += expanded_mip_width * sizeof(u32) * expanded_mip_height;
       }
 
       mip_src_data += mip_size;
     }
+
+    TexDecoder_DecodeLevels(mips_to_decode.data(), mips_to_decode.size(), texformat, tlut,
+                            tlutfmt);
+
+    for (size_t i = 0; i < mips_to_decode.size(); i++)
+    {
+      const TextureDecodeLevel& mip = mips_to_decode[i];
+      const u32 mip_width = CalculateLevelSize(width, mip_indices[i]);
+      const u32 mip_height = CalculateLevelSize(height, mip_indices[i]);
+      const u32 decoded_mip_size = mip.width * sizeof(u32) * mip.height;
+      entry->texture->Load(mip_indices[i], mip_width, mip_height, mip.width, mip.dst,
+                           decoded_mip_size);
+
+      arbitrary_mip_detector.AddLevel(mip_width, mip_height, mip.width, mip.dst);
+    }
   }
 
   entry->has_arbitrary_mips = hires_tex ? hires_tex->HasArbitraryMipmaps() :
@@ -1713,7 +1750,7 @@ TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
 
   // Compute total texture size. XFB textures aren't tiled, so this is simple.
   const u32 total_size = height * stride;
-  const u64 hash = Common::GetHash64(src_data, total_size, 0);
+  const u64 hash = Common::GetWideHash64(src_data, total_size, 0);
 
   // Do we currently have a version of this XFB copy in VRAM?
   TCacheEntry* entry = GetXFBFromCache(address, width, height, stride, hash);
@@ -1791,8 +1828,8 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::GetXFBFromCache(u32 address, u3
       u64 check_hash = hash;
       if (entry->native_width != width || entry->native_height != height)
       {
-        check_hash = Common::GetHash64(Memory::GetPointer(entry->addr),
-                                       entry->memory_stride * entry->native_height, 0);
+        check_hash = Common::GetWideHash64(Memory::GetPointer(entry->addr),
+                                           entry->memory_stride * entry->native_height, 0);
       }
 
       if (entry->hash == check_hash && !entry->reference_changed)
@@ -2295,11 +2332,7 @@ void TextureCacheBase::CopyRenderTargetToTexture(
 
       // Do not load textures by hash, if they were at least partly overwritten by an efb copy.
       // In this case, comparing the hash is not enough to check, if two textures are identical.
-      if (overlapping_entry->textures_by_hash_iter != textures_by_hash.end())
-      {
-        textures_by_hash.erase(overlapping_entry->textures_by_hash_iter);
-        overlapping_entry->textures_by_hash_iter = textures_by_hash.end();
-      }
+      RemoveFromHashIndex(overlapping_entry);
     }
     ++iter.first;
   }
@@ -2457,7 +2490,6 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::AllocateCacheEntry(const Textur
 
   TCacheEntry* cacheEntry =
       new TCacheEntry(std::move(alloc->texture), std::move(alloc->framebuffer));
-  cacheEntry->textures_by_hash_iter = textures_by_hash.end();
   cacheEntry->id = last_entry_id++;
   return cacheEntry;
 }
@@ -2545,6 +2577,22 @@ TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
   return std::make_pair(begin, end);
 }
 
+void TextureCacheBase::AddToHashIndex(TCacheEntry* entry, u64 hash)
+{
+  RemoveFromHashIndex(entry);
+  textures_by_hash.Insert(hash, entry);
+  entry->textures_by_hash_key = hash;
+}
+
+void TextureCacheBase::RemoveFromHashIndex(TCacheEntry* entry)
+{
+  if (!entry->textures_by_hash_key)
+    return;
+
+  textures_by_hash.Erase(*entry->textures_by_hash_key, entry);
+  entry->textures_by_hash_key.reset();
+}
+
 TextureCacheBase::TexAddrCache::iterator
 TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pending_efb_copy)
 {
@@ -2553,11 +2601,7 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
 
   TCacheEntry* entry = iter->second;
 
-  if (entry->textures_by_hash_iter != textures_by_hash.end())
-  {
-    textures_by_hash.erase(entry->textures_by_hash_iter);
-    entry->textures_by_hash_iter = textures_by_hash.end();
-  }
+  RemoveFromHashIndex(entry);
 
   for (size_t i = 0; i < bound_textures.size(); ++i)
   {
@@ -2908,7 +2952,7 @@ u64 TextureCacheBase::TCacheEntry::CalculateHash() const
   u8* ptr = Memory::GetPointer(addr);
   if (memory_stride == BytesPerRow())
   {
-    return Common::GetHash64(ptr, size_in_bytes, HashSampleSize());
+    return Common::GetWideHash64(ptr, size_in_bytes, HashSampleSize());
   }
   else
   {
@@ -2927,7 +2971,8 @@ u64 TextureCacheBase::TCacheEntry::CalculateHash() const
     {
       // Multiply by a prime number to mix the hash up a bit. This prevents identical blocks from
       // canceling each other out
-      temp_hash = (temp_hash * 397) ^ Common::GetHash64(ptr, BytesPerRow(), samples_per_row);
+      temp_hash =
+          (temp_hash * 397) ^ Common::GetWideHash64(ptr, BytesPerRow(), samples_per_row);
       ptr += memory_stride;
     }
     return temp_hash;
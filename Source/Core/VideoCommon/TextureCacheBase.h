@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <map>
@@ -12,10 +13,10 @@
 #include <string>
 #include <tuple>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/FlatHashMultimap.h"
 #include "Common/MathUtil.h"
 #include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/BPMemory.h"
@@ -97,6 +98,8 @@ public:
     u32 memory_stride;
     bool is_efb_copy;
     bool is_custom_tex;
+    // The custom texture which was still being streamed in when this entry was created.
+    std::string pending_custom_texture;
     bool may_have_overlapping_textures = true;
     bool tmem_only = false;           // indicates that this texture only exists in the tmem cache
     bool has_arbitrary_mips = false;  // indicates that the mips in this texture are arbitrary
@@ -115,14 +118,15 @@ public:
     // used to delete textures which haven't been used for TEXTURE_KILL_THRESHOLD frames
     int frameCount = FRAMECOUNT_INVALID;
 
-    // Keep an iterator to the entry in textures_by_hash, so it does not need to be searched when
-    // removing the cache entry
-    std::multimap<u64, TCacheEntry*>::iterator textures_by_hash_iter;
+    // The key this entry was added to textures_by_hash with, which can differ from hash after the
+    // hash of an XFB copy has been recalculated.
+    std::optional<u64> textures_by_hash_key;
 
     // This is used to keep track of both:
     //   * efb copies used by this partially updated texture
     //   * partially updated textures which refer to this efb copy
-    std::unordered_set<TCacheEntry*> references;
+    // There are rarely more than a few, so a vector is faster than a set here.
+    std::vector<TCacheEntry*> references;
 
     // Pending EFB copy
     std::unique_ptr<AbstractStagingTexture> pending_efb_copy;
@@ -162,9 +166,17 @@ public:
     // This texture entry is used by the other entry as a sub-texture
     void CreateReference(TCacheEntry* other_entry)
     {
+      if (HasReference(other_entry))
+        return;
+
       // References are two-way, so they can easily be destroyed later
-      this->references.emplace(other_entry);
-      other_entry->references.emplace(this);
+      this->references.push_back(other_entry);
+      other_entry->references.push_back(this);
+    }
+
+    bool HasReference(const TCacheEntry* other_entry) const
+    {
+      return std::find(references.begin(), references.end(), other_entry) != references.end();
     }
 
     void SetXfbCopy(u32 stride);
@@ -276,7 +288,7 @@ protected:
 
 private:
   using TexAddrCache = std::multimap<u32, TCacheEntry*>;
-  using TexHashCache = std::multimap<u64, TCacheEntry*>;
+  using TexHashCache = Common::FlatHashMultimap<TCacheEntry*>;
   using TexPool = std::unordered_multimap<TextureConfig, TexPoolEntry>;
 
   bool CreateUtilityTextures();
@@ -306,6 +318,9 @@ private:
   std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
   FindOverlappingTextures(u32 addr, u32 size_in_bytes);
 
+  void AddToHashIndex(TCacheEntry* entry, u64 hash);
+  void RemoveFromHashIndex(TCacheEntry* entry);
+
   // Removes and unlinks texture from texture cache and returns it to the pool
   TexAddrCache::iterator InvalidateTexture(TexAddrCache::iterator t_iter,
                                            bool discard_pending_efb_copy = false);
@@ -346,6 +361,8 @@ private:
     bool texfmt_overlay_center;
     bool hires_textures;
     bool cache_hires_textures;
+    bool stream_hires_textures;
+    int hires_texture_cache_size;
     bool copy_cache_enable;
     bool stereo_3d;
     bool efb_mono_depth;
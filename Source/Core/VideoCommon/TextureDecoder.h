@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <tuple>
 #include "Common/CommonTypes.h"
 
@@ -151,6 +152,19 @@ TextureFormat TexDecoder_GetEFBCopyBaseFormat(EFBCopyFormat format);
 
 void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFormat texformat,
                        const u8* tlut, TLUTFormat tlutfmt);
+
+struct TextureDecodeLevel
+{
+  u8* dst;
+  const u8* src;
+  int width;
+  int height;
+};
+
+// Decodes the levels of a texture, e.g. a mip chain. Levels which are big enough are split into
+// bands of block rows, and the bands of all levels are decoded on several threads at once.
+void TexDecoder_DecodeLevels(const TextureDecodeLevel* levels, size_t num_levels,
+                             TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
 void TexDecoder_DecodeRGBA8FromTmem(u8* dst, const u8* src_ar, const u8* src_gb, int width,
                                     int height);
 void TexDecoder_DecodeTexel(u8* dst, const u8* src, int s, int t, int imageWidth,
@@ -5,10 +5,13 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <vector>
 
+#include "Common/Align.h"
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 
 #include "VideoCommon/LookUpTables.h"
 #include "VideoCommon/TextureDecoder.h"
@@ -373,10 +376,78 @@ static void TexDecoder_DrawOverlay(u8* dst, int width, int height, TextureFormat
 void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFormat texformat,
                        const u8* tlut, TLUTFormat tlutfmt)
 {
-  _TexDecoder_DecodeImpl((u32*)dst, src, width, height, texformat, tlut, tlutfmt);
+  const TextureDecodeLevel level{dst, src, width, height};
+  TexDecoder_DecodeLevels(&level, 1, texformat, tlut, tlutfmt);
+}
+
+// Smaller bands aren't worth waking up another thread for.
+constexpr int MIN_TEXELS_PER_BAND = 32 * 1024;
+// Decoding is mostly limited by memory bandwidth, which a few threads already use up.
+constexpr u32 MAX_DECODE_WORKERS = 7;
+
+static Common::ThreadPool& GetDecodeThreadPool()
+{
+  // Leave cores for the CPU and GPU threads.
+  static Common::ThreadPool pool(
+      std::min(Common::ThreadPool::GetDefaultNumWorkers(2), MAX_DECODE_WORKERS), "Texture Decoder");
+  return pool;
+}
+
+void TexDecoder_DecodeLevels(const TextureDecodeLevel* levels, size_t num_levels,
+                             TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt)
+{
+  struct Band
+  {
+    const TextureDecodeLevel* level;
+    int first_row;
+    int num_rows;
+  };
+
+  const int block_width = TexDecoder_GetBlockWidthInTexels(texformat);
+  const int block_height = TexDecoder_GetBlockHeightInTexels(texformat);
+
+  // Bands have to start at a block row, which is where the source data of the block row starts.
+  std::vector<Band> bands;
+  int total_texels = 0;
+  for (size_t i = 0; i < num_levels; i++)
+  {
+    const TextureDecodeLevel& level = levels[i];
+    total_texels += level.width * level.height;
+    const int num_bands = std::max(level.width * level.height / MIN_TEXELS_PER_BAND, 1);
+    const int rows_per_band =
+        Common::AlignUp(static_cast<u32>((level.height + num_bands - 1) / num_bands),
+                        static_cast<u32>(block_height));
+    for (int row = 0; row < level.height; row += rows_per_band)
+      bands.push_back({&level, row, std::min(rows_per_band, level.height - row)});
+  }
+
+  const auto decode_band = [&](size_t i) {
+    const Band& band = bands[i];
+    const TextureDecodeLevel& level = *band.level;
+    const int src_row_size = TexDecoder_GetTextureSizeInBytes(
+        Common::AlignUp(static_cast<u32>(level.width), static_cast<u32>(block_width)), 1,
+        texformat);
+    _TexDecoder_DecodeImpl(reinterpret_cast<u32*>(level.dst) + band.first_row * level.width,
+                           level.src + band.first_row * src_row_size, level.width, band.num_rows,
+                           texformat, tlut, tlutfmt);
+  };
+
+  // A small mip chain has several bands, but isn't worth splitting up either.
+  if (total_texels < 2 * MIN_TEXELS_PER_BAND)
+  {
+    for (size_t i = 0; i < bands.size(); i++)
+      decode_band(i);
+  }
+  else
+  {
+    GetDecodeThreadPool().ParallelFor(bands.size(), decode_band);
+  }
 
   if (TexFmt_Overlay_Enable)
-    TexDecoder_DrawOverlay(dst, width, height, texformat);
+  {
+    for (size_t i = 0; i < num_levels; i++)
+      TexDecoder_DrawOverlay(levels[i].dst, levels[i].width, levels[i].height, texformat);
+  }
 }
 
 static inline u32 DecodePixel_IA8(u16 val)
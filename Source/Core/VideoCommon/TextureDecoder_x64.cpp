@@ -8,6 +8,7 @@
 
 #include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
+#include "Common/Inline.h"
 #include "Common/Intrinsics.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
@@ -161,6 +162,118 @@ static inline void DecodeBytes_IA4(u32* dst, const u8* src)
   }
 }
 
+// The AVX2 decoders convert eight texels at a time. The texel conversions take eight 16-bit
+// values, each in the low half of a 32-bit lane and already byte swapped, and return eight RGBA8
+// texels.
+
+// Loads two rows of four big-endian 16-bit texels.
+FUNCTION_TARGET_AVX2
+static inline __m256i Load16BitTexels_AVX2(const u8* src)
+{
+  const __m256i mask = _mm256_setr_epi8(1, 0, -128, -128, 3, 2, -128, -128, 5, 4, -128, -128, 7,
+                                        6, -128, -128, 9, 8, -128, -128, 11, 10, -128, -128, 13,
+                                        12, -128, -128, 15, 14, -128, -128);
+  const __m128i texels = _mm_loadu_si128((const __m128i*)src);
+  return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(texels), mask);
+}
+
+// Stores the low half of texels to dst, and the high half to the row below it.
+FUNCTION_TARGET_AVX2
+static inline void StoreTwoRows_AVX2(u32* dst, int width, __m256i texels)
+{
+  _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(texels));
+  _mm_storeu_si128((__m128i*)(dst + width), _mm256_extracti128_si256(texels, 1));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Convert4To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(v, 4), v);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Convert5To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(v, 3), _mm256_srli_epi32(v, 2));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i MakeRGBA_AVX2(__m256i r, __m256i g, __m256i b, __m256i a)
+{
+  return _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                         _mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_slli_epi32(a, 24)));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_IA8_AVX2(__m256i val)
+{
+  // (0 0 a i) -> (a i i i)
+  const __m256i mask = _mm256_setr_epi8(0, 0, 0, 1, 4, 4, 4, 5, 8, 8, 8, 9, 12, 12, 12, 13, 0, 0,
+                                        0, 1, 4, 4, 4, 5, 8, 8, 8, 9, 12, 12, 12, 13);
+  return _mm256_shuffle_epi8(val, mask);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_RGB565_AVX2(__m256i val)
+{
+  const __m256i mask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i r = Convert5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 11), mask_x1f));
+  const __m256i g6 = _mm256_and_si256(_mm256_srli_epi32(val, 5), _mm256_set1_epi32(0x3f));
+  const __m256i g = _mm256_or_si256(_mm256_slli_epi32(g6, 2), _mm256_srli_epi32(g6, 4));
+  const __m256i b = Convert5To8_AVX2(_mm256_and_si256(val, mask_x1f));
+  return MakeRGBA_AVX2(r, g, b, _mm256_set1_epi32(0xff));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_RGB5A3_AVX2(__m256i val)
+{
+  // Both encodings are decoded for all texels, and the top bit of each texel picks one of them.
+  const __m256i mask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i r5 = Convert5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 10), mask_x1f));
+  const __m256i g5 = Convert5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 5), mask_x1f));
+  const __m256i b5 = Convert5To8_AVX2(_mm256_and_si256(val, mask_x1f));
+  const __m256i rgb555 = MakeRGBA_AVX2(r5, g5, b5, _mm256_set1_epi32(0xff));
+
+  const __m256i mask_x0f = _mm256_set1_epi32(0x0f);
+  const __m256i r4 = Convert4To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 8), mask_x0f));
+  const __m256i g4 = Convert4To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 4), mask_x0f));
+  const __m256i b4 = Convert4To8_AVX2(_mm256_and_si256(val, mask_x0f));
+  const __m256i a3 = _mm256_and_si256(_mm256_srli_epi32(val, 12), _mm256_set1_epi32(0x07));
+  const __m256i a3_hi = _mm256_or_si256(_mm256_slli_epi32(a3, 5), _mm256_slli_epi32(a3, 2));
+  const __m256i a = _mm256_or_si256(a3_hi, _mm256_srli_epi32(a3, 1));
+  const __m256i rgb4443 = MakeRGBA_AVX2(r4, g4, b4, a);
+
+  const __m256i is_rgb555 = _mm256_srai_epi32(_mm256_slli_epi32(val, 16), 31);
+  return _mm256_blendv_epi8(rgb4443, rgb555, is_rgb555);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_Paletted_AVX2(__m256i val, TLUTFormat tlutfmt)
+{
+  switch (tlutfmt)
+  {
+  case TLUTFormat::IA8:
+    return DecodePixels_IA8_AVX2(val);
+  case TLUTFormat::RGB565:
+    return DecodePixels_RGB565_AVX2(val);
+  case TLUTFormat::RGB5A3:
+    return DecodePixels_RGB5A3_AVX2(val);
+  default:
+    return _mm256_setzero_si256();
+  }
+}
+
+// Decodes the first num_colors palette entries, a multiple of 8, to RGBA8.
+FUNCTION_TARGET_AVX2
+static void DecodeTLUT_AVX2(u32* palette, const u8* tlut, TLUTFormat tlutfmt, int num_colors)
+{
+  for (int i = 0; i < num_colors; i += 8)
+  {
+    const __m256i val = Load16BitTexels_AVX2(tlut + 2 * i);
+    _mm256_storeu_si256((__m256i*)(palette + i), DecodePixels_Paletted_AVX2(val, tlutfmt));
+  }
+}
+
 #ifdef CHECK
 static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 {
@@ -212,6 +325,41 @@ static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 // free to make the assumption that addresses are multiples of 16 in the aligned case.
 // TODO: complete SSE2 optimization of less often used texture formats.
 // TODO: refactor algorithms using _mm_loadl_epi64 unaligned loads to prefer 128-bit aligned loads.
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C4_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // The 16 colors fit in two registers, so the texels are looked up with permutes.
+  alignas(32) u32 palette[16];
+  DecodeTLUT_AVX2(palette, tlut, tlutfmt, 16);
+  const __m256i colors_lo = _mm256_load_si256((const __m256i*)palette);
+  const __m256i colors_hi = _mm256_load_si256((const __m256i*)(palette + 8));
+
+  // The first texel of each byte is in the high nibble.
+  const __m256i shifts = _mm256_setr_epi32(4, 0, 12, 8, 20, 16, 28, 24);
+  const __m256i mask_x0f = _mm256_set1_epi32(0x0f);
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
+      {
+        u32 row;
+        std::memcpy(&row, src + 4 * xStep, sizeof(row));
+        const __m256i indices =
+            _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(row), shifts), mask_x0f);
+        // Bit 3 of the index, shifted to the sign bit, picks the register.
+        const __m256 lo = _mm256_castsi256_ps(_mm256_permutevar8x32_epi32(colors_lo, indices));
+        const __m256 hi = _mm256_castsi256_ps(_mm256_permutevar8x32_epi32(colors_hi, indices));
+        const __m256 use_hi = _mm256_castsi256_ps(_mm256_slli_epi32(indices, 28));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x),
+                            _mm256_castps_si256(_mm256_blendv_ps(lo, hi, use_hi)));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_C4(u32* dst, const u8* src, int width, int height,
                                      TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                      int Wsteps4, int Wsteps8)
@@ -250,6 +398,40 @@ static void TexDecoder_DecodeImpl_C4(u32* dst, const u8* src, int width, int hei
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_I4_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m128i kMask_x0f = _mm_set1_epi32(0x0f0f0f0fL);
+  const __m128i kMask_xf0 = _mm_set1_epi32(0xf0f0f0f0L);
+
+  // Like the SSSE3 version, but each shuffle produces a whole row.
+  const __m256i mask_row0 = _mm256_setr_epi8(0, 0, 0, 0, 8, 8, 8, 8, 1, 1, 1, 1, 9, 9, 9, 9, 2, 2,
+                                             2, 2, 10, 10, 10, 10, 3, 3, 3, 3, 11, 11, 11, 11);
+  const __m256i mask_row1 = _mm256_add_epi8(mask_row0, _mm256_set1_epi8(4));
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 8; iy += 2, xStep++)
+      {
+        const __m128i r0 = _mm_loadl_epi64((const __m128i*)(src + 8 * xStep));
+        const __m128i i1 = _mm_and_si128(r0, kMask_xf0);
+        const __m128i i11 = _mm_or_si128(i1, _mm_srli_epi16(i1, 4));
+        const __m128i i2 = _mm_and_si128(r0, kMask_x0f);
+        const __m128i i22 = _mm_or_si128(i2, _mm_slli_epi16(i2, 4));
+        const __m256i base = _mm256_broadcastsi128_si256(_mm_unpacklo_epi64(i11, i22));
+
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x),
+                            _mm256_shuffle_epi8(base, mask_row0));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy + 1) * width + x),
+                            _mm256_shuffle_epi8(base, mask_row1));
+      }
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_I4_SSSE3(u32* dst, const u8* src, int width, int height,
                                            TextureFormat texformat, const u8* tlut,
@@ -390,6 +572,32 @@ static void TexDecoder_DecodeImpl_I4(u32* dst, const u8* src, int width, int hei
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_I8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Each shuffle expands a row of 8 bytes from two loaded rows to 8 texels.
+  const __m256i mask_row0 = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4,
+                                             4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+  const __m256i mask_row1 = _mm256_add_epi8(mask_row0, _mm256_set1_epi8(8));
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        const __m128i r0 = _mm_loadu_si128((const __m128i*)(src + 8 * xStep));
+        const __m256i r = _mm256_broadcastsi128_si256(r0);
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x),
+                            _mm256_shuffle_epi8(r, mask_row0));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy + 1) * width + x),
+                            _mm256_shuffle_epi8(r, mask_row1));
+      }
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_I8_SSSE3(u32* dst, const u8* src, int width, int height,
                                            TextureFormat texformat, const u8* tlut,
@@ -521,6 +729,29 @@ static void TexDecoder_DecodeImpl_I8(u32* dst, const u8* src, int width, int hei
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Decoding the whole palette up front leaves a single gather per row.
+  alignas(32) u32 palette[256];
+  DecodeTLUT_AVX2(palette, tlut, tlutfmt, 256);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
+      {
+        const __m256i indices =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + 8 * xStep)));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x),
+                            _mm256_i32gather_epi32((const int*)palette, indices, 4));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_C8(u32* dst, const u8* src, int width, int height,
                                      TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                      int Wsteps4, int Wsteps8)
@@ -559,6 +790,38 @@ static void TexDecoder_DecodeImpl_C8(u32* dst, const u8* src, int width, int hei
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA4_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m128i mask_x0f = _mm_set1_epi8(0x0f);
+  // (a i) pairs -> (a i i i)
+  const __m256i mask = _mm256_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7, 8, 8, 8, 9,
+                                        10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        const __m128i val = _mm_loadu_si128((const __m128i*)(src + 8 * xStep));
+        const __m128i i4 = _mm_and_si128(val, mask_x0f);
+        const __m128i a4 = _mm_and_si128(_mm_srli_epi16(val, 4), mask_x0f);
+        const __m128i i8 = _mm_or_si128(i4, _mm_slli_epi16(i4, 4));
+        const __m128i a8 = _mm_or_si128(a4, _mm_slli_epi16(a4, 4));
+
+        const __m256i row0 = _mm256_broadcastsi128_si256(_mm_unpacklo_epi8(i8, a8));
+        const __m256i row1 = _mm256_broadcastsi128_si256(_mm_unpackhi_epi8(i8, a8));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x),
+                            _mm256_shuffle_epi8(row0, mask));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy + 1) * width + x),
+                            _mm256_shuffle_epi8(row1, mask));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_IA4(u32* dst, const u8* src, int width, int height,
                                       TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                       int Wsteps4, int Wsteps8)
@@ -575,6 +838,28 @@ static void TexDecoder_DecodeImpl_IA4(u32* dst, const u8* src, int width, int he
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Shuffles two rows of (a i) pairs to (a i i i) at once.
+  const __m256i mask = _mm256_setr_epi8(1, 1, 1, 0, 3, 3, 3, 2, 5, 5, 5, 4, 7, 7, 7, 6, 9, 9, 9, 8,
+                                        11, 11, 11, 10, 13, 13, 13, 12, 15, 15, 15, 14);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        const __m128i r0 = _mm_loadu_si128((const __m128i*)(src + 8 * xStep));
+        StoreTwoRows_AVX2(dst + (y + iy) * width + x, width,
+                          _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(r0), mask));
+      }
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_IA8_SSSE3(u32* dst, const u8* src, int width, int height,
                                             TextureFormat texformat, const u8* tlut,
@@ -661,6 +946,59 @@ static void TexDecoder_DecodeImpl_IA8(u32* dst, const u8* src, int width, int he
   }
 }
 
+template <TLUTFormat tlutfmt>
+FUNCTION_TARGET_AVX2 static void DecodeC14X2_AVX2(u32* dst, const u8* src, int width, int height,
+                                                  const u8* tlut, int Wsteps4)
+{
+  const __m256i mask_x3fff = _mm256_set1_epi32(0x3fff);
+  const __m256i mask_x01 = _mm256_set1_epi32(0x01);
+  const __m256i swap_mask = _mm256_setr_epi8(1, 0, -128, -128, 5, 4, -128, -128, 9, 8, -128, -128,
+                                             13, 12, -128, -128, 1, 0, -128, -128, 5, 4, -128,
+                                             -128, 9, 8, -128, -128, 13, 12, -128, -128);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        const __m256i indices = _mm256_and_si256(Load16BitTexels_AVX2(src + 8 * xStep), mask_x3fff);
+        // Gather the aligned pairs of entries which contain the texels' entries, so that nothing
+        // past the end of the palette is read, and shift the odd entries down.
+        const __m256i pairs =
+            _mm256_i32gather_epi32((const int*)tlut, _mm256_srli_epi32(indices, 1), 4);
+        const __m256i shifts = _mm256_slli_epi32(_mm256_and_si256(indices, mask_x01), 4);
+        const __m256i val = _mm256_shuffle_epi8(_mm256_srlv_epi32(pairs, shifts), swap_mask);
+        StoreTwoRows_AVX2(dst + (y + iy) * width + x, width,
+                          DecodePixels_Paletted_AVX2(val, tlutfmt));
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C14X2_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  switch (tlutfmt)
+  {
+  case TLUTFormat::RGB5A3:
+    DecodeC14X2_AVX2<TLUTFormat::RGB5A3>(dst, src, width, height, tlut, Wsteps4);
+    break;
+
+  case TLUTFormat::IA8:
+    DecodeC14X2_AVX2<TLUTFormat::IA8>(dst, src, width, height, tlut, Wsteps4);
+    break;
+
+  case TLUTFormat::RGB565:
+    DecodeC14X2_AVX2<TLUTFormat::RGB565>(dst, src, width, height, tlut, Wsteps4);
+    break;
+
+  default:
+    break;
+  }
+}
+
 static void TexDecoder_DecodeImpl_C14X2(u32* dst, const u8* src, int width, int height,
                                         TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                         int Wsteps4, int Wsteps8)
@@ -699,6 +1037,24 @@ static void TexDecoder_DecodeImpl_C14X2(u32* dst, const u8* src, int width, int
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB565_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        StoreTwoRows_AVX2(dst + (y + iy) * width + x, width,
+                          DecodePixels_RGB565_AVX2(Load16BitTexels_AVX2(src + 8 * xStep)));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_RGB565(u32* dst, const u8* src, int width, int height,
                                          TextureFormat texformat, const u8* tlut,
                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
@@ -770,6 +1126,25 @@ static void TexDecoder_DecodeImpl_RGB565(u32* dst, const u8* src, int width, int
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB5A3_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Unlike the SSE versions, this doesn't need a scalar path for blocks with mixed encodings.
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy += 2, xStep += 2)
+      {
+        StoreTwoRows_AVX2(dst + (y + iy) * width + x, width,
+                          DecodePixels_RGB5A3_AVX2(Load16BitTexels_AVX2(src + 8 * xStep)));
+      }
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_RGB5A3_SSSE3(u32* dst, const u8* src, int width, int height,
                                                TextureFormat texformat, const u8* tlut,
@@ -997,6 +1372,33 @@ static void TexDecoder_DecodeImpl_RGB5A3(u32* dst, const u8* src, int width, int
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGBA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Like the SSSE3 version, with rows 0 and 2, and rows 1 and 3 sharing a register.
+  const __m256i mask0312 = _mm256_setr_epi8(2, 1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12, 2,
+                                            1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      const u8* src2 = src + 64 * yStep;
+      const __m256i ar = _mm256_loadu_si256((const __m256i*)src2);
+      const __m256i gb = _mm256_loadu_si256((const __m256i*)(src2 + 32));
+      const __m256i rgba02 = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(ar, gb), mask0312);
+      const __m256i rgba13 = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(ar, gb), mask0312);
+
+      u32* dst32 = dst + y * width + x;
+      _mm_storeu_si128((__m128i*)dst32, _mm256_castsi256_si128(rgba02));
+      _mm_storeu_si128((__m128i*)(dst32 + width), _mm256_castsi256_si128(rgba13));
+      _mm_storeu_si128((__m128i*)(dst32 + width * 2), _mm256_extracti128_si256(rgba02, 1));
+      _mm_storeu_si128((__m128i*)(dst32 + width * 3), _mm256_extracti128_si256(rgba13, 1));
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_RGBA8_SSSE3(u32* dst, const u8* src, int width, int height,
                                               TextureFormat texformat, const u8* tlut,
@@ -1153,6 +1555,204 @@ static void TexDecoder_DecodeImpl_RGBA8(u32* dst, const u8* src, int width, int
   }
 }
 
+// Calculates the colors of two DXT blocks, which are the low and high halves of dxt. This has to be
+// inlined, so that it uses the same instruction encoding as the AVX2 decoder.
+static DOLPHIN_FORCE_INLINE void DecodeCMPRColors(__m128i dxt, __m128i* out_colors0,
+                                                  __m128i* out_colors1)
+{
+  // JSD NOTE: You may see many strange patterns of behavior in the below code, but they
+  // are for performance reasons. Sometimes, calculating what should be obvious hard-coded
+  // constants is faster than loading their values from memory. Unfortunately, there is no
+  // way to inline 128-bit constants from opcodes so they must be loaded from memory. This
+  // seems a little ridiculous to me in that you can't even generate a constant value of 1
+  // without having to load it from memory. So, I stored the minimal constant I could,
+  // 128-bits worth of 1s :). Then I use sequences of shifts to squash it to the appropriate
+  // size and bitpositions that I need.
+  const __m128i allFFs128 = _mm_cmpeq_epi32(_mm_setzero_si128(), _mm_setzero_si128());
+
+  __m128i argb888x4;
+  __m128i c1 = _mm_unpackhi_epi16(dxt, dxt);
+  c1 = _mm_slli_si128(c1, 8);
+  const __m128i c0 =
+      _mm_or_si128(c1, _mm_srli_si128(_mm_slli_si128(_mm_unpacklo_epi16(dxt, dxt), 8), 8));
+
+  // Compare rgb0 to rgb1:
+  // Each 32-bit word will contain either 0xFFFFFFFF or 0x00000000 for true/false.
+  const __m128i c0cmp = _mm_srli_epi32(_mm_slli_epi32(_mm_srli_epi64(c0, 8), 16), 16);
+  const __m128i c0shr = _mm_srli_epi64(c0cmp, 32);
+  const __m128i cmprgb0rgb1 = _mm_cmpgt_epi32(c0cmp, c0shr);
+
+  int cmp0 = _mm_extract_epi16(cmprgb0rgb1, 0);
+  int cmp1 = _mm_extract_epi16(cmprgb0rgb1, 4);
+
+  // green:
+  // NOTE: We start with the larger number of bits (6) firts for G and shift the mask down
+  // 1 bit to get a 5-bit mask later for R and B components.
+  // low6mask == _mm_set_epi32(0x0000FC00, 0x0000FC00, 0x0000FC00, 0x0000FC00)
+  const __m128i low6mask = _mm_slli_epi32(_mm_srli_epi32(allFFs128, 24 + 2), 8 + 2);
+  const __m128i gtmp = _mm_srli_epi32(c0, 3);
+  const __m128i g0 = _mm_and_si128(gtmp, low6mask);
+  // low3mask == _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300)
+  const __m128i g1 = _mm_and_si128(
+      _mm_srli_epi32(gtmp, 6), _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300));
+  argb888x4 = _mm_or_si128(g0, g1);
+  // red:
+  // low5mask == _mm_set_epi32(0x000000F8, 0x000000F8, 0x000000F8, 0x000000F8)
+  const __m128i low5mask = _mm_slli_epi32(_mm_srli_epi32(low6mask, 8 + 3), 3);
+  const __m128i r0 = _mm_and_si128(c0, low5mask);
+  const __m128i r1 = _mm_srli_epi32(r0, 5);
+  argb888x4 = _mm_or_si128(argb888x4, _mm_or_si128(r0, r1));
+  // blue:
+  // _mm_slli_epi32(low5mask, 16) == _mm_set_epi32(0x00F80000, 0x00F80000, 0x00F80000,
+  // 0x00F80000)
+  const __m128i b0 = _mm_and_si128(_mm_srli_epi32(c0, 5), _mm_slli_epi32(low5mask, 16));
+  const __m128i b1 = _mm_srli_epi16(b0, 5);
+  // OR in the fixed alpha component
+  // _mm_slli_epi32( allFFs128, 24 ) == _mm_set_epi32(0xFF000000, 0xFF000000, 0xFF000000,
+  // 0xFF000000)
+  argb888x4 = _mm_or_si128(_mm_or_si128(argb888x4, _mm_slli_epi32(allFFs128, 24)),
+                           _mm_or_si128(b0, b1));
+  // calculate RGB2 and RGB3:
+  const __m128i rgb0 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(2, 2, 0, 0));
+  const __m128i rgb1 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(3, 3, 1, 1));
+  const __m128i rrggbb0 =
+      _mm_and_si128(_mm_unpacklo_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
+  const __m128i rrggbb1 =
+      _mm_and_si128(_mm_unpacklo_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
+  const __m128i rrggbb01 =
+      _mm_and_si128(_mm_unpackhi_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
+  const __m128i rrggbb11 =
+      _mm_and_si128(_mm_unpackhi_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
+
+  __m128i rgb2, rgb3;
+
+  // if (rgb0 > rgb1):
+  if (cmp0 != 0)
+  {
+    // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
+    // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
+    const __m128i rrggbbsum = _mm_add_epi16(rrggbb0, rrggbb1);
+
+    const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb0, 1);
+    const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb0, 2);
+
+    const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb1, 1);
+    const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb1, 2);
+
+    const __m128i rrggbb2 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
+    const __m128i rrggbb3 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
+
+    const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
+    const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
+
+    rgb2 = _mm_and_si128(rgb2dup, _mm_srli_si128(allFFs128, 8));
+    rgb3 = _mm_and_si128(rgb3dup, _mm_srli_si128(allFFs128, 8));
+  }
+  else
+  {
+    // RGB2b = avg(RGB0, RGB1)
+    const __m128i rrggbb21 = _mm_srai_epi16(_mm_add_epi16(rrggbb0, rrggbb1), 1);
+    const __m128i rgb210 = _mm_srli_si128(_mm_packus_epi16(rrggbb21, rrggbb21), 8);
+    rgb2 = rgb210;
+    rgb3 = _mm_and_si128(rgb210, _mm_srli_epi32(allFFs128, 8));
+  }
+
+  // if (rgb0 > rgb1):
+  if (cmp1 != 0)
+  {
+    // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
+    // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
+    const __m128i rrggbbsum = _mm_add_epi16(rrggbb01, rrggbb11);
+
+    const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb01, 1);
+    const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb01, 2);
+
+    const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb11, 1);
+    const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb11, 2);
+
+    const __m128i rrggbb2 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
+    const __m128i rrggbb3 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
+
+    const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
+    const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
+
+    rgb2 = _mm_or_si128(rgb2, _mm_and_si128(rgb2dup, _mm_slli_si128(allFFs128, 8)));
+    rgb3 = _mm_or_si128(rgb3, _mm_and_si128(rgb3dup, _mm_slli_si128(allFFs128, 8)));
+  }
+  else
+  {
+    // RGB2b = avg(RGB0, RGB1)
+    const __m128i rrggbb211 = _mm_srai_epi16(_mm_add_epi16(rrggbb01, rrggbb11), 1);
+    const __m128i rgb211 = _mm_slli_si128(_mm_packus_epi16(rrggbb211, rrggbb211), 8);
+    rgb2 = _mm_or_si128(rgb2, rgb211);
+
+    // _mm_srli_epi32( allFFs128, 8 ) == _mm_set_epi32(0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF,
+    // 0x00FFFFFF)
+    // Make this color fully transparent:
+    rgb3 = _mm_or_si128(rgb3, _mm_and_si128(_mm_and_si128(rgb2, _mm_srli_epi32(allFFs128, 8)),
+                                            _mm_slli_si128(allFFs128, 8)));
+  }
+
+  // Create an array for color lookups for DXT0 so we can use the 2-bit indices:
+  const __m128i mmcolors0 = _mm_or_si128(
+      _mm_or_si128(_mm_srli_si128(_mm_slli_si128(argb888x4, 8), 8),
+                   _mm_slli_si128(_mm_srli_si128(_mm_slli_si128(rgb2, 8), 8 + 4), 8)),
+      _mm_slli_si128(_mm_srli_si128(rgb3, 4), 8 + 4));
+
+  // Create an array for color lookups for DXT1 so we can use the 2-bit indices:
+  const __m128i mmcolors1 =
+      _mm_or_si128(_mm_or_si128(_mm_srli_si128(argb888x4, 8),
+                                _mm_slli_si128(_mm_srli_si128(rgb2, 8 + 4), 8)),
+                   _mm_slli_si128(_mm_srli_si128(rgb3, 8 + 4), 8 + 4));
+
+  *out_colors0 = mmcolors0;
+  *out_colors1 = mmcolors1;
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_CMPR_AVX2(u32* dst, const u8* src, int width, int height,
+                                            TextureFormat texformat, const u8* tlut,
+                                            TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // The colors of both blocks go into one register, the first block's in the low half, and each
+  // row of both blocks is looked up with a single permute.
+  const __m256i sel_mask = _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3);
+  const __m256i shifts = _mm256_setr_epi32(6, 4, 2, 0, 6, 4, 2, 0);
+  const __m256i block_offsets = _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4);
+  const __m256i mask_x03 = _mm256_set1_epi32(0x03);
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
+      {
+        const __m128i dxt = _mm_loadu_si128((__m128i*)(src + sizeof(struct DXTBlock) * 2 * xStep));
+        __m128i colors0, colors1;
+        DecodeCMPRColors(dxt, &colors0, &colors1);
+        const __m256i colors =
+            _mm256_inserti128_si256(_mm256_castsi128_si256(colors0), colors1, 1);
+        // The 2-bit indices, with one byte per row.
+        const __m256i sels = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(dxt), sel_mask);
+
+        u32* dst32 = dst + (y + z * 4) * width + x;
+        for (int row = 0; row < 4; row++)
+        {
+          const __m256i row_shifts = _mm256_add_epi32(shifts, _mm256_set1_epi32(8 * row));
+          const __m256i indices =
+              _mm256_and_si256(_mm256_srlv_epi32(sels, row_shifts), mask_x03);
+          _mm256_storeu_si256(
+              (__m256i*)(dst32 + row * width),
+              _mm256_permutevar8x32_epi32(colors, _mm256_add_epi32(indices, block_offsets)));
+        }
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int height,
                                        TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                        int Wsteps4, int Wsteps8)
@@ -1172,16 +1772,6 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
       // parallelizable at this level, so we do.
       for (int z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
       {
-        // JSD NOTE: You may see many strange patterns of behavior in the below code, but they
-        // are for performance reasons. Sometimes, calculating what should be obvious hard-coded
-        // constants is faster than loading their values from memory. Unfortunately, there is no
-        // way to inline 128-bit constants from opcodes so they must be loaded from memory. This
-        // seems a little ridiculous to me in that you can't even generate a constant value of 1
-        // without having to load it from memory. So, I stored the minimal constant I could,
-        // 128-bits worth of 1s :). Then I use sequences of shifts to squash it to the appropriate
-        // size and bitpositions that I need.
-        const __m128i allFFs128 = _mm_cmpeq_epi32(_mm_setzero_si128(), _mm_setzero_si128());
-
         // Load 128 bits, i.e. two DXTBlocks (64-bits each)
         const __m128i dxt = _mm_loadu_si128((__m128i*)(src + sizeof(struct DXTBlock) * 2 * xStep));
 
@@ -1192,144 +1782,8 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
         u32 dxt0sel = dxttmp[1];
         u32 dxt1sel = dxttmp[3];
 
-        __m128i argb888x4;
-        __m128i c1 = _mm_unpackhi_epi16(dxt, dxt);
-        c1 = _mm_slli_si128(c1, 8);
-        const __m128i c0 =
-            _mm_or_si128(c1, _mm_srli_si128(_mm_slli_si128(_mm_unpacklo_epi16(dxt, dxt), 8), 8));
-
-        // Compare rgb0 to rgb1:
-        // Each 32-bit word will contain either 0xFFFFFFFF or 0x00000000 for true/false.
-        const __m128i c0cmp = _mm_srli_epi32(_mm_slli_epi32(_mm_srli_epi64(c0, 8), 16), 16);
-        const __m128i c0shr = _mm_srli_epi64(c0cmp, 32);
-        const __m128i cmprgb0rgb1 = _mm_cmpgt_epi32(c0cmp, c0shr);
-
-        int cmp0 = _mm_extract_epi16(cmprgb0rgb1, 0);
-        int cmp1 = _mm_extract_epi16(cmprgb0rgb1, 4);
-
-        // green:
-        // NOTE: We start with the larger number of bits (6) firts for G and shift the mask down
-        // 1 bit to get a 5-bit mask later for R and B components.
-        // low6mask == _mm_set_epi32(0x0000FC00, 0x0000FC00, 0x0000FC00, 0x0000FC00)
-        const __m128i low6mask = _mm_slli_epi32(_mm_srli_epi32(allFFs128, 24 + 2), 8 + 2);
-        const __m128i gtmp = _mm_srli_epi32(c0, 3);
-        const __m128i g0 = _mm_and_si128(gtmp, low6mask);
-        // low3mask == _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300)
-        const __m128i g1 = _mm_and_si128(
-            _mm_srli_epi32(gtmp, 6), _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300));
-        argb888x4 = _mm_or_si128(g0, g1);
-        // red:
-        // low5mask == _mm_set_epi32(0x000000F8, 0x000000F8, 0x000000F8, 0x000000F8)
-        const __m128i low5mask = _mm_slli_epi32(_mm_srli_epi32(low6mask, 8 + 3), 3);
-        const __m128i r0 = _mm_and_si128(c0, low5mask);
-        const __m128i r1 = _mm_srli_epi32(r0, 5);
-        argb888x4 = _mm_or_si128(argb888x4, _mm_or_si128(r0, r1));
-        // blue:
-        // _mm_slli_epi32(low5mask, 16) == _mm_set_epi32(0x00F80000, 0x00F80000, 0x00F80000,
-        // 0x00F80000)
-        const __m128i b0 = _mm_and_si128(_mm_srli_epi32(c0, 5), _mm_slli_epi32(low5mask, 16));
-        const __m128i b1 = _mm_srli_epi16(b0, 5);
-        // OR in the fixed alpha component
-        // _mm_slli_epi32( allFFs128, 24 ) == _mm_set_epi32(0xFF000000, 0xFF000000, 0xFF000000,
-        // 0xFF000000)
-        argb888x4 = _mm_or_si128(_mm_or_si128(argb888x4, _mm_slli_epi32(allFFs128, 24)),
-                                 _mm_or_si128(b0, b1));
-        // calculate RGB2 and RGB3:
-        const __m128i rgb0 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(2, 2, 0, 0));
-        const __m128i rgb1 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(3, 3, 1, 1));
-        const __m128i rrggbb0 =
-            _mm_and_si128(_mm_unpacklo_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
-        const __m128i rrggbb1 =
-            _mm_and_si128(_mm_unpacklo_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
-        const __m128i rrggbb01 =
-            _mm_and_si128(_mm_unpackhi_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
-        const __m128i rrggbb11 =
-            _mm_and_si128(_mm_unpackhi_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
-
-        __m128i rgb2, rgb3;
-
-        // if (rgb0 > rgb1):
-        if (cmp0 != 0)
-        {
-          // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
-          // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
-          const __m128i rrggbbsum = _mm_add_epi16(rrggbb0, rrggbb1);
-
-          const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb0, 1);
-          const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb0, 2);
-
-          const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb1, 1);
-          const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb1, 2);
-
-          const __m128i rrggbb2 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
-          const __m128i rrggbb3 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
-
-          const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
-          const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
-
-          rgb2 = _mm_and_si128(rgb2dup, _mm_srli_si128(allFFs128, 8));
-          rgb3 = _mm_and_si128(rgb3dup, _mm_srli_si128(allFFs128, 8));
-        }
-        else
-        {
-          // RGB2b = avg(RGB0, RGB1)
-          const __m128i rrggbb21 = _mm_srai_epi16(_mm_add_epi16(rrggbb0, rrggbb1), 1);
-          const __m128i rgb210 = _mm_srli_si128(_mm_packus_epi16(rrggbb21, rrggbb21), 8);
-          rgb2 = rgb210;
-          rgb3 = _mm_and_si128(rgb210, _mm_srli_epi32(allFFs128, 8));
-        }
-
-        // if (rgb0 > rgb1):
-        if (cmp1 != 0)
-        {
-          // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
-          // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
-          const __m128i rrggbbsum = _mm_add_epi16(rrggbb01, rrggbb11);
-
-          const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb01, 1);
-          const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb01, 2);
-
-          const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb11, 1);
-          const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb11, 2);
-
-          const __m128i rrggbb2 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
-          const __m128i rrggbb3 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
-
-          const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
-          const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
-
-          rgb2 = _mm_or_si128(rgb2, _mm_and_si128(rgb2dup, _mm_slli_si128(allFFs128, 8)));
-          rgb3 = _mm_or_si128(rgb3, _mm_and_si128(rgb3dup, _mm_slli_si128(allFFs128, 8)));
-        }
-        else
-        {
-          // RGB2b = avg(RGB0, RGB1)
-          const __m128i rrggbb211 = _mm_srai_epi16(_mm_add_epi16(rrggbb01, rrggbb11), 1);
-          const __m128i rgb211 = _mm_slli_si128(_mm_packus_epi16(rrggbb211, rrggbb211), 8);
-          rgb2 = _mm_or_si128(rgb2, rgb211);
-
-          // _mm_srli_epi32( allFFs128, 8 ) == _mm_set_epi32(0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF,
-          // 0x00FFFFFF)
-          // Make this color fully transparent:
-          rgb3 = _mm_or_si128(rgb3, _mm_and_si128(_mm_and_si128(rgb2, _mm_srli_epi32(allFFs128, 8)),
-                                                  _mm_slli_si128(allFFs128, 8)));
-        }
-
-        // Create an array for color lookups for DXT0 so we can use the 2-bit indices:
-        const __m128i mmcolors0 = _mm_or_si128(
-            _mm_or_si128(_mm_srli_si128(_mm_slli_si128(argb888x4, 8), 8),
-                         _mm_slli_si128(_mm_srli_si128(_mm_slli_si128(rgb2, 8), 8 + 4), 8)),
-            _mm_slli_si128(_mm_srli_si128(rgb3, 4), 8 + 4));
-
-        // Create an array for color lookups for DXT1 so we can use the 2-bit indices:
-        const __m128i mmcolors1 =
-            _mm_or_si128(_mm_or_si128(_mm_srli_si128(argb888x4, 8),
-                                      _mm_slli_si128(_mm_srli_si128(rgb2, 8 + 4), 8)),
-                         _mm_slli_si128(_mm_srli_si128(rgb3, 8 + 4), 8 + 4));
+        __m128i mmcolors0, mmcolors1;
+        DecodeCMPRColors(dxt, &mmcolors0, &mmcolors1);
 
 // The #ifdef CHECKs here and below are to compare correctness of output against the reference code.
 // Don't use them in a normal build.
@@ -1418,11 +1872,18 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
   switch (texformat)
   {
   case TextureFormat::C4:
-    TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::I4:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_I4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_I4_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1430,7 +1891,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::I8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_I8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_I8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1438,15 +1902,27 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C8:
-    TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::IA4:
-    TexDecoder_DecodeImpl_IA4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_IA4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else
+      TexDecoder_DecodeImpl_IA4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                Wsteps8);
     break;
 
   case TextureFormat::IA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_IA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_IA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                       Wsteps8);
     else
@@ -1455,17 +1931,28 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C14X2:
-    TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C14X2_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                  Wsteps8);
     break;
 
   case TextureFormat::RGB565:
-    TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                 Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB565_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else
+      TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                   Wsteps8);
     break;
 
   case TextureFormat::RGB5A3:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB5A3_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGB5A3_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                          Wsteps8);
     else
@@ -1474,7 +1961,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGBA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGBA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGBA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                         Wsteps8);
     else
@@ -1483,7 +1973,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::CMPR:
-    TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_CMPR_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                      Wsteps8);
+    else
+      TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                 Wsteps8);
     break;
 
   case TextureFormat::XFB:
@@ -0,0 +1,267 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/TexturePack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+#include <xxhash.h>
+
+#include "Common/Align.h"
+#include "Common/Logging/Log.h"
+#include "VideoCommon/AbstractTexture.h"
+
+namespace TexturePackFormat
+{
+u64 GetNameHash(std::string_view name)
+{
+  return XXH64(name.data(), name.size(), 0);
+}
+}  // namespace TexturePackFormat
+
+TexturePack::TexturePack(Common::MappedFile file, std::string filename)
+    : m_file(std::move(file)), m_filename(std::move(filename))
+{
+}
+
+std::unique_ptr<TexturePack> TexturePack::Open(const std::string& filename)
+{
+  Common::MappedFile file(filename);
+  if (!file)
+    return nullptr;
+
+  // Can't use make_unique due to private constructor.
+  std::unique_ptr<TexturePack> pack(new TexturePack(std::move(file), filename));
+  if (!pack->Validate())
+  {
+    ERROR_LOG(VIDEO, "Texture pack %s is invalid", filename.c_str());
+    return nullptr;
+  }
+
+  return pack;
+}
+
+bool TexturePack::Validate()
+{
+  using TexturePackFormat::Entry;
+  using TexturePackFormat::Header;
+  using PackedLevel = TexturePackFormat::Level;
+
+  // Far larger than any backend supports, and small enough for the sizes not to overflow.
+  constexpr u32 MAX_DIMENSION = 1 << 16;
+
+  const u8* const data = m_file.GetData();
+  const u64 size = m_file.GetSize();
+  const auto in_file = [size](u64 offset, u64 length) {
+    return offset <= size && length <= size - offset;
+  };
+
+  if (size < sizeof(Header))
+    return false;
+
+  std::memcpy(&m_header, data, sizeof(Header));
+  if (m_header.magic != TexturePackFormat::MAGIC || m_header.version != TexturePackFormat::VERSION)
+    return false;
+
+  if (!in_file(m_header.entries_offset, u64(m_header.num_entries) * sizeof(Entry)) ||
+      !in_file(m_header.levels_offset, u64(m_header.num_levels) * sizeof(PackedLevel)) ||
+      !in_file(m_header.names_offset, m_header.names_size))
+  {
+    return false;
+  }
+
+  // The tables are accessed in place, so they have to be aligned.
+  if (m_header.entries_offset % alignof(u64) != 0 || m_header.levels_offset % alignof(u64) != 0)
+    return false;
+
+  m_entries = reinterpret_cast<const Entry*>(data + m_header.entries_offset);
+  m_levels = reinterpret_cast<const PackedLevel*>(data + m_header.levels_offset);
+  m_names = reinterpret_cast<const char*>(data + m_header.names_offset);
+
+  for (u32 i = 0; i < m_header.num_entries; i++)
+  {
+    const Entry& entry = m_entries[i];
+    if (u64(entry.name_offset) + entry.name_length > m_header.names_size ||
+        entry.num_levels == 0 || u64(entry.first_level) + entry.num_levels > m_header.num_levels ||
+        entry.format >= static_cast<u8>(AbstractTextureFormat::Undefined))
+    {
+      return false;
+    }
+
+    // Find relies on the entries being sorted.
+    if (i != 0 && std::make_tuple(m_entries[i - 1].name_hash, GetName(i - 1)) >=
+                      std::make_tuple(entry.name_hash, GetName(i)))
+    {
+      return false;
+    }
+
+    // The levels are uploaded straight from the file, so they must hold as much data as the
+    // backend is going to read for their size.
+    const auto format = static_cast<AbstractTextureFormat>(entry.format);
+    const u32 block_size = AbstractTexture::GetBlockSizeForFormat(format);
+    for (u32 j = 0; j < entry.num_levels; j++)
+    {
+      const PackedLevel& level = m_levels[entry.first_level + j];
+      if (level.width == 0 || level.height == 0 || level.row_length < level.width ||
+          level.row_length > MAX_DIMENSION || level.height > MAX_DIMENSION)
+      {
+        return false;
+      }
+
+      const u64 num_rows = (u64(level.height) + block_size - 1) / block_size;
+      const u64 stride = AbstractTexture::CalculateStrideForFormat(format, level.row_length);
+      if (level.data_size < stride * num_rows)
+        return false;
+    }
+  }
+
+  for (u32 i = 0; i < m_header.num_levels; i++)
+  {
+    if (!in_file(m_levels[i].data_offset, m_levels[i].data_size))
+      return false;
+  }
+
+  return true;
+}
+
+std::string_view TexturePack::GetName(u32 index) const
+{
+  const TexturePackFormat::Entry& entry = m_entries[index];
+  return std::string_view(m_names + entry.name_offset, entry.name_length);
+}
+
+std::optional<u32> TexturePack::Find(std::string_view name) const
+{
+  const u64 hash = TexturePackFormat::GetNameHash(name);
+  const TexturePackFormat::Entry* const end = m_entries + m_header.num_entries;
+  const TexturePackFormat::Entry* it =
+      std::lower_bound(m_entries, end, hash, [](const TexturePackFormat::Entry& entry, u64 value) {
+        return entry.name_hash < value;
+      });
+
+  for (; it != end && it->name_hash == hash; ++it)
+  {
+    const u32 index = static_cast<u32>(it - m_entries);
+    if (GetName(index) == name)
+      return index;
+  }
+
+  return std::nullopt;
+}
+
+TexturePack::Texture TexturePack::GetTexture(u32 index) const
+{
+  const TexturePackFormat::Entry& entry = m_entries[index];
+
+  Texture texture;
+  texture.format = static_cast<AbstractTextureFormat>(entry.format);
+  texture.has_arbitrary_mipmaps = (entry.flags & TexturePackFormat::FLAG_ARBITRARY_MIPMAPS) != 0;
+  texture.levels.reserve(entry.num_levels);
+  for (u32 i = 0; i < entry.num_levels; i++)
+  {
+    const TexturePackFormat::Level& level = m_levels[entry.first_level + i];
+    texture.levels.push_back({m_file.GetData() + level.data_offset,
+                              static_cast<size_t>(level.data_size), level.width, level.height,
+                              level.row_length});
+  }
+
+  return texture;
+}
+
+bool TexturePackWriter::Open(const std::string& filename)
+{
+  m_entries.clear();
+  m_levels.clear();
+
+  // The header is written by Finish, once the position of the index is known.
+  const TexturePackFormat::Header header{};
+  return m_file.Open(filename, "wb") && m_file.WriteBytes(&header, sizeof(header));
+}
+
+bool TexturePackWriter::AddTexture(std::string_view name, const TexturePack::Texture& texture)
+{
+  using namespace TexturePackFormat;
+
+  if (texture.levels.empty() || texture.levels.size() > 0xff)
+    return false;
+
+  PendingEntry pending;
+  pending.name = name;
+  pending.entry = {};
+  pending.entry.name_hash = GetNameHash(name);
+  pending.entry.first_level = static_cast<u32>(m_levels.size());
+  pending.entry.num_levels = static_cast<u8>(texture.levels.size());
+  pending.entry.format = static_cast<u8>(texture.format);
+  pending.entry.flags = texture.has_arbitrary_mipmaps ? FLAG_ARBITRARY_MIPMAPS : 0;
+
+  static constexpr u8 zeroes[DATA_ALIGNMENT] = {};
+  for (const TexturePack::Level& level : texture.levels)
+  {
+    const u64 offset = m_file.Tell();
+    const u64 aligned_offset = Common::AlignUp(offset, DATA_ALIGNMENT);
+    if (!m_file.WriteBytes(zeroes, aligned_offset - offset) ||
+        !m_file.WriteBytes(level.data, level.size))
+    {
+      return false;
+    }
+
+    m_levels.push_back(
+        {aligned_offset, level.size, level.width, level.height, level.row_length, 0});
+  }
+
+  m_entries.push_back(std::move(pending));
+  return true;
+}
+
+bool TexturePackWriter::Finish()
+{
+  using namespace TexturePackFormat;
+
+  std::sort(m_entries.begin(), m_entries.end(), [](const PendingEntry& a, const PendingEntry& b) {
+    return std::tie(a.entry.name_hash, a.name) < std::tie(b.entry.name_hash, b.name);
+  });
+
+  std::string names;
+  std::vector<Entry> entries;
+  entries.reserve(m_entries.size());
+  for (PendingEntry& pending : m_entries)
+  {
+    pending.entry.name_offset = static_cast<u32>(names.size());
+    pending.entry.name_length = static_cast<u32>(pending.name.size());
+    names += pending.name;
+    entries.push_back(pending.entry);
+  }
+
+  for (size_t i = 1; i < entries.size(); i++)
+  {
+    if (entries[i - 1].name_hash == entries[i].name_hash &&
+        m_entries[i - 1].name == m_entries[i].name)
+    {
+      ERROR_LOG(VIDEO, "Texture %s was added to the texture pack twice", m_entries[i].name.c_str());
+      return false;
+    }
+  }
+
+  Header header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.num_entries = static_cast<u32>(entries.size());
+  header.num_levels = static_cast<u32>(m_levels.size());
+
+  static constexpr u8 zeroes[alignof(u64)] = {};
+  const u64 end = m_file.Tell();
+  header.entries_offset = Common::AlignUp(end, alignof(u64));
+  header.levels_offset = header.entries_offset + entries.size() * sizeof(Entry);
+  header.names_offset = header.levels_offset + m_levels.size() * sizeof(Level);
+  header.names_size = names.size();
+
+  return m_file.WriteBytes(zeroes, header.entries_offset - end) &&
+         m_file.WriteArray(entries.data(), entries.size()) &&
+         m_file.WriteArray(m_levels.data(), m_levels.size()) &&
+         m_file.WriteBytes(names.data(), names.size()) && m_file.Seek(0, SEEK_SET) &&
+         m_file.WriteBytes(&header, sizeof(header)) && m_file.Close();
+}
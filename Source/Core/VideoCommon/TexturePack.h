@@ -0,0 +1,143 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/MappedFile.h"
+#include "VideoCommon/TextureConfig.h"
+
+// A texture pack stores custom textures in a single file, as an alternative to a directory with a
+// PNG or DDS file per texture and mip level. The textures are stored in the format they are
+// uploaded in, and the index is sorted by the hash of the texture names, so the file can be
+// memory-mapped and textures can be looked up and uploaded without parsing or copying anything.
+//
+// The file starts with a Header, followed by the texture data. The index is at the end of the file:
+// an array of Entry sorted by (name_hash, name), an array of Level and the texture names.
+// All values are little-endian.
+namespace TexturePackFormat
+{
+constexpr u32 MAGIC = 0x50545844;  // "DXTP"
+constexpr u32 VERSION = 1;
+// Texture data is aligned to this, for uploads which have alignment requirements.
+constexpr u64 DATA_ALIGNMENT = 64;
+
+enum EntryFlags : u8
+{
+  FLAG_ARBITRARY_MIPMAPS = 1 << 0,
+};
+
+#pragma pack(push, 1)
+struct Header
+{
+  u32 magic;
+  u32 version;
+  u32 num_entries;
+  u32 num_levels;
+  u64 entries_offset;
+  u64 levels_offset;
+  u64 names_offset;
+  u64 names_size;
+};
+static_assert(sizeof(Header) == 48);
+
+struct Entry
+{
+  u64 name_hash;
+  u32 name_offset;
+  u32 name_length;
+  u32 first_level;
+  u8 num_levels;
+  u8 format;
+  u8 flags;
+  u8 padding;
+};
+static_assert(sizeof(Entry) == 24);
+
+struct Level
+{
+  u64 data_offset;
+  u64 data_size;
+  u32 width;
+  u32 height;
+  u32 row_length;
+  u32 padding;
+};
+static_assert(sizeof(Level) == 32);
+#pragma pack(pop)
+
+u64 GetNameHash(std::string_view name);
+}  // namespace TexturePackFormat
+
+class TexturePack
+{
+public:
+  struct Level
+  {
+    const u8* data;
+    size_t size;
+    u32 width;
+    u32 height;
+    u32 row_length;
+  };
+
+  struct Texture
+  {
+    AbstractTextureFormat format;
+    bool has_arbitrary_mipmaps;
+    std::vector<Level> levels;
+  };
+
+  // Returns nullptr if the file doesn't exist or isn't a valid texture pack.
+  static std::unique_ptr<TexturePack> Open(const std::string& filename);
+
+  const std::string& GetFilename() const { return m_filename; }
+  u32 GetNumTextures() const { return m_header.num_entries; }
+  std::string_view GetName(u32 index) const;
+
+  bool Contains(std::string_view name) const { return Find(name).has_value(); }
+  std::optional<u32> Find(std::string_view name) const;
+  // The level data points into the pack, so it's only valid while the pack is open.
+  Texture GetTexture(u32 index) const;
+
+private:
+  explicit TexturePack(Common::MappedFile file, std::string filename);
+  bool Validate();
+
+  Common::MappedFile m_file;
+  std::string m_filename;
+  TexturePackFormat::Header m_header{};
+  const TexturePackFormat::Entry* m_entries = nullptr;
+  const TexturePackFormat::Level* m_levels = nullptr;
+  const char* m_names = nullptr;
+};
+
+// Writes a texture pack. Texture data is written out as textures are added, so that converting a
+// big pack doesn't need to keep all of it in memory.
+class TexturePackWriter
+{
+public:
+  bool Open(const std::string& filename);
+  bool AddTexture(std::string_view name, const TexturePack::Texture& texture);
+  // Writes the index. The pack is incomplete and can't be opened if this isn't called.
+  bool Finish();
+
+private:
+  struct PendingEntry
+  {
+    std::string name;
+    TexturePackFormat::Entry entry;
+  };
+
+  File::IOFile m_file;
+  std::vector<PendingEntry> m_entries;
+  std::vector<TexturePackFormat::Level> m_levels;
+};
@@ -5,6 +5,7 @@
 #include "VideoCommon/VertexLoaderManager.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -18,6 +19,7 @@
 #include "Core/HW/Memmap.h"
 
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/IndexGenerator.h"
@@ -249,7 +251,19 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
   return loader;
 }
 
-int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess)
+static bool CanCacheVertices(TVtxDesc vtx_desc)
+{
+  // Indexed attributes are read from the vertex arrays, which aren't part of the source data.
+  for (int i = 0; i < 12; i++)
+  {
+    if (vtx_desc.GetVertexArrayStatus(i) >= 2)
+      return false;
+  }
+  return true;
+}
+
+int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess,
+                CachedVertices* cached)
 {
   if (!count)
     return 0;
@@ -281,7 +295,41 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   DataReader dst = g_vertex_manager->PrepareForAdditionalData(
       primitive, count, loader->m_native_vtx_decl.stride, cullall);
 
-  count = loader->RunVertices(src, dst, count);
+  // The loaders only update the zfreeze caches for the last three vertices.
+  const int num_cached_positions = std::min(count, 3);
+
+  if (cached && cached->loader == loader && cached->input_count == count)
+  {
+    std::memcpy(dst.GetPointer(), cached->data.data(), cached->data.size());
+    for (int i = 0; i < num_cached_positions; i++)
+    {
+      std::copy(cached->position_cache[i].begin(), cached->position_cache[i].end(),
+                position_cache[i]);
+      position_matrix_index[i + 1] = cached->position_matrix_index[i];
+    }
+    loader->m_numLoadedVertices += count;
+    count = cached->output_count;
+  }
+  else
+  {
+    const int input_count = count;
+    count = loader->RunVertices(src, dst, count);
+
+    if (cached && CanCacheVertices(g_main_cp_state.vtx_desc))
+    {
+      cached->loader = loader;
+      cached->input_count = input_count;
+      cached->output_count = count;
+      cached->data.assign(dst.GetPointer(),
+                          dst.GetPointer() + count * loader->m_native_vtx_decl.stride);
+      for (int i = 0; i < num_cached_positions; i++)
+      {
+        std::copy(std::begin(position_cache[i]), std::end(position_cache[i]),
+                  cached->position_cache[i].begin());
+        cached->position_matrix_index[i] = position_matrix_index[i + 1];
+      }
+    }
+  }
 
   g_vertex_manager->AddIndices(primitive, count);
   g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
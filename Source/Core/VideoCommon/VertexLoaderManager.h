@@ -4,14 +4,17 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
 class DataReader;
 class NativeVertexFormat;
+class VertexLoaderBase;
 struct PortableVertexDeclaration;
 
 namespace VertexLoaderManager
@@ -34,8 +37,27 @@ NativeVertexFormat* GetOrCreateMatchingFormat(const PortableVertexDeclaration& d
 // offsets set to the unused attributes.
 NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl);
 
-// Returns -1 if buf_size is insufficient, else the amount of bytes consumed
-int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess);
+// The converted vertices of one draw, kept so that drawing the same vertices with the same vertex
+// format again doesn't have to run the vertex loader.
+struct CachedVertices
+{
+  // Set by the caller, which is responsible for the source data being the same.
+  u32 source_offset = 0;
+
+  VertexLoaderBase* loader = nullptr;
+  int input_count = 0;
+  int output_count = 0;
+  std::array<std::array<float, 4>, 3> position_cache{};
+  std::array<u32, 3> position_matrix_index{};
+  std::vector<u8> data;
+};
+
+// Returns -1 if buf_size is insufficient, else the amount of bytes consumed.
+// If cached is set, the vertices are copied from it when it holds the output of the same loader,
+// and it is filled in otherwise (unless the vertices use indexed attributes, which depend on
+// memory outside of src).
+int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess,
+                CachedVertices* cached = nullptr);
 
 // For debugging
 std::string VertexLoadersToString();
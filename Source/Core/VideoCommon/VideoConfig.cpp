@@ -89,6 +89,8 @@ void VideoConfig::Refresh()
   bDumpBaseTextures = Config::Get(Config::GFX_DUMP_BASE_TEXTURES);
   bHiresTextures = Config::Get(Config::GFX_HIRES_TEXTURES);
   bCacheHiresTextures = Config::Get(Config::GFX_CACHE_HIRES_TEXTURES);
+  bStreamHiresTextures = Config::Get(Config::GFX_STREAM_HIRES_TEXTURES);
+  iHiresTextureCacheSize = Config::Get(Config::GFX_HIRES_TEXTURE_CACHE_SIZE);
   bDumpEFBTarget = Config::Get(Config::GFX_DUMP_EFB_TARGET);
   bDumpXFBTarget = Config::Get(Config::GFX_DUMP_XFB_TARGET);
   bDumpFramesAsImages = Config::Get(Config::GFX_DUMP_FRAMES_AS_IMAGES);
@@ -101,6 +103,9 @@ void VideoConfig::Refresh()
   sDumpPath = Config::Get(Config::GFX_DUMP_PATH);
   iBitrateKbps = Config::Get(Config::GFX_BITRATE_KBPS);
   bInternalResolutionFrameDumps = Config::Get(Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS);
+  iDumpQueueSize = Config::Get(Config::GFX_DUMP_QUEUE_SIZE);
+  bDumpDropFrames = Config::Get(Config::GFX_DUMP_DROP_FRAMES);
+  bDumpDuplicateFrames = Config::Get(Config::GFX_DUMP_DUPLICATE_FRAMES);
   bEnableGPUTextureDecoding = Config::Get(Config::GFX_ENABLE_GPU_TEXTURE_DECODING);
   bEnablePixelLighting = Config::Get(Config::GFX_ENABLE_PIXEL_LIGHTING);
   bFastDepthCalc = Config::Get(Config::GFX_FAST_DEPTH_CALC);
@@ -128,6 +133,7 @@ void VideoConfig::Refresh()
   bDumpTevTextureFetches = Config::Get(Config::GFX_SW_DUMP_TEV_TEX_FETCHES);
   drawStart = Config::Get(Config::GFX_SW_DRAW_START);
   drawEnd = Config::Get(Config::GFX_SW_DRAW_END);
+  iSWRasterizerThreads = Config::Get(Config::GFX_SW_RASTERIZER_THREADS);
 
   bForceFiltering = Config::Get(Config::GFX_ENHANCE_FORCE_FILTERING);
   iMaxAnisotropy = Config::Get(Config::GFX_ENHANCE_MAX_ANISOTROPY);
@@ -225,3 +231,12 @@ u32 VideoConfig::GetShaderPrecompilerThreads() const
   else
     return GetNumAutoShaderCompilerThreads();
 }
+
+u32 VideoConfig::GetSWRasterizerThreads() const
+{
+  if (iSWRasterizerThreads >= 0)
+    return static_cast<u32>(iSWRasterizerThreads);
+
+  // Automatic number. The GPU thread rasterizes too, and the CPU thread needs a core of its own.
+  return static_cast<u32>(std::max(cpu_info.num_cores - 2, 0));
+}
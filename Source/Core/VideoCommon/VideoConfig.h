@@ -106,6 +106,8 @@ struct VideoConfig final
   bool bDumpBaseTextures;
   bool bHiresTextures;
   bool bCacheHiresTextures;
+  bool bStreamHiresTextures;
+  int iHiresTextureCacheSize;  // in MiB
   bool bDumpEFBTarget;
   bool bDumpXFBTarget;
   bool bDumpFramesAsImages;
@@ -115,6 +117,9 @@ struct VideoConfig final
   std::string sDumpFormat;
   std::string sDumpPath;
   bool bInternalResolutionFrameDumps;
+  int iDumpQueueSize;  // in frames
+  bool bDumpDropFrames;
+  bool bDumpDuplicateFrames;
   bool bFreeLook;
   FreelookControlType iFreelookControlType;
   bool bBorderlessFullscreen;
@@ -157,6 +162,9 @@ struct VideoConfig final
   // D3D only config, mostly to be merged into the above
   int iAdapter;
 
+  // VideoSW
+  int iSWRasterizerThreads;
+
   // VideoSW Debugging
   int drawStart;
   int drawEnd;
@@ -250,6 +258,7 @@ struct VideoConfig final
   bool UsingUberShaders() const;
   u32 GetShaderCompilerThreads() const;
   u32 GetShaderPrecompilerThreads() const;
+  u32 GetSWRasterizerThreads() const;
 };
 
 extern VideoConfig g_Config;
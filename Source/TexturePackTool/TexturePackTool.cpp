@@ -0,0 +1,60 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/HiresTextures.h"
+#include "VideoCommon/TexturePack.h"
+
+// Converts a directory of custom textures into a texture pack, which Dolphin loads instead of the
+// directory if it's named <game ID>.texpack and placed in the Load/Textures directory.
+int main(int argc, const char* argv[])
+{
+  if (argc != 3)
+  {
+    printf("USAGE: TexturePackTool <TEXTURE DIRECTORY> <OUTPUT FILE>\n");
+    printf("Converts the PNG and DDS textures in a directory into a texture pack.\n");
+    printf("Name the output file <game ID>.texpack to use it, e.g. GALE01.texpack.\n");
+    return 0;
+  }
+
+  const std::string directory = argv[1];
+  const std::string output_name = argv[2];
+  if (!File::IsDirectory(directory))
+  {
+    printf("ERROR: %s is not a directory.\n", directory.c_str());
+    return 1;
+  }
+
+  const bool success = HiresTexture::ConvertToTexturePack(
+      directory, output_name, [](size_t done, size_t total) {
+        // Writing a line per texture would slow down converting small textures considerably.
+        if (done % 100 != 0 && done != total)
+          return;
+
+        printf("\r%zu/%zu textures", done, total);
+        fflush(stdout);
+      });
+  printf("\n");
+
+  if (!success)
+  {
+    printf("ERROR: Failed to write %s.\n", output_name.c_str());
+    return 1;
+  }
+
+  const std::unique_ptr<TexturePack> pack = TexturePack::Open(output_name);
+  if (!pack)
+  {
+    printf("ERROR: %s could not be read back.\n", output_name.c_str());
+    return 1;
+  }
+
+  printf("Wrote %u textures to %s.\n", pack->GetNumTextures(), output_name.c_str());
+  return 0;
+}
@@ -0,0 +1,56 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <mbedtls/sha1.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+
+TEST(SHA1, KnownDigests)
+{
+  const std::string abc = "abc";
+  EXPECT_EQ(Common::SHA1::CalculateDigest(reinterpret_cast<const u8*>(abc.data()), abc.size()),
+            (Common::SHA1::Digest{0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e,
+                                  0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d}));
+
+  EXPECT_EQ(Common::SHA1::CalculateDigest(nullptr, 0),
+            (Common::SHA1::Digest{0xda, 0x39, 0xa3, 0xee, 0x5e, 0x6b, 0x4b, 0x0d, 0x32, 0x55,
+                                  0xbf, 0xef, 0x95, 0x60, 0x18, 0x90, 0xaf, 0xd8, 0x07, 0x09}));
+}
+
+TEST(SHA1, MatchesMbedtls)
+{
+  std::vector<u8> data(0x1000);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<u8>(i * 7 + i / 256);
+
+  // Every size around the block boundaries, where the padding takes one or two blocks
+  for (size_t size = 1; size < data.size(); size += size < 200 ? 1 : 61)
+  {
+    Common::SHA1::Digest expected;
+    mbedtls_sha1_ret(data.data(), size, expected.data());
+    EXPECT_EQ(Common::SHA1::CalculateDigest(data.data(), size), expected) << size;
+  }
+}
+
+TEST(SHA1, ContextMatchesOneShot)
+{
+  std::vector<u8> data(0x1000);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<u8>(i * 5 + i / 256);
+
+  // Updates of varying sizes, so that the buffered partial blocks are exercised
+  Common::SHA1::Context context;
+  size_t offset = 0;
+  for (size_t size = 1; offset + size <= data.size(); offset += size, size = size * 3 % 199 + 1)
+    context.Update(data.data() + offset, size);
+  context.Update(data.data() + offset, data.size() - offset);
+
+  EXPECT_EQ(context.Finish(), Common::SHA1::CalculateDigest(data.data(), data.size()));
+}
@@ -0,0 +1,159 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FlatHashMultimap.h"
+
+TEST(FlatHashMultimap, InsertFindErase)
+{
+  Common::FlatHashMultimap<int> map;
+  EXPECT_TRUE(map.Empty());
+  EXPECT_TRUE(map.FindIf(1, [](int) { return true; }) == nullptr);
+  EXPECT_FALSE(map.Erase(1, 1));
+
+  map.Insert(1, 10);
+  map.Insert(1, 11);
+  map.Insert(2, 20);
+  EXPECT_EQ(map.Size(), 3u);
+  EXPECT_EQ(map.Count(1), 2u);
+  EXPECT_EQ(map.Count(2), 1u);
+  EXPECT_EQ(map.Count(3), 0u);
+
+  const int* value = map.FindIf(1, [](int v) { return v == 11; });
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(*value, 11);
+  EXPECT_TRUE(map.FindIf(2, [](int v) { return v == 11; }) == nullptr);
+
+  EXPECT_FALSE(map.Erase(2, 21));
+  EXPECT_TRUE(map.Erase(1, 10));
+  EXPECT_EQ(map.Count(1), 1u);
+  EXPECT_EQ(map.Size(), 2u);
+
+  map.Clear();
+  EXPECT_TRUE(map.Empty());
+  EXPECT_EQ(map.Count(2), 0u);
+}
+
+// Compares against std::multimap with many colliding keys, so that erasing has to move elements
+// in long probe sequences back.
+TEST(FlatHashMultimap, MatchesMultimap)
+{
+  std::mt19937_64 rng(0);
+  Common::FlatHashMultimap<u32> map;
+  std::multimap<u64, u32> reference;
+
+  for (u32 i = 0; i < 100000; i++)
+  {
+    const u64 key = rng() % 512;
+    if (rng() % 3 == 0 && !reference.empty())
+    {
+      auto it = reference.lower_bound(key);
+      if (it == reference.end())
+        it = reference.begin();
+      EXPECT_TRUE(map.Erase(it->first, it->second));
+      reference.erase(it);
+    }
+    else
+    {
+      map.Insert(key, i);
+      reference.emplace(key, i);
+    }
+  }
+
+  EXPECT_EQ(map.Size(), reference.size());
+  for (u64 key = 0; key < 512; key++)
+    EXPECT_EQ(map.Count(key), reference.count(key)) << "key " << key;
+
+  std::vector<std::pair<u64, u32>> elements;
+  map.ForEach([&elements](u64 key, u32 value) { elements.emplace_back(key, value); });
+  std::sort(elements.begin(), elements.end());
+  std::vector<std::pair<u64, u32>> expected(reference.begin(), reference.end());
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(elements, expected);
+}
+
+// Models the texture cache's hash index: lookups of texture hashes with a few thousand live
+// textures, while textures keep being replaced. Disabled by default; run it with
+// --gtest_also_run_disabled_tests.
+TEST(FlatHashMultimap, DISABLED_Benchmark)
+{
+  constexpr u32 NUM_TEXTURES = 4096;
+  constexpr u32 NUM_OPERATIONS = 1000000;
+
+  std::mt19937_64 rng(0);
+  std::vector<u64> hashes(NUM_TEXTURES);
+  for (u64& hash : hashes)
+    hash = rng();
+
+  const auto measure = [&](const char* name, auto insert, auto find, auto erase) {
+    std::mt19937 op_rng(1);
+    for (u32 i = 0; i < NUM_TEXTURES; i++)
+      insert(hashes[i], i);
+
+    u64 found = 0;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (u32 i = 0; i < NUM_OPERATIONS; i++)
+    {
+      const u32 index = op_rng() % NUM_TEXTURES;
+      if (i % 16 == 0)
+      {
+        // A texture gets replaced by one with a different hash.
+        erase(hashes[index], index);
+        hashes[index] = hashes[index] * 0x9E3779B97F4A7C15 + 1;
+        insert(hashes[index], index);
+      }
+      else
+      {
+        found += find(hashes[index], index);
+      }
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    EXPECT_EQ(found, NUM_OPERATIONS - NUM_OPERATIONS / 16);
+    printf("%-16s %u operations in %lld us\n", name, NUM_OPERATIONS,
+           static_cast<long long>(
+               std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()));
+  };
+
+  {
+    Common::FlatHashMultimap<u32> map;
+    measure(
+        "FlatHashMultimap", [&](u64 key, u32 value) { map.Insert(key, value); },
+        [&](u64 key, u32 value) {
+          return map.FindIf(key, [value](u32 v) { return v == value; }) != nullptr;
+        },
+        [&](u64 key, u32 value) { map.Erase(key, value); });
+  }
+
+  {
+    std::multimap<u64, u32> map;
+    measure(
+        "std::multimap", [&](u64 key, u32 value) { map.emplace(key, value); },
+        [&](u64 key, u32 value) {
+          const auto range = map.equal_range(key);
+          return std::any_of(range.first, range.second,
+                             [value](const auto& it) { return it.second == value; });
+        },
+        [&](u64 key, u32 value) {
+          const auto range = map.equal_range(key);
+          for (auto it = range.first; it != range.second; ++it)
+          {
+            if (it->second == value)
+            {
+              map.erase(it);
+              break;
+            }
+          }
+        });
+  }
+}
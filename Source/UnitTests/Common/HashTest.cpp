@@ -0,0 +1,101 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <xxhash.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+
+#include "../TestData.h"
+
+// The SIMD versions must give the same results as the generic version, which these were
+// generated with.
+TEST(Hash, WideHashKnownValues)
+{
+  const std::vector<u8> data = GetTestData(5000);
+
+  EXPECT_EQ(Common::GetWideHash64(data.data(), 0, 0), 0x4a7f4210d3ba77cfu);
+  EXPECT_EQ(Common::GetWideHash64(data.data(), 3, 0), 0xdb366c7fee2c01d4u);
+  EXPECT_EQ(Common::GetWideHash64(data.data(), 64, 0), 0x589b25d36274ab75u);
+  EXPECT_EQ(Common::GetWideHash64(data.data(), 1000, 0), 0x683eff7f1bad7876u);
+  EXPECT_EQ(Common::GetWideHash64(data.data(), 5000, 0), 0x951e4d2a31698312u);
+  EXPECT_EQ(Common::GetWideHash64(data.data(), 5000, 128), 0xab0c735f5035dc19u);
+
+  const Common::Hash128 hash = Common::GetWideHash128(data.data(), 5000, 0);
+  EXPECT_EQ(hash.low, Common::GetWideHash64(data.data(), 5000, 0));
+  EXPECT_EQ(hash.high, 0x2bc287f8e37f2693u);
+}
+
+TEST(Hash, WideHashDependsOnEveryByte)
+{
+  std::vector<u8> data = GetTestData(2048 + 17);
+  const u32 size = static_cast<u32>(data.size());
+  const u64 original = Common::GetWideHash64(data.data(), size, 0);
+
+  for (size_t i = 0; i < data.size(); i++)
+  {
+    data[i] ^= 1;
+    EXPECT_NE(Common::GetWideHash64(data.data(), size, 0), original) << "byte " << i;
+    data[i] ^= 1;
+  }
+
+  // Trailing zeroes must change the hash as well.
+  std::vector<u8> zeroes(128);
+  EXPECT_NE(Common::GetWideHash64(zeroes.data(), 100, 0),
+            Common::GetWideHash64(zeroes.data(), 101, 0));
+}
+
+TEST(Hash, WideHashSampling)
+{
+  std::vector<u8> data = GetTestData(64 * 1024);
+  const u32 size = static_cast<u32>(data.size());
+  const u64 sampled = Common::GetWideHash64(data.data(), size, 512);
+  EXPECT_NE(sampled, Common::GetWideHash64(data.data(), size, 0));
+
+  // 512 words are 64 stripes, so only every 16th stripe is hashed.
+  data[64] ^= 1;
+  EXPECT_EQ(Common::GetWideHash64(data.data(), size, 512), sampled);
+  data[16 * 64] ^= 1;
+  EXPECT_NE(Common::GetWideHash64(data.data(), size, 512), sampled);
+}
+
+// Compares the throughput of the hashes on texture sized inputs. Disabled by default; run it with
+// --gtest_also_run_disabled_tests.
+TEST(Hash, DISABLED_Benchmark)
+{
+  Common::SetHash64Function();
+
+  for (u32 size : {2u * 1024, 32u * 1024, 512u * 1024, 4u * 1024 * 1024})
+  {
+    const std::vector<u8> data = GetTestData(size);
+    const u32 iterations = std::max(64u * 1024 * 1024 / size, 1u);
+
+    const auto measure = [&](const char* name, auto hash) {
+      u64 result = 0;
+      const auto start = std::chrono::high_resolution_clock::now();
+      for (u32 i = 0; i < iterations; i++)
+        result += hash(data.data(), size);
+      const auto end = std::chrono::high_resolution_clock::now();
+
+      const double seconds = std::chrono::duration<double>(end - start).count();
+      printf("%-14s %8u bytes: %8.2f GB/s (%016llx)\n", name, size,
+             static_cast<double>(size) * iterations / seconds / 1e9,
+             static_cast<unsigned long long>(result));
+    };
+
+    measure("GetHash64", [](const u8* src, u32 len) { return Common::GetHash64(src, len, 0); });
+    measure("GetWideHash64",
+            [](const u8* src, u32 len) { return Common::GetWideHash64(src, len, 0); });
+    measure("GetWideHash128",
+            [](const u8* src, u32 len) { return Common::GetWideHash128(src, len, 0).high; });
+    measure("XXH64", [](const u8* src, u32 len) { return u64{XXH64(src, len, 0)}; });
+  }
+}
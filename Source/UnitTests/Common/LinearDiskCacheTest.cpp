@@ -0,0 +1,188 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/LinearDiskCache.h"
+
+namespace
+{
+class Reader final : public LinearDiskCacheReader<u32, u8>
+{
+public:
+  void Read(const u32& key, const u8* value, u32 value_size) override
+  {
+    keys.push_back(key);
+    values[key] = std::vector<u8>(value, value + value_size);
+  }
+
+  std::vector<u32> keys;
+  std::map<u32, std::vector<u8>> values;
+};
+
+std::vector<u8> GetValue(u32 key, u32 version = 0)
+{
+  const u32 size = key % 100;
+  std::vector<u8> value;
+  value.reserve(size);
+  for (u32 i = 0; i < size; i++)
+    value.push_back(static_cast<u8>(key + version * 7 + i));
+  return value;
+}
+}  // namespace
+
+class LinearDiskCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = File::CreateTempDir();
+    m_filename = m_directory + "/test.cache";
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_directory); }
+
+  void AppendValues(LinearDiskCache<u32, u8>& cache, u32 first, u32 count, u32 version = 0)
+  {
+    for (u32 key = first; key < first + count; key++)
+    {
+      const std::vector<u8> value = GetValue(key, version);
+      cache.Append(key, value.data(), static_cast<u32>(value.size()));
+    }
+  }
+
+  std::string m_directory;
+  std::string m_filename;
+};
+
+TEST_F(LinearDiskCacheTest, RoundTrip)
+{
+  {
+    LinearDiskCache<u32, u8> cache;
+    EXPECT_EQ(cache.Open(m_filename), 0u);
+    AppendValues(cache, 1, 1000);
+    EXPECT_TRUE(cache.Contains(1000));
+  }
+  EXPECT_TRUE(File::Exists(m_filename + ".index"));
+
+  LinearDiskCache<u32, u8> cache;
+  EXPECT_EQ(cache.Open(m_filename), 1000u);
+  EXPECT_FALSE(cache.Contains(0));
+  std::vector<u8> value;
+  EXPECT_FALSE(cache.Get(1001, &value));
+  for (u32 key = 1; key <= 1000; key++)
+  {
+    ASSERT_TRUE(cache.Get(key, &value)) << key;
+    EXPECT_EQ(value, GetValue(key)) << key;
+  }
+
+  u32 num_keys = 0;
+  cache.ForEachKey([&num_keys](const u32&) { num_keys++; });
+  EXPECT_EQ(num_keys, 1000u);
+
+  // Values are read in the order they were appended.
+  Reader reader;
+  EXPECT_EQ(cache.OpenAndRead(m_filename, reader), 1000u);
+  for (u32 i = 0; i < 1000; i++)
+    EXPECT_EQ(reader.keys[i], i + 1);
+}
+
+TEST_F(LinearDiskCacheTest, ReplacesAndCompacts)
+{
+  {
+    LinearDiskCache<u32, u8> cache;
+    cache.Open(m_filename);
+    AppendValues(cache, 1, 100);
+    for (u32 version = 1; version <= 6; version++)
+      AppendValues(cache, 1, 50, version);
+  }
+  const u64 size = File::GetSize(m_filename);
+
+  // Half of the keys were replaced six times, so most of the file is stale.
+  LinearDiskCache<u32, u8> cache;
+  Reader reader;
+  EXPECT_EQ(cache.OpenAndRead(m_filename, reader), 100u);
+  EXPECT_LT(File::GetSize(m_filename), size / 2);
+  for (u32 key = 1; key <= 100; key++)
+    EXPECT_EQ(reader.values[key], GetValue(key, key <= 50 ? 6 : 0)) << key;
+
+  // The compacted file can be appended to.
+  AppendValues(cache, 101, 10);
+  cache.Close();
+  EXPECT_EQ(cache.Open(m_filename), 110u);
+  std::vector<u8> value;
+  ASSERT_TRUE(cache.Get(110, &value));
+  EXPECT_EQ(value, GetValue(110));
+}
+
+TEST_F(LinearDiskCacheTest, RecoversFromStaleIndex)
+{
+  {
+    LinearDiskCache<u32, u8> cache;
+    cache.Open(m_filename);
+    AppendValues(cache, 1, 100);
+  }
+  std::string old_index;
+  ASSERT_TRUE(File::ReadFileToString(m_filename + ".index", old_index));
+  {
+    LinearDiskCache<u32, u8> cache;
+    EXPECT_EQ(cache.Open(m_filename), 100u);
+    AppendValues(cache, 101, 100);
+  }
+
+  // As if Dolphin had crashed before writing the new index, and in the middle of an append.
+  ASSERT_TRUE(File::WriteStringToFile(m_filename + ".index", old_index));
+  {
+    File::IOFile file(m_filename, "r+b");
+    ASSERT_TRUE(file.Resize(file.GetSize() - 1));
+  }
+
+  LinearDiskCache<u32, u8> cache;
+  EXPECT_EQ(cache.Open(m_filename), 199u);
+  EXPECT_FALSE(cache.Contains(200));
+  std::vector<u8> value;
+  ASSERT_TRUE(cache.Get(199, &value));
+  EXPECT_EQ(value, GetValue(199));
+
+  // The partial entry is overwritten.
+  AppendValues(cache, 200, 1);
+  cache.Close();
+  EXPECT_EQ(cache.Open(m_filename), 200u);
+
+  // An index which doesn't match the cache is ignored.
+  cache.Close();
+  File::Delete(m_filename);
+  cache.Open(m_filename);
+  AppendValues(cache, 1, 10);
+  cache.Sync();
+  ASSERT_TRUE(File::WriteStringToFile(m_filename + ".index", old_index));
+  LinearDiskCache<u32, u8> other_cache;
+  EXPECT_EQ(other_cache.Open(m_filename), 10u);
+}
+
+TEST_F(LinearDiskCacheTest, Erase)
+{
+  LinearDiskCache<u32, u8> cache;
+  cache.Open(m_filename);
+  AppendValues(cache, 1, 10);
+  cache.Erase(5);
+  EXPECT_FALSE(cache.Contains(5));
+  cache.Close();
+  EXPECT_EQ(cache.Open(m_filename), 9u);
+
+  // Appending the key again brings it back.
+  AppendValues(cache, 5, 1, 1);
+  cache.Close();
+  EXPECT_EQ(cache.Open(m_filename), 10u);
+  std::vector<u8> value;
+  ASSERT_TRUE(cache.Get(5, &value));
+  EXPECT_EQ(value, GetValue(5, 1));
+}
@@ -0,0 +1,57 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/ThreadPool.h"
+
+TEST(ThreadPool, RunsEveryTaskOnce)
+{
+  for (u32 num_workers : {0u, 1u, 4u})
+  {
+    Common::ThreadPool pool(num_workers, "Test");
+    EXPECT_EQ(pool.GetNumThreads(), num_workers + 1);
+
+    for (size_t count : {0u, 1u, 7u, 1000u})
+    {
+      std::vector<std::atomic<u32>> calls(count);
+      pool.ParallelFor(count, [&calls](size_t i) { calls[i]++; });
+      for (size_t i = 0; i < count; i++)
+        EXPECT_EQ(calls[i], 1u) << "task " << i << " of " << count;
+    }
+  }
+}
+
+TEST(ThreadPool, ManyRounds)
+{
+  Common::ThreadPool pool(3, "Test");
+  std::atomic<u64> sum{0};
+  for (u32 round = 0; round < 10000; round++)
+    pool.ParallelFor(4, [&sum](size_t i) { sum += i + 1; });
+  EXPECT_EQ(sum, 10000u * 10);
+}
+
+TEST(ThreadPool, ConcurrentCallers)
+{
+  Common::ThreadPool pool(2, "Test");
+  std::atomic<u64> sum{0};
+
+  std::vector<std::thread> callers;
+  for (u32 caller = 0; caller < 4; caller++)
+  {
+    callers.emplace_back([&pool, &sum] {
+      for (u32 round = 0; round < 1000; round++)
+        pool.ParallelFor(16, [&sum](size_t) { sum++; });
+    });
+  }
+  for (std::thread& caller : callers)
+    caller.join();
+
+  EXPECT_EQ(sum, 4u * 1000 * 16);
+}
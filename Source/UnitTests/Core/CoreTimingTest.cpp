@@ -347,3 +347,144 @@ TEST(CoreTiming, Overclocking)
   SConfig::GetInstance().m_OCFactor = 1.0;
   AdvanceAndCheck(4, MAX_SLICE_LENGTH);
 }
+
+TEST(CoreTiming, CascadeFromOuterLevels)
+{
+  ScopeInit guard;
+
+  CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CallbackTemplate<0>);
+  CoreTiming::EventType* cb_b = CoreTiming::RegisterEvent("callbackB", CallbackTemplate<1>);
+  CoreTiming::EventType* cb_c = CoreTiming::RegisterEvent("callbackC", CallbackTemplate<2>);
+  CoreTiming::EventType* cb_d = CoreTiming::RegisterEvent("callbackD", CallbackTemplate<3>);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  // Every level covers 64 times the cycles of the one below it, so these start out in the second
+  // and third level and have to be moved down before they can run.
+  CoreTiming::ScheduleEvent(4200, cb_a, CB_IDS[0]);
+  CoreTiming::ScheduleEvent(70, cb_b, CB_IDS[1]);
+  CoreTiming::ScheduleEvent(4100, cb_c, CB_IDS[2]);
+  CoreTiming::ScheduleEvent(4201, cb_d, CB_IDS[3]);
+  EXPECT_EQ(70, PowerPC::ppcState.downcount);
+
+  AdvanceAndCheck(1, 4030);  // 4100 - 70
+  AdvanceAndCheck(2, 100);   // 4200 - 4100
+  AdvanceAndCheck(0, 1);     // 4201 - 4200
+  AdvanceAndCheck(3, MAX_SLICE_LENGTH);
+}
+
+TEST(CoreTiming, FarFutureEvent)
+{
+  ScopeInit guard;
+
+  CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CallbackTemplate<0>);
+  CoreTiming::EventType* cb_b = CoreTiming::RegisterEvent("callbackB", CallbackTemplate<1>);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  // Goes into the top level, which covers the remaining bits of the timer.
+  constexpr s64 FAR_FUTURE = INT64_C(1) << 62;
+  CoreTiming::ScheduleEvent(FAR_FUTURE, cb_b, CB_IDS[1]);
+  CoreTiming::ScheduleEvent(100, cb_a, CB_IDS[0]);
+  EXPECT_EQ(100, PowerPC::ppcState.downcount);
+
+  AdvanceAndCheck(0, MAX_SLICE_LENGTH);
+
+  // Skip ahead to the slice before the event instead of running through all the ones in between.
+  CoreTiming::g.global_timer = FAR_FUTURE - 500;
+  AdvanceAndCheck(1, MAX_SLICE_LENGTH, MAX_SLICE_LENGTH - 500);
+}
+
+TEST(CoreTiming, ScheduleIntoPassedSlot)
+{
+  ScopeInit guard;
+
+  CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CallbackTemplate<0>);
+  CoreTiming::EventType* cb_b = CoreTiming::RegisterEvent("callbackB", CallbackTemplate<1>);
+  CoreTiming::EventType* cb_c = CoreTiming::RegisterEvent("callbackC", CallbackTemplate<2>);
+  CoreTiming::EventType* cb_d = CoreTiming::RegisterEvent("callbackD", CallbackTemplate<3>);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  CoreTiming::ScheduleEvent(40, cb_a, CB_IDS[0]);
+  AdvanceAndCheck(0, MAX_SLICE_LENGTH);
+
+  // The lowest level is now at slot 40 of 64. Cycle 70 maps to slot 6 of it, which was already
+  // passed, and cycle 4101 wraps around the second level as well, so both have to wait in higher
+  // levels until the wheel gets there.
+  CoreTiming::ScheduleEvent(30, cb_b, CB_IDS[1]);
+  CoreTiming::ScheduleEvent(10, cb_c, CB_IDS[2]);
+  CoreTiming::ScheduleEvent(4061, cb_d, CB_IDS[3]);
+  EXPECT_EQ(10, PowerPC::ppcState.downcount);
+
+  AdvanceAndCheck(2, 20);    // 70 - 50
+  AdvanceAndCheck(1, 4031);  // 4101 - 70
+  AdvanceAndCheck(3, MAX_SLICE_LENGTH);
+}
+
+namespace MixedLoadBenchmark
+{
+constexpr int NUM_PERIODIC_EVENTS = 16;
+constexpr int NUM_IDLE_EVENTS = 2000;
+constexpr int NUM_SLICES = 200000;
+
+static std::array<CoreTiming::EventType*, NUM_PERIODIC_EVENTS> s_periodic_events;
+static u64 s_callbacks;
+
+static void PeriodicCallback(u64 userdata, s64 lateness)
+{
+  s_callbacks++;
+  const s64 period = 500 + static_cast<s64>(userdata) * 1733;
+  CoreTiming::ScheduleEvent(period - lateness, s_periodic_events[userdata], userdata);
+}
+
+static void IdleCallback(u64 userdata, s64 lateness)
+{
+  s_callbacks++;
+}
+}  // namespace MixedLoadBenchmark
+
+// Measures the cost of the event queue with a load similar to what the emulated hardware
+// generates: periodic events that reschedule themselves from their callbacks, an event that keeps
+// getting removed and scheduled again, and a large number of events that are far in the future.
+// Disabled by default; run it with --gtest_also_run_disabled_tests.
+TEST(CoreTiming, DISABLED_MixedLoadBenchmark)
+{
+  using namespace MixedLoadBenchmark;
+
+  ScopeInit guard;
+
+  for (int i = 0; i < NUM_PERIODIC_EVENTS; i++)
+  {
+    s_periodic_events[i] =
+        CoreTiming::RegisterEvent("periodic" + std::to_string(i), PeriodicCallback);
+  }
+  CoreTiming::EventType* idle_event = CoreTiming::RegisterEvent("idle", IdleCallback);
+  CoreTiming::EventType* rescheduled_event =
+      CoreTiming::RegisterEvent("rescheduled", IdleCallback);
+
+  // Enter slice 0
+  CoreTiming::Advance();
+
+  for (int i = 0; i < NUM_PERIODIC_EVENTS; i++)
+    CoreTiming::ScheduleEvent(i * 100, s_periodic_events[i], i);
+  for (int i = 0; i < NUM_IDLE_EVENTS; i++)
+    CoreTiming::ScheduleEvent(INT64_C(1) << 40 | i, idle_event, i);
+
+  s_callbacks = 0;
+  for (int slice = 0; slice < NUM_SLICES; slice++)
+  {
+    // Like the SI polling or DVD interrupts, which get cancelled and scheduled again.
+    CoreTiming::RemoveEvent(rescheduled_event);
+    CoreTiming::ScheduleEvent(3 * MAX_SLICE_LENGTH, rescheduled_event, slice);
+
+    PowerPC::ppcState.downcount = 0;  // Pretend the whole slice was executed
+    CoreTiming::Advance();
+  }
+
+  // Only the periodic events run, and every slice ends with one of them.
+  EXPECT_GE(s_callbacks, static_cast<u64>(NUM_SLICES));
+}
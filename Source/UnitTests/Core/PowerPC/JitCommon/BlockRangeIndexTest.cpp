@@ -0,0 +1,135 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+
+namespace
+{
+void SetRange(JitBlock* block, u32 address, u32 num_instructions)
+{
+  block->physicalAddress = address;
+  block->physical_addresses.clear();
+  for (u32 i = 0; i < num_instructions; i++)
+    block->physical_addresses.insert(address + i * 4);
+}
+
+std::vector<JitBlock*> Find(const BlockRangeIndex& index, u32 address, u32 length)
+{
+  std::vector<JitBlock*> blocks;
+  index.FindOverlappingBlocks(address, length, &blocks);
+  std::sort(blocks.begin(), blocks.end());
+  return blocks;
+}
+}  // namespace
+
+TEST(BlockRangeIndex, FindsOverlappingBlocks)
+{
+  BlockRangeIndex index;
+  std::vector<JitBlock> blocks(3);
+  SetRange(&blocks[0], 0x80000000, 4);   // 0x80000000 - 0x8000000F
+  SetRange(&blocks[1], 0x800000F8, 16);  // Spans two granules
+  SetRange(&blocks[2], 0x80003000, 1);   // Different page
+  for (JitBlock& block : blocks)
+    index.Add(block);
+
+  EXPECT_EQ(Find(index, 0x80000000, 4), std::vector<JitBlock*>{&blocks[0]});
+  EXPECT_TRUE(Find(index, 0x80000010, 0xE8).empty());
+  EXPECT_EQ(Find(index, 0x80000120, 0x20), std::vector<JitBlock*>{&blocks[1]});
+
+  // Found once even though it is in two granules.
+  std::vector<JitBlock*> expected{&blocks[0], &blocks[1]};
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(Find(index, 0x80000000, 0x1000), expected);
+
+  expected.push_back(&blocks[2]);
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(Find(index, 0x80000000, 0x10000), expected);
+  EXPECT_EQ(Find(index, 0x80003000, 4), std::vector<JitBlock*>{&blocks[2]});
+
+  // Ranges which wrap around the end of the address space must not go out of bounds.
+  EXPECT_TRUE(Find(index, 0xFFFFFF00, 0x1000).empty());
+}
+
+TEST(BlockRangeIndex, RemoveAndClear)
+{
+  BlockRangeIndex index;
+  std::vector<JitBlock> blocks(2);
+  SetRange(&blocks[0], 0x00001000, 0x100);
+  SetRange(&blocks[1], 0x00001200, 0x10);
+  index.Add(blocks[0]);
+  index.Add(blocks[1]);
+
+  index.Remove(blocks[0]);
+  EXPECT_TRUE(Find(index, 0x00001000, 0x100).empty());
+  EXPECT_EQ(Find(index, 0x00001000, 0x400), std::vector<JitBlock*>{&blocks[1]});
+
+  // Removed nodes get reused.
+  index.Add(blocks[0]);
+  EXPECT_EQ(Find(index, 0x00001000, 4), std::vector<JitBlock*>{&blocks[0]});
+
+  index.Clear();
+  EXPECT_TRUE(Find(index, 0, 0xFFFFFFFF).empty());
+}
+
+// Simulates a game streaming code overlays into memory: a large number of blocks is compiled, and
+// then parts of them get invalidated by icbi (32 bytes) and by DMA of new overlays (64 KiB), after
+// which the overlay's blocks get compiled again. Disabled by default; run it with
+// --gtest_also_run_disabled_tests.
+TEST(BlockRangeIndex, DISABLED_InvalidationBenchmark)
+{
+  constexpr u32 RAM_SIZE = 0x01800000;
+  constexpr int NUM_INVALIDATIONS = 20000;
+
+  for (u32 num_blocks : {1000u, 10000u, 100000u})
+  {
+    std::mt19937 rng(num_blocks);
+    std::vector<JitBlock> blocks(num_blocks);
+    const u32 spacing = (RAM_SIZE / num_blocks) & ~3u;
+    for (u32 i = 0; i < num_blocks; i++)
+      SetRange(&blocks[i], i * spacing, std::min<u32>(spacing / 4, 4 + rng() % 60));
+
+    BlockRangeIndex index;
+    std::vector<JitBlock*> found;
+    u64 blocks_found = 0;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (JitBlock& block : blocks)
+      index.Add(block);
+
+    for (int i = 0; i < NUM_INVALIDATIONS; i++)
+    {
+      const bool is_dma = i % 16 == 0;
+      const u32 length = is_dma ? 0x10000 : 32;
+      const u32 address = static_cast<u32>(rng() % RAM_SIZE) & ~(length - 1);
+
+      found.clear();
+      index.FindOverlappingBlocks(address, length, &found);
+      blocks_found += found.size();
+      for (JitBlock* block : found)
+        index.Remove(*block);
+      for (JitBlock* block : found)
+        index.Add(*block);
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    EXPECT_GT(blocks_found, 0u);
+
+    const u64 elapsed_ns = static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    printf("BlockRangeIndex: %u blocks, %d invalidations (%llu blocks) in %llu us "
+           "(%llu ns per invalidation)\n",
+           num_blocks, NUM_INVALIDATIONS, static_cast<unsigned long long>(blocks_found),
+           static_cast<unsigned long long>(elapsed_ns / 1000),
+           static_cast<unsigned long long>(elapsed_ns / NUM_INVALIDATIONS));
+  }
+}
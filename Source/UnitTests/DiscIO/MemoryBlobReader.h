@@ -0,0 +1,58 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "DiscIO/Blob.h"
+
+// A plain disc image in memory. Its data can also be read as the decrypted data of a partition,
+// which makes it usable as the source for encrypting Wii groups.
+class MemoryBlobReader final : public DiscIO::BlobReader
+{
+public:
+  explicit MemoryBlobReader(std::vector<u8> data) : m_data(std::move(data)) {}
+
+  DiscIO::BlobType GetBlobType() const override { return DiscIO::BlobType::PLAIN; }
+  u64 GetRawSize() const override { return m_data.size(); }
+  u64 GetDataSize() const override { return m_data.size(); }
+  bool IsDataSizeAccurate() const override { return true; }
+  u64 GetBlockSize() const override { return 0; }
+  bool HasFastRandomAccessInBlock() const override { return true; }
+  std::string GetCompressionMethod() const override { return {}; }
+
+  bool Read(u64 offset, u64 size, u8* out_ptr) override
+  {
+    if (offset + size > m_data.size())
+      return false;
+    std::copy_n(m_data.begin() + offset, size, out_ptr);
+    return true;
+  }
+
+  bool SupportsReadWiiDecrypted(u64 offset, u64 size, u64 partition_data_offset) const override
+  {
+    return m_decrypted;
+  }
+
+  bool ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr, u64 partition_data_offset) override
+  {
+    if (!m_decrypted)
+      return false;
+    m_decrypted_reads++;
+    return Read(offset, size, out_ptr);
+  }
+
+  void SetDecrypted(bool decrypted) { m_decrypted = decrypted; }
+  u64 GetDecryptedReads() const { return m_decrypted_reads; }
+
+private:
+  std::vector<u8> m_data;
+  bool m_decrypted = false;
+  u64 m_decrypted_reads = 0;
+};
@@ -0,0 +1,141 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/Swap.h"
+#include "Core/IOS/ES/Formats.h"
+#include "Core/IOS/IOSC.h"
+#include "DiscIO/Volume.h"
+#include "DiscIO/VolumeWii.h"
+
+#include "../TestData.h"
+#include "MemoryBlobReader.h"
+
+using DiscIO::VolumeWii;
+
+namespace
+{
+constexpr u64 PARTITION_OFFSET = 0x50000;
+constexpr u64 H3_TABLE_OFFSET = 0x8000;  // Relative to the partition
+constexpr u64 DATA_OFFSET = 0x20000;     // Relative to the partition
+constexpr u64 DATA_OFFSET_ON_DISC = PARTITION_OFFSET + DATA_OFFSET;
+}  // namespace
+
+// An encrypted disc with a single partition, which contains one group.
+class VolumeWiiTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_disc.resize(DATA_OFFSET_ON_DISC + VolumeWii::GROUP_TOTAL_SIZE);
+    m_data = GetTestData(VolumeWii::GROUP_DATA_SIZE);
+
+    // The partition table
+    Write32(0x40000, 1);
+    Write32(0x40004, 0x40020 >> 2);
+    Write32(0x40020, PARTITION_OFFSET >> 2);
+    Write32(0x40024, 0);
+
+    IOS::ES::Ticket ticket{};
+    ticket.signature.type = static_cast<IOS::SignatureType>(
+        Common::swap32(static_cast<u32>(IOS::SignatureType::RSA2048)));
+    ticket.title_id = Common::swap64(0x0001000052534245);
+    std::fill(std::begin(ticket.title_key), std::end(ticket.title_key), 0x5a);
+    std::memcpy(m_disc.data() + PARTITION_OFFSET, &ticket, sizeof(ticket));
+    const std::vector<u8> ticket_bytes(m_disc.data() + PARTITION_OFFSET,
+                                       m_disc.data() + PARTITION_OFFSET + sizeof(ticket));
+    const std::array<u8, VolumeWii::AES_KEY_SIZE> key =
+        IOS::ES::TicketReader(ticket_bytes).GetTitleKey();
+
+    Write32(PARTITION_OFFSET + 0x2b4, H3_TABLE_OFFSET >> 2);
+    Write32(PARTITION_OFFSET + 0x2b8, DATA_OFFSET >> 2);
+    Write32(PARTITION_OFFSET + 0x2bc, VolumeWii::GROUP_TOTAL_SIZE >> 2);
+
+    MemoryBlobReader decrypted(m_data);
+    decrypted.SetDecrypted(true);
+    auto group = std::make_unique<std::array<u8, VolumeWii::GROUP_TOTAL_SIZE>>();
+    ASSERT_TRUE(VolumeWii::EncryptGroup(
+        0, DATA_OFFSET_ON_DISC, m_data.size(), key, &decrypted, group.get(),
+        [this](VolumeWii::HashBlock hash_blocks[VolumeWii::BLOCKS_PER_GROUP]) {
+          Common::SHA1::CalculateDigest(reinterpret_cast<const u8*>(hash_blocks[0].h2),
+                                        sizeof(hash_blocks[0].h2),
+                                        m_disc.data() + PARTITION_OFFSET + H3_TABLE_OFFSET);
+        }));
+    std::copy(group->begin(), group->end(), m_disc.begin() + DATA_OFFSET_ON_DISC);
+  }
+
+  void Write32(u64 offset, u32 value)
+  {
+    const u32 swapped = Common::swap32(value);
+    std::memcpy(m_disc.data() + offset, &swapped, sizeof(swapped));
+  }
+
+  std::unique_ptr<VolumeWii> CreateVolume() const
+  {
+    return std::make_unique<VolumeWii>(std::make_unique<MemoryBlobReader>(m_disc));
+  }
+
+  const u8* GetEncryptedBlock(u64 block_index) const
+  {
+    return m_disc.data() + DATA_OFFSET_ON_DISC + block_index * VolumeWii::BLOCK_TOTAL_SIZE;
+  }
+
+  std::vector<u8> m_disc;
+  std::vector<u8> m_data;
+};
+
+TEST_F(VolumeWiiTest, ReadDecryptsSpansOfBlocks)
+{
+  const std::unique_ptr<VolumeWii> volume = CreateVolume();
+  const DiscIO::Partition partition = volume->GetGamePartition();
+  ASSERT_EQ(PARTITION_OFFSET, partition.offset);
+
+  // The whole group, spans which start or end inside blocks, and part of a single block.
+  const std::array<std::pair<u64, u64>, 4> reads = {{{0, VolumeWii::GROUP_DATA_SIZE},
+                                                     {0x1234, VolumeWii::BLOCK_DATA_SIZE * 5},
+                                                     {VolumeWii::BLOCK_DATA_SIZE * 7, 0x100},
+                                                     {VolumeWii::BLOCK_DATA_SIZE * 2, 0x10000}}};
+  for (const auto& [offset, size] : reads)
+  {
+    std::vector<u8> buffer(size);
+    ASSERT_TRUE(volume->Read(offset, size, buffer.data(), partition));
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_data.begin() + offset))
+        << "offset " << offset << ", size " << size;
+  }
+}
+
+TEST_F(VolumeWiiTest, CheckBlocksInParallelWithoutReadingFirst)
+{
+  // Blobs which support ReadWiiDecrypted, like WIA and RVZ, never make Read load the key, so
+  // the blocks may be the first thing that gets checked.
+  const std::unique_ptr<VolumeWii> volume = CreateVolume();
+  const DiscIO::Partition partition = volume->GetGamePartition();
+  volume->PrepareBlockIntegrityCheck(partition);
+
+  std::vector<u8> corrupt_block(GetEncryptedBlock(5), GetEncryptedBlock(6));
+  corrupt_block[VolumeWii::BLOCK_HEADER_SIZE + 0x100] ^= 1;
+
+  std::array<u8, VolumeWii::BLOCKS_PER_GROUP> results{};
+  VolumeWii::ProcessBlocksInParallel(results.size(), [&](size_t i) {
+    const u8* block = i == 5 ? corrupt_block.data() : GetEncryptedBlock(i);
+    results[i] = volume->CheckBlockIntegrity(i, block, partition);
+  });
+
+  for (size_t i = 0; i < results.size(); ++i)
+    EXPECT_EQ(i != 5, results[i] != 0) << "block " << i;
+
+  // Reading the blocks from the disc gives the same result.
+  EXPECT_TRUE(volume->CheckBlockIntegrity(0, partition));
+  EXPECT_TRUE(volume->CheckBlockIntegrity(VolumeWii::BLOCKS_PER_GROUP - 1, partition));
+}
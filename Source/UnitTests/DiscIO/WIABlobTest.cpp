@@ -0,0 +1,167 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/VolumeWii.h"
+#include "DiscIO/WIABlob.h"
+#include "DiscIO/WiiEncryptionCache.h"
+
+#include "../TestData.h"
+#include "MemoryBlobReader.h"
+
+namespace
+{
+constexpr u64 CHUNK_SIZE = 0x20000;
+constexpr u64 NUM_CHUNKS = 6;
+}  // namespace
+
+class WIABlobTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = File::CreateTempDir();
+    m_data = GetTestData(CHUNK_SIZE * NUM_CHUNKS);
+
+    const std::string path = m_directory + "/test.rvz";
+    {
+      MemoryBlobReader infile(m_data);
+      File::IOFile outfile(path, "wb");
+      const DiscIO::ConversionResultCode result = DiscIO::RVZFileReader::Convert(
+          &infile, nullptr, &outfile, DiscIO::WIARVZCompressionType::Zstd, 1, CHUNK_SIZE,
+          [](const std::string&, float) { return true; });
+      ASSERT_TRUE(result == DiscIO::ConversionResultCode::Success);
+    }
+
+    m_reader = DiscIO::RVZFileReader::Create(File::IOFile(path, "rb"), path);
+    ASSERT_TRUE(m_reader);
+
+    // Opening the file reads its tables through the chunk cache.
+    m_initial_statistics = m_reader->GetCacheStatistics();
+  }
+
+  void TearDown() override
+  {
+    m_reader.reset();
+    File::DeleteDirRecursively(m_directory);
+  }
+
+  void ReadChunk(u64 chunk)
+  {
+    // Skip the start of the data, which is stored in the header.
+    const u64 offset = chunk * CHUNK_SIZE + 0x100;
+    std::vector<u8> buffer(0x100);
+    ASSERT_TRUE(m_reader->Read(offset, buffer.size(), buffer.data()));
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_data.begin() + offset));
+  }
+
+  u64 GetChunkHits() const
+  {
+    return m_reader->GetCacheStatistics().chunk_hits - m_initial_statistics.chunk_hits;
+  }
+
+  u64 GetChunkMisses() const
+  {
+    return m_reader->GetCacheStatistics().chunk_misses - m_initial_statistics.chunk_misses;
+  }
+
+  std::string m_directory;
+  std::vector<u8> m_data;
+  std::unique_ptr<DiscIO::RVZFileReader> m_reader;
+  DiscIO::RVZFileReader::CacheStatistics m_initial_statistics;
+};
+
+TEST_F(WIABlobTest, ChunkCacheEvictsLeastRecentlyUsed)
+{
+  m_reader->SetCacheCapacity(CHUNK_SIZE * 2, 1);
+
+  ReadChunk(0);
+  ReadChunk(1);
+  ReadChunk(0);  // Hit
+  ReadChunk(2);  // Evicts chunk 1
+  ReadChunk(0);  // Hit
+  ReadChunk(1);  // Evicts chunk 2
+
+  EXPECT_EQ(2u, GetChunkHits());
+  EXPECT_EQ(4u, GetChunkMisses());
+}
+
+TEST_F(WIABlobTest, ChunkCacheHoldsAtLeastTwoChunks)
+{
+  m_reader->SetCacheCapacity(0, 1);
+
+  ReadChunk(0);
+  ReadChunk(1);
+  ReadChunk(0);  // Hit
+  ReadChunk(1);  // Hit
+
+  EXPECT_EQ(2u, GetChunkHits());
+  EXPECT_EQ(2u, GetChunkMisses());
+}
+
+TEST_F(WIABlobTest, ShrinkingChunkCacheKeepsMostRecentlyUsed)
+{
+  m_reader->SetCacheCapacity(CHUNK_SIZE * 4, 1);
+  for (u64 chunk = 0; chunk < 4; chunk++)
+    ReadChunk(chunk);
+
+  m_reader->SetCacheCapacity(CHUNK_SIZE * 2, 1);
+  ReadChunk(3);  // Hit
+  ReadChunk(2);  // Hit
+  ReadChunk(1);  // Was evicted
+
+  EXPECT_EQ(2u, GetChunkHits());
+  EXPECT_EQ(5u, GetChunkMisses());
+}
+
+TEST(WiiEncryptionCache, EvictsLeastRecentlyUsedGroup)
+{
+  constexpr u64 GROUP_DATA_SIZE = DiscIO::VolumeWii::GROUP_DATA_SIZE;
+  constexpr u64 GROUP_TOTAL_SIZE = DiscIO::VolumeWii::GROUP_TOTAL_SIZE;
+  constexpr u64 BLOCKS_PER_GROUP = DiscIO::VolumeWii::BLOCKS_PER_GROUP;
+
+  MemoryBlobReader blob(GetTestData(GROUP_DATA_SIZE * 3));
+  blob.SetDecrypted(true);
+  DiscIO::WiiEncryptionCache cache(&blob);
+  cache.SetCapacity(2);
+  EXPECT_EQ(2u, cache.GetCapacity());
+
+  const DiscIO::WiiEncryptionCache::Key key = {1, 2, 3, 4};
+  const auto encrypt = [&](u64 group) {
+    return cache.EncryptGroup(group * GROUP_TOTAL_SIZE, 0, GROUP_DATA_SIZE * 3, key);
+  };
+
+  const auto* group_0 = encrypt(0);
+  ASSERT_NE(nullptr, group_0);
+  const std::vector<u8> encrypted_group_0(group_0->begin(), group_0->end());
+  ASSERT_NE(nullptr, encrypt(1));
+  EXPECT_EQ(BLOCKS_PER_GROUP * 2, blob.GetDecryptedReads());
+
+  // A hit doesn't read from the blob again, and returns the same data.
+  group_0 = encrypt(0);
+  ASSERT_NE(nullptr, group_0);
+  EXPECT_TRUE(std::equal(group_0->begin(), group_0->end(), encrypted_group_0.begin()));
+  EXPECT_EQ(BLOCKS_PER_GROUP * 2, blob.GetDecryptedReads());
+
+  // Group 1 is the least recently used one, so it gets evicted.
+  ASSERT_NE(nullptr, encrypt(2));
+  ASSERT_NE(nullptr, encrypt(0));
+  ASSERT_NE(nullptr, encrypt(1));
+  EXPECT_EQ(BLOCKS_PER_GROUP * 4, blob.GetDecryptedReads());
+
+  EXPECT_EQ(2u, cache.GetHits());
+  EXPECT_EQ(4u, cache.GetMisses());
+}
@@ -0,0 +1,24 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Returns size bytes of pseudo-random data. The data only depends on size, so tests can hardcode
+// values which were computed from it.
+inline std::vector<u8> GetTestData(size_t size)
+{
+  std::vector<u8> data(size);
+  u32 state = 0x12345678;
+  std::generate(data.begin(), data.end(), [&state] {
+    state = state * 1103515245 + 12345;
+    return static_cast<u8>(state >> 16);
+  });
+  return data;
+}
@@ -0,0 +1,124 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/TevCombiner.h"
+#include "VideoCommon/BPMemory.h"
+
+namespace
+{
+using CombineFunction = void (*)(const TevStageCombiner::ColorCombiner&,
+                                 const TevStageCombiner::AlphaCombiner&,
+                                 const TevCombiner::Inputs&, TevCombiner::Outputs*);
+
+// Compares a combiner implementation against the scalar one for every regular (non-compare)
+// combination of bias, op, clamp and shift, using inputs outside of the register range as well.
+void TestAgainstScalar(CombineFunction combine)
+{
+  std::default_random_engine engine(0);
+  std::uniform_int_distribution<int> dist(-32768, 32767);
+
+  for (u32 color_mode = 0; color_mode < 64; color_mode++)
+  {
+    for (u32 alpha_mode = 0; alpha_mode < 64; alpha_mode++)
+    {
+      TevStageCombiner::ColorCombiner cc{};
+      TevStageCombiner::AlphaCombiner ac{};
+      cc.bias = color_mode & 3;
+      cc.op = (color_mode >> 2) & 1;
+      cc.clamp = (color_mode >> 3) & 1;
+      cc.shift = color_mode >> 4;
+      ac.bias = alpha_mode & 3;
+      ac.op = (alpha_mode >> 2) & 1;
+      ac.clamp = (alpha_mode >> 3) & 1;
+      ac.shift = alpha_mode >> 4;
+      if (cc.bias == 3 || ac.bias == 3)
+        continue;
+
+      for (int iteration = 0; iteration < 16; iteration++)
+      {
+        TevCombiner::Inputs inputs;
+        for (int pixel = 0; pixel < TevCombiner::NUM_PIXELS; pixel++)
+        {
+          for (int comp = 0; comp < 4; comp++)
+          {
+            inputs.a[pixel][comp] = static_cast<s16>(dist(engine));
+            inputs.b[pixel][comp] = static_cast<s16>(dist(engine));
+            inputs.c[pixel][comp] = static_cast<s16>(dist(engine));
+            inputs.d[pixel][comp] = static_cast<s16>(dist(engine));
+          }
+        }
+
+        TevCombiner::Outputs expected;
+        TevCombiner::Outputs actual;
+        TevCombiner::CombineRegularScalar(cc, ac, inputs, &expected);
+        combine(cc, ac, inputs, &actual);
+
+        for (int pixel = 0; pixel < TevCombiner::NUM_PIXELS; pixel++)
+        {
+          for (int comp = 0; comp < 4; comp++)
+          {
+            ASSERT_EQ(expected.result[pixel][comp], actual.result[pixel][comp])
+                << "cc=" << cc.hex << " ac=" << ac.hex << " pixel=" << pixel
+                << " comp=" << comp;
+          }
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+#ifdef _M_X86
+TEST(TevCombiner, SSE2MatchesScalar)
+{
+  TestAgainstScalar(TevCombiner::CombineRegularSSE2);
+}
+
+TEST(TevCombiner, AVX2MatchesScalar)
+{
+  if (!cpu_info.bAVX2)
+    return;
+
+  TestAgainstScalar(TevCombiner::CombineRegularAVX2);
+}
+#endif
+
+TEST(TevCombiner, CompareModes)
+{
+  TevStageCombiner::ColorCombiner cc{};
+  TevStageCombiner::AlphaCombiner ac{};
+  cc.bias = 3;  // compare mode
+  cc.clamp = 1;
+  cc.shift = 3;  // TEVCMP_RGB8_GT
+  ac.bias = 3;
+  ac.clamp = 1;
+  ac.shift = 3;  // TEVCMP_A8_GT
+
+  TevCombiner::Inputs inputs{};
+  for (int pixel = 0; pixel < TevCombiner::NUM_PIXELS; pixel++)
+  {
+    for (int comp = 0; comp < 4; comp++)
+    {
+      inputs.a[pixel][comp] = static_cast<s16>(pixel * 2 + (comp & 1));
+      inputs.b[pixel][comp] = static_cast<s16>(pixel * 2);
+      inputs.c[pixel][comp] = 100;
+      inputs.d[pixel][comp] = 10;
+    }
+  }
+
+  TevCombiner::Outputs outputs;
+  TevCombiner::Combine(cc, ac, inputs, &outputs);
+
+  for (int pixel = 0; pixel < TevCombiner::NUM_PIXELS; pixel++)
+  {
+    for (int comp = 0; comp < 4; comp++)
+      EXPECT_EQ((comp & 1) ? 110 : 10, outputs.result[pixel][comp]);
+  }
+}
@@ -0,0 +1,86 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "VideoBackends/Software/Tev.h"
+#include "VideoCommon/BPMemory.h"
+
+class TevTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    memset(static_cast<void*>(&bpmem), 0, sizeof(bpmem));
+    // Leave the texture color registers alone in every stage, unless a test says otherwise
+    for (auto& combiner : bpmem.combiners)
+    {
+      combiner.colorC.a = TEVCOLORARG_ZERO;
+      combiner.colorC.b = TEVCOLORARG_ZERO;
+      combiner.colorC.c = TEVCOLORARG_ZERO;
+      combiner.colorC.d = TEVCOLORARG_ZERO;
+      combiner.alphaC.a = TEVALPHAARG_ZERO;
+      combiner.alphaC.b = TEVALPHAARG_ZERO;
+      combiner.alphaC.c = TEVALPHAARG_ZERO;
+      combiner.alphaC.d = TEVALPHAARG_ZERO;
+    }
+  }
+};
+
+TEST_F(TevTest, NoTextureLookup)
+{
+  EXPECT_FALSE(Tev::ReadsCarriedInputs());
+
+  // Without any lookup, the texture color keeps the same value for the whole draw
+  bpmem.combiners[0].colorC.a = TEVCOLORARG_TEXC;
+  EXPECT_FALSE(Tev::ReadsCarriedInputs());
+}
+
+TEST_F(TevTest, TextureColorReadAfterLookup)
+{
+  bpmem.genMode.numtevstages = 1;
+  bpmem.tevorders[0].enable0 = 1;
+  bpmem.combiners[0].colorC.a = TEVCOLORARG_TEXC;
+  bpmem.combiners[1].alphaC.b = TEVALPHAARG_TEXA;
+  EXPECT_FALSE(Tev::ReadsCarriedInputs());
+}
+
+TEST_F(TevTest, TextureColorReadBeforeLookup)
+{
+  bpmem.genMode.numtevstages = 1;
+  bpmem.tevorders[0].enable1 = 1;
+  bpmem.combiners[0].colorC.d = TEVCOLORARG_TEXA;
+  EXPECT_TRUE(Tev::ReadsCarriedInputs());
+}
+
+TEST_F(TevTest, ZTextureAfterLookup)
+{
+  bpmem.tevorders[0].enable0 = 1;
+  bpmem.ztex2.op = ZTEXTURE_ADD;
+  EXPECT_FALSE(Tev::ReadsCarriedInputs());
+
+  bpmem.tevorders[0].enable0 = 0;
+  EXPECT_FALSE(Tev::ReadsCarriedInputs());
+
+  bpmem.genMode.numtevstages = 1;
+  bpmem.tevorders[0].enable1 = 1;
+  EXPECT_FALSE(Tev::ReadsCarriedInputs());
+}
+
+TEST_F(TevTest, IndirectTextureCoordinate)
+{
+  bpmem.tevorders[0].enable0 = 1;
+  bpmem.tevind[0].fb_addprev = 1;
+  EXPECT_TRUE(Tev::ReadsCarriedInputs());
+
+  // The first stage doesn't write the texture coordinate with an invalid matrix, so once the
+  // second stage writes it, the lookup reads the one left behind by the previous pixel
+  bpmem.tevind[0].fb_addprev = 0;
+  bpmem.tevind[0].mid = 13;
+  EXPECT_FALSE(Tev::ReadsCarriedInputs());
+  bpmem.genMode.numtevstages = 1;
+  EXPECT_TRUE(Tev::ReadsCarriedInputs());
+}
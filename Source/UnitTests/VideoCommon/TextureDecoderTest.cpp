@@ -0,0 +1,217 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Common/Align.h"
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+#include "../TestData.h"
+
+// The portable decoder is the reference for the optimized ones. Since it isn't part of videocommon
+// when they are, it is built into the test under another name.
+void TexDecoder_DecodeImpl_Generic(u32* dst, const u8* src, int width, int height,
+                                   TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
+#define _TexDecoder_DecodeImpl TexDecoder_DecodeImpl_Generic
+#include "VideoCommon/TextureDecoder_Generic.cpp"
+#undef _TexDecoder_DecodeImpl
+
+namespace
+{
+constexpr TextureFormat FORMATS[] = {TextureFormat::I4,     TextureFormat::I8,
+                                     TextureFormat::IA4,    TextureFormat::IA8,
+                                     TextureFormat::RGB565, TextureFormat::RGB5A3,
+                                     TextureFormat::RGBA8,  TextureFormat::C4,
+                                     TextureFormat::C8,     TextureFormat::C14X2,
+                                     TextureFormat::CMPR};
+
+constexpr TLUTFormat TLUT_FORMATS[] = {TLUTFormat::IA8, TLUTFormat::RGB565, TLUTFormat::RGB5A3};
+
+enum class InstructionSet
+{
+  SSE2,
+  SSSE3,
+  AVX2,
+};
+
+constexpr const char* INSTRUCTION_SET_NAMES[] = {"SSE2", "SSSE3", "AVX2"};
+
+// The instruction sets which the x64 decoder can use on this CPU.
+std::vector<InstructionSet> GetSupportedInstructionSets()
+{
+  std::vector<InstructionSet> sets = {InstructionSet::SSE2};
+  if (cpu_info.bSSSE3)
+    sets.push_back(InstructionSet::SSSE3);
+  if (cpu_info.bAVX2)
+    sets.push_back(InstructionSet::AVX2);
+  return sets;
+}
+
+// Hides the instruction sets above the given one from the decoder, so that all of its code paths
+// can be tested on a single CPU.
+class ScopedInstructionSet final
+{
+public:
+  explicit ScopedInstructionSet(InstructionSet set)
+      : m_ssse3(cpu_info.bSSSE3), m_avx2(cpu_info.bAVX2)
+  {
+    cpu_info.bSSSE3 = m_ssse3 && set >= InstructionSet::SSSE3;
+    cpu_info.bAVX2 = m_avx2 && set >= InstructionSet::AVX2;
+  }
+
+  ~ScopedInstructionSet()
+  {
+    cpu_info.bSSSE3 = m_ssse3;
+    cpu_info.bAVX2 = m_avx2;
+  }
+
+  ScopedInstructionSet(const ScopedInstructionSet&) = delete;
+  ScopedInstructionSet& operator=(const ScopedInstructionSet&) = delete;
+
+private:
+  bool m_ssse3;
+  bool m_avx2;
+};
+
+std::vector<u32> DecodeSerially(const u8* src, int width, int height, TextureFormat format,
+                                const u8* tlut)
+{
+  std::vector<u32> dst(width * height);
+  _TexDecoder_DecodeImpl(dst.data(), src, width, height, format, tlut, TLUTFormat::RGB5A3);
+  return dst;
+}
+}  // namespace
+
+TEST(TextureDecoder, MatchesGenericDecoder)
+{
+  const std::vector<u8> tlut = GetTestData(16384 * 2);
+
+  for (InstructionSet set : GetSupportedInstructionSets())
+  {
+    ScopedInstructionSet scoped_set(set);
+
+    for (TextureFormat format : FORMATS)
+    {
+      // A few blocks in each direction, with an odd number of them in each row.
+      const u32 block_width = TexDecoder_GetBlockWidthInTexels(format);
+      const u32 block_height = TexDecoder_GetBlockHeightInTexels(format);
+      const int width = static_cast<int>(Common::AlignUp(36u, block_width));
+      const int height = static_cast<int>(Common::AlignUp(20u, block_height));
+      const std::vector<u8> src =
+          GetTestData(TexDecoder_GetTextureSizeInBytes(width, height, format));
+
+      for (TLUTFormat tlut_format : TLUT_FORMATS)
+      {
+        std::vector<u32> expected(width * height);
+        TexDecoder_DecodeImpl_Generic(expected.data(), src.data(), width, height, format,
+                                      tlut.data(), tlut_format);
+        std::vector<u32> dst(width * height);
+        _TexDecoder_DecodeImpl(dst.data(), src.data(), width, height, format, tlut.data(),
+                               tlut_format);
+        EXPECT_EQ(dst, expected) << INSTRUCTION_SET_NAMES[static_cast<int>(set)] << " format "
+                                 << static_cast<int>(format) << " TLUT format "
+                                 << static_cast<int>(tlut_format);
+      }
+    }
+  }
+}
+
+// Splitting textures into bands of block rows must not change the result.
+TEST(TextureDecoder, ParallelMatchesSerial)
+{
+  const std::vector<u8> tlut = GetTestData(16384 * 2);
+
+  for (TextureFormat format : FORMATS)
+  {
+    const u32 block_width = TexDecoder_GetBlockWidthInTexels(format);
+    const u32 block_height = TexDecoder_GetBlockHeightInTexels(format);
+
+    // Big enough to be split, with a height which doesn't divide into equal bands.
+    const int width = 1024;
+    const int height = static_cast<int>(Common::AlignUp(600u, block_height));
+    // Twice the size of the first level, so that there is enough data for the mip chain.
+    const std::vector<u8> src =
+        GetTestData(2 * TexDecoder_GetTextureSizeInBytes(width, height, format));
+
+    std::vector<u32> dst(width * height);
+    TexDecoder_Decode(reinterpret_cast<u8*>(dst.data()), src.data(), width, height, format,
+                      tlut.data(), TLUTFormat::RGB5A3);
+    EXPECT_EQ(dst, DecodeSerially(src.data(), width, height, format, tlut.data()))
+        << "format " << static_cast<int>(format);
+
+    // A mip chain, down to a single block.
+    std::vector<std::vector<u32>> mips;
+    std::vector<TextureDecodeLevel> levels;
+    const u8* mip_src = src.data();
+    u32 mip_width = width;
+    u32 mip_height = height;
+    while (mip_width >= block_width && mip_height >= block_height)
+    {
+      const u32 expanded_width = Common::AlignUp(mip_width, block_width);
+      const u32 expanded_height = Common::AlignUp(mip_height, block_height);
+      mips.emplace_back(expanded_width * expanded_height);
+      levels.push_back({reinterpret_cast<u8*>(mips.back().data()), mip_src,
+                        static_cast<int>(expanded_width), static_cast<int>(expanded_height)});
+      mip_src += TexDecoder_GetTextureSizeInBytes(expanded_width, expanded_height, format);
+      mip_width /= 2;
+      mip_height /= 2;
+    }
+
+    TexDecoder_DecodeLevels(levels.data(), levels.size(), format, tlut.data(),
+                            TLUTFormat::RGB5A3);
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+      EXPECT_EQ(mips[i], DecodeSerially(levels[i].src, levels[i].width, levels[i].height, format,
+                                        tlut.data()))
+          << "format " << static_cast<int>(format) << " level " << i;
+    }
+  }
+}
+
+// Compares the decoders for each instruction set, and the parallel decoder, on 1024x1024 textures.
+// Disabled by default; run it with --gtest_also_run_disabled_tests.
+TEST(TextureDecoder, DISABLED_Benchmark)
+{
+  const std::vector<u8> tlut = GetTestData(16384 * 2);
+  const int width = 1024;
+  const int height = 1024;
+
+  for (TextureFormat format : FORMATS)
+  {
+    const std::vector<u8> src =
+        GetTestData(TexDecoder_GetTextureSizeInBytes(width, height, format));
+    std::vector<u32> dst(width * height);
+
+    const auto measure = [&](const char* name, auto decode) {
+      constexpr int ITERATIONS = 20;
+      const auto start = std::chrono::high_resolution_clock::now();
+      for (int i = 0; i < ITERATIONS; i++)
+        decode();
+      const auto end = std::chrono::high_resolution_clock::now();
+      printf("%-8s format %2d: %8.1f us per %dx%d texture\n", name, static_cast<int>(format),
+             std::chrono::duration<double, std::micro>(end - start).count() / ITERATIONS, width,
+             height);
+    };
+
+    for (InstructionSet set : GetSupportedInstructionSets())
+    {
+      ScopedInstructionSet scoped_set(set);
+      measure(INSTRUCTION_SET_NAMES[static_cast<int>(set)], [&] {
+        _TexDecoder_DecodeImpl(dst.data(), src.data(), width, height, format, tlut.data(),
+                               TLUTFormat::RGB5A3);
+      });
+    }
+
+    measure("Parallel", [&] {
+      TexDecoder_Decode(reinterpret_cast<u8*>(dst.data()), src.data(), width, height, format,
+                        tlut.data(), TLUTFormat::RGB5A3);
+    });
+  }
+}
@@ -0,0 +1,175 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/TexturePack.h"
+
+class TexturePackTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = File::CreateTempDir();
+    m_filename = m_directory + "/test.texpack";
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_directory); }
+
+  static std::vector<u8> GetLevelData(u32 texture, u32 level, size_t size)
+  {
+    std::vector<u8> data(size);
+    for (size_t i = 0; i < size; i++)
+      data[i] = static_cast<u8>(texture * 31 + level * 7 + i);
+    return data;
+  }
+
+  std::string m_directory;
+  std::string m_filename;
+};
+
+TEST_F(TexturePackTest, RoundTrip)
+{
+  constexpr u32 NUM_TEXTURES = 1000;
+
+  TexturePackWriter writer;
+  ASSERT_TRUE(writer.Open(m_filename));
+  for (u32 i = 0; i < NUM_TEXTURES; i++)
+  {
+    // A mip chain for every other texture, with levels whose sizes aren't aligned.
+    const u32 num_levels = i % 2 ? 3 : 1;
+    std::vector<std::vector<u8>> data;
+    TexturePack::Texture texture;
+    texture.format = i % 3 ? AbstractTextureFormat::DXT1 : AbstractTextureFormat::RGBA8;
+    texture.has_arbitrary_mipmaps = i % 5 == 0;
+    for (u32 level = 0; level < num_levels; level++)
+    {
+      data.push_back(GetLevelData(i, level, (2048 + i) >> level));
+      texture.levels.push_back(
+          {data.back().data(), data.back().size(), 16u >> level, 8u >> level, 16u >> level});
+    }
+
+    ASSERT_TRUE(writer.AddTexture(fmt::format("tex1_{}", i), texture));
+  }
+  ASSERT_TRUE(writer.Finish());
+
+  const std::unique_ptr<TexturePack> pack = TexturePack::Open(m_filename);
+  ASSERT_TRUE(pack);
+  ASSERT_EQ(pack->GetNumTextures(), NUM_TEXTURES);
+  EXPECT_FALSE(pack->Contains("tex1_1000"));
+  EXPECT_FALSE(pack->Contains(""));
+
+  for (u32 i = 0; i < NUM_TEXTURES; i++)
+  {
+    const std::string name = fmt::format("tex1_{}", i);
+    const std::optional<u32> index = pack->Find(name);
+    ASSERT_TRUE(index.has_value()) << name;
+    EXPECT_EQ(pack->GetName(*index), name);
+
+    const TexturePack::Texture texture = pack->GetTexture(*index);
+    EXPECT_TRUE(texture.format ==
+                (i % 3 ? AbstractTextureFormat::DXT1 : AbstractTextureFormat::RGBA8));
+    EXPECT_EQ(texture.has_arbitrary_mipmaps, i % 5 == 0);
+    ASSERT_EQ(texture.levels.size(), i % 2 ? 3u : 1u);
+    for (u32 level = 0; level < texture.levels.size(); level++)
+    {
+      const TexturePack::Level& packed = texture.levels[level];
+      EXPECT_EQ(packed.width, 16u >> level);
+      EXPECT_EQ(packed.height, 8u >> level);
+      EXPECT_EQ(packed.row_length, 16u >> level);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(packed.data) % TexturePackFormat::DATA_ALIGNMENT, 0u);
+      EXPECT_EQ(std::vector<u8>(packed.data, packed.data + packed.size),
+                GetLevelData(i, level, (2048 + i) >> level));
+    }
+  }
+}
+
+TEST_F(TexturePackTest, RejectsDuplicateNames)
+{
+  const std::vector<u8> data(16);
+  TexturePack::Texture texture;
+  texture.format = AbstractTextureFormat::RGBA8;
+  texture.has_arbitrary_mipmaps = false;
+  texture.levels.push_back({data.data(), data.size(), 2, 2, 2});
+
+  TexturePackWriter writer;
+  ASSERT_TRUE(writer.Open(m_filename));
+  ASSERT_TRUE(writer.AddTexture("tex1_a", texture));
+  ASSERT_TRUE(writer.AddTexture("tex1_a", texture));
+  EXPECT_FALSE(writer.Finish());
+}
+
+TEST_F(TexturePackTest, RejectsInvalidFiles)
+{
+  const std::vector<u8> data(16);
+  TexturePack::Texture texture;
+  texture.format = AbstractTextureFormat::RGBA8;
+  texture.has_arbitrary_mipmaps = false;
+  texture.levels.push_back({data.data(), data.size(), 2, 2, 2});
+
+  TexturePackWriter writer;
+  ASSERT_TRUE(writer.Open(m_filename));
+  ASSERT_TRUE(writer.AddTexture("tex1_a", texture));
+  ASSERT_TRUE(writer.Finish());
+  ASSERT_TRUE(TexturePack::Open(m_filename));
+
+  // A pack which wasn't finished has no header.
+  {
+    TexturePackWriter unfinished;
+    ASSERT_TRUE(unfinished.Open(m_directory + "/unfinished.texpack"));
+    ASSERT_TRUE(unfinished.AddTexture("tex1_a", texture));
+  }
+  EXPECT_FALSE(TexturePack::Open(m_directory + "/unfinished.texpack"));
+
+  // Truncating the file cuts off the index.
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(m_filename, contents));
+  contents.pop_back();
+  ASSERT_TRUE(File::WriteStringToFile(m_filename, contents));
+  EXPECT_FALSE(TexturePack::Open(m_filename));
+
+  EXPECT_FALSE(TexturePack::Open(m_directory + "/missing.texpack"));
+}
+
+TEST_F(TexturePackTest, RejectsLevelsSmallerThanTheirSize)
+{
+  // 4x4 RGBA8 needs 64 bytes, and a row length of 8 doubles that.
+  const std::vector<u8> data(64);
+  for (u32 row_length : {4u, 8u})
+  {
+    TexturePack::Texture texture;
+    texture.format = AbstractTextureFormat::RGBA8;
+    texture.has_arbitrary_mipmaps = false;
+    texture.levels.push_back({data.data(), data.size(), 4, 4, row_length});
+
+    TexturePackWriter writer;
+    ASSERT_TRUE(writer.Open(m_filename));
+    ASSERT_TRUE(writer.AddTexture("tex1_a", texture));
+    ASSERT_TRUE(writer.Finish());
+    EXPECT_EQ(TexturePack::Open(m_filename) != nullptr, row_length == 4) << row_length;
+  }
+
+  // The row length can't be smaller than the width.
+  TexturePack::Texture texture;
+  texture.format = AbstractTextureFormat::RGBA8;
+  texture.has_arbitrary_mipmaps = false;
+  texture.levels.push_back({data.data(), data.size(), 4, 4, 2});
+
+  TexturePackWriter writer;
+  ASSERT_TRUE(writer.Open(m_filename));
+  ASSERT_TRUE(writer.AddTexture("tex1_a", texture));
+  ASSERT_TRUE(writer.Finish());
+  EXPECT_FALSE(TexturePack::Open(m_filename));
+}